@@ -0,0 +1,44 @@
+#include "si.hpp"
+
+#include <cstdio>
+
+typedef SI_LENGTH_m(double) Length_m;
+typedef SI_SPEED_m_s(double) Speed_m_s;
+typedef SI_TIME_s(double) Time_s;
+typedef SI_PRESSURE_Pa(double) Pressure_Pa;
+
+
+#include "bench/common.hpp"
+#include "bench/matrix.hpp"
+#include "bench/ring_series.hpp"
+#include "bench/spans.hpp"
+#include "bench/thresholds.hpp"
+#include "bench/sorting.hpp"
+#include "bench/hashing.hpp"
+#include "bench/wire.hpp"
+#include "bench/json.hpp"
+#include "bench/scalars.hpp"
+#include "bench/dual.hpp"
+#include "bench/uncertain.hpp"
+#include "bench/calculus.hpp"
+#include "bench/ode.hpp"
+#include "bench/filters.hpp"
+
+
+
+int main() {
+	matrix::bench();
+	ring_series::bench();
+	spans::bench();
+	thresholds::bench();
+	sorting::bench();
+	hashing::bench();
+	wire::bench();
+	json::bench();
+	scalars::bench();
+	dual::bench();
+	uncertain::bench();
+	calculus::bench();
+	ode::bench();
+	filters::bench();
+}
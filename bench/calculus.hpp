@@ -0,0 +1,93 @@
+#ifndef CALCULUS_HPP_
+#define CALCULUS_HPP_
+
+
+#include <cmath>
+#include <vector>
+
+
+namespace calculus {
+
+
+// Small enough for the arrays to stay in the L2 cache.
+const std::size_t size = 1 << 14;
+const int runs = 2000;
+
+typedef SI_POWER_W(double) Power_W;
+typedef SI_ENERGY_J(double) Energy_J;
+
+
+template <typename Scalar, typename Span>
+void compare(const char* name, Scalar scalar, Span span) {
+	const double scalar_ns = common::measure(runs, scalar);
+	const double span_ns = common::measure(runs, span);
+
+	std::printf("Calculus: %s over %zu samples\n", name, size);
+	common::report("raw double loop", scalar_ns, scalar_ns);
+	common::report("span function", span_ns, scalar_ns);
+}
+
+
+// The energy from a power sampled at uneven times, and the speed from
+// positions, with the loops on raw doubles that the functions replace.
+void bench() {
+	std::vector<Power_W> power(size);
+	std::vector<Time_s> times(size);
+	std::vector<Length_m> positions(size);
+	for(std::size_t i = 0; i < size; i++) {
+		times[i] = Time_s(0.01 * i + 0.001 * (i % 3));
+		power[i] = Power_W(100 + 10 * std::sin(0.01 * i));
+		positions[i] = Length_m(5 * times[i].value * times[i].value);
+	}
+	const si::quantity_span<const Power_W> y(power);
+	const si::quantity_span<const Time_s> x(times);
+	const si::quantity_span<const Length_m> p(positions);
+	std::vector<Energy_J> energy(size);
+	std::vector<Speed_m_s> speeds(size);
+	const double* raw_y = y.raw();
+	const double* raw_x = x.raw();
+	const double* raw_p = p.raw();
+
+	compare("trapezoid", [&]() {
+		double sum = 0;
+		for(std::size_t i = 0; i + 1 < size; i++) {
+			sum += (raw_y[i] + raw_y[i + 1]) * (raw_x[i + 1] - raw_x[i]);
+		}
+		common::sink = Energy_J(sum / 2).value;
+	}, [&]() {
+		common::sink = si::trapezoid(y, x).value;
+	});
+
+	compare("cumulative_integral", [&]() {
+		double sum = 0;
+		energy[0] = Energy_J(0);
+		for(std::size_t i = 0; i + 1 < size; i++) {
+			sum += (raw_y[i] + raw_y[i + 1]) * (raw_x[i + 1] - raw_x[i]);
+			energy[i + 1] = Energy_J(sum / 2);
+		}
+		common::sink = energy[size - 1].value;
+	}, [&]() {
+		si::cumulative_integral(y, x, si::quantity_span<Energy_J>(energy));
+		common::sink = energy[size - 1].value;
+	});
+
+	compare("gradient", [&]() {
+		speeds[0] = Speed_m_s((raw_p[1] - raw_p[0]) / (raw_x[1] - raw_x[0]));
+		for(std::size_t i = 1; i + 1 < size; i++) {
+			const double a = raw_x[i] - raw_x[i - 1];
+			const double b = raw_x[i + 1] - raw_x[i];
+			speeds[i] = Speed_m_s((a * a * (raw_p[i + 1] - raw_p[i]) + b * b * (raw_p[i] - raw_p[i - 1])) / (a * b * (a + b)));
+		}
+		speeds[size - 1] = Speed_m_s((raw_p[size - 1] - raw_p[size - 2]) / (raw_x[size - 1] - raw_x[size - 2]));
+		common::sink = speeds[size / 2].value;
+	}, [&]() {
+		si::gradient(p, x, si::quantity_span<Speed_m_s>(speeds));
+		common::sink = speeds[size / 2].value;
+	});
+}
+
+
+} /* namespace calculus */
+
+
+#endif /* CALCULUS_HPP_ */
@@ -0,0 +1,39 @@
+#ifndef COMMON_HPP_
+#define COMMON_HPP_
+
+
+#include <chrono>
+#include <cstdio>
+
+
+namespace common {
+
+
+// Results are accumulated here so the optimizer can't drop the measured code.
+volatile double sink;
+
+
+// Runs f() the given number of times and returns the mean time per run in nanoseconds.
+template <typename F>
+double measure(int runs, F f) {
+	f(); // Warm-up
+
+	const auto start = std::chrono::steady_clock::now();
+	for(int i = 0; i < runs; i++) {
+		f();
+	}
+	const auto end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::nano>(end - start).count() / runs;
+}
+
+
+void report(const char* name, double ns, double baseline_ns) {
+	std::printf("  %-40s %12.1f ns  %6.2fx\n", name, ns, ns / baseline_ns);
+}
+
+
+} /* namespace common */
+
+
+#endif /* COMMON_HPP_ */
@@ -0,0 +1,68 @@
+#ifndef DEBUG_HPP_
+#define DEBUG_HPP_
+
+
+#include <cmath>
+
+
+namespace debug {
+
+
+const int n = 1 << 12;
+const int runs = 200;
+
+
+void bench(const char* build) {
+	static double raw_x[n], raw_v[n];
+	static Length_m x[n];
+	static Speed_m_s v[n];
+	for(int i = 0; i < n; i++) {
+		raw_x[i] = i;
+		raw_v[i] = 0.5 * i;
+		x[i] = Length_m(raw_x[i]);
+		v[i] = Speed_m_s(raw_v[i]);
+	}
+
+	// x += v * dt; x2 = x * x; accumulate lengths in different ratios.
+	const double raw_ns = common::measure(runs, [&]() {
+		const double dt = 0.01;
+		double total = 0.0;
+		double total_cm = 0.0;
+		for(int i = 0; i < n; i++) {
+			raw_x[i] += raw_v[i] * dt;
+			const double area = raw_x[i] * raw_x[i];
+			total += std::sqrt(area) - raw_x[i] / 2;
+			total_cm += raw_x[i] * 100;
+			if(raw_x[i] * 100 < total_cm) {
+				total -= 1;
+			}
+		}
+		common::sink = total + total_cm;
+	});
+
+	const double si_ns = common::measure(runs, [&]() {
+		const Time_s dt(0.01);
+		Length_m total(0.0);
+		Length_cm total_cm(0.0);
+		for(int i = 0; i < n; i++) {
+			x[i] += v[i] * dt;
+			const auto area = x[i] * x[i];
+			total += sqrt(area) - x[i] / 2;
+			total_cm += x[i];
+			if(x[i] < total_cm) {
+				total -= Length_m(1.0);
+			}
+		}
+		common::sink = total.value + total_cm.value;
+	});
+
+	std::printf("Abstraction penalty of SI values over raw doubles (-%s)\n", build);
+	common::report("raw double", raw_ns, raw_ns);
+	common::report("si::SIValue", si_ns, raw_ns);
+}
+
+
+} /* namespace debug */
+
+
+#endif /* DEBUG_HPP_ */
@@ -0,0 +1,106 @@
+#ifndef DUAL_HPP_
+#define DUAL_HPP_
+
+
+#include <cmath>
+#include <vector>
+
+
+namespace dual {
+
+
+const std::size_t size = 1 << 12;
+const int runs = 200;
+
+typedef si::dual<double, 4> Dual;
+
+
+// The range of a projectile launched at speed v and angle from height h, with
+// gravity g.
+template <typename T>
+si::Length_m<T> range(const si::Speed_m_s<T>& v, const T& angle, const si::Length_m<T>& h,
+                      const si::Acceleration_m_s2<T>& g)
+{
+	using std::cos;
+	using std::sin;
+	const auto vx = v * cos(angle);
+	const auto vy = v * sin(angle);
+	const auto flight = (vy + std::sqrt(vy * vy + 2.0 * g * h)) / g;
+	return vx * flight;
+}
+
+
+struct launch {
+	double v, angle, h, g;
+
+	double at(const double* x) const {
+		return range(si::Speed_m_s<double>(x[0]), x[1], si::Length_m<double>(x[2]),
+		             si::Acceleration_m_s2<double>(x[3])).value;
+	}
+};
+
+
+// The gradient of the range by the 4 inputs, for each launch: with dual
+// numbers in one evaluation, and with central finite differences in 8.
+void bench() {
+	std::vector<launch> launches(size);
+	for(std::size_t i = 0; i < size; i++) {
+		const launch l = { 10.0 + double(i % 50), 0.1 + double(i % 13) * 0.1, double(i % 7), 9.81 };
+		launches[i] = l;
+	}
+	std::vector<double> ranges(size);
+	std::vector<double> gradients(size * 4);
+
+	const double value_ns = common::measure(runs, [&]() {
+		for(std::size_t i = 0; i < size; i++) {
+			const launch& l = launches[i];
+			const double x[4] = { l.v, l.angle, l.h, l.g };
+			ranges[i] = l.at(x);
+		}
+		common::sink = ranges[size - 1];
+	});
+
+	const double dual_ns = common::measure(runs, [&]() {
+		for(std::size_t i = 0; i < size; i++) {
+			const launch& l = launches[i];
+			const auto r = range(si::variable<4>(si::Speed_m_s<double>(l.v), 0), Dual::variable(l.angle, 1),
+			                     si::variable<4>(si::Length_m<double>(l.h), 2),
+			                     si::variable<4>(si::Acceleration_m_s2<double>(l.g), 3));
+			ranges[i] = r.value.value;
+			for(std::size_t k = 0; k < 4; k++) {
+				gradients[i * 4 + k] = r.value.d[k];
+			}
+		}
+		common::sink = gradients[size * 4 - 1];
+	});
+
+	const double differences_ns = common::measure(runs, [&]() {
+		for(std::size_t i = 0; i < size; i++) {
+			const launch& l = launches[i];
+			double x[4] = { l.v, l.angle, l.h, l.g };
+			ranges[i] = l.at(x);
+			for(std::size_t k = 0; k < 4; k++) {
+				const double xk = x[k];
+				const double step = 1e-6 * std::fmax(std::fabs(xk), 1.0);
+				x[k] = xk + step;
+				const double above = l.at(x);
+				x[k] = xk - step;
+				const double below = l.at(x);
+				x[k] = xk;
+				gradients[i * 4 + k] = (above - below) / (2 * step);
+			}
+		}
+		common::sink = gradients[size * 4 - 1];
+	});
+
+	std::printf("Dual numbers: gradient of %zu projectile ranges by 4 inputs\n", size);
+	common::report("value only, doubles", value_ns, value_ns);
+	common::report("value and gradient, dual<double, 4>", dual_ns, value_ns);
+	common::report("value and gradient, finite differences", differences_ns, value_ns);
+}
+
+
+} /* namespace dual */
+
+
+#endif /* DUAL_HPP_ */
@@ -0,0 +1,144 @@
+#ifndef FILTERS_HPP_
+#define FILTERS_HPP_
+
+
+#include <cmath>
+#include <vector>
+
+
+namespace filters {
+
+
+const std::size_t channels = 16;
+const std::size_t frames = 1 << 12;
+const std::size_t window = 64;
+const int runs = 100;
+
+typedef si::batch<double, channels> Batch;
+typedef si::Pressure_Pa<Batch> Pressures_Pa;
+
+
+// Runs a filter over each channel of the interleaved frames: one channel at
+// a time, then all of them in a batch.
+template <typename Raw, typename Single, typename Batched>
+void compare(const char* name, Raw raw, Single single, Batched batched) {
+	const double raw_ns = common::measure(runs, raw);
+	const double single_ns = common::measure(runs, single);
+	const double batched_ns = common::measure(runs, batched);
+
+	std::printf("Filters: %s over %zu channels of %zu samples\n", name, channels, frames);
+	common::report("raw doubles, one channel at a time", raw_ns, raw_ns);
+	common::report("SI filter, one channel at a time", single_ns, raw_ns);
+	common::report("SI filter, batch of 16 channels", batched_ns, raw_ns);
+}
+
+
+template <typename Filter>
+void run_single(const Filter& prototype, const std::vector<double>& samples) {
+	double sum = 0;
+	for(std::size_t c = 0; c < channels; c++) {
+		Filter filter = prototype;
+		for(std::size_t i = 0; i < frames; i++) {
+			sum += filter(Pressure_Pa(samples[i * channels + c])).value;
+		}
+	}
+	common::sink = sum;
+}
+
+template <typename Filter>
+void run_batched(const Filter& prototype, const std::vector<double>& samples) {
+	Filter filter = prototype;
+	Batch sum(0);
+	for(std::size_t i = 0; i < frames; i++) {
+		Batch x;
+		for(std::size_t c = 0; c < channels; c++) {
+			x[c] = samples[i * channels + c];
+		}
+		sum += filter(Pressures_Pa(x)).value;
+	}
+	common::sink = sum[0];
+}
+
+
+// Pressure sensors at 100 Hz smoothed by an EMA of 1 s, a mean over 64
+// samples and a fourth order Butterworth low-pass at 2 Hz, with the scalar
+// code the filters replace.
+void bench() {
+	const Time_s period(0.01);
+	std::vector<double> samples(frames * channels);
+	for(std::size_t i = 0; i < frames; i++) {
+		for(std::size_t c = 0; c < channels; c++) {
+			samples[i * channels + c] = 101325 + 50 * std::sin(0.01 * i + c) + 5 * std::sin(1.7 * i * (c + 1));
+		}
+	}
+
+	const si::ema<Pressure_Pa> ema(Time_s(1), period);
+	compare("EMA", [&]() {
+		double sum = 0;
+		for(std::size_t c = 0; c < channels; c++) {
+			double average = samples[c];
+			for(std::size_t i = 0; i < frames; i++) {
+				average += (samples[i * channels + c] - average) * ema.alpha();
+				sum += average;
+			}
+		}
+		common::sink = sum;
+	}, [&]() {
+		run_single(ema, samples);
+	}, [&]() {
+		run_batched(si::ema<Pressures_Pa>(Time_s(1), period), samples);
+	});
+
+	compare("moving average of 64", [&]() {
+		double sum = 0;
+		for(std::size_t c = 0; c < channels; c++) {
+			double ring[window];
+			double running = 0;
+			for(std::size_t i = 0; i < frames; i++) {
+				const double x = samples[i * channels + c];
+				if(i >= window) {
+					running -= ring[i % window];
+				}
+				ring[i % window] = x;
+				running += x;
+				sum += running / (i < window ? i + 1 : window);
+			}
+		}
+		common::sink = sum;
+	}, [&]() {
+		run_single(si::moving_average<Pressure_Pa, window>(), samples);
+	}, [&]() {
+		run_batched(si::moving_average<Pressures_Pa, window>(), samples);
+	});
+
+	typedef si::biquad_cascade<Pressure_Pa, 2> Cascade;
+	const Cascade cascade = Cascade::butterworth_low_pass(si::Frequency_Hz<double>(2), period);
+	compare("Butterworth low-pass of order 4", [&]() {
+		double sum = 0;
+		for(std::size_t c = 0; c < channels; c++) {
+			double z[2][2] = { { 0, 0 }, { 0, 0 } };
+			for(std::size_t i = 0; i < frames; i++) {
+				double y = samples[i * channels + c];
+				for(std::size_t s = 0; s < 2; s++) {
+					const si::biquad_coefficients& k = cascade.stage(s).coefficients();
+					const double x = y;
+					y = x * k.b0 + z[s][0];
+					z[s][0] = x * k.b1 - y * k.a1 + z[s][1];
+					z[s][1] = x * k.b2 - y * k.a2;
+				}
+				sum += y;
+			}
+		}
+		common::sink = sum;
+	}, [&]() {
+		run_single(cascade, samples);
+	}, [&]() {
+		run_batched(si::biquad_cascade<Pressures_Pa, 2>::butterworth_low_pass(si::Frequency_Hz<double>(2), period), samples);
+	});
+}
+
+
+} /* namespace filters */
+
+
+#endif /* FILTERS_HPP_ */
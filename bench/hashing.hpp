@@ -0,0 +1,57 @@
+#ifndef HASHING_HPP_
+#define HASHING_HPP_
+
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+
+namespace hashing {
+
+
+const std::size_t samples = 1 << 18;
+const std::size_t distinct = 1 << 14;
+const int runs = 20;
+
+typedef si::Frequency_Hz<int> Frequency_Hz;
+
+
+// Counts the samples of each frequency, then looks up every sample.
+template <typename Map>
+double measure(const std::vector<Frequency_Hz>& keys) {
+	return common::measure(runs, [&]() {
+		Map map;
+		for(const Frequency_Hz& key : keys) {
+			map[key] += 1;
+		}
+		std::size_t total = 0;
+		for(const Frequency_Hz& key : keys) {
+			total += map[key];
+		}
+		common::sink = double(total);
+	});
+}
+
+
+void bench() {
+	std::vector<Frequency_Hz> keys(samples);
+	std::uint64_t state = 1;
+	for(std::size_t i = 0; i < samples; i++) {
+		state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		keys[i] = Frequency_Hz(int((state >> 33) % distinct) * 50);
+	}
+
+	const double std_ns = measure<std::unordered_map<Frequency_Hz, int>>(keys);
+	const double map_ns = measure<si::quantity_map<Frequency_Hz, int>>(keys);
+
+	std::printf("Hashing: group %zu samples by %zu frequencies (int), then look them up\n", samples, distinct);
+	common::report("std::unordered_map with std::hash", std_ns, std_ns);
+	common::report("si::quantity_map", map_ns, std_ns);
+}
+
+
+} /* namespace hashing */
+
+
+#endif /* HASHING_HPP_ */
@@ -0,0 +1,90 @@
+#ifndef JSON_HPP_
+#define JSON_HPP_
+
+
+#include <cstdlib>
+#include <vector>
+
+
+namespace json {
+
+
+const std::size_t records = 2 << 20;
+const int runs = 1;
+
+typedef si::Speed_km_h<double> Speed_km_h;
+typedef si::Length_km<double> Length_km;
+
+
+struct vector_sink {
+	std::vector<char>& text;
+
+	void write(const char* data, std::size_t size) {
+		text.insert(text.end(), data, data + size);
+	}
+};
+
+
+// Reads the speeds and lengths of the records into columns.
+struct columns : si::json::handler {
+	std::vector<Speed_m_s> speeds;
+	std::vector<Length_m> lengths;
+
+	void quantity(const si::json::quantity& q) {
+		Speed_m_s speed;
+		Length_m length;
+		if(q.get(speed)) {
+			speeds.push_back(speed);
+		} else if(q.get(length)) {
+			lengths.push_back(length);
+		}
+	}
+};
+
+
+void bench() {
+	std::vector<char> document;
+	document.reserve(records * 100);
+
+	// [{"id":0,"speed":{"value":12.5,"unit":"km/h"},"length":{"value":0.25,"unit":"km"}}, ...]
+	const double write_ns = common::measure(runs, [&]() {
+		document.clear();
+		vector_sink sink = { document };
+		si::json::writer<vector_sink> writer(sink);
+		writer.start_array();
+		for(std::size_t i = 0; i < records; i++) {
+			writer.start_object();
+			writer.key("id");
+			writer.number((long long)i);
+			writer.key("speed");
+			writer.quantity(Speed_km_h(double(i % 1000) * 0.125));
+			writer.key("length");
+			writer.quantity(Length_km(double(i % 4096) * 0.001));
+			writer.end_object();
+		}
+		writer.end_array();
+	});
+
+	columns result;
+	const double read_ns = common::measure(runs, [&]() {
+		result = columns();
+		result.speeds.reserve(records);
+		result.lengths.reserve(records);
+		if(!si::json::parse(document.data(), document.size(), result)) {
+			std::abort();
+		}
+		common::sink = result.speeds.back().value + result.lengths.back().value;
+	});
+
+	const double megabytes = document.size() / 1e6;
+	std::printf("JSON: %zu records with a speed and a length, %.0f MB\n", records, megabytes);
+	common::report("si::json::writer", write_ns, write_ns);
+	common::report("si::json::reader into columns", read_ns, write_ns);
+	std::printf("  writer: %.0f MB/s, reader: %.0f MB/s\n", megabytes * 1e9 / write_ns, megabytes * 1e9 / read_ns);
+}
+
+
+} /* namespace json */
+
+
+#endif /* JSON_HPP_ */
@@ -0,0 +1,88 @@
+#ifndef MATRIX_HPP_
+#define MATRIX_HPP_
+
+
+namespace matrix {
+
+
+// Builds a dimensions_lists type with N entries, alternating between lengths and speeds.
+template <std::size_t N, typename... Lists>
+struct mixed_units {
+	typedef typename mixed_units<N - 1,
+		typename std::conditional<N % 2 == 0, Length_m::DimensionsList, Speed_m_s::DimensionsList>::type,
+		Lists...
+	>::type type;
+};
+
+template <typename... Lists>
+struct mixed_units<0, Lists...> {
+	typedef si::dimensions_lists<Lists...> type;
+};
+
+
+// Reference kernel: plain triple loop over raw arrays.
+template <std::size_t N>
+void raw_multiply(const double* a, const double* b, double* c) {
+	for(std::size_t i = 0; i < N; i++) {
+		for(std::size_t j = 0; j < N; j++) {
+			double sum = 0.0;
+			for(std::size_t k = 0; k < N; k++) {
+				sum += a[i * N + k] * b[k * N + j];
+			}
+			c[i * N + j] = sum;
+		}
+	}
+}
+
+
+template <std::size_t N>
+void run() {
+	typedef typename mixed_units<N>::type Units;
+	typedef si::matrix<Units, Units> Square;
+
+	Square a, b;
+	for(std::size_t i = 0; i < N; i++) {
+		for(std::size_t j = 0; j < N; j++) {
+			a(i, j) = (i == j) ? double(N) : double((i + 2 * j) % 5) * 0.1;
+			b(i, j) = double((3 * i + j) % 7) * 0.2;
+		}
+	}
+
+	const int runs = int(20000000 / (N * N * N)) + 1;
+
+	double raw_c[N * N];
+	const double raw_ns = common::measure(runs, [&]() {
+		raw_multiply<N>(a.data(), b.data(), raw_c);
+		common::sink = raw_c[N - 1];
+	});
+	const double mul_ns = common::measure(runs, [&]() {
+		const Square c = a * b;
+		common::sink = c(0, N - 1);
+	});
+
+	Square x;
+	const double solve_ns = common::measure(runs, [&]() {
+		si::solve(a, b, x);
+		common::sink = x(0, N - 1);
+	});
+
+	std::printf(" %zux%zu\n", N, N);
+	common::report("raw multiply", raw_ns, raw_ns);
+	common::report("si::matrix multiply", mul_ns, raw_ns);
+	common::report("si::solve", solve_ns, raw_ns);
+}
+
+
+void bench() {
+	std::printf("Matrix (time relative to raw multiply)\n");
+	run<6>();
+	run<16>();
+	run<32>();
+	run<64>();
+}
+
+
+} /* namespace matrix */
+
+
+#endif /* MATRIX_HPP_ */
@@ -0,0 +1,98 @@
+#ifndef ODE_HPP_
+#define ODE_HPP_
+
+
+#include <tuple>
+
+
+namespace ode {
+
+
+const std::size_t systems = 256;
+const std::size_t lanes = 16;
+const int runs = 20;
+
+typedef si::batch<double, lanes> Batch;
+
+
+// A damped spring: x'' = -k/m x - c/m x'
+struct damped {
+	template <typename T>
+	std::tuple<si::Speed_m_s<T>, si::Acceleration_m_s2<T>>
+	operator()(const Time_s&, const std::tuple<si::Length_m<T>, si::Speed_m_s<T>>& y) const {
+		const auto stiffness = si::Force_N<double>(8) / Length_m(1);
+		const auto damping = si::Force_N<double>(0.5) / Speed_m_s(1);
+		const si::Mass_kg<double> mass(2);
+		return std::make_tuple(std::get<1>(y), -(stiffness / mass) * std::get<0>(y) - (damping / mass) * std::get<1>(y));
+	}
+};
+
+
+// The same system and method on raw doubles.
+void raw_rk4(double& x, double& v, double t0, double t1, double dt) {
+	const std::size_t steps = std::size_t(std::ceil((t1 - t0) / dt));
+	const double h = (t1 - t0) / steps;
+	for(std::size_t i = 0; i < steps; i++) {
+		const double k1x = v,                  k1v = -4 * x - 0.25 * v;
+		const double x2 = x + h / 2 * k1x,     v2 = v + h / 2 * k1v;
+		const double k2x = v2,                 k2v = -4 * x2 - 0.25 * v2;
+		const double x3 = x + h / 2 * k2x,     v3 = v + h / 2 * k2v;
+		const double k3x = v3,                 k3v = -4 * x3 - 0.25 * v3;
+		const double x4 = x + h * k3x,         v4 = v + h * k3v;
+		const double k4x = v4,                 k4v = -4 * x4 - 0.25 * v4;
+		x += h / 6 * (k1x + 2 * k2x + 2 * k3x + k4x);
+		v += h / 6 * (k1v + 2 * k2v + 2 * k3v + k4v);
+	}
+}
+
+
+// 256 damped springs from different positions, integrated over 10 s by RK4
+// with steps of 10 ms, one system at a time on raw doubles and on SI values,
+// and 16 systems at a time on batches.
+void bench() {
+	const Time_s t0(0), t1(10), dt(0.01);
+
+	const double raw_ns = common::measure(runs, [&]() {
+		double sum = 0;
+		for(std::size_t s = 0; s < systems; s++) {
+			double x = 1.0 + s, v = 0;
+			raw_rk4(x, v, t0.value, t1.value, dt.value);
+			sum += x;
+		}
+		common::sink = sum;
+	});
+
+	const double single_ns = common::measure(runs, [&]() {
+		double sum = 0;
+		for(std::size_t s = 0; s < systems; s++) {
+			const auto y = si::ode::rk4(damped(), std::make_tuple(Length_m(1.0 + s), Speed_m_s(0)), t0, t1, dt);
+			sum += std::get<0>(y).value;
+		}
+		common::sink = sum;
+	});
+
+	const double batched_ns = common::measure(runs, [&]() {
+		double sum = 0;
+		for(std::size_t s = 0; s < systems; s += lanes) {
+			Batch x0;
+			for(std::size_t i = 0; i < lanes; i++) {
+				x0[i] = 1.0 + s + i;
+			}
+			const auto y = si::ode::rk4(damped(), std::make_tuple(si::Length_m<Batch>(x0), si::Speed_m_s<Batch>(Batch(0))),
+			                            t0, t1, dt);
+			sum += std::get<0>(y).value[0];
+		}
+		common::sink = sum;
+	});
+
+	std::printf("ODE: RK4 for %zu damped springs over 1000 steps\n", systems);
+	common::report("raw doubles, one system at a time", raw_ns, raw_ns);
+	common::report("si::ode::rk4, one system at a time", single_ns, raw_ns);
+	common::report("si::ode::rk4, batches of 16 systems", batched_ns, raw_ns);
+}
+
+
+} /* namespace ode */
+
+
+#endif /* ODE_HPP_ */
@@ -0,0 +1,58 @@
+#ifndef RING_SERIES_HPP_
+#define RING_SERIES_HPP_
+
+
+#include <deque>
+
+
+namespace ring_series {
+
+
+const std::size_t capacity = 1 << 16;
+const std::size_t window = 256;
+
+typedef si::ring_series<Pressure_Pa, capacity> Series;
+
+
+void bench() {
+	static Series series;
+	std::deque<Pressure_Pa> deque;
+	for(std::size_t i = 0; i < capacity; i++) {
+		const Pressure_Pa p(101325.0 + double((i * 7919) % 1000));
+		series.push(Time_s(double(i)), p);
+		deque.push_back(p);
+	}
+
+	static Series::window windows[capacity / window];
+
+	const double deque_ns = common::measure(200, [&]() {
+		double total = 0.0;
+		for(std::size_t begin = 0; begin < deque.size(); begin += window) {
+			Pressure_Pa min = deque[begin];
+			Pressure_Pa max = deque[begin];
+			Pressure_Pa sum(0.0);
+			for(std::size_t i = begin; i < begin + window; i++) {
+				if(deque[i] < min) min = deque[i];
+				if(deque[i] > max) max = deque[i];
+				sum += deque[i];
+			}
+			total += min.value + max.value + sum.value / window;
+		}
+		common::sink = total;
+	});
+
+	const double series_ns = common::measure(200, [&]() {
+		const std::size_t n = series.downsample(window, windows, capacity / window);
+		common::sink = windows[n - 1].mean.value;
+	});
+
+	std::printf("Ring series: min/max/mean of %zu samples in windows of %zu\n", capacity, window);
+	common::report("std::deque scalar loop", deque_ns, deque_ns);
+	common::report("si::ring_series::downsample", series_ns, deque_ns);
+}
+
+
+} /* namespace ring_series */
+
+
+#endif /* RING_SERIES_HPP_ */
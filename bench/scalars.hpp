@@ -0,0 +1,64 @@
+#ifndef SCALARS_HPP_
+#define SCALARS_HPP_
+
+
+#include <vector>
+
+
+namespace scalars {
+
+
+// Small enough for the arrays to stay in the L1 and L2 caches.
+const std::size_t size = 1 << 14;
+const int runs = 20000;
+
+typedef si::Length_m<float> LengthFlt_m;
+
+
+// Scales float lengths by a gain and adds an offset, as a sensor calibration
+// does. Multiplying a float value by a float scalar keeps it a float, so the
+// loop vectorizes with 8 floats per AVX2 register, as the loop over raw floats.
+// Multiplying by a double scalar computes the products in doubles, 4 per
+// register, and converts them back to floats.
+void bench() {
+	std::vector<float> raw(size), raw_out(size);
+	std::vector<LengthFlt_m> in(size), out(size);
+	for(std::size_t i = 0; i < size; i++) {
+		raw[i] = float(i % 1000) * 0.25f;
+		in[i] = LengthFlt_m(raw[i]);
+	}
+	const float gain = 1.0625f;
+	const LengthFlt_m offset(-0.5f);
+
+	const double raw_ns = common::measure(runs, [&]() {
+		for(std::size_t i = 0; i < size; i++) {
+			raw_out[i] = raw[i] * gain + -0.5f;
+		}
+		common::sink = raw_out[size - 1];
+	});
+
+	const double float_ns = common::measure(runs, [&]() {
+		for(std::size_t i = 0; i < size; i++) {
+			out[i] = in[i] * gain + offset;
+		}
+		common::sink = out[size - 1].value;
+	});
+
+	const double double_ns = common::measure(runs, [&]() {
+		for(std::size_t i = 0; i < size; i++) {
+			out[i] = in[i] * double(gain) + offset;
+		}
+		common::sink = out[size - 1].value;
+	});
+
+	std::printf("Scalars: calibration of %zu float lengths\n", size);
+	common::report("raw floats", raw_ns, raw_ns);
+	common::report("SI floats, float gain", float_ns, raw_ns);
+	common::report("SI floats, double gain", double_ns, raw_ns);
+}
+
+
+} /* namespace scalars */
+
+
+#endif /* SCALARS_HPP_ */
@@ -0,0 +1,103 @@
+#ifndef SORTING_HPP_
+#define SORTING_HPP_
+
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+
+namespace sorting {
+
+
+const std::size_t size = 1 << 18;
+const int runs = 20;
+
+typedef Length_m::apply_ratio<std::kilo>::type Length_km;
+typedef Length_m::apply_ratio<std::centi>::type Length_cm;
+
+
+void bench() {
+	std::vector<Length_m> lengths(size);
+	unsigned state = 12345;
+	for(std::size_t i = 0; i < size; i++) {
+		state = state * 1103515245 + 12345;
+		lengths[i] = Length_m(double(int(state >> 4)) / 1024.0);
+	}
+	std::vector<Length_m> values(size);
+
+	// Each measurement includes the copy of the unsorted values.
+	const double std_ns = common::measure(runs, [&]() {
+		values = lengths;
+		std::sort(values.begin(), values.end());
+		common::sink = values[size / 2].value;
+	});
+	const double sort_ns = common::measure(runs, [&]() {
+		values = lengths;
+		si::sort(si::quantity_span<Length_m>(values));
+		common::sink = values[size / 2].value;
+	});
+	const double radix_ns = common::measure(runs, [&]() {
+		values = lengths;
+		si::radix_sort(si::quantity_span<Length_m>(values));
+		common::sink = values[size / 2].value;
+	});
+
+	std::printf("Sorting: %zu lengths in m (double)\n", size);
+	common::report("std::sort", std_ns, std_ns);
+	common::report("si::sort", sort_ns, std_ns);
+	common::report("si::radix_sort", radix_ns, std_ns);
+
+	std::vector<Length_m> top(100);
+	const double partial_ns = common::measure(runs, [&]() {
+		values = lengths;
+		std::partial_sort(values.begin(), values.begin() + top.size(), values.end(), std::greater<Length_m>());
+		common::sink = values[0].value;
+	});
+	const double top_ns = common::measure(runs, [&]() {
+		si::top_k(si::quantity_span<const Length_m>(lengths), si::quantity_span<Length_m>(top));
+		common::sink = top[0].value;
+	});
+
+	std::printf("Sorting: top %zu of %zu lengths in m (double)\n", top.size(), size);
+	common::report("std::partial_sort", partial_ns, partial_ns);
+	common::report("si::top_k", top_ns, partial_ns);
+
+	// Three sorted runs in km, m and cm
+	const std::size_t run = size / 3;
+	std::vector<Length_km> km(run);
+	std::vector<Length_m> m(run);
+	std::vector<Length_cm> cm(run);
+	for(std::size_t i = 0; i < run; i++) {
+		km[i] = Length_km(lengths[i].value / 1000);
+		m[i] = lengths[run + i];
+		cm[i] = Length_cm(lengths[2 * run + i].value * 100);
+	}
+	std::sort(km.begin(), km.end());
+	std::sort(m.begin(), m.end());
+	std::sort(cm.begin(), cm.end());
+	std::vector<Length_m> merged(3 * run);
+
+	const double concat_ns = common::measure(runs, [&]() {
+		std::copy(km.begin(), km.end(), merged.begin());
+		std::copy(m.begin(), m.end(), merged.begin() + run);
+		std::copy(cm.begin(), cm.end(), merged.begin() + 2 * run);
+		std::sort(merged.begin(), merged.end());
+		common::sink = merged[run].value;
+	});
+	const double merge_ns = common::measure(runs, [&]() {
+		si::merge(si::quantity_span<Length_m>(merged), si::quantity_span<const Length_km>(km),
+		          si::quantity_span<const Length_m>(m), si::quantity_span<const Length_cm>(cm));
+		common::sink = merged[run].value;
+	});
+
+	std::printf("Sorting: merge of sorted runs of %zu lengths in km, m and cm (double)\n", run);
+	common::report("convert, concatenate and std::sort", concat_ns, concat_ns);
+	common::report("si::merge", merge_ns, concat_ns);
+}
+
+
+} /* namespace sorting */
+
+
+#endif /* SORTING_HPP_ */
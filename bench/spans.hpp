@@ -0,0 +1,106 @@
+#ifndef SPANS_HPP_
+#define SPANS_HPP_
+
+
+#include <vector>
+
+
+namespace spans {
+
+
+// Small enough for the arrays to stay in the L2 cache.
+const std::size_t size = 1 << 14;
+const int runs = 2000;
+
+typedef si::multiplication<Length_m, Length_m>::type Area_m2;
+typedef Length_m::apply_ratio<std::kilo>::type Length_km;
+
+
+template <typename Scalar, typename Span>
+void compare(const char* name, Scalar scalar, Span span) {
+	const double scalar_ns = common::measure(runs, scalar);
+	const double span_ns = common::measure(runs, span);
+
+	std::printf("Spans: %s of %zu doubles\n", name, size);
+	common::report("scalar loop", scalar_ns, scalar_ns);
+	common::report("span function", span_ns, scalar_ns);
+}
+
+
+void bench() {
+	std::vector<Area_m2> areas(size);
+	std::vector<Length_m> a(size), b(size), out(size);
+	std::vector<Length_km> c(size), out_km(size);
+	std::vector<Speed_m_s> speeds(size);
+	std::vector<Time_s> times(size);
+	for(std::size_t i = 0; i < size; i++) {
+		areas[i] = Area_m2(double(i % 1000) + 0.5);
+		a[i] = Length_m(double(i % 777) - 300.0);
+		b[i] = Length_m(double(i % 555));
+		c[i] = Length_km(double(i % 333) / 1000.0);
+		speeds[i] = Speed_m_s(double(i % 99));
+		times[i] = Time_s(double(i % 10));
+	}
+
+	const si::quantity_span<const Length_m> in_a(a), in_b(b);
+	const si::quantity_span<Length_m> result(out);
+	const si::quantity_span<Length_km> result_km(out_km);
+
+	compare("sqrt", [&]() {
+		for(std::size_t i = 0; i < size; i++) {
+			out[i] = std::sqrt(areas[i]);
+		}
+		common::sink = out[size - 1].value;
+	}, [&]() {
+		si::sqrt(si::quantity_span<const Area_m2>(areas), result);
+		common::sink = out[size - 1].value;
+	});
+
+	compare("hypot", [&]() {
+		for(std::size_t i = 0; i < size; i++) {
+			out[i] = std::hypot(a[i], b[i]);
+		}
+		common::sink = out[size - 1].value;
+	}, [&]() {
+		si::hypot(in_a, in_b, result);
+		common::sink = out[size - 1].value;
+	});
+
+	compare("abs, m to km", [&]() {
+		for(std::size_t i = 0; i < size; i++) {
+			out_km[i] = std::abs(a[i]);
+		}
+		common::sink = out_km[size - 1].value;
+	}, [&]() {
+		si::abs(in_a, result_km);
+		common::sink = out_km[size - 1].value;
+	});
+
+	const Length_km lo(-0.1), hi(0.2);
+	compare("clamp to km bounds", [&]() {
+		for(std::size_t i = 0; i < size; i++) {
+			out[i] = a[i] < lo ? Length_m(lo) : (hi < a[i] ? Length_m(hi) : a[i]);
+		}
+		common::sink = out[size - 1].value;
+	}, [&]() {
+		si::clamp(in_a, lo, hi, result);
+		common::sink = out[size - 1].value;
+	});
+
+	compare("fma, speed * time + km", [&]() {
+		for(std::size_t i = 0; i < size; i++) {
+			out[i] = speeds[i] * times[i] + c[i];
+		}
+		common::sink = out[size - 1].value;
+	}, [&]() {
+		si::fma(si::quantity_span<const Speed_m_s>(speeds), si::quantity_span<const Time_s>(times),
+		        si::quantity_span<const Length_km>(c), result);
+		common::sink = out[size - 1].value;
+	});
+}
+
+
+} /* namespace spans */
+
+
+#endif /* SPANS_HPP_ */
@@ -0,0 +1,75 @@
+#ifndef THRESHOLDS_HPP_
+#define THRESHOLDS_HPP_
+
+
+#include <cstdint>
+#include <vector>
+
+
+namespace thresholds {
+
+
+const std::size_t size = 1 << 16;
+const int runs = 1000;
+
+typedef si::Speed_km_h<double> Speed_km_h;
+
+
+template <typename Column>
+void bench(const char* name) {
+	std::vector<Column> speeds(size);
+	for(std::size_t i = 0; i < size; i++) {
+		speeds[i] = Column(typename Column::ValueType((i * 7919) % 50));
+	}
+	const si::quantity_span<const Column> span(speeds);
+	const Speed_km_h limit(100);
+
+	std::vector<Column> out(size);
+	std::vector<std::uint32_t> indices(size);
+
+	const double count_loop_ns = common::measure(runs, [&]() {
+		std::size_t count = 0;
+		for(std::size_t i = 0; i < size; i++) {
+			count += speeds[i] > limit;
+		}
+		common::sink = double(count);
+	});
+	const double count_ns = common::measure(runs, [&]() {
+		common::sink = double(si::count_if_greater(span, limit));
+	});
+
+	const double filter_loop_ns = common::measure(runs, [&]() {
+		std::size_t count = 0;
+		for(std::size_t i = 0; i < size; i++) {
+			if(speeds[i] > limit) {
+				out[count++] = speeds[i];
+			}
+		}
+		common::sink = double(count);
+	});
+	const double filter_ns = common::measure(runs, [&]() {
+		common::sink = double(si::filter(span, si::above(limit), si::quantity_span<Column>(out)));
+	});
+	const double select_ns = common::measure(runs, [&]() {
+		common::sink = double(si::select(span, si::above(limit), indices.data()));
+	});
+
+	std::printf("Thresholds: %zu speeds in m/s (%s) above 100 km/h\n", size, name);
+	common::report("count, scalar loop", count_loop_ns, count_loop_ns);
+	common::report("si::count_if_greater", count_ns, count_loop_ns);
+	common::report("filter, scalar loop", filter_loop_ns, filter_loop_ns);
+	common::report("si::filter", filter_ns, filter_loop_ns);
+	common::report("si::select", select_ns, filter_loop_ns);
+}
+
+
+void bench() {
+	bench<Speed_m_s>("double");
+	bench<si::Speed_m_s<int>>("int");
+}
+
+
+} /* namespace thresholds */
+
+
+#endif /* THRESHOLDS_HPP_ */
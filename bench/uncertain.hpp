@@ -0,0 +1,91 @@
+#ifndef UNCERTAIN_HPP_
+#define UNCERTAIN_HPP_
+
+
+#include <cmath>
+#include <random>
+
+
+namespace uncertain {
+
+
+const std::size_t samples = 1 << 16;
+const int runs = 20;
+
+typedef si::uncertain<double> Uncertain;
+
+
+// A strain gauge pressure sensor: the pressure from the output voltage of its
+// bridge, the excitation voltage, the gauge factor and the stiffness.
+struct sensor {
+	template <typename T>
+	si::Pressure_Pa<T> operator()(const si::Voltage_V<T>& output, const si::Voltage_V<T>& excitation,
+	                              const T& gauge, const si::Pressure_Pa<T>& stiffness) const
+	{
+		const T ratio = output / excitation;
+		const T strain = 4.0 * ratio / (gauge * (1.0 + 2.0 * ratio));
+		return stiffness * strain;
+	}
+};
+
+
+// One evaluation per sample on SI values of doubles, with the normal samples
+// drawn by normal.
+template <typename Normal>
+void per_sample(const si::Voltage_V<Uncertain>& output, const si::Voltage_V<Uncertain>& excitation,
+                const Uncertain& gauge, const si::Pressure_Pa<Uncertain>& stiffness, Normal normal)
+{
+	std::mt19937_64 engine(1);
+	const sensor model;
+	double sum = 0, squares = 0;
+	for(std::size_t i = 0; i < samples; i++) {
+		const si::Voltage_V<double> o(output.value.value + output.value.sigma * normal(engine));
+		const si::Voltage_V<double> e(excitation.value.value + excitation.value.sigma * normal(engine));
+		const double g = gauge.value + gauge.sigma * normal(engine);
+		const si::Pressure_Pa<double> s(stiffness.value.value + stiffness.value.sigma * normal(engine));
+		const double p = model(o, e, g, s).value;
+		sum += p;
+		squares += p * p;
+	}
+	common::sink = std::sqrt(squares / samples - (sum / samples) * (sum / samples));
+}
+
+
+// The pressure of the sensor with its uncertainty, by Monte Carlo: with one
+// evaluation per sample on SI values of doubles, drawn by
+// std::normal_distribution and by the ziggurat sampler of si::monte_carlo, and
+// with si::monte_carlo, which evaluates batches of 256 samples.
+void bench() {
+	const si::Voltage_V<Uncertain> output(Uncertain(0.004, 0.00002));
+	const si::Voltage_V<Uncertain> excitation(Uncertain(10, 0.01));
+	const Uncertain gauge(2.1, 0.01);
+	const si::Pressure_Pa<Uncertain> stiffness(Uncertain(2e11, 2e9));
+	const sensor model;
+	std::normal_distribution<double> distribution;
+	const double scalar_ns = common::measure(runs, [&]() {
+		per_sample(output, excitation, gauge, stiffness, [&](std::mt19937_64& e) { return distribution(e); });
+	});
+
+	const si::_monte_carlo::ziggurat& z = si::_monte_carlo::tables();
+	const double ziggurat_ns = common::measure(runs, [&]() {
+		per_sample(output, excitation, gauge, stiffness, [&](std::mt19937_64& e) { return si::_monte_carlo::normal(e, z); });
+	});
+
+	const double batched_ns = common::measure(runs, [&]() {
+		std::mt19937_64 engine(1);
+		const si::Pressure_Pa<Uncertain> p = si::monte_carlo<256>(model, samples, engine,
+		                                                           output, excitation, gauge, stiffness);
+		common::sink = p.value.sigma;
+	});
+
+	std::printf("Uncertainty: Monte Carlo of a pressure sensor with %zu samples\n", samples);
+	common::report("per sample, std::normal_distribution", scalar_ns, scalar_ns);
+	common::report("per sample, ziggurat", ziggurat_ns, scalar_ns);
+	common::report("si::monte_carlo, batches of 256 samples", batched_ns, scalar_ns);
+}
+
+
+} /* namespace uncertain */
+
+
+#endif /* UNCERTAIN_HPP_ */
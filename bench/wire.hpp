@@ -0,0 +1,135 @@
+#ifndef WIRE_HPP_
+#define WIRE_HPP_
+
+
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+
+namespace wire {
+
+
+const std::size_t count = 1 << 20;
+const int runs = 5;
+
+
+// Sends the message through a socket pair from another thread, and receives
+// it into a buffer.
+void transfer(const std::vector<unsigned char>& message, std::vector<unsigned char>& received) {
+	int sockets[2];
+	if(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+		std::abort();
+	}
+
+	std::thread sender([&]() {
+		for(std::size_t sent = 0; sent < message.size(); ) {
+			const ssize_t n = ::write(sockets[0], message.data() + sent, message.size() - sent);
+			if(n <= 0) {
+				std::abort();
+			}
+			sent += std::size_t(n);
+		}
+		close(sockets[0]);
+	});
+
+	received.resize(message.size());
+	std::size_t size = 0;
+	ssize_t n;
+	while((n = ::read(sockets[1], received.data() + size, received.size() - size)) > 0) {
+		size += std::size_t(n);
+	}
+	received.resize(size);
+	close(sockets[1]);
+	sender.join();
+}
+
+
+void bench() {
+	std::vector<Length_m> lengths(count);
+	for(std::size_t i = 0; i < count; i++) {
+		lengths[i] = Length_m(double(i) * 0.37 - 1000);
+	}
+	std::vector<unsigned char> message, received;
+	message.reserve(count * 24 + 64);
+
+	// Encodes the values as text with their unit, and parses them back.
+	const double text_ns = common::measure(runs, [&]() {
+		message.clear();
+		char buffer[32];
+		for(const Length_m& length : lengths) {
+			const int n = std::snprintf(buffer, sizeof(buffer), "%.17g m\n", length.value);
+			message.insert(message.end(), buffer, buffer + n);
+		}
+		message.push_back('\0');
+		transfer(message, received);
+
+		double sum = 0;
+		const char* p = (const char*)received.data();
+		for(std::size_t i = 0; i < count; i++) {
+			char* end;
+			sum += std::strtod(p, &end);
+			if(std::strncmp(end, " m\n", 3) != 0) {
+				std::abort();
+			}
+			p = end + 3;
+		}
+		common::sink = sum;
+	});
+
+	const double records_ns = common::measure(runs, [&]() {
+		message.clear();
+		for(const Length_m& length : lengths) {
+			si::wire::write(message, length);
+		}
+		transfer(message, received);
+
+		double sum = 0;
+		si::wire::reader reader(received);
+		Length_m length;
+		while(reader.read(length)) {
+			sum += length.value;
+		}
+		common::sink = sum;
+	});
+
+	std::vector<Length_m> storage;
+	const double column_ns = common::measure(runs, [&]() {
+		message.clear();
+		si::wire::write(message, si::quantity_span<const Length_m>(lengths));
+		transfer(message, received);
+
+		si::quantity_span<const Length_m> view;
+		si::wire::reader reader(received);
+		if(!reader.read(view, storage)) {
+			std::abort();
+		}
+		double sum = 0;
+		for(std::size_t i = 0; i < view.size(); i++) {
+			sum += view[i].value;
+		}
+		common::sink = sum;
+	});
+
+	// Only the socket transfer of the column, the bound of the column time.
+	const double transfer_ns = common::measure(runs, [&]() {
+		transfer(message, received);
+		common::sink = received[0];
+	});
+
+	std::printf("Wire: encode %zu lengths (double), send them through a socket pair, decode and sum them\n", count);
+	common::report("text with unit (%.17g m, strtod)", text_ns, text_ns);
+	common::report("si::wire records", records_ns, text_ns);
+	common::report("si::wire column (zero-copy read)", column_ns, text_ns);
+	common::report("socket transfer of the column alone", transfer_ns, text_ns);
+	std::printf("  column throughput: %.0f MB/s of values\n", count * sizeof(double) * 1e3 / column_ns);
+}
+
+
+} /* namespace wire */
+
+
+#endif /* WIRE_HPP_ */
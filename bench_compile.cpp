@@ -0,0 +1,15 @@
+// A translation unit that only uses lengths and times, for measuring the
+// parse time of the different ways of including the library.
+#ifdef SPLIT_HEADERS
+ #include "si/length.hpp"
+ #include "si/time.hpp"
+#elif !defined(PRECOMPILED_HEADER)
+ #include "si.hpp"
+#endif
+
+typedef si::Length_m<double> Length_m;
+typedef si::Time_s<double>   Time_s;
+
+double speed(Length_m len, Time_s time) {
+	return (len / time).value;
+}
@@ -0,0 +1,23 @@
+#include "si.hpp"
+
+#include <cstdio>
+
+using namespace std;
+
+typedef SI_LENGTH_m(double) Length_m;
+typedef SI_LENGTH_cm(double) Length_cm;
+typedef SI_SPEED_m_s(double) Speed_m_s;
+typedef SI_TIME_s(double) Time_s;
+
+
+#include "bench/common.hpp"
+#include "bench/debug.hpp"
+
+
+#define STR(X) #X
+#define XSTR(X) STR(X)
+
+
+int main() {
+	debug::bench(XSTR(BENCH_OPTIMIZATION));
+}
@@ -0,0 +1,368 @@
+#ifndef SI_ARROW_HPP_
+#define SI_ARROW_HPP_
+
+
+#include <stdint.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "dimension_code.hpp"
+#include "ratio_table.hpp"
+#include "si_value.hpp"
+#include "span.hpp"
+#include "symbol_table.hpp"
+
+
+// The structs of the Arrow C data interface, as defined by its specification
+// (https://arrow.apache.org/docs/format/CDataInterface.html).
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+extern "C" {
+
+struct ArrowSchema {
+	// Array type description
+	const char* format;
+	const char* name;
+	const char* metadata;
+	int64_t flags;
+	int64_t n_children;
+	struct ArrowSchema** children;
+	struct ArrowSchema* dictionary;
+
+	// Release callback
+	void (*release)(struct ArrowSchema*);
+	// Opaque producer-specific data
+	void* private_data;
+};
+
+struct ArrowArray {
+	// Array data description
+	int64_t length;
+	int64_t null_count;
+	int64_t offset;
+	int64_t n_buffers;
+	int64_t n_children;
+	const void** buffers;
+	struct ArrowArray** children;
+	struct ArrowArray* dictionary;
+
+	// Release callback
+	void (*release)(struct ArrowArray*);
+	// Opaque producer-specific data
+	void* private_data;
+};
+
+} /* extern "C" */
+
+#endif /* ARROW_C_DATA_INTERFACE */
+
+
+namespace si {
+
+
+namespace _arrow {
+
+
+const char* const dimensions_key = "si.dimensions";
+const char* const ratio_key = "si.ratio";
+const char* const unit_key = "si.unit";
+
+
+// The format string of an underlying type.
+template <typename T>
+struct format {
+	static_assert(std::is_floating_point<T>::value ? sizeof(T) == 4  ||  sizeof(T) == 8 :
+	              std::is_signed<T>::value  &&  (sizeof(T) == 4  ||  sizeof(T) == 8),
+	              "Arrow columns support 32 and 64 bit signed integers, float and double");
+	static const char* value() {
+		return std::is_floating_point<T>::value ? (sizeof(T) == 4 ? "f" : "g") :
+		                                          (sizeof(T) == 4 ? "i" : "l");
+	}
+};
+
+
+// The metadata is a sequence of native 32 bit integers and strings: the
+// number of pairs, then the length and the bytes of each key and value.
+inline void append_int32(std::string& out, std::int32_t value) {
+	out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+inline void append_pair(std::string& out, const char* key, const std::string& value) {
+	append_int32(out, std::int32_t(std::strlen(key)));
+	out += key;
+	append_int32(out, std::int32_t(value.size()));
+	out += value;
+}
+
+template <typename SIValueType>
+std::string metadata() {
+	typedef typename SIValueType::Ratio Ratio;
+	const std::size_t unit = _symbol_table::find(SIValueType::Dimensions,
+		_ratio_table::index_of(Ratio::num, Ratio::den));
+
+	char dimensions[64];
+	std::snprintf(dimensions, sizeof(dimensions), "%d,%d,%d,%d,%d,%d,%d",
+	              unpack_dimension(SIValueType::Dimensions, 0), unpack_dimension(SIValueType::Dimensions, 1),
+	              unpack_dimension(SIValueType::Dimensions, 2), unpack_dimension(SIValueType::Dimensions, 3),
+	              unpack_dimension(SIValueType::Dimensions, 4), unpack_dimension(SIValueType::Dimensions, 5),
+	              unpack_dimension(SIValueType::Dimensions, 6));
+	char ratio[48];
+	if(Ratio::den == 1) {
+		std::snprintf(ratio, sizeof(ratio), "%lld", (long long)Ratio::num);
+	} else {
+		std::snprintf(ratio, sizeof(ratio), "%lld/%lld", (long long)Ratio::num, (long long)Ratio::den);
+	}
+
+	std::string out;
+	append_int32(out, unit == _symbol_table::unit_count ? 2 : 3);
+	append_pair(out, dimensions_key, dimensions);
+	append_pair(out, ratio_key, ratio);
+	if(unit != _symbol_table::unit_count) {
+		append_pair(out, unit_key, _symbol_table::units[unit].symbol);
+	}
+	return out;
+}
+
+
+inline std::int32_t read_int32(const char*& p) {
+	std::int32_t value;
+	std::memcpy(&value, p, sizeof(value));
+	p += sizeof(value);
+	return value;
+}
+
+// Finds the value of a key in the metadata.
+inline bool find_metadata(const char* metadata, const char* key, std::string& value) {
+	if(metadata == nullptr) {
+		return false;
+	}
+	const char* p = metadata;
+	const std::int32_t pairs = read_int32(p);
+	const std::size_t key_length = std::strlen(key);
+	for(std::int32_t i = 0; i < pairs; i++) {
+		const std::int32_t length = read_int32(p);
+		const bool found = std::size_t(length) == key_length  &&  std::memcmp(p, key, key_length) == 0;
+		p += length;
+		const std::int32_t value_length = read_int32(p);
+		if(found) {
+			value.assign(p, value_length);
+			return true;
+		}
+		p += value_length;
+	}
+	return false;
+}
+
+inline bool parse_dimensions(const std::string& text, dimension_code& dimensions) {
+	int powers[7];
+	int end = 0;
+	if(std::sscanf(text.c_str(), "%d,%d,%d,%d,%d,%d,%d%n", &powers[0], &powers[1], &powers[2], &powers[3],
+	               &powers[4], &powers[5], &powers[6], &end) != 7  ||  std::size_t(end) != text.size()) {
+		return false;
+	}
+	for(int power : powers) {
+		if(power < -128  ||  power > 127) {
+			return false;
+		}
+	}
+	dimensions = pack_dimensions(powers[0], powers[1], powers[2], powers[3], powers[4], powers[5], powers[6]);
+	return true;
+}
+
+inline bool parse_ratio(const std::string& text, long long& num, long long& den) {
+	int end = 0;
+	den = 1;
+	if(std::sscanf(text.c_str(), "%lld/%lld%n", &num, &den, &end) == 2  &&  std::size_t(end) == text.size()) {
+		return num > 0  &&  den > 0;
+	}
+	end = 0;
+	return std::sscanf(text.c_str(), "%lld%n", &num, &end) == 1  &&  std::size_t(end) == text.size()  &&  num > 0;
+}
+
+
+struct schema_data {
+	std::string name;
+	std::string metadata;
+};
+
+inline void release_schema(ArrowSchema* schema) {
+	delete static_cast<schema_data*>(schema->private_data);
+	schema->release = nullptr;
+}
+
+template <typename SIValueType>
+void export_schema(ArrowSchema* schema, const char* name) {
+	typedef typename SIValueType::ValueType T;
+	schema_data* const data = new schema_data;
+	data->name = name;
+	data->metadata = metadata<SIValueType>();
+
+	schema->format = format<T>::value();
+	schema->name = data->name.c_str();
+	schema->metadata = data->metadata.data();
+	schema->flags = 0;
+	schema->n_children = 0;
+	schema->children = nullptr;
+	schema->dictionary = nullptr;
+	schema->release = release_schema;
+	schema->private_data = data;
+}
+
+
+// The buffers of an array, and what keeps its values alive: nothing for a
+// span, or the vector of the values.
+template <typename Owner>
+struct array_data {
+	Owner owner;
+	const void* buffers[2];
+};
+
+struct no_owner {};
+
+template <typename Owner>
+void release_array(ArrowArray* array) {
+	delete static_cast<array_data<Owner>*>(array->private_data);
+	array->release = nullptr;
+}
+
+template <typename Owner>
+void export_array(ArrowArray* array, const void* values, std::size_t size, Owner&& owner) {
+	array_data<Owner>* const data = new array_data<Owner>{ std::move(owner), { nullptr, values } };
+
+	array->length = std::int64_t(size);
+	array->null_count = 0;
+	array->offset = 0;
+	array->n_buffers = 2;
+	array->n_children = 0;
+	array->buffers = data->buffers;
+	array->children = nullptr;
+	array->dictionary = nullptr;
+	array->release = release_array<Owner>;
+	array->private_data = data;
+}
+
+
+} /* namespace si::_arrow */
+
+
+
+/**
+ * @brief Exchange of columns of SI values through the Arrow C data interface.
+ *
+ * @details A column is exported as an Arrow array of a primitive type
+ * (@c int32, @c int64, @c float32 or @c float64, by the underlying type) with
+ * no nulls, whose data buffer is the memory of the values, without any
+ * copy. The unit is in the metadata of the field:
+ *   - @c si.dimensions: the powers of the base units (meter, gram, second,
+ *     ampere, kelvin, candela and mole), like <tt>1,0,-1,0,0,0,0</tt> for a
+ *     speed.
+ *   - @c si.ratio: the ratio to the base units, like @c 5/18 for km/h or
+ *     @c 1000 for kilograms (as the base unit of mass is the gram).
+ *   - @c si.unit: the symbol of the unit, if it has one, like @c km/h.
+ *
+ * An imported array is checked once against an SI value type, and its
+ * values are then accessed through a span, also without any copy.
+ */
+namespace arrow {
+
+
+/// Exports a span of values as an Arrow array, without copying them.
+/**
+ * The values must outlive the array: the release callbacks only free the
+ * structures of the array and the schema.
+ *
+ * @param array An array to initialize, which the consumer must release.
+ * @param schema A schema to initialize, which the consumer must release.
+ * @param name The name of the field.
+ */
+template <typename SIValueType>
+void export_column(quantity_span<SIValueType> values, ArrowArray* array, ArrowSchema* schema, const char* name = "") {
+	typedef typename std::remove_const<SIValueType>::type ValueType_;
+	_arrow::export_schema<ValueType_>(schema, name);
+	_arrow::export_array(array, values.raw(), values.size(), _arrow::no_owner());
+}
+
+
+/// Exports a vector of values as an Arrow array, moving it into the array.
+/**
+ * The values are not copied, and they are freed by the release callback of
+ * the array.
+ *
+ * @see export_column(quantity_span<SIValueType>, ArrowArray*, ArrowSchema*, const char*)
+ */
+template <typename SIValueType>
+void export_column(std::vector<SIValueType>&& values, ArrowArray* array, ArrowSchema* schema, const char* name = "") {
+	_arrow::export_schema<SIValueType>(schema, name);
+	const void* const data = values.data();
+	const std::size_t size = values.size();
+	_arrow::export_array(array, data, size, std::move(values));
+}
+
+
+/// Checks that an Arrow field has the unit and underlying type of an SI value type.
+/**
+ * The schema must not be released, its format must be the one of the
+ * underlying type, and its metadata must have the dimensions and the ratio
+ * of the type. The symbol of the unit is not checked.
+ */
+template <typename SIValueType>
+bool matches(const ArrowSchema& schema) {
+	typedef typename SIValueType::ValueType T;
+	typedef typename SIValueType::Ratio Ratio;
+
+	std::string text;
+	dimension_code dimensions;
+	long long num, den;
+	return schema.release != nullptr  &&
+	       schema.format != nullptr  &&  std::strcmp(schema.format, _arrow::format<T>::value()) == 0  &&
+	       schema.n_children == 0  &&  schema.dictionary == nullptr  &&
+	       _arrow::find_metadata(schema.metadata, _arrow::dimensions_key, text)  &&
+	       _arrow::parse_dimensions(text, dimensions)  &&  dimensions == SIValueType::Dimensions  &&
+	       _arrow::find_metadata(schema.metadata, _arrow::ratio_key, text)  &&
+	       _arrow::parse_ratio(text, num, den)  &&  num == Ratio::num  &&  den == Ratio::den;
+}
+
+
+/// Imports an Arrow array as a span of values, without copying them.
+/**
+ * The field is checked with @c matches, and the array must have no nulls
+ * (a null count of 0, or no validity bitmap) and aligned values. The span
+ * points to the buffer of the array, so the array must not be released
+ * while the span is used.
+ *
+ * @return Whether the array could be imported.
+ */
+template <typename SIValueType>
+bool import_column(const ArrowSchema& schema, const ArrowArray& array, quantity_span<const SIValueType>& values) {
+	if(!matches<SIValueType>(schema)  ||  array.release == nullptr  ||  array.n_buffers != 2  ||
+	   array.length < 0  ||  array.offset < 0  ||
+	   array.null_count > 0  ||  (array.null_count < 0  &&  array.buffers[0] != nullptr)) {
+		return false;
+	}
+	const SIValueType* const data = static_cast<const SIValueType*>(array.buffers[1]);
+	if(array.length > 0  &&  (data == nullptr  ||  std::uintptr_t(data) % alignof(SIValueType) != 0)) {
+		return false;
+	}
+	values = quantity_span<const SIValueType>(array.length > 0 ? data + array.offset : nullptr, std::size_t(array.length));
+	return true;
+}
+
+
+} /* namespace si::arrow */
+
+
+} /* namespace si */
+
+
+#endif /* SI_ARROW_HPP_ */
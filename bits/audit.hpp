@@ -0,0 +1,351 @@
+#ifndef SI_AUDIT_HPP_
+#define SI_AUDIT_HPP_
+
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include "config.hpp"
+#include "conversions.hpp"
+#include "dimension_code.hpp"
+#include "forward.hpp"
+
+
+namespace si {
+
+
+/**
+ * @brief Detection of the conversions that lose information.
+ *
+ * @details When @c SI_AUDIT_CONVERSIONS is defined, the conversions of SI
+ * values to another ratio or underlying type (by the converting constructor,
+ * or by @c += and @c -= with a value of another type), and the compound
+ * multiplications and divisions of integer SI values by floating point
+ * scalars, are checked. A conversion loses information when the stored value
+ * is not the converted value:
+ *   - @b truncation: an integer type drops the fractional part, like 7 m
+ *     stored in kilometers as 0 km, or 7.2 m stored in an @c int as 7 m.
+ *   - @b narrowing: the converted value is out of the range of an integer
+ *     type, like 2^40 m stored in an @c int. A floating point value out of
+ *     range is reported before its conversion, which would be undefined, and
+ *     the nearest bound of the type is stored instead.
+ *   - @b rounding: a floating point type has fewer digits than the source
+ *     type, and rounds the value, like a @c double stored in a @c float.
+ *
+ * Conversions between floating point types with at least the digits of the
+ * source are not checked: a @c double in kilometers converted to meters is
+ * rounded as any other @c double multiplication. NaNs are not reported.
+ *
+ * Each lossy conversion is counted, and depending on the mode it is also
+ * reported to a handler, or it aborts the program. The checks of conversions
+ * that lose nothing take a few nanoseconds. When @c SI_AUDIT_CONVERSIONS is not
+ * defined nothing is checked, and the conversions compile to the same code as
+ * without this header.
+ */
+namespace audit {
+
+
+/// How a conversion loses information.
+enum kind {
+	truncation,
+	narrowing,
+	rounding
+};
+
+/// What to do when a conversion loses information, besides counting it.
+enum mode {
+	count, ///< Nothing else (the default)
+	log,   ///< Call the handler
+	trap   ///< Call the handler, then abort
+};
+
+/// A conversion that lost information.
+struct loss {
+	kind what;
+	conversions::type_info from;
+	conversions::type_info to;
+	long double value;  ///< The converted value, in the ratio of @c to
+	long double stored; ///< The value that was stored instead
+};
+
+/// A function called with each lossy conversion, in modes @c log and @c trap.
+typedef void (*handler)(const loss&);
+
+
+/// Prints the loss to @c stderr, like <tt>Lossy conversion (truncation): cm (int) -> m (int), 0.07 stored as 0</tt>.
+inline void print(const loss& l) {
+	static const char* const kinds[] = { "truncation", "narrowing", "rounding" };
+	std::fprintf(stderr, "Lossy conversion (%s): %s -> %s, %.21Lg stored as %.21Lg\n", kinds[l.what],
+	             conversions::name(l.from).c_str(), conversions::name(l.to).c_str(), l.value, l.stored);
+}
+
+
+} /* namespace si::audit */
+
+
+
+namespace _audit {
+
+
+struct state {
+	std::atomic<int> mode;
+	std::atomic<audit::handler> handler;
+	std::atomic<unsigned long long> counts[3];
+
+	state() : mode(audit::count), handler(&audit::print) {
+		for(auto& count : counts) {
+			count.store(0, std::memory_order_relaxed);
+		}
+	}
+};
+
+inline state& global() {
+	static state s;
+	return s;
+}
+
+
+// The cold path, out of line so it is not flattened into the callers.
+template <typename From, typename To>
+SI_NOINLINE void lost(audit::kind what, long double value, long double stored) {
+	state& s = global();
+	s.counts[what].fetch_add(1, std::memory_order_relaxed);
+	const int mode = s.mode.load(std::memory_order_relaxed);
+	if(mode != audit::count) {
+		const audit::loss l = { what, _conversions::info<From>(), _conversions::info<To>(), value, stored };
+		s.handler.load(std::memory_order_acquire)(l);
+		if(mode == audit::trap) {
+			std::abort();
+		}
+	}
+}
+
+
+template <typename T>
+struct digits {
+	static const int value = std::numeric_limits<T>::digits;
+};
+
+
+// Checks that the value converted to To, computed in Wide, was stored exactly.
+// Integers are checked always; floating point values only when To has fewer
+// digits than From, as otherwise they are rounded by the conversion no more
+// than by any other operation in To.
+template <typename From, typename To,
+          bool _Integral = std::is_integral<typename To::ValueType>::value,
+          bool _Fewer = (digits<typename To::ValueType>::value < digits<typename From::ValueType>::value)>
+struct checker {
+	template <typename Wide>
+	SI_INLINE static bool in_range(Wide, typename To::ValueType&) {
+		return true;
+	}
+
+	template <typename Wide>
+	SI_INLINE static void check(Wide, typename To::ValueType) {}
+};
+
+template <typename From, typename To, bool _Fewer>
+struct checker<From, To, true, _Fewer> {
+	typedef typename To::ValueType T;
+
+	// The bounds are powers of two, exact in Wide: max + 1 is (max / 2 + 1) * 2.
+	template <typename Wide>
+	SI_INLINE static bool fits(Wide value) {
+		return value >= Wide(std::numeric_limits<T>::min())  &&  value < Wide(std::numeric_limits<T>::max() / 2 + 1) * 2;
+	}
+
+	// Checks a floating point value before it is converted to T, as the
+	// conversion is undefined out of the range of T. Otherwise it reports the
+	// narrowing and sets stored to the nearest bound. NaNs are let through.
+	template <typename Wide>
+	SI_INLINE static bool in_range(Wide value, T& stored) {
+		if(fits(value)  ||  value != value) {
+			return true;
+		}
+		stored = value < 0 ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+		lost<From, To>(audit::narrowing, value, stored);
+		return false;
+	}
+
+	template <typename Wide>
+	SI_INLINE static void check(Wide value, T stored) {
+		if(!fits(value)) {
+			if(value == value) {
+				lost<From, To>(audit::narrowing, value, stored);
+			}
+		} else if(Wide(stored) != value) {
+			lost<From, To>(audit::truncation, value, stored);
+		}
+	}
+};
+
+template <typename From, typename To>
+struct checker<From, To, false, true> {
+	template <typename Wide>
+	SI_INLINE static bool in_range(Wide, typename To::ValueType&) {
+		return true;
+	}
+
+	template <typename Wide>
+	SI_INLINE static void check(Wide value, typename To::ValueType stored) {
+		if(Wide(stored) != value  &&  value == value) {
+			lost<From, To>(audit::rounding, value, stored);
+		}
+	}
+};
+
+
+// The type in which the converted values are computed for the checks: double,
+// unless it has fewer digits than one of the types.
+template <typename T1, typename T2>
+struct wide {
+	typedef typename std::conditional<(digits<T1>::value > digits<double>::value  ||
+	                                   digits<T2>::value > digits<double>::value),
+	                                  long double, double>::type type;
+};
+
+
+// Checks the conversion of value from From to To, scaled by Mult, that stored
+// the value stored. Only conversions between arithmetic types are checked: the
+// other types, like dual numbers, have no digits to compare.
+template <typename From, typename To,
+          bool _Arithmetic = (std::is_arithmetic<typename From::ValueType>::value  &&
+                              std::is_arithmetic<typename To::ValueType>::value)>
+struct conversion {
+	typedef typename wide<typename From::ValueType, typename To::ValueType>::type Wide;
+
+	// The scaled values are computed in double (see SIValue::scale), so only
+	// the conversions between integers of the same ratio are defined out of
+	// range.
+	template <typename Mult>
+	static constexpr bool through_floating() {
+		return !std::is_integral<typename From::ValueType>::value  ||  Mult::num != 1  ||  Mult::den != 1;
+	}
+
+	template <typename Mult>
+	SI_INLINE static bool in_range(typename From::ValueType value, Mult, typename To::ValueType& stored) {
+		return !through_floating<Mult>()  ||
+		       checker<From, To>::in_range(Wide(value) * Wide(Mult::num) / Wide(Mult::den), stored);
+	}
+
+	template <typename Mult>
+	SI_INLINE static void check(typename From::ValueType value, Mult, typename To::ValueType stored) {
+		checker<From, To>::check(Wide(value) * Wide(Mult::num) / Wide(Mult::den), stored);
+	}
+};
+
+template <typename From, typename To>
+struct conversion<From, To, false> {
+	template <typename Mult>
+	SI_INLINE static bool in_range(const typename From::ValueType&, Mult, const typename To::ValueType&) {
+		return true;
+	}
+
+	template <typename Mult>
+	SI_INLINE static void check(const typename From::ValueType&, Mult, const typename To::ValueType&) {}
+};
+
+// Checks that the conversion of value from From to To, scaled by Mult, is
+// defined, before it is computed. Otherwise it sets stored to the value to
+// store instead.
+template <typename From, typename To, typename Mult>
+SI_INLINE bool in_range(const typename From::ValueType& value, Mult, typename To::ValueType& stored) {
+	return conversion<From, To>::in_range(value, Mult(), stored);
+}
+
+template <typename From, typename To, typename Mult>
+SI_INLINE void check(const typename From::ValueType& value, Mult, const typename To::ValueType& stored) {
+	conversion<From, To>::check(value, Mult(), stored);
+}
+
+
+// Multiplies or divides an SI value by a scalar in place, and checks the
+// value stored. Only integers scaled by floating point scalars are checked:
+// other products are computed in the type of the value, and a float multiplied
+// by a double is rounded as by any other float operation. The unchecked ones
+// compute nothing else, so a value of a heavyweight type is not copied.
+template <typename SIValueType, typename Scalar,
+          typename Product = decltype(std::declval<typename SIValueType::ValueType&>() * std::declval<const Scalar&>()),
+          bool _Checked = (std::is_integral<typename SIValueType::ValueType>::value  &&
+                           std::is_floating_point<Product>::value)>
+struct scaler {
+	SI_INLINE static void multiply(typename SIValueType::ValueType& value, const Scalar& n) {
+		value *= n;
+	}
+
+	SI_INLINE static void divide(typename SIValueType::ValueType& value, const Scalar& n) {
+		value /= n;
+	}
+};
+
+template <typename SIValueType, typename Scalar, typename Product>
+struct scaler<SIValueType, Scalar, Product, true> {
+	typedef SIValue<Product, typename SIValueType::Ratio, SIValueType::Dimensions> From;
+
+	SI_INLINE static void multiply(typename SIValueType::ValueType& value, const Scalar& n) {
+		store(value, value * n);
+	}
+
+	SI_INLINE static void divide(typename SIValueType::ValueType& value, const Scalar& n) {
+		store(value, value / n);
+	}
+
+	// Like the compound assignment, but the range is checked first.
+	SI_INLINE static void store(typename SIValueType::ValueType& value, Product result) {
+		if(checker<From, SIValueType, true, false>::in_range(result, value)) {
+			value = typename SIValueType::ValueType(result);
+			checker<From, SIValueType, true, false>::check(result, value);
+		}
+	}
+};
+
+
+} /* namespace si::_audit */
+
+
+
+namespace audit {
+
+
+/// Sets what to do with the lossy conversions, besides counting them.
+inline void set_mode(mode m) {
+	_audit::global().mode.store(m, std::memory_order_relaxed);
+}
+
+inline mode get_mode() {
+	return mode(_audit::global().mode.load(std::memory_order_relaxed));
+}
+
+/// Sets the function called in modes @c log and @c trap. By default it is @c print.
+inline void set_handler(handler h) {
+	_audit::global().handler.store(h ? h : &print, std::memory_order_release);
+}
+
+/// Returns the number of lossy conversions of a kind, in all the threads.
+inline unsigned long long losses(kind what) {
+	return _audit::global().counts[what].load(std::memory_order_relaxed);
+}
+
+/// Returns the number of lossy conversions of all kinds, in all the threads.
+inline unsigned long long losses() {
+	return losses(truncation) + losses(narrowing) + losses(rounding);
+}
+
+/// Sets the counts to zero.
+inline void reset() {
+	for(auto& count : _audit::global().counts) {
+		count.store(0, std::memory_order_relaxed);
+	}
+}
+
+
+} /* namespace si::audit */
+
+
+} /* namespace si */
+
+
+#endif /* SI_AUDIT_HPP_ */
@@ -0,0 +1,250 @@
+#ifndef SI_BATCH_HPP_
+#define SI_BATCH_HPP_
+
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include "config.hpp"
+
+
+namespace si {
+
+
+/**
+ * @brief @c N values operated on together, lane by lane.
+ *
+ * @details A batch stores its lanes as a plain array, and each operation is a
+ * loop over the lanes that the compiler vectorizes. As the underlying type of
+ * an SI value it evaluates a unit-typed function on @c N inputs at once: a
+ * <tt>Pressure_Pa<batch<double, 256>></tt> holds 256 pressures, and dividing
+ * it by an area computes 256 quotients with the units checked once. Functions
+ * of SI values written as templates on the underlying type take batches
+ * unchanged, which is how @c monte_carlo evaluates a model on many samples per
+ * call.
+ *
+ * Batches are not compared, as comparisons would differ by lane.
+ *
+ * @tparam T The type of the lanes. Must be an arithmetic type.
+ * @tparam N The number of lanes.
+ */
+template <typename T, std::size_t N>
+struct batch {
+	static_assert(std::is_arithmetic<T>::value, "The lanes of a batch must have an arithmetic type");
+	static_assert(N > 0, "A batch must have at least one lane");
+
+	/// The type of the lanes.
+	typedef T value_type;
+
+	/// The lanes.
+	T v[N];
+
+
+	/// Zero in every lane.
+	SI_INLINE batch() noexcept {
+		for(std::size_t i = 0; i < N; i++) {
+			v[i] = T();
+		}
+	}
+
+	/// The same value in every lane.
+	SI_INLINE batch(const T& value) noexcept {
+		for(std::size_t i = 0; i < N; i++) {
+			v[i] = value;
+		}
+	}
+
+	/// Conversion from a batch of another type, lane by lane.
+	template <typename U>
+	SI_INLINE batch(const batch<U, N>& b) noexcept {
+		for(std::size_t i = 0; i < N; i++) {
+			v[i] = T(b.v[i]);
+		}
+	}
+
+	/// Returns the @c i-th lane.
+	SI_INLINE T& operator[](std::size_t i) noexcept {
+		return v[i];
+	}
+
+	/// Returns the @c i-th lane.
+	SI_INLINE const T& operator[](std::size_t i) const noexcept {
+		return v[i];
+	}
+
+
+	SI_INLINE batch& operator+=(const batch& b) noexcept {
+		for(std::size_t i = 0; i < N; i++) {
+			v[i] += b.v[i];
+		}
+		return *this;
+	}
+
+	SI_INLINE batch& operator-=(const batch& b) noexcept {
+		for(std::size_t i = 0; i < N; i++) {
+			v[i] -= b.v[i];
+		}
+		return *this;
+	}
+
+	SI_INLINE batch& operator*=(const batch& b) noexcept {
+		for(std::size_t i = 0; i < N; i++) {
+			v[i] *= b.v[i];
+		}
+		return *this;
+	}
+
+	SI_INLINE batch& operator/=(const batch& b) noexcept {
+		for(std::size_t i = 0; i < N; i++) {
+			v[i] /= b.v[i];
+		}
+		return *this;
+	}
+
+	SI_INLINE batch& operator+=(const T& c) noexcept {
+		for(std::size_t i = 0; i < N; i++) {
+			v[i] += c;
+		}
+		return *this;
+	}
+
+	SI_INLINE batch& operator-=(const T& c) noexcept {
+		for(std::size_t i = 0; i < N; i++) {
+			v[i] -= c;
+		}
+		return *this;
+	}
+
+	SI_INLINE batch& operator*=(const T& c) noexcept {
+		for(std::size_t i = 0; i < N; i++) {
+			v[i] *= c;
+		}
+		return *this;
+	}
+
+	SI_INLINE batch& operator/=(const T& c) noexcept {
+		for(std::size_t i = 0; i < N; i++) {
+			v[i] /= c;
+		}
+		return *this;
+	}
+
+
+	// As for dual numbers, the binary operators are hidden friends that accept
+	// anything convertible to T on either side.
+
+	SI_INLINE friend batch operator+(const batch& b) noexcept { return b; }
+	SI_INLINE friend batch operator-(const batch& b) noexcept { return batch() -= b; }
+
+	SI_INLINE friend batch operator+(batch a, const batch& b) noexcept { return a += b; }
+	SI_INLINE friend batch operator-(batch a, const batch& b) noexcept { return a -= b; }
+	SI_INLINE friend batch operator*(batch a, const batch& b) noexcept { return a *= b; }
+	SI_INLINE friend batch operator/(batch a, const batch& b) noexcept { return a /= b; }
+
+	SI_INLINE friend batch operator+(batch a, const T& c) noexcept { return a += c; }
+	SI_INLINE friend batch operator-(batch a, const T& c) noexcept { return a -= c; }
+	SI_INLINE friend batch operator*(batch a, const T& c) noexcept { return a *= c; }
+	SI_INLINE friend batch operator/(batch a, const T& c) noexcept { return a /= c; }
+
+	SI_INLINE friend batch operator+(const T& c, batch a) noexcept { return a += c; }
+	SI_INLINE friend batch operator-(const T& c, const batch& b) noexcept { return batch(c) -= b; }
+	SI_INLINE friend batch operator*(const T& c, batch a) noexcept { return a *= c; }
+	SI_INLINE friend batch operator/(const T& c, const batch& b) noexcept { return batch(c) /= b; }
+};
+
+
+
+namespace _batch {
+
+
+// Applies f to each lane.
+template <typename T, std::size_t N, typename F>
+SI_INLINE batch<T, N> map(const batch<T, N>& b, F f) noexcept {
+	batch<T, N> result;
+	for(std::size_t i = 0; i < N; i++) {
+		result.v[i] = f(b.v[i]);
+	}
+	return result;
+}
+
+
+} /* namespace si::_batch */
+
+
+
+/// Returns the square roots of the lanes of a batch.
+/** @relates batch */
+template <typename T, std::size_t N>
+SI_INLINE batch<decltype(std::sqrt(T())), N> sqrt(const batch<T, N>& b) noexcept {
+	batch<decltype(std::sqrt(T())), N> result;
+	for(std::size_t i = 0; i < N; i++) {
+		result.v[i] = std::sqrt(b.v[i]);
+	}
+	return result;
+}
+
+/// Returns the cube roots of the lanes of a batch.
+/** @relates batch */
+template <typename T, std::size_t N>
+SI_INLINE batch<T, N> cbrt(const batch<T, N>& b) noexcept {
+	return _batch::map(b, [](T x) { return T(std::cbrt(x)); });
+}
+
+/// Returns the lanes of a batch raised to a power.
+/** @relates batch */
+template <typename T, std::size_t N>
+SI_INLINE batch<T, N> pow(const batch<T, N>& b, const T& p) noexcept {
+	return _batch::map(b, [p](T x) { return T(std::pow(x, p)); });
+}
+
+/// Returns the absolute values of the lanes of a batch.
+/** @relates batch */
+template <typename T, std::size_t N>
+SI_INLINE batch<T, N> abs(const batch<T, N>& b) noexcept {
+	return _batch::map(b, [](T x) { return x < 0 ? -x : x; });
+}
+
+/// Returns the square roots of the sums of the squares of the lanes of two batches.
+/** @relates batch */
+template <typename T, std::size_t N>
+SI_INLINE batch<T, N> hypot(const batch<T, N>& a, const batch<T, N>& b) noexcept {
+	batch<T, N> result;
+	for(std::size_t i = 0; i < N; i++) {
+		result.v[i] = std::hypot(a.v[i], b.v[i]);
+	}
+	return result;
+}
+
+/// Returns e raised to the lanes of a batch.
+/** @relates batch */
+template <typename T, std::size_t N>
+SI_INLINE batch<T, N> exp(const batch<T, N>& b) noexcept {
+	return _batch::map(b, [](T x) { return T(std::exp(x)); });
+}
+
+/// Returns the natural logarithms of the lanes of a batch.
+/** @relates batch */
+template <typename T, std::size_t N>
+SI_INLINE batch<T, N> log(const batch<T, N>& b) noexcept {
+	return _batch::map(b, [](T x) { return T(std::log(x)); });
+}
+
+/// Returns the sines of the lanes of a batch.
+/** @relates batch */
+template <typename T, std::size_t N>
+SI_INLINE batch<T, N> sin(const batch<T, N>& b) noexcept {
+	return _batch::map(b, [](T x) { return T(std::sin(x)); });
+}
+
+/// Returns the cosines of the lanes of a batch.
+/** @relates batch */
+template <typename T, std::size_t N>
+SI_INLINE batch<T, N> cos(const batch<T, N>& b) noexcept {
+	return _batch::map(b, [](T x) { return T(std::cos(x)); });
+}
+
+
+} /* namespace si */
+
+
+#endif /* SI_BATCH_HPP_ */
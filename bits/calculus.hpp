@@ -0,0 +1,376 @@
+#ifndef SI_CALCULUS_HPP_
+#define SI_CALCULUS_HPP_
+
+
+#include <cstddef>
+#include <ratio>
+#include <type_traits>
+#include "dimension_code.hpp"
+#include "operations.hpp"
+#include "simd.hpp"
+#include "span.hpp"
+#include "span_math.hpp"
+
+
+namespace si {
+
+
+namespace _calculus {
+
+
+// The type of the integral of Y over X, for SI values only, so the overloads
+// for a constant step don't match spans.
+template <typename Y, typename X>
+struct integral_of {};
+
+template <typename ValueType1, typename Ratio1, dimension_code Dimensions1,
+          typename ValueType2, typename Ratio2, dimension_code Dimensions2>
+struct integral_of<SIValue<ValueType1, Ratio1, Dimensions1>, SIValue<ValueType2, Ratio2, Dimensions2>>
+	: multiplication<SIValue<ValueType1, Ratio1, Dimensions1>, SIValue<ValueType2, Ratio2, Dimensions2>>
+{};
+
+template <typename Y, typename X>
+struct integral : integral_of<typename std::remove_const<Y>::type, typename std::remove_const<X>::type> {};
+
+
+template <typename Y, typename X>
+typename integral<Y, X>::type trapezoid(quantity_span<Y> y, quantity_span<X> x, std::true_type) {
+	typedef typename integral<Y, X>::type Result;
+	const _simd::trapezoid_op op = { x.raw(), y.raw(), 0.5 };
+	return Result(_simd::sum(op, y.size() - 1));
+}
+
+template <typename Y, typename X>
+typename integral<Y, X>::type trapezoid(quantity_span<Y> y, quantity_span<X> x, std::false_type) {
+	typedef decltype((y[0] + y[1]) * (x[1] - x[0])) Term;
+	Term sum = Term();
+	for(std::size_t i = 0; i + 1 < y.size(); i++) {
+		sum += (y[i] + y[i + 1]) * (x[i + 1] - x[i]);
+	}
+	return sum / 2;
+}
+
+
+template <typename Y, typename Step>
+typename integral<Y, Step>::type trapezoid(quantity_span<Y> y, const Step& dx, std::true_type) {
+	typedef typename integral<Y, Step>::type Result;
+	const _simd::uniform_trapezoid_op op = { y.raw(), 0.5 * dx.value };
+	return Result(_simd::sum(op, y.size() - 1));
+}
+
+template <typename Y, typename Step>
+typename integral<Y, Step>::type trapezoid(quantity_span<Y> y, const Step& dx, std::false_type) {
+	typedef typename std::remove_const<Y>::type YType;
+	YType sum = YType();
+	for(std::size_t i = 0; i + 1 < y.size(); i++) {
+		sum += y[i] + y[i + 1];
+	}
+	return sum * dx / 2;
+}
+
+
+// The Simpson rule over the first m values, m odd, and the last interval
+// when there is one more: the integral of the parabola through the last 3
+// values, h (5 y[n-1] + 8 y[n-2] - y[n-3]) / 12.
+template <typename Y, typename Step>
+typename integral<Y, Step>::type simpson(quantity_span<Y> y, const Step& dx, std::true_type) {
+	typedef typename integral<Y, Step>::type Result;
+	const double* raw = y.raw();
+	const std::size_t n = y.size();
+	const std::size_t m = n % 2 ? n : n - 1;
+	const _simd::alternating_op op = { raw, 2, 4 };
+	double sum = (_simd::sum(op, m) - raw[0] - raw[m - 1]) / 3;
+	if(m < n) {
+		sum += (5 * raw[n - 1] + 8 * raw[n - 2] - raw[n - 3]) / 12;
+	}
+	return Result(sum * dx.value);
+}
+
+template <typename Y, typename Step>
+typename integral<Y, Step>::type simpson(quantity_span<Y> y, const Step& dx, std::false_type) {
+	typedef typename integral<Y, Step>::type Result;
+	typedef typename std::remove_const<Y>::type YType;
+	const std::size_t n = y.size();
+	const std::size_t m = n % 2 ? n : n - 1;
+	YType sum = YType();
+	for(std::size_t i = 0; i + 2 < m; i += 2) {
+		sum += y[i] + y[i + 1] * 4 + y[i + 2];
+	}
+	Result result = sum * dx / 3;
+	if(m < n) {
+		result += (y[n - 1] * 5 + y[n - 2] * 8 - y[n - 3]) * dx / 12;
+	}
+	return result;
+}
+
+
+template <typename Y, typename X, typename Out>
+void cumulative_integral(quantity_span<Y> y, quantity_span<X> x, quantity_span<Out> out, std::true_type) {
+	typedef typename integral<Y, X>::type Result;
+	const _simd::trapezoid_op op = {
+		x.raw(), y.raw(),
+		0.5 * _span_math::scale<typename Result::Ratio, typename Out::Ratio>()
+	};
+	_simd::scan(op, y.size() - 1, out.raw() + 1);
+}
+
+template <typename Y, typename X, typename Out>
+void cumulative_integral(quantity_span<Y> y, quantity_span<X> x, quantity_span<Out> out, std::false_type) {
+	typedef decltype((y[0] + y[1]) * (x[1] - x[0])) Term;
+	Term sum = Term();
+	for(std::size_t i = 0; i + 1 < y.size(); i++) {
+		sum += (y[i] + y[i + 1]) * (x[i + 1] - x[i]);
+		out[i + 1] = sum / 2;
+	}
+}
+
+
+template <typename Y, typename Step, typename Out>
+void cumulative_integral(quantity_span<Y> y, const Step& dx, quantity_span<Out> out, std::true_type) {
+	typedef typename integral<Y, Step>::type Result;
+	const _simd::uniform_trapezoid_op op = {
+		y.raw(),
+		0.5 * dx.value * _span_math::scale<typename Result::Ratio, typename Out::Ratio>()
+	};
+	_simd::scan(op, y.size() - 1, out.raw() + 1);
+}
+
+template <typename Y, typename Step, typename Out>
+void cumulative_integral(quantity_span<Y> y, const Step& dx, quantity_span<Out> out, std::false_type) {
+	typedef typename std::remove_const<Y>::type YType;
+	YType sum = YType();
+	for(std::size_t i = 0; i + 1 < y.size(); i++) {
+		sum += y[i] + y[i + 1];
+		out[i + 1] = sum * dx / 2;
+	}
+}
+
+
+// The values inside: the slopes on both sides, each weighted by the width of
+// the other side (see _simd::gradient_op).
+template <typename Y, typename X, typename Out>
+void gradient(quantity_span<Y> y, quantity_span<X> x, quantity_span<Out> out, std::true_type) {
+	typedef typename std::remove_const<Y>::type YType;
+	typedef typename std::remove_const<X>::type XType;
+	typedef typename std::ratio_divide<typename YType::Ratio, typename XType::Ratio>::type Ratio;
+	const _simd::gradient_op op = { x.raw(), y.raw(), _span_math::scale<Ratio, typename Out::Ratio>() };
+	_simd::each(op, y.size() - 2, out.raw() + 1);
+}
+
+template <typename Y, typename X, typename Out>
+void gradient(quantity_span<Y> y, quantity_span<X> x, quantity_span<Out> out, std::false_type) {
+	for(std::size_t i = 1; i + 1 < y.size(); i++) {
+		const auto a = x[i] - x[i - 1];
+		const auto b = x[i + 1] - x[i];
+		out[i] = (a * a * (y[i + 1] - y[i]) + b * b * (y[i] - y[i - 1])) / (a * b * (a + b));
+	}
+}
+
+
+template <typename Y, typename Step, typename Out>
+void gradient(quantity_span<Y> y, const Step& dx, quantity_span<Out> out, std::true_type) {
+	typedef typename std::remove_const<Y>::type YType;
+	typedef typename std::ratio_divide<typename YType::Ratio, typename Step::Ratio>::type Ratio;
+	const _simd::central_difference_op op = {
+		y.raw(),
+		_span_math::scale<Ratio, typename Out::Ratio>() / (2 * dx.value)
+	};
+	_simd::each(op, y.size() - 2, out.raw() + 1);
+}
+
+template <typename Y, typename Step, typename Out>
+void gradient(quantity_span<Y> y, const Step& dx, quantity_span<Out> out, std::false_type) {
+	for(std::size_t i = 1; i + 1 < y.size(); i++) {
+		out[i] = (y[i + 1] - y[i - 1]) / (dx * 2);
+	}
+}
+
+
+} /* namespace si::_calculus */
+
+
+
+/**
+ * @name Integration and differentiation over spans
+ *
+ * These functions integrate and differentiate series of SI values sampled at
+ * the times (or positions) of a second span, or at a constant step. The types
+ * of the results are derived from the types of the samples: integrating a
+ * power in W over times in s gives an energy in J, and differentiating
+ * positions in m gives speeds in m/s:
+ * @code
+ *   const si::Energy_J<double> energy = si::trapezoid(power, times);
+ *   si::gradient(positions, times, si::quantity_span<si::Speed_m_s<double>>(speeds));
+ * @endcode
+ *
+ * The samples and their times must have the same size, and the times must be
+ * increasing. The functions that write a series take an output span with the
+ * size of the samples, which must not overlap the inputs, and which may have
+ * any ratio with the dimensions of the result.
+ *
+ * When all the underlying types are @c double, the sums and the differences
+ * are computed with AVX2 or SSE2 instructions, selected at runtime, and are
+ * rounded like sums in a different order. Otherwise each result is computed
+ * as the operations on single values would.
+ */
+///@{
+
+
+/// The integral of the samples by the trapezoidal rule.
+/**
+ * Less than two samples have an integral of zero.
+ *
+ * @return The integral, with the ratio of the product of the ratios.
+ */
+template <typename Y, typename X>
+typename _calculus::integral<Y, X>::type trapezoid(quantity_span<Y> y, quantity_span<X> x) {
+	if(y.size() < 2) {
+		return typename _calculus::integral<Y, X>::type();
+	}
+	return _calculus::trapezoid(y, x, _span_math::all_double<Y, X>());
+}
+
+/// The integral of samples at a constant step by the trapezoidal rule.
+template <typename Y, typename Step>
+typename _calculus::integral<Y, Step>::type trapezoid(quantity_span<Y> y, const Step& dx) {
+	if(y.size() < 2) {
+		return typename _calculus::integral<Y, Step>::type();
+	}
+	return _calculus::trapezoid(y, dx, _span_math::all_double<Y, Step>());
+}
+
+
+/// The integral of the samples by Simpson's rule.
+/**
+ * The rule integrates the parabola through each pair of intervals, so it is
+ * exact for polynomials up to the third degree over a constant step (and the
+ * second degree otherwise). With an odd number of intervals, the last one is
+ * integrated with the parabola through the last three samples. Two samples
+ * are integrated by the trapezoidal rule.
+ *
+ * Over uneven steps, the rule needs floating point times, and is computed
+ * one pair of intervals at a time, without SIMD instructions.
+ */
+template <typename Y, typename X>
+typename _calculus::integral<Y, X>::type simpson(quantity_span<Y> y, quantity_span<X> x) {
+	typedef typename std::remove_const<X>::type XType;
+	typedef typename _calculus::integral<Y, X>::type Result;
+	static_assert(std::is_floating_point<typename XType::ValueType>::value,
+	              "Simpson's rule over uneven steps needs floating point times");
+	const std::size_t n = y.size();
+	if(n < 3) {
+		return trapezoid(y, x);
+	}
+
+	const std::size_t m = n % 2 ? n : n - 1;
+	Result sum = Result();
+	for(std::size_t i = 0; i + 2 < m; i += 2) {
+		const XType h0 = x[i + 1] - x[i];
+		const XType h1 = x[i + 2] - x[i + 1];
+		const XType h = h0 + h1;
+		sum += h / 6 * ((2 - h1 / h0) * y[i] + h * h / (h0 * h1) * y[i + 1] + (2 - h0 / h1) * y[i + 2]);
+	}
+	if(m < n) {
+		const XType h0 = x[n - 2] - x[n - 3];
+		const XType h1 = x[n - 1] - x[n - 2];
+		const XType h = h0 + h1;
+		sum += h1 / 6 * ((2 * h1 + 3 * h0) / h * y[n - 1] + (h1 + 3 * h0) / h0 * y[n - 2] - h1 * h1 / (h0 * h) * y[n - 3]);
+	}
+	return sum;
+}
+
+/// The integral of samples at a constant step by Simpson's rule.
+template <typename Y, typename Step>
+typename _calculus::integral<Y, Step>::type simpson(quantity_span<Y> y, const Step& dx) {
+	if(y.size() < 3) {
+		return trapezoid(y, dx);
+	}
+	return _calculus::simpson(y, dx, _span_math::all_double<Y, Step>());
+}
+
+
+/// The integrals from the first sample to each sample, by the trapezoidal rule.
+/**
+ * The first integral is zero. Each next one is the previous one plus the
+ * trapezoid between the samples; when vectorized, the trapezoids are summed
+ * by blocks in the registers, with a single addition carrying the sum from
+ * one block to the next.
+ */
+template <typename Y, typename X, typename Out>
+void cumulative_integral(quantity_span<Y> y, quantity_span<X> x, quantity_span<Out> out) {
+	typedef typename std::remove_const<Y>::type YType;
+	typedef typename std::remove_const<X>::type XType;
+	static_assert(Out::Dimensions == add_dimensions(YType::Dimensions, XType::Dimensions),
+	              "The result must have the dimensions of the product of the samples and the times");
+	if(y.empty()) {
+		return;
+	}
+	out[0] = Out();
+	_calculus::cumulative_integral(y, x, out, _span_math::all_double<Y, X, Out>());
+}
+
+/// The integrals from the first sample to each sample at a constant step, by the trapezoidal rule.
+template <typename Y, typename Step, typename Out>
+void cumulative_integral(quantity_span<Y> y, const Step& dx, quantity_span<Out> out) {
+	typedef typename std::remove_const<Y>::type YType;
+	static_assert(Out::Dimensions == add_dimensions(YType::Dimensions, Step::Dimensions),
+	              "The result must have the dimensions of the product of the samples and the step");
+	if(y.empty()) {
+		return;
+	}
+	out[0] = Out();
+	_calculus::cumulative_integral(y, dx, out, _span_math::all_double<Y, Step, Out>());
+}
+
+
+/// The derivative at each sample.
+/**
+ * Inside, the derivatives are central differences of the second order, exact
+ * for a parabola even over uneven steps (like @c numpy.gradient). At both
+ * ends, they are the slopes of the first and last intervals. A single sample
+ * has a derivative of zero.
+ */
+template <typename Y, typename X, typename Out>
+void gradient(quantity_span<Y> y, quantity_span<X> x, quantity_span<Out> out) {
+	typedef typename std::remove_const<Y>::type YType;
+	typedef typename std::remove_const<X>::type XType;
+	static_assert(Out::Dimensions == subtract_dimensions(YType::Dimensions, XType::Dimensions),
+	              "The result must have the dimensions of the quotient of the samples by the times");
+	const std::size_t n = y.size();
+	if(n < 2) {
+		if(n == 1) {
+			out[0] = Out();
+		}
+		return;
+	}
+	out[0] = (y[1] - y[0]) / (x[1] - x[0]);
+	out[n - 1] = (y[n - 1] - y[n - 2]) / (x[n - 1] - x[n - 2]);
+	_calculus::gradient(y, x, out, _span_math::all_double<Y, X, Out>());
+}
+
+/// The derivative at each sample, for samples at a constant step.
+template <typename Y, typename Step, typename Out>
+void gradient(quantity_span<Y> y, const Step& dx, quantity_span<Out> out) {
+	typedef typename std::remove_const<Y>::type YType;
+	static_assert(Out::Dimensions == subtract_dimensions(YType::Dimensions, Step::Dimensions),
+	              "The result must have the dimensions of the quotient of the samples by the step");
+	const std::size_t n = y.size();
+	if(n < 2) {
+		if(n == 1) {
+			out[0] = Out();
+		}
+		return;
+	}
+	out[0] = (y[1] - y[0]) / dx;
+	out[n - 1] = (y[n - 1] - y[n - 2]) / dx;
+	_calculus::gradient(y, dx, out, _span_math::all_double<Y, Step, Out>());
+}
+
+
+///@}
+
+
+} /* namespace si */
+
+
+#endif /* SI_CALCULUS_HPP_ */
@@ -0,0 +1,115 @@
+#ifndef SI_CHRONO_HPP_
+#define SI_CHRONO_HPP_
+
+
+#include <chrono>
+#include "config.hpp"
+#include "si_value.hpp"
+#include "operations.hpp"
+
+
+namespace si {
+
+
+/// Provides the SI time value type equivalent to a @c std::chrono::duration type.
+/**
+ * For instance, <tt>duration_value<std::chrono::milliseconds>::type</tt> is a
+ * time value with the same underlying type as @c std::chrono::milliseconds and
+ * a @c std::milli ratio.
+ */
+template <typename Duration>
+struct duration_value;
+
+template <typename Rep, typename Period>
+struct duration_value<std::chrono::duration<Rep, Period>> {
+	/// The time value type.
+	typedef SIValue<Rep, typename Period::type, time_dimensions> type;
+};
+
+
+/// Converts a time value to a @c std::chrono::duration with the same underlying type and ratio.
+/**
+ * @relates SIValue
+ */
+template <typename ValueType, typename Ratio, dimension_code Dimensions>
+SI_INLINE constexpr
+std::chrono::duration<ValueType, Ratio>
+to_duration(const SIValue<ValueType, Ratio, Dimensions>& v) {
+	return static_cast<std::chrono::duration<ValueType, Ratio>>(v);
+}
+
+
+/// Converts a @c std::chrono::duration to a time value with the same underlying type and ratio.
+/**
+ * @relates SIValue
+ */
+template <typename Rep, typename Period>
+SI_INLINE constexpr
+typename duration_value<std::chrono::duration<Rep, Period>>::type
+from_duration(const std::chrono::duration<Rep, Period>& d) {
+	return typename duration_value<std::chrono::duration<Rep, Period>>::type(d);
+}
+
+
+
+/// Multiplies an SI value to a @c std::chrono::duration.
+/**
+ * The duration is taken as a time value with the same underlying type and ratio.
+ * For instance, a frequency times a duration is a scalar value.
+ * @relates SIValue
+ */
+template <typename ValueType, typename Ratio, dimension_code Dimensions, typename Rep, typename Period>
+SI_INLINE
+typename multiplication<SIValue<ValueType, Ratio, Dimensions>,
+                        typename duration_value<std::chrono::duration<Rep, Period>>::type>::type
+operator*(const SIValue<ValueType, Ratio, Dimensions>& v, const std::chrono::duration<Rep, Period>& d) {
+	return v * from_duration(d);
+}
+
+
+/// Multiplies a @c std::chrono::duration to an SI value.
+/**
+ * @see operator*(const SIValue&, const std::chrono::duration&)
+ * @relates SIValue
+ */
+template <typename Rep, typename Period, typename ValueType, typename Ratio, dimension_code Dimensions>
+SI_INLINE
+typename multiplication<typename duration_value<std::chrono::duration<Rep, Period>>::type,
+                        SIValue<ValueType, Ratio, Dimensions>>::type
+operator*(const std::chrono::duration<Rep, Period>& d, const SIValue<ValueType, Ratio, Dimensions>& v) {
+	return from_duration(d) * v;
+}
+
+
+/// Divides an SI value by a @c std::chrono::duration.
+/**
+ * The duration is taken as a time value with the same underlying type and ratio.
+ * @relates SIValue
+ */
+template <typename ValueType, typename Ratio, dimension_code Dimensions, typename Rep, typename Period>
+SI_INLINE auto
+operator/(const SIValue<ValueType, Ratio, Dimensions>& v, const std::chrono::duration<Rep, Period>& d)
+	-> decltype(v / from_duration(d))
+{
+	return v / from_duration(d);
+}
+
+
+/// Divides a @c std::chrono::duration by an SI value.
+/**
+ * The duration is taken as a time value with the same underlying type and ratio.
+ * @relates SIValue
+ */
+template <typename Rep, typename Period, typename ValueType, typename Ratio, dimension_code Dimensions>
+SI_INLINE auto
+operator/(const std::chrono::duration<Rep, Period>& d, const SIValue<ValueType, Ratio, Dimensions>& v)
+	-> decltype(from_duration(d) / v)
+{
+	return from_duration(d) / v;
+}
+
+
+} /* namespace si */
+
+
+#endif /* SI_CHRONO_HPP_ */
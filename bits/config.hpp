@@ -0,0 +1,77 @@
+#ifndef SI_CONFIG_HPP_
+#define SI_CONFIG_HPP_
+
+
+/**
+ * @file
+ * Compiler-specific settings.
+ *
+ * Define @c SI_EXTERN_TEMPLATES to declare the SI value types of the generated
+ * headers for @c int, @c long long, @c float and @c double as extern templates.
+ * They are then instantiated once in @c instances.o (built by <tt>make si</tt>),
+ * which must be linked. This pays off along with @c SI_NO_FORCE_INLINE, as the
+ * out-of-line copies of the operators are emitted only once.
+ *
+ * Define @c SI_TRACK_CONVERSIONS to count the conversions between SI value
+ * types, by pair of types (see @c si::conversions). It must be defined alike
+ * in all the translation units of a program.
+ *
+ * Define @c SI_AUDIT_CONVERSIONS to detect the conversions that lose
+ * information by truncation, narrowing or rounding (see @c si::audit). It
+ * must also be defined alike in all the translation units.
+ */
+
+
+/// Declaration specifier for the SI value constructors and operators.
+/**
+ * The operators are thin wrappers around operations on the underlying type, so
+ * under GCC and Clang they are always inlined and flattened into the caller,
+ * even when building without optimizations (@c -O0). This keeps unoptimized
+ * builds close to the speed of the equivalent code using raw scalars.
+ *
+ * Define @c SI_NO_FORCE_INLINE to let the compiler decide.
+ */
+#if !defined(SI_NO_FORCE_INLINE)  &&  (defined(__GNUC__) || defined(__clang__))
+ #define SI_INLINE inline __attribute__((always_inline, flatten))
+#else
+ #define SI_INLINE inline
+#endif
+
+/// Declaration specifier for cold functions called from the SI_INLINE ones.
+/**
+ * They are never inlined, so flattening does not copy them into every caller.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+ #define SI_NOINLINE inline __attribute__((noinline))
+#else
+ #define SI_NOINLINE inline
+#endif
+
+
+/// Whether the bulk operations over spans have SSE2 and AVX2 versions.
+/**
+ * The AVX2 versions are compiled with a target attribute and selected at
+ * runtime, so the library does not need to be built with @c -mavx2. Define
+ * @c SI_NO_SIMD to use only the scalar versions.
+ */
+#if !defined(SI_NO_SIMD)  &&  defined(__GNUC__)  &&  (defined(__x86_64__) || defined(__SSE2__))
+ #define SI_SIMD_X86 1
+ #define SI_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+ #define SI_SIMD_X86 0
+ #define SI_TARGET_AVX2
+#endif
+
+
+/// Whether @c si::unit parses unit strings at compile time.
+/**
+ * It needs class types as template parameters, from C++20.
+ */
+#if defined(__cpp_nontype_template_args)  &&  __cpp_nontype_template_args >= 201911L
+ #define SI_UNIT_STRINGS 1
+#else
+ #define SI_UNIT_STRINGS 0
+#endif
+
+
+#endif /* SI_CONFIG_HPP_ */
@@ -0,0 +1,318 @@
+#ifndef SI_CONVERSIONS_HPP_
+#define SI_CONVERSIONS_HPP_
+
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "config.hpp"
+#include "dimension_code.hpp"
+#include "ratio_table.hpp"
+#include "symbol_table.hpp"
+
+
+namespace si {
+
+
+/**
+ * @brief Counts of the conversions between SI value types.
+ *
+ * @details When @c SI_TRACK_CONVERSIONS is defined, every conversion of an SI
+ * value to another ratio or underlying type (by the converting constructor, or
+ * by @c += and @c -= with a value of another type) is counted, by the pair of
+ * source and destination types. This finds the conversions that a program
+ * pays for without noticing, like lengths going back and forth between
+ * centimeters and meters in a loop.
+ *
+ * Each thread counts in its own shard, without atomic read-modify-write
+ * operations or locks, so counting costs a few nanoseconds. The shards are
+ * summed when the counts are read. When @c SI_TRACK_CONVERSIONS is not defined
+ * nothing is counted, and the conversions compile to the same code as without
+ * this header.
+ *
+ * At most @c max_pairs distinct pairs of types are counted; conversions between
+ * further pairs are not.
+ */
+namespace conversions {
+
+
+/// An SI value type, as described in the report.
+struct type_info {
+	const char* value_type; ///< Like @c int or @c double
+	dimension_code dimensions;
+	std::intmax_t num;
+	std::intmax_t den;
+};
+
+/// The count of conversions from an SI value type to another.
+struct entry {
+	type_info from;
+	type_info to;
+	unsigned long long count;
+};
+
+
+/// The maximum number of distinct pairs of types that are counted.
+const std::size_t max_pairs = 1024;
+
+
+} /* namespace si::conversions */
+
+
+
+namespace _conversions {
+
+
+template <typename T> struct value_type_name { static const char* get() { return "?"; } };
+template <> struct value_type_name<int> { static const char* get() { return "int"; } };
+template <> struct value_type_name<unsigned> { static const char* get() { return "unsigned"; } };
+template <> struct value_type_name<long> { static const char* get() { return "long"; } };
+template <> struct value_type_name<unsigned long> { static const char* get() { return "unsigned long"; } };
+template <> struct value_type_name<long long> { static const char* get() { return "long long"; } };
+template <> struct value_type_name<unsigned long long> { static const char* get() { return "unsigned long long"; } };
+template <> struct value_type_name<float> { static const char* get() { return "float"; } };
+template <> struct value_type_name<double> { static const char* get() { return "double"; } };
+template <> struct value_type_name<long double> { static const char* get() { return "long double"; } };
+
+
+// The counts of a thread. Only the thread writes them, and only the relaxed
+// loads of the readers race with its relaxed stores.
+struct shard {
+	std::atomic<unsigned long long> counts[conversions::max_pairs];
+
+	shard() {
+		for(auto& count : counts) {
+			count.store(0, std::memory_order_relaxed);
+		}
+	}
+};
+
+
+struct registry {
+	std::mutex mutex;
+	std::vector<conversions::entry> pairs; // The types of each id, and the counts of the finished threads
+	std::vector<shard*> shards;            // The shards of the running threads
+};
+
+inline registry& global() {
+	static registry r;
+	return r;
+}
+
+
+// The shard of the calling thread. The pointer has no dynamic initialization,
+// so it is read without calling the TLS wrapper of the owner.
+inline shard*& current() {
+	static thread_local shard* s = nullptr;
+	return s;
+}
+
+// Whether the owner of the shard of the calling thread is destroyed. Like
+// the pointer, it has no dynamic initialization, so it can be read while the
+// other thread_local objects of the thread are destroyed.
+inline bool& finished() {
+	static thread_local bool f = false;
+	return f;
+}
+
+// Owns the shard of a thread. When the thread finishes, its counts are added
+// to the registry.
+struct owner {
+	shard* s;
+
+	owner() : s(new shard) {
+		registry& r = global();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		r.shards.push_back(s);
+	}
+
+	~owner() {
+		registry& r = global();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		for(std::size_t id = 0; id < r.pairs.size(); id++) {
+			r.pairs[id].count += s->counts[id].load(std::memory_order_relaxed);
+		}
+		r.shards.erase(std::find(r.shards.begin(), r.shards.end(), s));
+		delete s;
+		current() = nullptr;
+		finished() = true;
+	}
+};
+
+
+// Out of line, so the cold paths are not inlined into every conversion by the
+// flatten attribute of SI_INLINE. Returns nullptr once the owner is destroyed,
+// as it is not constructed again.
+SI_NOINLINE shard* attach() {
+	if(finished()) {
+		return nullptr;
+	}
+	static thread_local owner o;
+	return o.s;
+}
+
+// Counts a conversion of a thread without a shard, made by the destructor of
+// one of its thread_local objects. The count goes to the registry, like the
+// counts of the finished threads.
+SI_NOINLINE void record_finished(std::size_t id) {
+	registry& r = global();
+	std::lock_guard<std::mutex> lock(r.mutex);
+	r.pairs[id].count++;
+}
+
+// The id of the pair, or max_pairs if there are too many.
+SI_NOINLINE std::size_t add_pair(const conversions::type_info& from, const conversions::type_info& to) {
+	registry& r = global();
+	std::lock_guard<std::mutex> lock(r.mutex);
+	if(r.pairs.size() == conversions::max_pairs) {
+		return conversions::max_pairs;
+	}
+	const conversions::entry e = { from, to, 0 };
+	r.pairs.push_back(e);
+	return r.pairs.size() - 1;
+}
+
+
+template <typename SIValueType>
+conversions::type_info info() {
+	const conversions::type_info i = {
+		value_type_name<typename SIValueType::ValueType>::get(),
+		SIValueType::Dimensions, SIValueType::Ratio::num, SIValueType::Ratio::den
+	};
+	return i;
+}
+
+
+// Counts a conversion from From to To.
+template <typename From, typename To>
+inline void record() {
+	static const std::size_t id = add_pair(info<From>(), info<To>());
+	if(id == conversions::max_pairs) {
+		return;
+	}
+	shard*& s = current();
+	if(!s  &&  !(s = attach())) {
+		record_finished(id);
+		return;
+	}
+	std::atomic<unsigned long long>& count = s->counts[id];
+	count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+
+} /* namespace si::_conversions */
+
+
+
+namespace conversions {
+
+
+/// Returns the counts of the pairs of types converted so far, by all the threads.
+/**
+ * The pairs are sorted from the most converted. Pairs that were not converted
+ * since the last @c reset are left out.
+ */
+inline std::vector<entry> counts() {
+	_conversions::registry& r = _conversions::global();
+	std::lock_guard<std::mutex> lock(r.mutex);
+	std::vector<entry> result(r.pairs);
+	for(const _conversions::shard* s : r.shards) {
+		for(std::size_t id = 0; id < result.size(); id++) {
+			result[id].count += s->counts[id].load(std::memory_order_relaxed);
+		}
+	}
+	result.erase(std::remove_if(result.begin(), result.end(), [](const entry& e) { return e.count == 0; }),
+	             result.end());
+	std::stable_sort(result.begin(), result.end(), [](const entry& e1, const entry& e2) { return e1.count > e2.count; });
+	return result;
+}
+
+
+/// Sets all the counts to zero.
+/**
+ * Conversions made by other threads while resetting may be lost.
+ */
+inline void reset() {
+	_conversions::registry& r = _conversions::global();
+	std::lock_guard<std::mutex> lock(r.mutex);
+	for(entry& e : r.pairs) {
+		e.count = 0;
+	}
+	for(_conversions::shard* s : r.shards) {
+		for(auto& count : s->counts) {
+			count.store(0, std::memory_order_relaxed);
+		}
+	}
+}
+
+
+/// Returns a readable name of a type, like <tt>km/h (double)</tt>.
+/**
+ * Units without a symbol are named by the powers of the base units and the
+ * ratio, like <tt>m^2·s ×9/25 (long long)</tt>.
+ */
+inline std::string name(const type_info& type) {
+	std::string result;
+	const std::size_t unit = _symbol_table::find(type.dimensions, _ratio_table::index_of(type.num, type.den));
+	if(unit != _symbol_table::unit_count) {
+		result = _symbol_table::units[unit].symbol;
+	} else {
+		static const char* const base[] = { "m", "g", "s", "A", "K", "cd", "mol" };
+		char text[48];
+		for(int i = 0; i < 7; i++) {
+			const int power = unpack_dimension(type.dimensions, i);
+			if(power != 0) {
+				if(!result.empty()) {
+					result += "·";
+				}
+				result += base[i];
+				if(power != 1) {
+					std::snprintf(text, sizeof(text), "^%d", power);
+					result += text;
+				}
+			}
+		}
+		if(result.empty()) {
+			result = "1";
+		}
+		if(type.num != 1  ||  type.den != 1) {
+			if(type.den == 1) {
+				std::snprintf(text, sizeof(text), " ×%jd", type.num);
+			} else {
+				std::snprintf(text, sizeof(text), " ×%jd/%jd", type.num, type.den);
+			}
+			result += text;
+		}
+	}
+	return result + " (" + type.value_type + ")";
+}
+
+
+/// Prints the counts, from the most converted pair of types.
+/**
+ * Each line has the count and the types, like
+ * @code
+ *       1000  cm (int) -> m (int)
+ * @endcode
+ */
+inline void report(std::FILE* file = stderr) {
+	const std::vector<entry> entries = counts();
+	std::fprintf(file, "Conversions between SI value types:%s\n", entries.empty() ? " none" : "");
+	for(const entry& e : entries) {
+		std::fprintf(file, "%12llu  %s -> %s\n", e.count, name(e.from).c_str(), name(e.to).c_str());
+	}
+}
+
+
+} /* namespace si::conversions */
+
+
+} /* namespace si */
+
+
+#endif /* SI_CONVERSIONS_HPP_ */
@@ -0,0 +1,140 @@
+#ifndef SI_DIMENSION_CODE_HPP_
+#define SI_DIMENSION_CODE_HPP_
+
+
+namespace si {
+
+
+/// A code that packs the powers of the seven SI base units in a single integer.
+/**
+ * Each power is stored in 8 bits, biased by 128, starting at the least
+ * significant bits with the power of the first base unit (meter). Powers must
+ * be in the range [-128, 127], also for the results of the operations below.
+ *
+ * As an SI value type has a single code instead of seven powers, its name is
+ * shorter (in diagnostics and debug information), and the dimensions of the
+ * result of an operation are computed by a constant expression instead of by
+ * instantiating class templates.
+ *
+ * @see pack_dimensions
+ */
+typedef unsigned long long dimension_code;
+
+
+namespace _dimension_code {
+
+
+const int field_bits = 8;
+const int bias = 128;
+const dimension_code field_mask = 0xFF;
+
+// The biases of all the fields. It is also the code of a dimensionless value.
+const dimension_code biases = 0x0080808080808080ULL;
+
+// The least significant bit of each field.
+const dimension_code low_bits = 0x0001010101010101ULL;
+
+
+constexpr dimension_code field(int power, int index) {
+	return dimension_code(power + bias) << (field_bits * index);
+}
+
+
+} /* namespace si::_dimension_code */
+
+
+
+/// Packs the powers of the seven SI base units in a dimension code.
+constexpr dimension_code pack_dimensions(int m, int g, int s, int A, int K, int cd, int mol) {
+	return _dimension_code::field(m,   0)
+	     | _dimension_code::field(g,   1)
+	     | _dimension_code::field(s,   2)
+	     | _dimension_code::field(A,   3)
+	     | _dimension_code::field(K,   4)
+	     | _dimension_code::field(cd,  5)
+	     | _dimension_code::field(mol, 6);
+}
+
+
+/// Returns the power of the base unit at @c index (0 to 6) in a dimension code.
+constexpr int unpack_dimension(dimension_code code, int index) {
+	return int((code >> (_dimension_code::field_bits * index)) & _dimension_code::field_mask) - _dimension_code::bias;
+}
+
+
+/// The dimension code of dimensionless values.
+const dimension_code dimensionless = _dimension_code::biases;
+
+/// The dimension code of time values.
+const dimension_code time_dimensions = pack_dimensions(0, 0, 1, 0, 0, 0, 0);
+
+
+/// The dimension code of a product: the powers are added.
+constexpr dimension_code add_dimensions(dimension_code code1, dimension_code code2) {
+	return code1 + code2 - _dimension_code::biases;
+}
+
+/// The dimension code of an inverse: the powers are negated.
+constexpr dimension_code negate_dimensions(dimension_code code) {
+	return 2 * _dimension_code::biases - code;
+}
+
+/// The dimension code of a quotient: the powers are subtracted.
+constexpr dimension_code subtract_dimensions(dimension_code code1, dimension_code code2) {
+	return code1 - code2 + _dimension_code::biases;
+}
+
+/// Tests if all the powers are even. As the bias is even, it is a parity test on each field.
+constexpr bool all_dimensions_even(dimension_code code) {
+	return (code & _dimension_code::low_bits) == 0;
+}
+
+/// The dimension code of a power: the powers are multiplied by @c n.
+/**
+ * As the code is linear in each field, it is a plain multiplication followed
+ * by the removal of the extra biases. Unsigned wrap-around keeps it exact for
+ * negative @c n as long as the resulting powers are in range.
+ */
+constexpr dimension_code multiply_dimensions(dimension_code code, int n) {
+	return code * dimension_code(n) - _dimension_code::biases * dimension_code(n - 1);
+}
+
+/// Tests if all the powers are multiples of @c n.
+constexpr bool dimensions_divisible(dimension_code code, int n) {
+	return unpack_dimension(code, 0) % n == 0
+	    && unpack_dimension(code, 1) % n == 0
+	    && unpack_dimension(code, 2) % n == 0
+	    && unpack_dimension(code, 3) % n == 0
+	    && unpack_dimension(code, 4) % n == 0
+	    && unpack_dimension(code, 5) % n == 0
+	    && unpack_dimension(code, 6) % n == 0;
+}
+
+/// The dimension code of a root: the powers are divided by @c n.
+/**
+ * All the powers must be multiples of @c n (see @c dimensions_divisible).
+ */
+constexpr dimension_code divide_dimensions(dimension_code code, int n) {
+	return pack_dimensions(unpack_dimension(code, 0) / n,
+	                       unpack_dimension(code, 1) / n,
+	                       unpack_dimension(code, 2) / n,
+	                       unpack_dimension(code, 3) / n,
+	                       unpack_dimension(code, 4) / n,
+	                       unpack_dimension(code, 5) / n,
+	                       unpack_dimension(code, 6) / n);
+}
+
+/// The dimension code of a square root: the powers are halved.
+/**
+ * All the powers must be even (see @c all_dimensions_even). Then no bit is
+ * shifted across fields, and each biased field @c p+128 becomes @c p/2+64.
+ */
+constexpr dimension_code half_dimensions(dimension_code code) {
+	return (code >> 1) + _dimension_code::biases / 2;
+}
+
+
+} /* namespace si */
+
+
+#endif /* SI_DIMENSION_CODE_HPP_ */
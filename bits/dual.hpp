@@ -0,0 +1,331 @@
+#ifndef SI_DUAL_HPP_
+#define SI_DUAL_HPP_
+
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include "config.hpp"
+#include "dimension_code.hpp"
+#include "operations.hpp"
+#include "si_value.hpp"
+
+
+namespace si {
+
+
+/**
+ * @brief A number with its partial derivatives, for forward-mode automatic differentiation.
+ *
+ * @details A dual number carries a value and its @c N partial derivatives with
+ * respect to the independent variables of a computation. Each arithmetic
+ * operation and function propagates the derivatives by the chain rule, so
+ * evaluating a function once on dual numbers gives its value and its exact
+ * gradient, without the truncation errors and the <tt>N + 1</tt> evaluations
+ * of finite differences.
+ *
+ * It is meant to be the underlying type of SI values: the units are checked
+ * as for any other type, and @c multiplication, @c division and
+ * @c sqrt_function give the right types. The variables are seeded with
+ * @c variable, and the derivatives are read with their units by
+ * @c derivative:
+ * @code
+ *   const auto v = si::variable<2>(si::Speed_m_s<double>(20), 0);
+ *   const auto t = si::variable<2>(si::Time_s<double>(3), 1);
+ *   const auto distance = v * t;                                        // 60 m
+ *   const auto d_dv = si::derivative<si::Speed_m_s<double>>(distance, 0); // 3 s
+ *   const auto d_dt = si::derivative<si::Time_s<double>>(distance, 1);    // 20 m/s
+ * @endcode
+ *
+ * The derivatives are a plain array operated on element by element, which the
+ * compiler vectorizes: a @c dual<double, 4> propagates its gradient with one
+ * AVX operation per step.
+ *
+ * Comparisons compare only the values.
+ *
+ * @tparam T The type of the value and of the derivatives. Must be a floating
+ *           point type.
+ * @tparam N The number of independent variables.
+ */
+template <typename T, std::size_t N>
+struct dual {
+	static_assert(std::is_floating_point<T>::value, "The type of a dual number must be a floating point type");
+	static_assert(N > 0, "A dual number must have at least one derivative");
+
+	/// The value.
+	T value;
+	/// The partial derivatives of the value with respect to each variable.
+	T d[N];
+
+
+	/// Zero, with zero derivatives.
+	SI_INLINE dual() noexcept : value() {
+		for(std::size_t i = 0; i < N; i++) {
+			d[i] = T();
+		}
+	}
+
+	/// A constant, with zero derivatives.
+	SI_INLINE dual(const T& value) noexcept : value(value) {
+		for(std::size_t i = 0; i < N; i++) {
+			d[i] = T();
+		}
+	}
+
+	/// Conversion from a dual number of another type.
+	template <typename U>
+	SI_INLINE dual(const dual<U, N>& x) noexcept : value(x.value) {
+		for(std::size_t i = 0; i < N; i++) {
+			d[i] = T(x.d[i]);
+		}
+	}
+
+	/// Returns the @c i-th independent variable, whose derivative with respect to itself is 1.
+	SI_INLINE static dual variable(const T& value, std::size_t i) noexcept {
+		dual x(value);
+		x.d[i] = T(1);
+		return x;
+	}
+
+
+	SI_INLINE dual& operator+=(const dual& x) noexcept {
+		value += x.value;
+		for(std::size_t i = 0; i < N; i++) {
+			d[i] += x.d[i];
+		}
+		return *this;
+	}
+
+	SI_INLINE dual& operator-=(const dual& x) noexcept {
+		value -= x.value;
+		for(std::size_t i = 0; i < N; i++) {
+			d[i] -= x.d[i];
+		}
+		return *this;
+	}
+
+	// (u v)' = u' v + u v'
+	SI_INLINE dual& operator*=(const dual& x) noexcept {
+		for(std::size_t i = 0; i < N; i++) {
+			d[i] = d[i] * x.value + value * x.d[i];
+		}
+		value *= x.value;
+		return *this;
+	}
+
+	// (u / v)' = (u' - (u / v) v') / v
+	SI_INLINE dual& operator/=(const dual& x) noexcept {
+		const T inverse = T(1) / x.value;
+		value *= inverse;
+		for(std::size_t i = 0; i < N; i++) {
+			d[i] = (d[i] - value * x.d[i]) * inverse;
+		}
+		return *this;
+	}
+
+	SI_INLINE dual& operator+=(const T& c) noexcept {
+		value += c;
+		return *this;
+	}
+
+	SI_INLINE dual& operator-=(const T& c) noexcept {
+		value -= c;
+		return *this;
+	}
+
+	SI_INLINE dual& operator*=(const T& c) noexcept {
+		value *= c;
+		for(std::size_t i = 0; i < N; i++) {
+			d[i] *= c;
+		}
+		return *this;
+	}
+
+	SI_INLINE dual& operator/=(const T& c) noexcept {
+		return *this *= T(1) / c;
+	}
+
+
+	// The binary operators are found only by argument-dependent lookup, and
+	// accept anything convertible to T on either side, as std::complex does.
+
+	SI_INLINE friend dual operator+(const dual& x) noexcept { return x; }
+	SI_INLINE friend dual operator-(const dual& x) noexcept { return dual() -= x; }
+
+	SI_INLINE friend dual operator+(dual x, const dual& y) noexcept { return x += y; }
+	SI_INLINE friend dual operator-(dual x, const dual& y) noexcept { return x -= y; }
+	SI_INLINE friend dual operator*(dual x, const dual& y) noexcept { return x *= y; }
+	SI_INLINE friend dual operator/(dual x, const dual& y) noexcept { return x /= y; }
+
+	SI_INLINE friend dual operator+(dual x, const T& c) noexcept { return x += c; }
+	SI_INLINE friend dual operator-(dual x, const T& c) noexcept { return x -= c; }
+	SI_INLINE friend dual operator*(dual x, const T& c) noexcept { return x *= c; }
+	SI_INLINE friend dual operator/(dual x, const T& c) noexcept { return x /= c; }
+
+	SI_INLINE friend dual operator+(const T& c, dual x) noexcept { return x += c; }
+	SI_INLINE friend dual operator-(const T& c, const dual& x) noexcept { return dual(c) -= x; }
+	SI_INLINE friend dual operator*(const T& c, dual x) noexcept { return x *= c; }
+	SI_INLINE friend dual operator/(const T& c, const dual& x) noexcept { return dual(c) /= x; }
+
+	SI_INLINE friend bool operator==(const dual& x, const dual& y) noexcept { return x.value == y.value; }
+	SI_INLINE friend bool operator!=(const dual& x, const dual& y) noexcept { return x.value != y.value; }
+	SI_INLINE friend bool operator<(const dual& x, const dual& y) noexcept { return x.value < y.value; }
+	SI_INLINE friend bool operator>(const dual& x, const dual& y) noexcept { return x.value > y.value; }
+	SI_INLINE friend bool operator<=(const dual& x, const dual& y) noexcept { return x.value <= y.value; }
+	SI_INLINE friend bool operator>=(const dual& x, const dual& y) noexcept { return x.value >= y.value; }
+};
+
+
+
+namespace _dual {
+
+
+// The result of f(x), given f(x) and f'(x): the derivatives are scaled by f'(x).
+template <typename T, std::size_t N>
+SI_INLINE dual<T, N> chain(const dual<T, N>& x, const T& f, const T& df) noexcept {
+	dual<T, N> result(f);
+	for(std::size_t i = 0; i < N; i++) {
+		result.d[i] = df * x.d[i];
+	}
+	return result;
+}
+
+
+} /* namespace si::_dual */
+
+
+
+/// Returns the square root of a dual number.
+/**
+ * The derivatives are infinite at 0.
+ *
+ * @relates dual
+ */
+template <typename T, std::size_t N>
+SI_INLINE dual<T, N> sqrt(const dual<T, N>& x) noexcept {
+	const T root = std::sqrt(x.value);
+	return _dual::chain(x, root, T(0.5) / root);
+}
+
+/// Returns the cube root of a dual number.
+/** @relates dual */
+template <typename T, std::size_t N>
+SI_INLINE dual<T, N> cbrt(const dual<T, N>& x) noexcept {
+	const T root = std::cbrt(x.value);
+	return _dual::chain(x, root, T(1) / (3 * root * root));
+}
+
+/// Returns a dual number raised to a constant power.
+/** @relates dual */
+template <typename T, std::size_t N>
+SI_INLINE dual<T, N> pow(const dual<T, N>& x, const T& p) noexcept {
+	return _dual::chain(x, std::pow(x.value, p), p == 0 ? T(0) : p * std::pow(x.value, p - 1));
+}
+
+/// Returns the absolute value of a dual number.
+/**
+ * The derivatives at 0 are those of @c x.
+ *
+ * @relates dual
+ */
+template <typename T, std::size_t N>
+SI_INLINE dual<T, N> abs(const dual<T, N>& x) noexcept {
+	return x.value < 0 ? -x : x;
+}
+
+/// Returns the square root of the sum of the squares of two dual numbers.
+/** @relates dual */
+template <typename T, std::size_t N>
+SI_INLINE dual<T, N> hypot(const dual<T, N>& x, const dual<T, N>& y) noexcept {
+	const T h = std::hypot(x.value, y.value);
+	const T inverse = T(1) / h;
+	dual<T, N> result(h);
+	for(std::size_t i = 0; i < N; i++) {
+		result.d[i] = (x.value * x.d[i] + y.value * y.d[i]) * inverse;
+	}
+	return result;
+}
+
+/// Returns e raised to a dual number.
+/** @relates dual */
+template <typename T, std::size_t N>
+SI_INLINE dual<T, N> exp(const dual<T, N>& x) noexcept {
+	const T e = std::exp(x.value);
+	return _dual::chain(x, e, e);
+}
+
+/// Returns the natural logarithm of a dual number.
+/** @relates dual */
+template <typename T, std::size_t N>
+SI_INLINE dual<T, N> log(const dual<T, N>& x) noexcept {
+	return _dual::chain(x, std::log(x.value), T(1) / x.value);
+}
+
+/// Returns the sine of a dual number.
+/** @relates dual */
+template <typename T, std::size_t N>
+SI_INLINE dual<T, N> sin(const dual<T, N>& x) noexcept {
+	return _dual::chain(x, std::sin(x.value), std::cos(x.value));
+}
+
+/// Returns the cosine of a dual number.
+/** @relates dual */
+template <typename T, std::size_t N>
+SI_INLINE dual<T, N> cos(const dual<T, N>& x) noexcept {
+	return _dual::chain(x, std::cos(x.value), -std::sin(x.value));
+}
+
+
+
+/// Returns the SI value of the @c i-th of @c N independent variables.
+/**
+ * For instance, <tt>si::variable<3>(Time_s(2), 1)</tt> is 2 s, and the
+ * second of 3 variables.
+ *
+ * @relates dual
+ */
+template <std::size_t N, typename T, typename Ratio, dimension_code Dimensions>
+SI_INLINE SIValue<dual<T, N>, Ratio, Dimensions>
+variable(const SIValue<T, Ratio, Dimensions>& v, std::size_t i) noexcept {
+	return SIValue<dual<T, N>, Ratio, Dimensions>(dual<T, N>::variable(v.value, i));
+}
+
+
+/// Returns the value of an SI value of dual numbers, without the derivatives.
+/** @relates dual */
+template <typename T, std::size_t N, typename Ratio, dimension_code Dimensions>
+SI_INLINE SIValue<T, Ratio, Dimensions>
+primal(const SIValue<dual<T, N>, Ratio, Dimensions>& v) noexcept {
+	return SIValue<T, Ratio, Dimensions>(v.value.value);
+}
+
+
+/// Returns the partial derivative of an SI value of dual numbers with respect to the @c i-th variable.
+/**
+ * @c Wrt is the type of the variable, whose underlying type may be a dual
+ * number or not: only its unit matters. The derivative has the type of the
+ * quotient of the value by the variable, so the derivative of a length with
+ * respect to a time in seconds is a speed in meters per second:
+ * @code
+ *   const si::Speed_m_s<double> speed = si::derivative<si::Time_s<double>>(length, 0);
+ * @endcode
+ *
+ * The variable must have been seeded in the unit of @c Wrt, as the
+ * derivatives are those of the stored values.
+ *
+ * @relates dual
+ */
+template <typename Wrt, typename T, std::size_t N, typename Ratio, dimension_code Dimensions>
+SI_INLINE typename division<SIValue<T, Ratio, Dimensions>,
+                            SIValue<T, typename Wrt::Ratio, Wrt::Dimensions>>::type
+derivative(const SIValue<dual<T, N>, Ratio, Dimensions>& v, std::size_t i) noexcept {
+	typedef typename division<SIValue<T, Ratio, Dimensions>,
+	                          SIValue<T, typename Wrt::Ratio, Wrt::Dimensions>>::type ResultType;
+	return ResultType(v.value.d[i]);
+}
+
+
+} /* namespace si */
+
+
+#endif /* SI_DUAL_HPP_ */
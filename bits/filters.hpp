@@ -0,0 +1,437 @@
+#ifndef SI_FILTERS_HPP_
+#define SI_FILTERS_HPP_
+
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <ratio>
+#include <type_traits>
+#include "batch.hpp"
+#include "config.hpp"
+#include "dimension_code.hpp"
+#include "si_value.hpp"
+
+
+namespace si {
+
+
+namespace _filters {
+
+
+typedef SIValue<double, std::ratio<1>, time_dimensions> seconds;
+typedef SIValue<double, std::ratio<1>, negate_dimensions(time_dimensions)> hertz;
+
+
+// Whether V is a floating point type, or a batch of them.
+template <typename V>
+struct is_floating : std::is_floating_point<V> {};
+
+template <typename T, std::size_t N>
+struct is_floating<batch<T, N>> : std::is_floating_point<T> {};
+
+
+template <typename TimeType>
+double to_seconds(const TimeType& time) {
+	static_assert(TimeType::Dimensions == time_dimensions, "The time constants and sample periods must be time values");
+	return seconds(time).value;
+}
+
+template <typename Rep, typename Period>
+double to_seconds(const std::chrono::duration<Rep, Period>& time) {
+	return seconds(time).value;
+}
+
+template <typename FrequencyType>
+double to_hertz(const FrequencyType& frequency) {
+	static_assert(FrequencyType::Dimensions == hertz::Dimensions, "The cutoffs must be frequency values");
+	return hertz(frequency).value;
+}
+
+
+// Adds x to s, and the rounding error of the addition to c. Unlike the
+// Neumaier summation this two-sum needs no branch, so it runs lane by lane on
+// batches.
+template <typename V>
+SI_INLINE void add(V& s, V& c, const V& x) {
+	const V t = s + x;
+	const V z = t - s;
+	c += (s - (t - z)) + (x - z);
+	s = t;
+}
+
+
+} /* namespace si::_filters */
+
+
+
+/**
+ * @brief An exponential moving average of a stream of SI values.
+ *
+ * @details Each sample moves the average towards it by a fraction
+ * <tt>1 - exp(-T / tau)</tt> of the difference, for a sample period @c T and
+ * a time constant @c tau: a step in the input is followed to 63% after @c tau.
+ * The first sample, after construction or @c reset, initializes the average,
+ * so a channel with an offset doesn't ramp up from zero.
+ *
+ * As for all the filters, an underlying type of <tt>batch<double, N></tt>
+ * filters @c N channels at once, with the same coefficients and each lane
+ * computed as a single channel would be:
+ * <tt>ema<Pressure_Pa<batch<double, 16>>></tt> smooths 16 pressure sensors
+ * per call, with vector instructions.
+ *
+ * @tparam SIValueType The type of the values. Its underlying type must be a
+ * floating point type or a batch of them.
+ */
+template <typename SIValueType>
+class ema {
+	static_assert(_filters::is_floating<typename SIValueType::ValueType>::value,
+	              "The filters need a floating point underlying type");
+
+public:
+	typedef SIValueType value_type;
+
+
+	/// Constructs the filter for a time constant and a sample period.
+	/**
+	 * A time constant of zero makes the average follow the input.
+	 */
+	template <typename TimeType1, typename TimeType2>
+	ema(const TimeType1& time_constant, const TimeType2& sample_period)
+		: _alpha(1 - std::exp(-_filters::to_seconds(sample_period) / _filters::to_seconds(time_constant))),
+		  _average(), _primed(false) {}
+
+
+	/// Filters the next sample, and returns the new average.
+	SI_INLINE value_type operator()(const value_type& x) {
+		if(_primed) {
+			_average += (x.value - _average) * _alpha;
+		} else {
+			_average = x.value;
+			_primed = true;
+		}
+		return value_type(_average);
+	}
+
+	/// The current average, zero before the first sample.
+	value_type value() const {
+		return value_type(_average);
+	}
+
+	/// The fraction of the difference to a sample that it moves the average by.
+	double alpha() const {
+		return _alpha;
+	}
+
+	/// Forgets the samples.
+	void reset() {
+		_average = typename value_type::ValueType();
+		_primed = false;
+	}
+
+
+private:
+	double _alpha;
+	typename value_type::ValueType _average;
+	bool _primed;
+};
+
+
+
+/**
+ * @brief The mean of the last @c Window values of a stream of SI values.
+ *
+ * @details The window is a ring of the last samples, and their sum is updated
+ * in constant time per sample with compensated additions and subtractions:
+ * the rounding errors are accumulated apart, so the mean doesn't drift over a
+ * long stream of values with a large offset. Until the window is full, the
+ * mean is over the samples received.
+ *
+ * Batches filter several channels at once, as for @c ema.
+ *
+ * @tparam SIValueType The type of the values. Its underlying type must be a
+ * floating point type or a batch of them.
+ * @tparam Window The number of values averaged.
+ */
+template <typename SIValueType, std::size_t Window>
+class moving_average {
+	static_assert(_filters::is_floating<typename SIValueType::ValueType>::value,
+	              "The filters need a floating point underlying type");
+	static_assert(Window > 0, "The window must have at least one value");
+
+	typedef typename SIValueType::ValueType raw;
+
+public:
+	typedef SIValueType value_type;
+
+	static const std::size_t window = Window;
+
+
+	moving_average() : _sum(), _error(), _next(0), _count(0) {}
+
+
+	/// Filters the next sample, and returns the new mean.
+	SI_INLINE value_type operator()(const value_type& x) {
+		raw change = x.value;
+		if(_count == Window) {
+			// The exact difference with the oldest sample, so the sum
+			// depends on a single addition per sample.
+			_filters::add(change, _error, raw(-_samples[_next]));
+		} else {
+			_count++;
+		}
+		_samples[_next] = x.value;
+		_filters::add(_sum, _error, change);
+		_next = _next + 1 == Window ? 0 : _next + 1;
+		return mean();
+	}
+
+	/// The mean of the samples in the window, zero if there is none.
+	value_type mean() const {
+		return _count ? value_type((_sum + _error) / double(_count)) : value_type();
+	}
+
+	/// The number of samples in the window.
+	std::size_t size() const {
+		return _count;
+	}
+
+	bool full() const {
+		return _count == Window;
+	}
+
+	/// Forgets the samples.
+	void reset() {
+		_sum = raw();
+		_error = raw();
+		_next = 0;
+		_count = 0;
+	}
+
+
+private:
+	raw _samples[Window];
+	raw _sum;
+	raw _error;
+	std::size_t _next;
+	std::size_t _count;
+};
+
+
+
+/**
+ * @brief The coefficients of a biquad filter, normalized so a0 is 1.
+ *
+ * @details The filter computes
+ * <tt>y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]</tt>.
+ * The coefficients are dimensionless, and the factories compute them from a
+ * cutoff frequency and a sample period as in the Audio EQ Cookbook of R.
+ * Bristow-Johnson. The cutoff must be below half the sample rate.
+ */
+struct biquad_coefficients {
+	double b0, b1, b2, a1, a2;
+
+
+	/// The second-order low-pass filter with a cutoff and a quality factor.
+	/**
+	 * The default quality factor gives a Butterworth filter, with no peak.
+	 */
+	template <typename FrequencyType, typename TimeType>
+	static biquad_coefficients low_pass(const FrequencyType& cutoff, const TimeType& sample_period,
+	                                    double q = 0.70710678118654752) {
+		const double w = 2 * 3.14159265358979324 * _filters::to_hertz(cutoff) * _filters::to_seconds(sample_period);
+		const double c = std::cos(w);
+		const double a0 = 1 + std::sin(w) / (2 * q);
+		const biquad_coefficients result = {
+			(1 - c) / 2 / a0, (1 - c) / a0, (1 - c) / 2 / a0, -2 * c / a0, (2 - a0) / a0
+		};
+		return result;
+	}
+
+	/// The second-order high-pass filter with a cutoff and a quality factor.
+	/**
+	 * The default quality factor gives a Butterworth filter, with no peak.
+	 */
+	template <typename FrequencyType, typename TimeType>
+	static biquad_coefficients high_pass(const FrequencyType& cutoff, const TimeType& sample_period,
+	                                     double q = 0.70710678118654752) {
+		const double w = 2 * 3.14159265358979324 * _filters::to_hertz(cutoff) * _filters::to_seconds(sample_period);
+		const double c = std::cos(w);
+		const double a0 = 1 + std::sin(w) / (2 * q);
+		const biquad_coefficients result = {
+			(1 + c) / 2 / a0, -(1 + c) / a0, (1 + c) / 2 / a0, -2 * c / a0, (2 - a0) / a0
+		};
+		return result;
+	}
+
+
+	/// The gain of the filter for a constant input.
+	double dc_gain() const {
+		return (b0 + b1 + b2) / (1 + a1 + a2);
+	}
+};
+
+
+
+/**
+ * @brief A biquad IIR filter of a stream of SI values.
+ *
+ * @details The filter is computed in the transposed direct form II, with two
+ * values of state. The first sample, after construction or @c reset, sets the
+ * state as if the input had always had its value, so a low-pass filter starts
+ * from it instead of ringing up from zero.
+ *
+ * Batches filter several channels at once, as for @c ema.
+ *
+ * @tparam SIValueType The type of the values. Its underlying type must be a
+ * floating point type or a batch of them.
+ */
+template <typename SIValueType>
+class biquad {
+	static_assert(_filters::is_floating<typename SIValueType::ValueType>::value,
+	              "The filters need a floating point underlying type");
+
+	typedef typename SIValueType::ValueType raw;
+
+public:
+	typedef SIValueType value_type;
+
+
+	/// Constructs a filter that passes its input unchanged.
+	biquad() : _z1(), _z2(), _primed(false) {
+		const biquad_coefficients identity = { 1, 0, 0, 0, 0 };
+		_c = identity;
+	}
+
+	explicit biquad(const biquad_coefficients& coefficients) : _c(coefficients), _z1(), _z2(), _primed(false) {}
+
+
+	/// Filters the next sample, and returns the output.
+	SI_INLINE value_type operator()(const value_type& x) {
+		const raw in = x.value;
+		if(!_primed) {
+			prime(in);
+		}
+		const raw out = in * _c.b0 + _z1;
+		_z1 = in * _c.b1 - out * _c.a1 + _z2;
+		_z2 = in * _c.b2 - out * _c.a2;
+		return value_type(out);
+	}
+
+	const biquad_coefficients& coefficients() const {
+		return _c;
+	}
+
+	/// Forgets the samples.
+	void reset() {
+		_z1 = raw();
+		_z2 = raw();
+		_primed = false;
+	}
+
+
+private:
+	// Sets the state for a constant input. Out of line, so the state of a
+	// cascade stays in registers in the loops over the samples.
+	SI_NOINLINE void prime(const raw& in) {
+		const raw steady = in * _c.dc_gain();
+		_z1 = steady - in * _c.b0;
+		_z2 = in * _c.b2 - steady * _c.a2;
+		_primed = true;
+	}
+
+	biquad_coefficients _c;
+	raw _z1;
+	raw _z2;
+	bool _primed;
+};
+
+
+
+/**
+ * @brief A cascade of @c Stages biquad filters of a stream of SI values.
+ *
+ * @details Each sample goes through the stages in order. The factories make a
+ * Butterworth filter of order <tt>2 Stages</tt>, whose stages have the quality
+ * factors <tt>1 / (2 cos((2k + 1) pi / (4 Stages)))</tt>.
+ *
+ * Batches filter several channels at once, as for @c ema.
+ *
+ * @tparam SIValueType The type of the values. Its underlying type must be a
+ * floating point type or a batch of them.
+ * @tparam Stages The number of biquad filters.
+ */
+template <typename SIValueType, std::size_t Stages>
+class biquad_cascade {
+	static_assert(Stages > 0, "A cascade must have at least one stage");
+
+public:
+	typedef SIValueType value_type;
+
+	static const std::size_t stages = Stages;
+
+
+	/// Constructs the cascade from the coefficients of its stages.
+	explicit biquad_cascade(const biquad_coefficients (&coefficients)[Stages]) {
+		for(std::size_t i = 0; i < Stages; i++) {
+			_stages[i] = biquad<SIValueType>(coefficients[i]);
+		}
+	}
+
+
+	/// The Butterworth low-pass filter of order <tt>2 Stages</tt> with a cutoff.
+	template <typename FrequencyType, typename TimeType>
+	static biquad_cascade butterworth_low_pass(const FrequencyType& cutoff, const TimeType& sample_period) {
+		biquad_coefficients coefficients[Stages];
+		for(std::size_t i = 0; i < Stages; i++) {
+			coefficients[i] = biquad_coefficients::low_pass(cutoff, sample_period, quality(i));
+		}
+		return biquad_cascade(coefficients);
+	}
+
+	/// The Butterworth high-pass filter of order <tt>2 Stages</tt> with a cutoff.
+	template <typename FrequencyType, typename TimeType>
+	static biquad_cascade butterworth_high_pass(const FrequencyType& cutoff, const TimeType& sample_period) {
+		biquad_coefficients coefficients[Stages];
+		for(std::size_t i = 0; i < Stages; i++) {
+			coefficients[i] = biquad_coefficients::high_pass(cutoff, sample_period, quality(i));
+		}
+		return biquad_cascade(coefficients);
+	}
+
+
+	/// Filters the next sample, and returns the output of the last stage.
+	SI_INLINE value_type operator()(const value_type& x) {
+		value_type y = x;
+		for(std::size_t i = 0; i < Stages; i++) {
+			y = _stages[i](y);
+		}
+		return y;
+	}
+
+	/// The i-th stage.
+	const biquad<SIValueType>& stage(std::size_t i) const {
+		return _stages[i];
+	}
+
+	/// Forgets the samples.
+	void reset() {
+		for(std::size_t i = 0; i < Stages; i++) {
+			_stages[i].reset();
+		}
+	}
+
+
+private:
+	static double quality(std::size_t i) {
+		return 1 / (2 * std::cos((2 * i + 1) * 3.14159265358979324 / (4 * Stages)));
+	}
+
+	biquad<SIValueType> _stages[Stages];
+};
+
+
+} /* namespace si */
+
+
+#endif /* SI_FILTERS_HPP_ */
@@ -2,10 +2,13 @@
 #define SI_FORWARD_HPP_
 
 
+#include "dimension_code.hpp"
+
+
 namespace si {
 
 
-template <typename ValueType, typename Ratio, int... Dimensions>
+template <typename ValueType, typename Ratio, dimension_code Dimensions>
 class SIValue;
 
 template <typename ValueType, typename Ratio, typename DimensionsList>
@@ -3,10 +3,161 @@
 
 
 #include <cmath>
-#include "int_list.hpp"
+#include "config.hpp"
+#include "dimension_code.hpp"
 #include "operations.hpp"
 
 
+namespace si {
+
+
+namespace _pow {
+
+
+// x^N by squaring, with the steps unrolled at compile time.
+template <int N, bool _Odd = (N % 2 == 1)>
+struct integral_power {
+	template <typename T>
+	SI_INLINE static T of(T x) {
+		return integral_power<N / 2>::of(x * x);
+	}
+};
+
+template <int N>
+struct integral_power<N, true> {
+	template <typename T>
+	SI_INLINE static T of(T x) {
+		return x * integral_power<N / 2>::of(x * x);
+	}
+};
+
+template <>
+struct integral_power<1, true> {
+	template <typename T>
+	SI_INLINE static T of(T x) {
+		return x;
+	}
+};
+
+template <>
+struct integral_power<0, false> {
+	template <typename T>
+	SI_INLINE static T of(T) {
+		return T(1);
+	}
+};
+
+
+// The N-th root of x.
+template <int N>
+struct nth_root {
+	template <typename T>
+	SI_INLINE static T of(T x) {
+		return std::pow(x, T(1) / N);
+	}
+};
+
+template <>
+struct nth_root<1> {
+	template <typename T>
+	SI_INLINE static T of(T x) {
+		return x;
+	}
+};
+
+template <>
+struct nth_root<2> {
+	template <typename T>
+	SI_INLINE static T of(T x) {
+		return std::sqrt(x);
+	}
+};
+
+template <>
+struct nth_root<3> {
+	template <typename T>
+	SI_INLINE static T of(T x) {
+		return std::cbrt(x);
+	}
+};
+
+
+// Scales x by Ratio when the ratio of the result is not exact (and so it is 1).
+template <bool ExactRatio>
+struct base {
+	template <typename Ratio, typename T>
+	SI_INLINE static T of(T x) {
+		return x;
+	}
+};
+
+template <>
+struct base<false> {
+	template <typename Ratio, typename T>
+	SI_INLINE static T of(T x) {
+		return x * Ratio::num / Ratio::den;
+	}
+};
+
+
+} /* namespace si::_pow */
+
+
+
+/// Raises an SI value to the rational power <tt>Num/Den</tt>.
+/**
+ * The powers of the base units and the ratio of the result are computed at
+ * compile time (see @c pow_function). At runtime the value is raised to
+ * @c Num by repeated squaring, and the @c Den-th root is taken with
+ * @c std::sqrt, @c std::cbrt or @c std::pow.
+ *
+ * For instance, <tt>si::pow<3>(length)</tt> is a volume and
+ * <tt>si::pow<1, 2>(area)</tt> is a length.
+ *
+ * @relates SIValue
+ */
+template <int Num, int Den = 1, typename ValueType, typename Ratio, dimension_code Dimensions>
+SI_INLINE typename pow_function<SIValue<ValueType, Ratio, Dimensions>, Num, Den>::type
+pow(const SIValue<ValueType, Ratio, Dimensions>& v) {
+	typedef pow_function<SIValue<ValueType, Ratio, Dimensions>, Num, Den> Function;
+	typedef typename Function::type ResultType;
+	typedef typename ResultType::ValueType NewValueType;
+
+	const NewValueType base = _pow::base<Function::exact_ratio>::template of<Ratio>(NewValueType(v.value));
+	const NewValueType powered = _pow::integral_power<(Function::num < 0 ? -Function::num : Function::num)>::of(base);
+	const NewValueType rooted = _pow::nth_root<Function::den>::of(powered);
+	return ResultType(Function::num < 0 ? NewValueType(1) / rooted : rooted);
+}
+
+
+/// Returns the square of an SI value.
+/**
+ * @see pow
+ * @relates SIValue
+ */
+template <typename ValueType, typename Ratio, dimension_code Dimensions>
+SI_INLINE typename pow_function<SIValue<ValueType, Ratio, Dimensions>, 2>::type
+square(const SIValue<ValueType, Ratio, Dimensions>& v) {
+	return pow<2>(v);
+}
+
+
+/// Returns the cube of an SI value.
+/**
+ * @see pow
+ * @relates SIValue
+ */
+template <typename ValueType, typename Ratio, dimension_code Dimensions>
+SI_INLINE typename pow_function<SIValue<ValueType, Ratio, Dimensions>, 3>::type
+cube(const SIValue<ValueType, Ratio, Dimensions>& v) {
+	return pow<3>(v);
+}
+
+
+} /* namespace si */
+
+
+
 /// The standard C++ namespace.
 namespace std {
 
@@ -15,11 +166,11 @@ namespace std {
 /**
  * @details The return type is the same as the argument.
  */
-template <typename ValueType, typename Ratio, int... Dimensions>
-::si::SIValue<ValueType, Ratio, Dimensions...>
-abs(const ::si::SIValue<ValueType, Ratio, Dimensions...>& v) {
+template <typename ValueType, typename Ratio, ::si::dimension_code Dimensions>
+SI_INLINE ::si::SIValue<ValueType, Ratio, Dimensions>
+abs(const ::si::SIValue<ValueType, Ratio, Dimensions>& v) {
 	typedef
-		typename ::si::SIValue<ValueType, Ratio, Dimensions...>
+		typename ::si::SIValue<ValueType, Ratio, Dimensions>
 		ResultType;
 
 	return ResultType(abs(v.value));
@@ -31,16 +182,68 @@ abs(const ::si::SIValue<ValueType, Ratio, Dimensions...>& v) {
  * This function accepts only arguments where the power of the base units are
  * even. The return type has base units with half the powers of the argument
  * base units.
+ *
+ * The ratio of the return type is the square root of the ratio of the
+ * argument when that is exact, so the square root of an area in square
+ * kilometers is a length in kilometers. Otherwise the ratio is 1.
+ *
+ * @see si::pow
+ */
+template <typename ValueType, typename Ratio, ::si::dimension_code Dimensions>
+SI_INLINE typename ::si::sqrt_function< ::si::SIValue<ValueType, Ratio, Dimensions>>::type
+sqrt(const ::si::SIValue<ValueType, Ratio, Dimensions>& v) {
+	// Same as si::pow, without the steps that do nothing for a root.
+	typedef ::si::pow_function< ::si::SIValue<ValueType, Ratio, Dimensions>, 1, 2> Function;
+	typedef typename Function::type ResultType;
+	typedef typename ResultType::ValueType NewValueType;
+	return ResultType(sqrt(::si::_pow::base<Function::exact_ratio>::template of<Ratio>(NewValueType(v.value))));
+}
+
+
+/// Returns the cube root of the SI value argument.
+/**
+ * This function accepts only arguments where the power of the base units are
+ * multiples of 3. The ratio is handled as in @c sqrt.
+ *
+ * @see si::pow
  */
-template <typename ValueType, typename Ratio, int... Dimensions>
-typename ::si::sqrt_function< ::si::SIValue<ValueType, Ratio, Dimensions...>>::type
-sqrt(const ::si::SIValue<ValueType, Ratio, Dimensions...>& v) {
-	static_assert(::si::int_list_all_even< ::si::int_list<Dimensions...>>::value, "All base unit powers must be even");
+template <typename ValueType, typename Ratio, ::si::dimension_code Dimensions>
+SI_INLINE typename ::si::pow_function< ::si::SIValue<ValueType, Ratio, Dimensions>, 1, 3>::type
+cbrt(const ::si::SIValue<ValueType, Ratio, Dimensions>& v) {
+	// Same as si::pow, without the steps that do nothing for a root.
+	typedef ::si::pow_function< ::si::SIValue<ValueType, Ratio, Dimensions>, 1, 3> Function;
+	typedef typename Function::type ResultType;
+	typedef typename ResultType::ValueType NewValueType;
+	return ResultType(cbrt(::si::_pow::base<Function::exact_ratio>::template of<Ratio>(NewValueType(v.value))));
+}
+
 
+/// Returns the square root of the sum of the squares of two SI values with same units.
+/**
+ * The values are converted to the ratio of their sum before the computation,
+ * which does not overflow or underflow at intermediate stages.
+ */
+template <typename ValueType1, typename Ratio1,
+          typename ValueType2, typename Ratio2,
+          ::si::dimension_code Dimensions>
+SI_INLINE
+::si::SIValue<decltype(hypot(ValueType1(), ValueType2())),
+              typename ::si::addition< ::si::SIValue<ValueType1, Ratio1, Dimensions>,
+                                       ::si::SIValue<ValueType2, Ratio2, Dimensions>>::type::Ratio,
+              Dimensions>
+hypot(const ::si::SIValue<ValueType1, Ratio1, Dimensions>& v1,
+      const ::si::SIValue<ValueType2, Ratio2, Dimensions>& v2)
+{
 	typedef
-		typename ::si::sqrt_function< ::si::SIValue<ValueType, Ratio, Dimensions...>>::type
+		::si::SIValue<decltype(hypot(ValueType1(), ValueType2())),
+		              typename ::si::addition< ::si::SIValue<ValueType1, Ratio1, Dimensions>,
+		                                       ::si::SIValue<ValueType2, Ratio2, Dimensions>>::type::Ratio,
+		              Dimensions>
 		ResultType;
-	return ResultType(sqrt(v.value * Ratio::num / Ratio::den));
+
+	const ResultType a = v1;
+	const ResultType b = v2;
+	return ResultType(hypot(a.value, b.value));
 }
 
 
@@ -0,0 +1,153 @@
+#ifndef SI_HASH_HPP_
+#define SI_HASH_HPP_
+
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include "dimension_code.hpp"
+#include "si_value.hpp"
+
+
+namespace si {
+
+
+namespace _hash {
+
+
+// The finalizer of the splitmix64 generator, which spreads every input bit
+// over all the output bits.
+inline std::uint64_t mix(std::uint64_t x) {
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+	return x ^ (x >> 31);
+}
+
+
+inline std::uint64_t of_integer(std::intmax_t value) {
+	return mix(std::uint64_t(value));
+}
+
+// Integer values are hashed as integers, so they hash like the same values
+// stored in integers. This also hashes both zeros alike.
+inline std::uint64_t of_floating(double value) {
+	if(value == std::floor(value)  &&  value >= -9.2e18  &&  value <= 9.2e18) {
+		return of_integer(std::intmax_t(value));
+	}
+	std::uint64_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return mix(bits);
+}
+
+
+// Tells if value * num fits in intmax_t.
+template <typename Ratio>
+bool scalable(std::intmax_t value) {
+	const std::intmax_t limit = std::numeric_limits<std::intmax_t>::max() / Ratio::num;
+	return value <= limit  &&  value >= -limit;
+}
+
+
+// The hash of a value normalized to the base ratio (1).
+template <typename ValueType, typename Ratio,
+          bool _Integral = std::is_integral<ValueType>::value,
+          bool _IntegralRatio = (Ratio::den == 1)>
+struct normalized;
+
+// Fast path: an integer in a ratio with an integer factor is an integer in the base ratio.
+// When it does not fit in intmax_t, it is hashed like the same value in a double.
+template <typename ValueType, typename Ratio>
+struct normalized<ValueType, Ratio, true, true> {
+	static std::uint64_t hash(ValueType value) {
+		if(!scalable<Ratio>(std::intmax_t(value))) {
+			return of_floating(double(value) * Ratio::num);
+		}
+		return of_integer(std::intmax_t(value) * Ratio::num);
+	}
+};
+
+template <typename ValueType, typename Ratio>
+struct normalized<ValueType, Ratio, true, false> {
+	static std::uint64_t hash(ValueType value) {
+		if(!scalable<Ratio>(std::intmax_t(value))) {
+			return of_floating(double(value) * Ratio::num / Ratio::den);
+		}
+		const std::intmax_t scaled = std::intmax_t(value) * Ratio::num;
+		if(scaled % Ratio::den == 0) {
+			return of_integer(scaled / Ratio::den);
+		}
+		return of_floating(double(scaled) / Ratio::den);
+	}
+};
+
+template <typename ValueType, typename Ratio, bool _IntegralRatio>
+struct normalized<ValueType, Ratio, false, _IntegralRatio> {
+	static std::uint64_t hash(ValueType value) {
+		return of_floating(Ratio::num == 1  &&  Ratio::den == 1 ?
+		                   double(value) :
+		                   double(value) * Ratio::num / Ratio::den);
+	}
+};
+
+
+// The hash of an underlying value, for containers whose keys all have the same type.
+template <typename ValueType>
+std::uint64_t raw(ValueType value, std::true_type) {
+	return mix(std::uint64_t(value));
+}
+
+// Adding zero turns a negative zero into a positive zero, so both hash alike.
+template <typename ValueType>
+std::uint64_t raw(ValueType value, std::false_type) {
+	const double normalized = double(value) + 0.0;
+	std::uint64_t bits;
+	std::memcpy(&bits, &normalized, sizeof(bits));
+	return mix(bits);
+}
+
+template <typename ValueType>
+std::uint64_t raw(ValueType value) {
+	return raw(value, std::is_integral<ValueType>());
+}
+
+
+} /* namespace si::_hash */
+
+
+} /* namespace si */
+
+
+
+namespace std {
+
+
+/// Hash of SI values, consistent with the comparison between different ratios.
+/**
+ * The value is normalized to the base ratio before it is hashed, so 1 km,
+ * 1000 m and 1000.0 m have the same hash. Values that are integers in the
+ * base ratio are hashed as integers, and other values by the bits of the
+ * normalized @c double. Values that compare equal have the same hash when
+ * the normalization is exact, which is always the case for integer values in
+ * a ratio with an integer factor (like kilometers, the fast path).
+ *
+ * @relates SIValue
+ */
+template <typename ValueType, typename Ratio, ::si::dimension_code Dimensions>
+struct hash< ::si::SIValue<ValueType, Ratio, Dimensions>> {
+	typedef ::si::SIValue<ValueType, Ratio, Dimensions> argument_type;
+	typedef std::size_t result_type;
+
+	std::size_t operator()(const argument_type& v) const {
+		return std::size_t(::si::_hash::normalized<ValueType, Ratio>::hash(v.value));
+	}
+};
+
+
+} /* namespace std */
+
+
+#endif /* SI_HASH_HPP_ */
@@ -2,32 +2,20 @@
 #define SI_INT_LIST_HPP_
 
 
+#include <cstddef>
+#include <type_traits>
+
+
 namespace si {
 
 
-template <int... Values>
-struct int_list;
-
-template <int HeadValue, int... TailValues>
-struct int_list<HeadValue, TailValues...> {
-	static const int head = HeadValue;
-	typedef int_list<TailValues...> tail;
-	static const bool empty = false;
-
-	template <int NewHeadValue>
-	struct with_head {
-		typedef int_list<NewHeadValue, HeadValue, TailValues...> type;
-	};
-};
+// The operations below work element-wise with a single pack expansion, so
+// they do not instantiate a class template per element.
 
-template <>
-struct int_list<> {
-	static const bool empty = true;
 
-	template <int NewHeadValue>
-	struct with_head {
-		typedef int_list<NewHeadValue> type;
-	};
+template <int... Values>
+struct int_list {
+	static const bool empty = sizeof...(Values) == 0;
 };
 
 
@@ -35,20 +23,9 @@ struct int_list<> {
 template <class IntList1, class IntList2>
 struct int_list_add;
 
-template <int HeadValue1, int... TailValues1,
-          int HeadValue2, int... TailValues2>
-struct int_list_add<int_list<HeadValue1, TailValues1...>, int_list<HeadValue2, TailValues2...>> {
-private:
-	static const int _head = HeadValue1 + HeadValue2;
-	typedef typename int_list_add<int_list<TailValues1...>, int_list<TailValues2...>>::type _tail;
-
-public:
-	typedef typename _tail::template with_head<_head>::type type;
-};
-
-template <>
-struct int_list_add<int_list<>, int_list<>> {
-	typedef int_list<> type;
+template <int... Values1, int... Values2>
+struct int_list_add<int_list<Values1...>, int_list<Values2...>> {
+	typedef int_list<(Values1 + Values2)...> type;
 };
 
 
@@ -56,30 +33,19 @@ struct int_list_add<int_list<>, int_list<>> {
 template <typename IntList>
 struct int_list_negative;
 
-template <int HeadValue, int... TailValues>
-struct int_list_negative<int_list<HeadValue, TailValues...>> {
-private:
-	static const int _head = -HeadValue;
-	typedef typename int_list_negative<int_list<TailValues...>>::type _tail;
-
-public:
-	typedef typename _tail::template with_head<_head>::type type;
-};
-
-template <>
-struct int_list_negative<int_list<>> {
-	typedef int_list<> type;
+template <int... Values>
+struct int_list_negative<int_list<Values...>> {
+	typedef int_list<(-Values)...> type;
 };
 
 
 
 template <typename IntList1, typename IntList2>
-struct int_list_subtract {
-private:
-	typedef typename int_list_negative<IntList2>::type _NegativeIntList2;
+struct int_list_subtract;
 
-public:
-	typedef typename int_list_add<IntList1, _NegativeIntList2>::type type;
+template <int... Values1, int... Values2>
+struct int_list_subtract<int_list<Values1...>, int_list<Values2...>> {
+	typedef int_list<(Values1 - Values2)...> type;
 };
 
 
@@ -87,34 +53,39 @@ public:
 template <typename IntList>
 struct int_list_half;
 
-template <int HeadValue, int... TailValues>
-struct int_list_half<int_list<HeadValue, TailValues...>> {
-private:
-	static const int _head = HeadValue / 2;
-	typedef typename int_list_half<int_list<TailValues...>>::type _tail;
-
-public:
-	typedef typename _tail::template with_head<_head>::type type;
+template <int... Values>
+struct int_list_half<int_list<Values...>> {
+	typedef int_list<(Values / 2)...> type;
 };
 
-template <>
-struct int_list_half<int_list<>> {
-	typedef int_list<> type;
-};
 
 
+template <bool... Values>
+struct _bool_list;
 
 template <typename IntList>
 struct int_list_all_even;
 
-template <int HeadValue, int... TailValues>
-struct int_list_all_even<int_list<HeadValue, TailValues...>> {
-	static const bool value = HeadValue % 2 == 0  &&  int_list_all_even<int_list<TailValues...>>::value;
+// All values are even if shifting the list of results by one position yields the same list.
+template <int... Values>
+struct int_list_all_even<int_list<Values...>> {
+	static const bool value = std::is_same<_bool_list<true, (Values % 2 == 0)...>,
+	                                       _bool_list<(Values % 2 == 0)..., true>>::value;
 };
 
-template<>
-struct int_list_all_even<int_list<>> {
-	static const bool value = true;
+
+
+// The indices 0 to N - 1 as a pack, to expand over the elements of a tuple.
+
+template <std::size_t... I>
+struct index_list {};
+
+template <std::size_t N, std::size_t... I>
+struct make_index_list : make_index_list<N - 1, N - 1, I...> {};
+
+template <std::size_t... I>
+struct make_index_list<0, I...> {
+	typedef index_list<I...> type;
 };
 
 
@@ -0,0 +1,300 @@
+#ifndef SI_INTERVAL_HPP_
+#define SI_INTERVAL_HPP_
+
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include "config.hpp"
+
+
+namespace si {
+
+
+namespace _interval {
+
+
+// The results are computed rounded to nearest, and then moved outward by one
+// unit in the last place when they are inexact. Each error below is zero when
+// the result is exact, and otherwise has the sign of the exact result minus
+// the rounded one, so the rounding mode of the program is never changed.
+// The error is NaN when its sign is unknown, and the result is then moved in
+// both directions.
+
+template <typename T>
+SI_INLINE T down(T x, T error) {
+	return !(error >= 0) ? std::nextafter(x, -std::numeric_limits<T>::infinity()) : x;
+}
+
+template <typename T>
+SI_INLINE T up(T x, T error) {
+	return !(error <= 0) ? std::nextafter(x, std::numeric_limits<T>::infinity()) : x;
+}
+
+// Tells if the error of an operation whose result is x may be too small to
+// be represented, so that it is 0 although the result is inexact.
+template <typename T>
+SI_INLINE bool may_underflow(T x) {
+	return std::fabs(x) < std::numeric_limits<T>::min();
+}
+
+template <typename T>
+SI_INLINE T unknown() {
+	return std::numeric_limits<T>::quiet_NaN();
+}
+
+// The error of a result x that is not finite: the opposite of x when it
+// overflowed from finite operands, so an overflow to +inf gives a lower bound
+// of the largest finite value, and 0 when an operand is infinite.
+template <typename T>
+SI_INLINE T overflow_error(T a, T b, T x) {
+	return std::isfinite(a)  &&  std::isfinite(b) ? -x : T(0);
+}
+
+// The error of a result x of nonzero operands whose error underflowed to 0:
+// the sign of the exact result when x is 0, and otherwise unknown.
+template <typename T>
+SI_INLINE T underflow_error(T a, T b, T x) {
+	return x != 0 ? unknown<T>() : (a > 0) == (b > 0) ? T(1) : T(-1);
+}
+
+// The error of s = a + b (Knuth's two-sum).
+template <typename T>
+SI_INLINE T sum_error(T a, T b, T s) {
+	if(!std::isfinite(s)) {
+		return overflow_error(a, b, s);
+	}
+	const T b_virtual = s - a;
+	return (a - (s - b_virtual)) + (b - b_virtual);
+}
+
+// The error of p = a * b.
+template <typename T>
+SI_INLINE T product_error(T a, T b, T p) {
+	if(!std::isfinite(p)) {
+		return overflow_error(a, b, p);
+	}
+	const T error = std::fma(a, b, -p);
+	return error == 0  &&  may_underflow(p)  &&  a != 0  &&  b != 0 ? underflow_error(a, b, p) : error;
+}
+
+// The sign of the error of q = a / b, from the remainder a - q b, which is
+// exact unless q is below the normal range.
+template <typename T>
+SI_INLINE T quotient_error(T a, T b, T q) {
+	if(!std::isfinite(q)) {
+		return overflow_error(a, b, q);
+	}
+	const T remainder = -std::fma(q, b, -a);
+	return remainder != 0 ? ((remainder > 0) == (b > 0) ? T(1) : T(-1)) :
+	       may_underflow(q)  &&  a != 0 ? underflow_error(a, b, q) : T(0);
+}
+
+// The sign of the error of r = sqrt(x), from the exact x - r^2.
+template <typename T>
+SI_INLINE T root_error(T x, T r) {
+	return -std::fma(r, r, -x);
+}
+
+template <typename T>
+SI_INLINE T product_down(T a, T b) {
+	const T p = a * b;
+	return down(p, product_error(a, b, p));
+}
+
+template <typename T>
+SI_INLINE T product_up(T a, T b) {
+	const T p = a * b;
+	return up(p, product_error(a, b, p));
+}
+
+template <typename T>
+SI_INLINE T quotient_down(T a, T b) {
+	const T q = a / b;
+	return down(q, quotient_error(a, b, q));
+}
+
+template <typename T>
+SI_INLINE T quotient_up(T a, T b) {
+	const T q = a / b;
+	return up(q, quotient_error(a, b, q));
+}
+
+
+} /* namespace si::_interval */
+
+
+
+/**
+ * @brief A closed interval of real numbers, which contains the exact result of a computation.
+ *
+ * @details Each operation returns the smallest interval of @c T that contains
+ * the results of the operation on all the numbers of its operands, rounded
+ * outward: when a bound is not exact, it is moved away from the result by one
+ * unit in the last place. A bound that is exact, as in sums of small integers,
+ * is kept. So computing with intervals gives bounds that are guaranteed to
+ * contain the exact result, including the rounding errors.
+ *
+ * It can be the underlying type of SI values, like
+ * <tt>Pressure_Pa<interval<double>></tt>. The bounds of a product grow with
+ * the relative widths of the factors, and the bounds of every occurrence of a
+ * variable are taken as independent, so <tt>x - x</tt> is not 0 for a wide
+ * @c x: rewrite expressions to use each variable once where possible.
+ *
+ * The quotient by an interval that contains 0 is the whole real line.
+ *
+ * Intervals are equal when both bounds are. Other comparisons are not defined,
+ * as overlapping intervals are neither less nor greater.
+ *
+ * @tparam T The type of the bounds. Must be a floating point type.
+ */
+template <typename T>
+struct interval {
+	static_assert(std::is_floating_point<T>::value, "The bounds of an interval must have a floating point type");
+
+	/// The lower bound.
+	T lo;
+	/// The upper bound.
+	T hi;
+
+
+	/// The interval [0, 0].
+	SI_INLINE interval() noexcept : lo(), hi() {}
+
+	/// The interval [x, x], which contains only @c x.
+	SI_INLINE interval(const T& x) noexcept : lo(x), hi(x) {}
+
+	/// The interval [lo, hi].
+	SI_INLINE interval(const T& lo, const T& hi) noexcept : lo(lo), hi(hi) {}
+
+	/// Conversion from an interval of another type, rounded outward.
+	template <typename U>
+	SI_INLINE interval(const interval<U>& x) noexcept
+		: lo(_interval::down(T(x.lo), U(T(x.lo)) > x.lo ? T(-1) : T(0))),
+		  hi(_interval::up(T(x.hi), U(T(x.hi)) < x.hi ? T(1) : T(0)))
+	{}
+
+	/// Returns the interval [x - radius, x + radius], rounded outward.
+	SI_INLINE static interval around(const T& x, const T& radius) noexcept {
+		return interval(x) + interval(-radius, radius);
+	}
+
+
+	/// Returns the middle of the interval.
+	SI_INLINE T midpoint() const noexcept {
+		return lo / 2 + hi / 2;
+	}
+
+	/// Returns the width of the interval, rounded up.
+	SI_INLINE T width() const noexcept {
+		const T w = hi - lo;
+		return _interval::up(w, _interval::sum_error(hi, -lo, w));
+	}
+
+	/// Tells if the interval contains @c x.
+	SI_INLINE bool contains(const T& x) const noexcept {
+		return lo <= x  &&  x <= hi;
+	}
+
+
+	SI_INLINE interval& operator+=(const interval& x) noexcept {
+		const T l = lo + x.lo;
+		const T h = hi + x.hi;
+		lo = _interval::down(l, _interval::sum_error(lo, x.lo, l));
+		hi = _interval::up(h, _interval::sum_error(hi, x.hi, h));
+		return *this;
+	}
+
+	SI_INLINE interval& operator-=(const interval& x) noexcept {
+		return *this += interval(-x.hi, -x.lo);
+	}
+
+	SI_INLINE interval& operator*=(const interval& x) noexcept {
+		using namespace _interval;
+		const T l = std::min(std::min(product_down(lo, x.lo), product_down(lo, x.hi)),
+		                     std::min(product_down(hi, x.lo), product_down(hi, x.hi)));
+		const T h = std::max(std::max(product_up(lo, x.lo), product_up(lo, x.hi)),
+		                     std::max(product_up(hi, x.lo), product_up(hi, x.hi)));
+		lo = l;
+		hi = h;
+		return *this;
+	}
+
+	SI_INLINE interval& operator/=(const interval& x) noexcept {
+		using namespace _interval;
+		if(x.lo <= 0  &&  x.hi >= 0) {
+			lo = -std::numeric_limits<T>::infinity();
+			hi = std::numeric_limits<T>::infinity();
+			return *this;
+		}
+		const T l = std::min(std::min(quotient_down(lo, x.lo), quotient_down(lo, x.hi)),
+		                     std::min(quotient_down(hi, x.lo), quotient_down(hi, x.hi)));
+		const T h = std::max(std::max(quotient_up(lo, x.lo), quotient_up(lo, x.hi)),
+		                     std::max(quotient_up(hi, x.lo), quotient_up(hi, x.hi)));
+		lo = l;
+		hi = h;
+		return *this;
+	}
+
+
+	// As for dual numbers, the binary operators are hidden friends that accept
+	// anything convertible to T on either side.
+
+	SI_INLINE friend interval operator+(const interval& x) noexcept { return x; }
+	SI_INLINE friend interval operator-(const interval& x) noexcept { return interval(-x.hi, -x.lo); }
+
+	SI_INLINE friend interval operator+(interval x, const interval& y) noexcept { return x += y; }
+	SI_INLINE friend interval operator-(interval x, const interval& y) noexcept { return x -= y; }
+	SI_INLINE friend interval operator*(interval x, const interval& y) noexcept { return x *= y; }
+	SI_INLINE friend interval operator/(interval x, const interval& y) noexcept { return x /= y; }
+
+	SI_INLINE friend interval operator+(interval x, const T& c) noexcept { return x += interval(c); }
+	SI_INLINE friend interval operator-(interval x, const T& c) noexcept { return x -= interval(c); }
+	SI_INLINE friend interval operator*(interval x, const T& c) noexcept { return x *= interval(c); }
+	SI_INLINE friend interval operator/(interval x, const T& c) noexcept { return x /= interval(c); }
+
+	SI_INLINE friend interval operator+(const T& c, const interval& x) noexcept { return interval(c) += x; }
+	SI_INLINE friend interval operator-(const T& c, const interval& x) noexcept { return interval(c) -= x; }
+	SI_INLINE friend interval operator*(const T& c, const interval& x) noexcept { return interval(c) *= x; }
+	SI_INLINE friend interval operator/(const T& c, const interval& x) noexcept { return interval(c) /= x; }
+
+	SI_INLINE friend bool operator==(const interval& x, const interval& y) noexcept {
+		return x.lo == y.lo  &&  x.hi == y.hi;
+	}
+
+	SI_INLINE friend bool operator!=(const interval& x, const interval& y) noexcept {
+		return !(x == y);
+	}
+};
+
+
+/// Returns the square root of an interval, rounded outward.
+/**
+ * The negative part of the interval is ignored.
+ *
+ * @relates interval
+ */
+template <typename T>
+SI_INLINE interval<T> sqrt(const interval<T>& x) noexcept {
+	const T lo = x.lo > 0 ? x.lo : T(0);
+	const T hi = x.hi > 0 ? x.hi : T(0);
+	const T l = std::sqrt(lo);
+	const T h = std::sqrt(hi);
+	return interval<T>(_interval::down(l, _interval::root_error(lo, l)), _interval::up(h, _interval::root_error(hi, h)));
+}
+
+/// Returns the absolute values of the numbers of an interval.
+/** @relates interval */
+template <typename T>
+SI_INLINE interval<T> abs(const interval<T>& x) noexcept {
+	return x.lo >= 0 ? x
+	     : x.hi <= 0 ? -x
+	     : interval<T>(T(0), std::max(-x.lo, x.hi));
+}
+
+
+} /* namespace si */
+
+
+#endif /* SI_INTERVAL_HPP_ */
@@ -0,0 +1,1080 @@
+#ifndef SI_JSON_HPP_
+#define SI_JSON_HPP_
+
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "dimension_code.hpp"
+#include "ratio_table.hpp"
+#include "si_value.hpp"
+#include "symbol_table.hpp"
+
+
+namespace si {
+
+
+/**
+ * @brief Streaming JSON reader and writer for quantities.
+ *
+ * @details A quantity is an object with a number @c "value" and a string
+ * @c "unit" with the symbol of a unit, in any order and with no other
+ * members, like <tt>{"value": 12.5, "unit": "km/h"}</tt>. The symbols are
+ * the ones of the generated units, in UTF-8 (like @c "m/s²" or @c "μm"), or
+ * spelled in ASCII with @c u for μ, @c ohm for Ω, @c * for · and @c ^ for the
+ * powers (like @c "m/s^2" or @c "um").
+ *
+ * The reader calls a handler for each element of a document, like a SAX
+ * parser, and calls @c quantity once for a whole quantity object, with its
+ * unit already resolved. The handler then converts it to a typed SI value,
+ * for a field or the end of a column: @code
+ *     struct speeds : si::json::handler {
+ *         std::vector<SpeedDbl_m_s> values;
+ *
+ *         void quantity(const si::json::quantity& q) {
+ *             SpeedDbl_m_s speed;
+ *             if(q.get(speed)) {
+ *                 values.push_back(speed);
+ *             }
+ *         }
+ *     };
+ * @endcode
+ *
+ * The reader reads the document in blocks, so it can be larger than the
+ * memory, and only allocates its buffer, which grows to fit the longest
+ * token, and a string for the strings with escape sequences. The writer
+ * doesn't allocate at all.
+ */
+namespace json {
+
+
+/// A quantity object read from a document.
+struct quantity {
+	double value;
+	dimension_code dimensions;
+	/// The ratio of the unit.
+	std::intmax_t num, den;
+	/// The symbol of the unit, in UTF-8 (even if it was spelled in ASCII).
+	const char* symbol;
+
+	/// Converts the quantity to an SI value with the same dimensions.
+	/**
+	 * Like the conversions between SI values, the value is truncated for an
+	 * integer underlying type.
+	 *
+	 * @return Whether the dimensions are the same.
+	 */
+	template <typename SIValueType>
+	bool get(SIValueType& out) const {
+		typedef typename SIValueType::ValueType T;
+		typedef typename SIValueType::Ratio Ratio;
+		if(dimensions != SIValueType::Dimensions) {
+			return false;
+		}
+		out.value = num == Ratio::num  &&  den == Ratio::den ?
+		            T(value) :
+		            T((long double)value * ((long double)num * Ratio::den) / ((long double)den * Ratio::num));
+		return true;
+	}
+};
+
+
+/// A handler that ignores all the elements, to derive handlers from.
+/**
+ * Strings and keys are passed unescaped, in UTF-8, and are valid until the
+ * handler returns.
+ */
+struct handler {
+	void start_object() {}
+	void end_object() {}
+	void start_array() {}
+	void end_array() {}
+	void key(const char* /*text*/, std::size_t /*length*/) {}
+	void string(const char* /*text*/, std::size_t /*length*/) {}
+	void number(double /*value*/) {}
+	void boolean(bool /*value*/) {}
+	void null() {}
+	void quantity(const json::quantity& /*q*/) {}
+};
+
+
+/// A source that reads a document from memory.
+class memory_source {
+public:
+	memory_source(const char* data, std::size_t size) : _data(data), _size(size) {}
+
+	std::size_t read(char* buffer, std::size_t size) {
+		const std::size_t n = std::min(size, _size);
+		std::memcpy(buffer, _data, n);
+		_data += n;
+		_size -= n;
+		return n;
+	}
+
+private:
+	const char* _data;
+	std::size_t _size;
+};
+
+
+/// A source that reads a document from a file.
+class file_source {
+public:
+	explicit file_source(std::FILE* file) : _file(file) {}
+
+	std::size_t read(char* buffer, std::size_t size) {
+		return std::fread(buffer, 1, size, _file);
+	}
+
+private:
+	std::FILE* _file;
+};
+
+
+/// A sink that writes a document to a file.
+class file_sink {
+public:
+	explicit file_sink(std::FILE* file) : _file(file) {}
+
+	void write(const char* data, std::size_t size) {
+		std::fwrite(data, 1, size, _file);
+	}
+
+private:
+	std::FILE* _file;
+};
+
+
+} /* namespace si::json */
+
+
+
+namespace _json {
+
+
+const std::size_t read_block_size = 1 << 16;
+const std::size_t write_buffer_size = 1 << 13;
+const int max_depth = 256;
+
+
+// Compares a NUL-terminated string with a string of the given length.
+inline int compare(const char* text, const char* s, std::size_t length) {
+	for(std::size_t i = 0; i < length; i++) {
+		if(text[i] != s[i]) {
+			return text[i] == '\0' ? -1 : (unsigned char)text[i] < (unsigned char)s[i] ? -1 : 1;
+		}
+	}
+	return text[length] == '\0' ? 0 : 1;
+}
+
+// The index of the unit with the symbol, or unit_count if there is none.
+inline std::size_t find_unit(const char* symbol, std::size_t length) {
+	std::size_t begin = 0, end = _symbol_table::spelling_count;
+	while(begin < end) {
+		const std::size_t middle = (begin + end) / 2;
+		const int c = compare(_symbol_table::spellings[middle].text, symbol, length);
+		if(c == 0) {
+			return _symbol_table::spellings[middle].unit;
+		}
+		if(c < 0) {
+			begin = middle + 1;
+		} else {
+			end = middle;
+		}
+	}
+	return _symbol_table::unit_count;
+}
+
+
+// The index of the unit of an SI value type.
+template <typename SIValueType>
+struct unit_of {
+	static const std::size_t value = _symbol_table::find(
+		SIValueType::Dimensions,
+		_ratio_table::index_of(SIValueType::Ratio::num, SIValueType::Ratio::den));
+	static_assert(value != _symbol_table::unit_count, "The type has no unit symbol");
+};
+
+
+// An integer converted to the widest type of the same signedness.
+template <typename T>
+constexpr typename std::conditional<std::is_signed<T>::value, long long, unsigned long long>::type widest(T value) {
+	return value;
+}
+
+
+// The powers of ten that are exact in a double.
+const double exact_powers_of_ten[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+const int max_exact_digits = 15;
+const int max_mantissa_digits = 19;
+
+
+inline void append_utf8(std::string& out, unsigned code_point) {
+	if(code_point < 0x80) {
+		out += char(code_point);
+	} else if(code_point < 0x800) {
+		out += char(0xC0 | (code_point >> 6));
+		out += char(0x80 | (code_point & 0x3F));
+	} else if(code_point < 0x10000) {
+		out += char(0xE0 | (code_point >> 12));
+		out += char(0x80 | ((code_point >> 6) & 0x3F));
+		out += char(0x80 | (code_point & 0x3F));
+	} else {
+		out += char(0xF0 | (code_point >> 18));
+		out += char(0x80 | ((code_point >> 12) & 0x3F));
+		out += char(0x80 | ((code_point >> 6) & 0x3F));
+		out += char(0x80 | (code_point & 0x3F));
+	}
+}
+
+inline int hex_digit(int c) {
+	return c >= '0'  &&  c <= '9' ? c - '0' :
+	       c >= 'a'  &&  c <= 'f' ? c - 'a' + 10 :
+	       c >= 'A'  &&  c <= 'F' ? c - 'A' + 10 :
+	       -1;
+}
+
+inline bool is_digit(int c) {
+	return c >= '0'  &&  c <= '9';
+}
+
+
+} /* namespace si::_json */
+
+
+
+namespace json {
+
+
+/// Parses a document from a source, and calls a handler for its elements.
+/**
+ * @tparam Source A type with a method <tt>std::size_t read(char* buffer,
+ *     std::size_t size)</tt> that returns 0 at the end of the document, like
+ *     @c memory_source or @c file_source.
+ * @tparam Handler A type with the methods of @c handler.
+ */
+template <typename Source, typename Handler>
+class reader {
+public:
+	reader(Source& source, Handler& handler) :
+		_source(source), _handler(handler), _buffer(_json::read_block_size),
+		_pos(0), _end(0), _mark(npos), _offset(0), _eof(false),
+		_cache() {}
+
+
+	/// Parses the whole document.
+	/**
+	 * @return Whether it is valid JSON. If it isn't, the handler has been
+	 *     called for the elements before the error.
+	 */
+	bool parse() {
+		return parse_value(0)  &&  skip_whitespace() == -1;
+	}
+
+	/// The offset in the document where the parser stopped.
+	std::size_t offset() const {
+		return _offset + _pos;
+	}
+
+private:
+	static const std::size_t npos = std::size_t(-1);
+	static const std::size_t max_symbol_length = 30;
+	static const std::size_t cache_size = 16;
+
+	Source& _source;
+	Handler& _handler;
+
+	// The buffer holds the bytes from _offset in the document up to _end. The
+	// ones before the current position (_pos) or the mark are discarded when
+	// more bytes are read.
+	std::vector<char> _buffer;
+	std::size_t _pos;
+	std::size_t _end;
+	std::size_t _mark;
+	std::size_t _offset;
+	bool _eof;
+	std::string _unescaped;
+
+	// The units of the last symbols that were looked up, by a hash of the
+	// symbol, as documents tend to repeat a few of them.
+	struct cached_unit {
+		unsigned char length; // 0 for an empty entry
+		char symbol[max_symbol_length];
+		std::size_t unit;
+	};
+	cached_unit _cache[cache_size];
+
+
+	// Reads more bytes at the end of the buffer.
+	bool fill() {
+		if(_eof) {
+			return false;
+		}
+		const std::size_t keep = std::min(_pos, _mark);
+		if(keep > 0) {
+			std::memmove(_buffer.data(), _buffer.data() + keep, _end - keep);
+			_end -= keep;
+			_pos -= keep;
+			if(_mark != npos) {
+				_mark -= keep;
+			}
+			_offset += keep;
+		}
+		if(_end == _buffer.size()) {
+			_buffer.resize(2 * _buffer.size());
+		}
+
+		const std::size_t n = _source.read(_buffer.data() + _end, _buffer.size() - _end);
+		_end += n;
+		_eof = n == 0;
+		return !_eof;
+	}
+
+	// The byte at an offset from the current position, or -1 at the end.
+	int peek(std::size_t k = 0) {
+		if(_pos + k < _end) {
+			return (unsigned char)_buffer[_pos + k];
+		}
+		return peek_past_end(k);
+	}
+
+	int peek_past_end(std::size_t k) {
+		while(_pos + k >= _end) {
+			if(!fill()) {
+				return -1;
+			}
+		}
+		return (unsigned char)_buffer[_pos + k];
+	}
+
+	int skip_whitespace() {
+		for(;;) {
+			while(_pos < _end) {
+				const char c = _buffer[_pos];
+				if(c != ' '  &&  c != '\n'  &&  c != '\r'  &&  c != '\t') {
+					return (unsigned char)c;
+				}
+				_pos++;
+			}
+			if(!fill()) {
+				return -1;
+			}
+		}
+	}
+
+
+	bool parse_value(int depth) {
+		switch(skip_whitespace()) {
+		case '{': {
+			if(depth == _json::max_depth) {
+				return false;
+			}
+			_mark = _pos;
+			json::quantity q;
+			const bool is_quantity = parse_quantity(q);
+			_pos = is_quantity ? _pos : _mark;
+			_mark = npos;
+			if(is_quantity) {
+				_handler.quantity(q);
+				return true;
+			}
+			return parse_object(depth + 1);
+		}
+		case '[':
+			return depth < _json::max_depth  &&  parse_array(depth + 1);
+		case '"': {
+			const char* text;
+			std::size_t length;
+			if(!parse_string(text, length)) {
+				return false;
+			}
+			_handler.string(text, length);
+			return true;
+		}
+		case 't':
+			if(!parse_literal("true", 4)) {
+				return false;
+			}
+			_handler.boolean(true);
+			return true;
+		case 'f':
+			if(!parse_literal("false", 5)) {
+				return false;
+			}
+			_handler.boolean(false);
+			return true;
+		case 'n':
+			if(!parse_literal("null", 4)) {
+				return false;
+			}
+			_handler.null();
+			return true;
+		default: {
+			double value;
+			if(!parse_number(value)) {
+				return false;
+			}
+			_handler.number(value);
+			return true;
+		}
+		}
+	}
+
+
+	// Parses an object if it is a quantity. Otherwise it returns false, and
+	// the object is parsed again as any other object.
+	bool parse_quantity(json::quantity& q) {
+		_pos++; // {
+		bool has_value = false, has_unit = false;
+		for(;;) {
+			const char* key;
+			std::size_t length;
+			if(skip_whitespace() != '"'  ||  !parse_string(key, length)) {
+				return false;
+			}
+			const bool is_value = length == 5  &&  std::memcmp(key, "value", 5) == 0;
+			const bool is_unit = length == 4  &&  std::memcmp(key, "unit", 4) == 0;
+			if(is_value ? has_value : is_unit ? has_unit : true) {
+				return false;
+			}
+			if(skip_whitespace() != ':') {
+				return false;
+			}
+			_pos++;
+
+			const int c = skip_whitespace();
+			if(is_value) {
+				if((c != '-'  &&  !_json::is_digit(c))  ||  !parse_number(q.value)) {
+					return false;
+				}
+				has_value = true;
+			} else {
+				const char* symbol;
+				if(c != '"'  ||  !parse_string(symbol, length)  ||  !resolve_unit(symbol, length, q)) {
+					return false;
+				}
+				has_unit = true;
+			}
+
+			const int next = skip_whitespace();
+			_pos++;
+			if(next == '}') {
+				return has_value  &&  has_unit;
+			}
+			if(next != ',') {
+				return false;
+			}
+		}
+	}
+
+	bool resolve_unit(const char* symbol, std::size_t length, json::quantity& q) {
+		if(length == 0  ||  length > max_symbol_length) {
+			return false;
+		}
+		cached_unit& cached = _cache[(length * 7 + (unsigned char)symbol[0] + (unsigned char)symbol[length - 1]) % cache_size];
+		if(cached.length != length  ||  std::memcmp(symbol, cached.symbol, length) != 0) {
+			const std::size_t index = _json::find_unit(symbol, length);
+			if(index == _symbol_table::unit_count) {
+				return false;
+			}
+			cached.length = (unsigned char)length;
+			std::memcpy(cached.symbol, symbol, length);
+			cached.unit = index;
+		}
+
+		const _symbol_table::unit& unit = _symbol_table::units[cached.unit];
+		q.dimensions = unit.dimensions;
+		q.num = _ratio_table::num[unit.ratio];
+		q.den = _ratio_table::den[unit.ratio];
+		q.symbol = unit.symbol;
+		return true;
+	}
+
+
+	bool parse_object(int depth) {
+		_pos++; // {
+		_handler.start_object();
+		int c = skip_whitespace();
+		if(c == '}') {
+			_pos++;
+			_handler.end_object();
+			return true;
+		}
+		for(;;) {
+			const char* key;
+			std::size_t length;
+			if(c != '"'  ||  !parse_string(key, length)) {
+				return false;
+			}
+			_handler.key(key, length);
+			if(skip_whitespace() != ':') {
+				return false;
+			}
+			_pos++;
+			if(!parse_value(depth)) {
+				return false;
+			}
+
+			c = skip_whitespace();
+			if(c == '}') {
+				_pos++;
+				_handler.end_object();
+				return true;
+			}
+			if(c != ',') {
+				return false;
+			}
+			_pos++;
+			c = skip_whitespace();
+		}
+	}
+
+	bool parse_array(int depth) {
+		_pos++; // [
+		_handler.start_array();
+		if(skip_whitespace() == ']') {
+			_pos++;
+			_handler.end_array();
+			return true;
+		}
+		for(;;) {
+			if(!parse_value(depth)) {
+				return false;
+			}
+
+			const int c = skip_whitespace();
+			if(c == ']') {
+				_pos++;
+				_handler.end_array();
+				return true;
+			}
+			if(c != ',') {
+				return false;
+			}
+			_pos++;
+		}
+	}
+
+
+	bool parse_literal(const char* literal, std::size_t length) {
+		for(std::size_t k = 0; k < length; k++) {
+			if(peek(k) != literal[k]) {
+				return false;
+			}
+		}
+		_pos += length;
+		return true;
+	}
+
+
+	// Parses a string, which is in the buffer if it has no escape sequences.
+	bool parse_string(const char*& text, std::size_t& length) {
+		bool escaped = false;
+		std::size_t k = 1;
+		for(;;) {
+			// Skips the plain bytes in the buffer
+			const char* p = _buffer.data() + _pos + k;
+			const char* const end = _buffer.data() + _end;
+			while(p < end  &&  *p != '"'  &&  *p != '\\'  &&  (unsigned char)*p >= 0x20) {
+				p++;
+			}
+			k = p - (_buffer.data() + _pos);
+
+			const int c = peek(k);
+			if(c == '"') {
+				break;
+			}
+			if(c < 0x20) { // Control character, or end of the document
+				return false;
+			}
+			if(c == '\\') {
+				escaped = true;
+				k++;
+				if(peek(k) < 0) {
+					return false;
+				}
+			}
+			k++;
+		}
+
+		if(!escaped) {
+			text = _buffer.data() + _pos + 1;
+			length = k - 1;
+		} else {
+			if(!unescape(_buffer.data() + _pos + 1, k - 1)) {
+				return false;
+			}
+			text = _unescaped.data();
+			length = _unescaped.size();
+		}
+		_pos += k + 1;
+		return true;
+	}
+
+	bool unescape(const char* s, std::size_t length) {
+		_unescaped.clear();
+		for(std::size_t i = 0; i < length; i++) {
+			if(s[i] != '\\') {
+				_unescaped += s[i];
+				continue;
+			}
+			switch(s[++i]) {
+			case '"':  _unescaped += '"';  break;
+			case '\\': _unescaped += '\\'; break;
+			case '/':  _unescaped += '/';  break;
+			case 'b':  _unescaped += '\b'; break;
+			case 'f':  _unescaped += '\f'; break;
+			case 'n':  _unescaped += '\n'; break;
+			case 'r':  _unescaped += '\r'; break;
+			case 't':  _unescaped += '\t'; break;
+			case 'u': {
+				unsigned code_point;
+				if(!hex4(s, length, i + 1, code_point)) {
+					return false;
+				}
+				i += 4;
+				// A surrogate pair
+				unsigned low;
+				if(code_point >= 0xD800  &&  code_point < 0xDC00  &&
+				   i + 2 < length  &&  s[i + 1] == '\\'  &&  s[i + 2] == 'u'  &&
+				   hex4(s, length, i + 3, low)  &&  low >= 0xDC00  &&  low < 0xE000) {
+					code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+					i += 6;
+				}
+				_json::append_utf8(_unescaped, code_point);
+				break;
+			}
+			default:
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static bool hex4(const char* s, std::size_t length, std::size_t i, unsigned& value) {
+		if(i + 4 > length) {
+			return false;
+		}
+		value = 0;
+		for(std::size_t j = i; j < i + 4; j++) {
+			const int digit = _json::hex_digit(s[j]);
+			if(digit < 0) {
+				return false;
+			}
+			value = value * 16 + unsigned(digit);
+		}
+		return true;
+	}
+
+
+	// Parses a number. Numbers with up to 15 significant digits and a small
+	// exponent are converted exactly with a single multiplication or division
+	// (which are correctly rounded), and the others by strtod.
+	bool parse_number(double& value) {
+		std::size_t k = 0;
+		const bool negative = peek(k) == '-';
+		k += negative;
+
+		std::uint64_t mantissa = 0;
+		int digits = 0;
+		int exponent = 0;
+		const auto add_digit = [&](int c) {
+			if(digits < _json::max_mantissa_digits) {
+				mantissa = mantissa * 10 + unsigned(c - '0');
+				digits += mantissa != 0;
+				return 0;
+			}
+			digits++;
+			return 1; // The digit is dropped
+		};
+
+		int c = peek(k);
+		if(c == '0') {
+			c = peek(++k);
+		} else if(_json::is_digit(c)) {
+			do {
+				exponent += add_digit(c);
+				c = peek(++k);
+			} while(_json::is_digit(c));
+		} else {
+			return false;
+		}
+
+		if(c == '.') {
+			c = peek(++k);
+			if(!_json::is_digit(c)) {
+				return false;
+			}
+			do {
+				exponent -= 1 - add_digit(c);
+				c = peek(++k);
+			} while(_json::is_digit(c));
+		}
+
+		if(c == 'e'  ||  c == 'E') {
+			c = peek(++k);
+			const bool negative_exponent = c == '-';
+			if(c == '+'  ||  c == '-') {
+				c = peek(++k);
+			}
+			if(!_json::is_digit(c)) {
+				return false;
+			}
+			int e = 0;
+			do {
+				e = std::min(e * 10 + (c - '0'), 100000);
+				c = peek(++k);
+			} while(_json::is_digit(c));
+			exponent += negative_exponent ? -e : e;
+		}
+
+		if(mantissa == 0) {
+			value = negative ? -0.0 : 0.0;
+		} else if(digits <= _json::max_exact_digits  &&  exponent >= -22  &&  exponent <= 22) {
+			value = exponent < 0 ?
+			        double(mantissa) / _json::exact_powers_of_ten[-exponent] :
+			        double(mantissa) * _json::exact_powers_of_ten[exponent];
+			value = negative ? -value : value;
+		} else {
+			value = to_double(_buffer.data() + _pos, k);
+		}
+		_pos += k;
+		return true;
+	}
+
+	double to_double(const char* text, std::size_t length) {
+		char copy[64];
+		if(length < sizeof(copy)) {
+			std::memcpy(copy, text, length);
+			copy[length] = '\0';
+			return std::strtod(copy, nullptr);
+		}
+		_unescaped.assign(text, length);
+		return std::strtod(_unescaped.c_str(), nullptr);
+	}
+};
+
+
+/// Parses a document from a source, and calls a handler for its elements.
+/**
+ * @return Whether the document is valid JSON.
+ * @see reader
+ */
+template <typename Source, typename Handler>
+bool parse(Source& source, Handler& handler) {
+	return reader<Source, Handler>(source, handler).parse();
+}
+
+/// Parses a document in memory, and calls a handler for its elements.
+template <typename Handler>
+bool parse(const char* data, std::size_t size, Handler& handler) {
+	memory_source source(data, size);
+	return parse(source, handler);
+}
+
+
+
+/// Writes a document to a sink, without allocating memory.
+/**
+ * The elements are written in the order of the calls, with the commas
+ * between them. The output is buffered, and it is flushed by @c flush and
+ * by the destructor.
+ *
+ * Numbers are written in the shortest form among 15 and 17 significant
+ * digits that reads back as the same value, and NaNs and infinities as
+ * @c null, as JSON can't represent them.
+ *
+ * @tparam Sink A type with a method <tt>void write(const char* data,
+ *     std::size_t size)</tt>, like @c file_sink.
+ */
+template <typename Sink>
+class writer {
+public:
+	explicit writer(Sink& sink) : _sink(sink), _size(0), _depth(0), _after_key(false) {
+		_has_elements[0] = false;
+	}
+
+	~writer() {
+		flush();
+	}
+
+
+	/// Starts an object.
+	/**
+	 * @return @c false, without writing anything, if the object would be
+	 *     nested deeper than the reader accepts (256 levels). Its contents
+	 *     and its end must not be written then.
+	 */
+	bool start_object() {
+		return open('{');
+	}
+
+	void end_object() {
+		close('}');
+	}
+
+	/// Starts an array.
+	/**
+	 * @return @c false, without writing anything, if the array would be
+	 *     nested too deep, like @c start_object.
+	 */
+	bool start_array() {
+		return open('[');
+	}
+
+	void end_array() {
+		close(']');
+	}
+
+	void key(const char* text, std::size_t length) {
+		separate();
+		put_string(text, length);
+		put(':');
+		_after_key = true;
+	}
+
+	void key(const char* text) {
+		key(text, std::strlen(text));
+	}
+
+	void string(const char* text, std::size_t length) {
+		separate();
+		put_string(text, length);
+	}
+
+	void string(const char* text) {
+		string(text, std::strlen(text));
+	}
+
+	void number(double value) {
+		separate();
+		put_number(value);
+	}
+
+	/// Writes an integer exactly, whatever its type.
+	template <typename T>
+	typename std::enable_if<std::is_integral<T>::value>::type number(T value) {
+		separate();
+		put_integer(_json::widest<T>(value));
+	}
+
+	void boolean(bool value) {
+		separate();
+		put(value ? "true" : "false", value ? 4 : 5);
+	}
+
+	void null() {
+		separate();
+		put("null", 4);
+	}
+
+
+	/// Writes a quantity object, with the symbol of the unit of its type.
+	template <typename SIValueType>
+	void quantity(const SIValueType& v) {
+		separate();
+		put("{\"value\":", 9);
+		put_value(v.value, std::is_integral<typename SIValueType::ValueType>());
+		put(",\"unit\":\"", 9);
+		const char* const symbol = _symbol_table::units[_json::unit_of<SIValueType>::value].symbol;
+		put(symbol, std::strlen(symbol));
+		put("\"}", 2);
+	}
+
+
+	/// Writes the buffered output to the sink.
+	void flush() {
+		if(_size > 0) {
+			_sink.write(_buffer, _size);
+			_size = 0;
+		}
+	}
+
+private:
+	Sink& _sink;
+	char _buffer[_json::write_buffer_size];
+	std::size_t _size;
+	int _depth;
+	bool _has_elements[_json::max_depth + 1];
+	bool _after_key;
+
+
+	// Makes room for size bytes in the buffer.
+	void reserve(std::size_t size) {
+		if(_size + size > sizeof(_buffer)) {
+			flush();
+		}
+	}
+
+	void put(char c) {
+		reserve(1);
+		_buffer[_size++] = c;
+	}
+
+	void put(const char* data, std::size_t size) {
+		reserve(size);
+		if(size > sizeof(_buffer)) {
+			_sink.write(data, size);
+			return;
+		}
+		std::memcpy(_buffer + _size, data, size);
+		_size += size;
+	}
+
+	// Writes the comma before an element, unless it is the value of a key
+	// or the first element of an object or array.
+	void separate() {
+		if(_after_key) {
+			_after_key = false;
+		} else if(_has_elements[_depth]) {
+			put(',');
+		}
+		_has_elements[_depth] = true;
+	}
+
+	bool open(char c) {
+		if(_depth == _json::max_depth) {
+			return false;
+		}
+		separate();
+		put(c);
+		_has_elements[++_depth] = false;
+		return true;
+	}
+
+	void close(char c) {
+		_depth--;
+		put(c);
+	}
+
+
+	void put_string(const char* text, std::size_t length) {
+		static const char hex[] = "0123456789abcdef";
+		put('"');
+		std::size_t run = 0; // Start of the bytes that don't need escaping
+		for(std::size_t i = 0; i < length; i++) {
+			const unsigned char c = (unsigned char)text[i];
+			if(c >= 0x20  &&  c != '"'  &&  c != '\\') {
+				continue;
+			}
+			put(text + run, i - run);
+			run = i + 1;
+			if(c == '"'  ||  c == '\\') {
+				const char escape[2] = { '\\', char(c) };
+				put(escape, 2);
+			} else {
+				const char escape[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF] };
+				put(escape, 6);
+			}
+		}
+		put(text + run, length - run);
+		put('"');
+	}
+
+	void put_integer(long long value) {
+		put_integer(value < 0 ? 0 - (unsigned long long)value : (unsigned long long)value, value < 0);
+	}
+
+	void put_integer(unsigned long long magnitude, bool negative = false) {
+		char digits[24];
+		char* p = digits + sizeof(digits);
+		do {
+			*--p = char('0' + magnitude % 10);
+			magnitude /= 10;
+		} while(magnitude > 0);
+		if(negative) {
+			*--p = '-';
+		}
+		put(p, digits + sizeof(digits) - p);
+	}
+
+	void put_number(double value) {
+		if(value != value  ||  value == HUGE_VAL  ||  value == -HUGE_VAL) {
+			put("null", 4);
+			return;
+		}
+		if(value == 0  &&  std::signbit(value)) {
+			put("-0", 2);
+			return;
+		}
+		if(value == std::floor(value)  &&  std::fabs(value) < 1e15) {
+			put_integer((long long)value);
+			return;
+		}
+		if(put_decimal(value)) {
+			return;
+		}
+		const std::size_t max_length = 32;
+		reserve(max_length);
+		char* const text = _buffer + _size;
+		int length = std::snprintf(text, max_length, "%.15g", value);
+		if(std::strtod(text, nullptr) != value) {
+			length = std::snprintf(text, max_length, "%.17g", value);
+		}
+		_size += std::size_t(length);
+	}
+
+	// Writes a value with the fewest decimals d such that value is the double
+	// nearest to m / 10^d for an integer m. As the division is correctly
+	// rounded, like the conversion when the number is read, it reads back as
+	// the same value. Fails for values that need more than 15 significant
+	// digits or an exponent.
+	bool put_decimal(double value) {
+		const double magnitude = std::fabs(value);
+		if(magnitude < 1e-5  ||  magnitude >= 1e15) {
+			return false;
+		}
+		for(int d = 1; d <= 20  &&  magnitude * _json::exact_powers_of_ten[d] < 1e15; d++) {
+			const double m = std::floor(magnitude * _json::exact_powers_of_ten[d] + 0.5);
+			if(m / _json::exact_powers_of_ten[d] != magnitude) {
+				continue;
+			}
+
+			char digits[24];
+			char* const end = digits + sizeof(digits);
+			char* p = end;
+			for(unsigned long long n = (unsigned long long)m; n > 0  ||  end - p <= d; n /= 10) {
+				if(end - p == d) {
+					*--p = '.';
+				}
+				*--p = char('0' + n % 10);
+			}
+			if(value < 0) {
+				*--p = '-';
+			}
+			put(p, end - p);
+			return true;
+		}
+		return false;
+	}
+
+	template <typename T>
+	void put_value(T value, std::true_type) {
+		put_integer(_json::widest<T>(value));
+	}
+
+	template <typename T>
+	void put_value(T value, std::false_type) {
+		put_number(double(value));
+	}
+};
+
+
+} /* namespace si::json */
+
+
+} /* namespace si */
+
+
+#endif /* SI_JSON_HPP_ */
@@ -0,0 +1,380 @@
+#ifndef SI_MATRIX_HPP_
+#define SI_MATRIX_HPP_
+
+
+#include <cstddef>
+#include <cmath>
+#include <ratio>
+#include <type_traits>
+#include "int_list.hpp"
+#include "si_value.hpp"
+
+
+namespace si {
+
+
+/// A list of dimension vectors (@c int_list types), one per matrix row or column.
+template <typename... DimensionsLists>
+struct dimensions_lists {
+	static const std::size_t size = sizeof...(DimensionsLists);
+};
+
+
+template <std::size_t Index, typename DimensionsListsPack>
+struct dimensions_lists_at;
+
+template <std::size_t Index, typename HeadList, typename... TailLists>
+struct dimensions_lists_at<Index, dimensions_lists<HeadList, TailLists...>> {
+	typedef typename dimensions_lists_at<Index - 1, dimensions_lists<TailLists...>>::type type;
+};
+
+template <typename HeadList, typename... TailLists>
+struct dimensions_lists_at<0, dimensions_lists<HeadList, TailLists...>> {
+	typedef HeadList type;
+};
+
+
+/// Builds a @c dimensions_lists type from the units of SI value types.
+/**
+ * For instance, the units of a position/velocity state vector can be given as:
+ * @code
+ *   typedef ::si::dimensions_lists_of<Length_m, Speed_m_s>::type StateUnits;
+ * @endcode
+ */
+template <typename... SIValueTypes>
+struct dimensions_lists_of {
+	typedef dimensions_lists<typename SIValueTypes::DimensionsList...> type;
+};
+
+
+
+/**
+ * @brief A dense matrix whose elements have per-row and per-column units.
+ *
+ * @details The element at row @a i and column @a j has the unit
+ * <tt>RowUnits[i] / ColUnits[j]</tt>, so a product <tt>A * B</tt> is only
+ * well-formed when the column units of @c A are the row units of @c B. A
+ * column vector of quantities @c X is a <tt>matrix<X, D></tt> where @c D holds
+ * a single dimensionless entry (see @c column_vector).
+ *
+ * All elements are stored as @c double values in base units (ratio 1) in a
+ * single contiguous, row-major and cache-line aligned array.
+ *
+ * @tparam RowUnits A @c dimensions_lists type with the units of the rows.
+ * @tparam ColUnits A @c dimensions_lists type with the units of the columns.
+ */
+template <typename RowUnits, typename ColUnits>
+class matrix {
+public:
+	typedef RowUnits RowUnitsList;
+	typedef ColUnits ColUnitsList;
+
+	/// Number of rows.
+	static const std::size_t rows = RowUnits::size;
+	/// Number of columns.
+	static const std::size_t cols = ColUnits::size;
+
+	static_assert(rows > 0  &&  cols > 0, "A matrix must have at least one row and one column");
+
+
+	/// Provides the SI value type of the element at row @c Row and column @c Col.
+	template <std::size_t Row, std::size_t Col>
+	struct element {
+	private:
+		typedef typename dimensions_lists_at<Row, RowUnits>::type _RowDimensions;
+		typedef typename dimensions_lists_at<Col, ColUnits>::type _ColDimensions;
+		typedef typename int_list_subtract<_RowDimensions, _ColDimensions>::type _DimensionsList;
+
+	public:
+		/// The element type.
+		typedef typename make_value<double, ::std::ratio<1>, _DimensionsList>::type type;
+	};
+
+
+	/// Default constructor. All elements are zero.
+	matrix() : _data() {}
+
+
+	/// Returns the element at row @c Row and column @c Col.
+	template <std::size_t Row, std::size_t Col>
+	typename element<Row, Col>::type get() const {
+		static_assert(Row < rows  &&  Col < cols, "Element out of range");
+		return typename element<Row, Col>::type(_data[Row * cols + Col]);
+	}
+
+	/// Sets the element at row @c Row and column @c Col.
+	/**
+	 * The value is converted according to the ratios and the underlying types.
+	 * It can only be set from a value of the same unit.
+	 */
+	template <std::size_t Row, std::size_t Col, typename SIValueType>
+	void set(const SIValueType& v) {
+		static_assert(Row < rows  &&  Col < cols, "Element out of range");
+		const typename element<Row, Col>::type converted = v;
+		_data[Row * cols + Col] = converted.value;
+	}
+
+
+	/// Raw access to an element, in base units.
+	double& operator()(std::size_t row, std::size_t col) {
+		return _data[row * cols + col];
+	}
+
+	/// Raw access to an element, in base units.
+	const double& operator()(std::size_t row, std::size_t col) const {
+		return _data[row * cols + col];
+	}
+
+	/// The row-major array with all the elements, in base units.
+	double* data() {
+		return _data;
+	}
+
+	/// The row-major array with all the elements, in base units.
+	const double* data() const {
+		return _data;
+	}
+
+private:
+	alignas(64) double _data[rows * cols];
+};
+
+
+template <typename RowUnits, typename ColUnits>
+const std::size_t matrix<RowUnits, ColUnits>::rows;
+
+template <typename RowUnits, typename ColUnits>
+const std::size_t matrix<RowUnits, ColUnits>::cols;
+
+
+
+/// Provides the type of a column vector with the given row units.
+template <typename RowUnits>
+struct column_vector {
+private:
+	typedef typename dimensions_lists_at<0, RowUnits>::type _FirstDimensions;
+	typedef typename int_list_subtract<_FirstDimensions, _FirstDimensions>::type _Dimensionless;
+
+public:
+	typedef matrix<RowUnits, dimensions_lists<_Dimensionless>> type;
+};
+
+
+
+namespace _matrix {
+
+
+// Edge of the square tiles of the LU factorization, and width of the strips
+// of columns of the multiplication.
+const std::size_t block_size = 32;
+
+
+inline std::size_t min(std::size_t a, std::size_t b) {
+	return a < b ? a : b;
+}
+
+
+// The columns j0 to j0 + W of c[N×M] = a[N×K] * b[K×M], all row-major. Each
+// row of them is accumulated in a local array over the whole inner dimension,
+// with loops of constant length: as the array can't alias the operands, they
+// are unrolled and vectorized, and the row is stored once. The alignment also
+// works around GCC 12 emitting aligned AVX-512 stores to the array at a
+// misaligned address.
+template <std::size_t N, std::size_t K, std::size_t M, std::size_t W>
+void multiply_columns(const double* a, const double* b, double* c, std::size_t j0) {
+	for(std::size_t i = 0; i < N; i++) {
+		alignas(64) double row[W];
+		const double* const a_row = a + i * K;
+		for(std::size_t j = 0; j < W; j++) {
+			row[j] = a_row[0] * b[j0 + j];
+		}
+		for(std::size_t k = 1; k < K; k++) {
+			const double a_ik = a_row[k];
+			const double* const b_row = b + k * M + j0;
+			for(std::size_t j = 0; j < W; j++) {
+				row[j] += a_ik * b_row[j];
+			}
+		}
+		for(std::size_t j = 0; j < W; j++) {
+			c[i * M + j0 + j] = row[j];
+		}
+	}
+}
+
+
+// c[N×M] = a[N×K] * b[K×M], all row-major, by strips of block_size columns.
+template <std::size_t N, std::size_t K, std::size_t M>
+void multiply(const double* a, const double* b, double* c) {
+	const std::size_t tail = M % block_size;
+	std::size_t j0 = 0;
+	for(; j0 + block_size <= M; j0 += block_size) {
+		multiply_columns<N, K, M, block_size>(a, b, c, j0);
+	}
+	if(tail != 0) {
+		multiply_columns<N, K, M, tail == 0 ? 1 : tail>(a, b, c, j0);
+	}
+}
+
+
+// In-place LU factorization with partial pivoting of a[N×N], row-major.
+// The permutation applied to the rows is stored in perm. Returns false if the
+// matrix is singular.
+template <std::size_t N>
+bool lu_factorize(double* a, std::size_t* perm) {
+	for(std::size_t i = 0; i < N; i++) {
+		perm[i] = i;
+	}
+
+	for(std::size_t k0 = 0; k0 < N; k0 += block_size) {
+		const std::size_t k1 = min(k0 + block_size, N);
+
+		// Factorizes the panel formed by the columns [k0, k1).
+		for(std::size_t k = k0; k < k1; k++) {
+			std::size_t pivot = k;
+			for(std::size_t i = k + 1; i < N; i++) {
+				if(std::fabs(a[i * N + k]) > std::fabs(a[pivot * N + k])) {
+					pivot = i;
+				}
+			}
+			if(a[pivot * N + k] == 0.0) {
+				return false;
+			}
+			if(pivot != k) {
+				for(std::size_t j = 0; j < N; j++) {
+					const double tmp = a[k * N + j];
+					a[k * N + j] = a[pivot * N + j];
+					a[pivot * N + j] = tmp;
+				}
+				const std::size_t tmp = perm[k];
+				perm[k] = perm[pivot];
+				perm[pivot] = tmp;
+			}
+
+			const double inv_pivot = 1.0 / a[k * N + k];
+			for(std::size_t i = k + 1; i < N; i++) {
+				const double l_ik = a[i * N + k] *= inv_pivot;
+				for(std::size_t j = k + 1; j < k1; j++) {
+					a[i * N + j] -= l_ik * a[k * N + j];
+				}
+			}
+		}
+
+		// Computes the U12 block: the rows [k0, k1) right of the panel.
+		for(std::size_t k = k0; k < k1; k++) {
+			for(std::size_t i = k + 1; i < k1; i++) {
+				const double l_ik = a[i * N + k];
+				for(std::size_t j = k1; j < N; j++) {
+					a[i * N + j] -= l_ik * a[k * N + j];
+				}
+			}
+		}
+
+		// Updates the trailing submatrix: A22 -= L21 * U12.
+		for(std::size_t i = k1; i < N; i++) {
+			double* const a_row = a + i * N;
+			for(std::size_t k = k0; k < k1; k++) {
+				const double l_ik = a_row[k];
+				const double* const u_row = a + k * N;
+				for(std::size_t j = k1; j < N; j++) {
+					a_row[j] -= l_ik * u_row[j];
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+
+// Solves L*U*x = P*b for the M right-hand sides in b[N×M], row-major, given the
+// output of lu_factorize. The solution is stored in x[N×M].
+template <std::size_t N, std::size_t M>
+void lu_solve(const double* lu, const std::size_t* perm, const double* b, double* x) {
+	for(std::size_t i = 0; i < N; i++) {
+		for(std::size_t j = 0; j < M; j++) {
+			x[i * M + j] = b[perm[i] * M + j];
+		}
+	}
+
+	for(std::size_t i = 0; i < N; i++) {
+		double* const x_row = x + i * M;
+		for(std::size_t k = 0; k < i; k++) {
+			const double l_ik = lu[i * N + k];
+			const double* const x_k = x + k * M;
+			for(std::size_t j = 0; j < M; j++) {
+				x_row[j] -= l_ik * x_k[j];
+			}
+		}
+	}
+
+	for(std::size_t i = N; i-- > 0; ) {
+		double* const x_row = x + i * M;
+		for(std::size_t k = i + 1; k < N; k++) {
+			const double u_ik = lu[i * N + k];
+			const double* const x_k = x + k * M;
+			for(std::size_t j = 0; j < M; j++) {
+				x_row[j] -= u_ik * x_k[j];
+			}
+		}
+		const double inv_diagonal = 1.0 / lu[i * N + i];
+		for(std::size_t j = 0; j < M; j++) {
+			x_row[j] *= inv_diagonal;
+		}
+	}
+}
+
+
+} /* namespace si::_matrix */
+
+
+
+/// Multiplies two matrices.
+/**
+ * The column units of the left operand must be the row units of the right
+ * operand.
+ *
+ * @return A matrix with the row units of the left operand and the column units
+ *         of the right operand.
+ * @relates matrix
+ */
+template <typename RowUnits, typename InnerUnits, typename ColUnits>
+matrix<RowUnits, ColUnits>
+operator*(const matrix<RowUnits, InnerUnits>& a, const matrix<InnerUnits, ColUnits>& b) {
+	matrix<RowUnits, ColUnits> c;
+	_matrix::multiply<RowUnits::size, InnerUnits::size, ColUnits::size>(a.data(), b.data(), c.data());
+	return c;
+}
+
+
+/// Solves the linear system <tt>A * X = B</tt>.
+/**
+ * @c A must be square. The solution @c X has the column units of @c A as its
+ * row units and the column units of @c B as its column units.
+ *
+ * @return @c false if @c A is singular, in which case @c x is left unchanged.
+ * @relates matrix
+ */
+template <typename RowUnits, typename InnerUnits, typename ColUnits>
+bool solve(const matrix<RowUnits, InnerUnits>& a,
+           const matrix<RowUnits, ColUnits>& b,
+           matrix<InnerUnits, ColUnits>& x)
+{
+	static const std::size_t N = RowUnits::size;
+	static const std::size_t M = ColUnits::size;
+	static_assert(N == InnerUnits::size, "The matrix must be square");
+
+	matrix<RowUnits, InnerUnits> lu = a;
+	std::size_t perm[N];
+	if(!_matrix::lu_factorize<N>(lu.data(), perm)) {
+		return false;
+	}
+
+	_matrix::lu_solve<N, M>(lu.data(), perm, b.data(), x.data());
+	return true;
+}
+
+
+} /* namespace si */
+
+
+#endif /* SI_MATRIX_HPP_ */
@@ -0,0 +1,415 @@
+#ifndef SI_ODE_HPP_
+#define SI_ODE_HPP_
+
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include "batch.hpp"
+#include "dimension_code.hpp"
+#include "int_list.hpp"
+#include "operations.hpp"
+#include "si_value.hpp"
+
+
+namespace si {
+
+
+namespace _ode {
+
+
+// The number of independent systems in a value of the state: one, or one per
+// lane of a batch.
+template <typename V>
+struct lanes {
+	static const std::size_t count = 1;
+
+	static double get(const V& v, std::size_t) {
+		return double(v);
+	}
+};
+
+template <typename T, std::size_t N>
+struct lanes<batch<T, N>> {
+	static const std::size_t count = N;
+
+	static double get(const batch<T, N>& b, std::size_t i) {
+		return double(b.v[i]);
+	}
+};
+
+
+// The underlying type of all the quantities of a state.
+template <typename... Quantities>
+struct common_value_type;
+
+template <typename Quantity>
+struct common_value_type<Quantity> {
+	typedef typename Quantity::ValueType type;
+};
+
+template <typename Quantity, typename... Quantities>
+struct common_value_type<Quantity, Quantities...> {
+	typedef typename Quantity::ValueType type;
+	static_assert(std::is_same<type, typename common_value_type<Quantities...>::type>::value,
+	              "All the quantities of a state must have the same underlying type");
+};
+
+
+// The underlying values of a state, in the ratios of its quantities. They are
+// contiguous and aligned, so the loops over them are vectorized.
+template <typename V, std::size_t N>
+struct flat {
+	alignas(32) V v[N];
+};
+
+
+// The type of the rate of Quantity over Time, which the derivative function
+// must return for it in any ratio.
+template <typename Rate, typename Quantity, typename Time>
+struct rate {
+	typedef typename division<Quantity, Time>::type type;
+	static_assert(std::remove_cv<typename std::remove_reference<Rate>::type>::type::Dimensions == type::Dimensions,
+	              "The derivative function must return the rate over time of each quantity of the state");
+};
+
+
+// The conversions between a state and its underlying values, and the
+// evaluation of the derivative function on the underlying values.
+template <typename Time, typename... Quantities>
+struct system {
+	static_assert(std::is_floating_point<typename Time::ValueType>::value,
+	              "The time must have a floating point underlying type");
+
+	typedef std::tuple<Quantities...> state;
+	typedef flat<typename common_value_type<Quantities...>::type, sizeof...(Quantities)> raw;
+	typedef typename make_index_list<sizeof...(Quantities)>::type indices;
+
+	template <std::size_t... I>
+	static state unpack(const raw& y, index_list<I...>) {
+		return state(Quantities(y.v[I])...);
+	}
+
+	static state unpack(const raw& y) {
+		return unpack(y, indices());
+	}
+
+	template <std::size_t... I>
+	static void pack(const state& s, raw& y, index_list<I...>) {
+		const int expand[] = { (y.v[I] = std::get<I>(s).value, 0)... };
+		(void)expand;
+	}
+
+	static void pack(const state& s, raw& y) {
+		pack(s, y, indices());
+	}
+
+	// The rates in the ratios of the quantities over the ratio of the time.
+	template <typename F, std::size_t... I>
+	static void rates(const F& f, double t, const raw& y, raw& k, index_list<I...>) {
+		const auto r = f(Time(t), unpack(y));
+		static_assert(std::tuple_size<typename std::remove_const<decltype(r)>::type>::value == sizeof...(Quantities),
+		              "The derivative function must return a rate for each quantity of the state");
+		const int expand[] = {
+			(k.v[I] = typename rate<decltype(std::get<I>(r)), Quantities, Time>::type(std::get<I>(r)).value, 0)...
+		};
+		(void)expand;
+	}
+
+	template <typename F>
+	static void rates(const F& f, double t, const raw& y, raw& k) {
+		rates(f, t, y, k, indices());
+	}
+};
+
+
+// h (a[0] k[0] + ... + a[S - 1] k[S - 1]), value by value.
+template <typename V, std::size_t N, std::size_t S>
+void weighted_sum(double h, const double (&a)[S], const flat<V, N>* const (&k)[S], flat<V, N>& out) {
+	for(std::size_t j = 0; j < N; j++) {
+		V sum = k[0]->v[j] * a[0];
+		for(std::size_t s = 1; s < S; s++) {
+			sum += k[s]->v[j] * a[s];
+		}
+		out.v[j] = sum * h;
+	}
+}
+
+// y + h (a[0] k[0] + ... + a[S - 1] k[S - 1]), value by value. out may be y.
+template <typename V, std::size_t N, std::size_t S>
+void combine(const flat<V, N>& y, double h, const double (&a)[S], const flat<V, N>* const (&k)[S], flat<V, N>& out) {
+	for(std::size_t j = 0; j < N; j++) {
+		V sum = k[0]->v[j] * a[0];
+		for(std::size_t s = 1; s < S; s++) {
+			sum += k[s]->v[j] * a[s];
+		}
+		out.v[j] = y.v[j] + sum * h;
+	}
+}
+
+
+// The root mean square of the errors of a system, each relative to its
+// absolute tolerance plus the relative tolerance times the larger magnitude
+// of the value before and after the step. The largest over the systems of a
+// batch, and NaN if any is NaN.
+template <typename V, std::size_t N>
+double error_norm(const flat<V, N>& error, const flat<V, N>& y, const flat<V, N>& next,
+                  const flat<V, N>& absolute, double relative)
+{
+	typedef lanes<V> L;
+	double norm = 0;
+	for(std::size_t l = 0; l < L::count; l++) {
+		double sum = 0;
+		for(std::size_t j = 0; j < N; j++) {
+			const double before = std::fabs(L::get(y.v[j], l));
+			const double after = std::fabs(L::get(next.v[j], l));
+			const double e = L::get(error.v[j], l) / (L::get(absolute.v[j], l) + relative * (before < after ? after : before));
+			sum += e * e;
+		}
+		if(!(sum / N <= norm)) {
+			norm = sum / N;
+		}
+	}
+	return std::sqrt(norm);
+}
+
+
+struct ignore {
+	template <typename Time, typename State>
+	void operator()(const Time&, const State&) const {}
+};
+
+
+} /* namespace si::_ode */
+
+
+
+/**
+ * @brief Integration of systems of ordinary differential equations over SI values.
+ *
+ * @details The state of a system is a tuple of quantities, like a position,
+ * a speed and a temperature. The derivative function takes the time and the
+ * state, and returns the rate over time of each quantity:
+ * @code
+ *   struct spring {
+ *       template <typename T>
+ *       std::tuple<si::Speed_m_s<T>, si::Acceleration_m_s2<T>>
+ *       operator()(si::Time_s<double> t, const std::tuple<si::Length_m<T>, si::Speed_m_s<T>>& y) const {
+ *           return std::make_tuple(std::get<1>(y), -stiffness / mass * std::get<0>(y));
+ *       }
+ *   };
+ *   const auto y = si::ode::rk4(spring(), std::make_tuple(x0, v0), t0, t1, dt);
+ * @endcode
+ *
+ * The dimensions of the rates are checked at compile time, and they may have
+ * any ratio (a position in m may have a rate in km/h). The integrators store
+ * the state as an aligned array of its underlying values, so the steps are
+ * loops over plain values.
+ *
+ * The quantities must all have the same underlying type. With a @c batch as
+ * the underlying type, each lane is an independent system, and the systems
+ * are integrated together: a derivative function written as a template on
+ * the underlying type evaluates all of them with vector instructions. The
+ * time is shared by the systems. Batches of 8 or 16 doubles are the fastest
+ * per system, as larger ones don't fit in the vector registers.
+ */
+namespace ode {
+
+
+/// The result of an integration with an adaptive step.
+template <typename Time, typename... Quantities>
+struct solution {
+	/// The state at the end, or where the integration stopped.
+	std::tuple<Quantities...> state;
+
+	/// The time of the state.
+	Time time;
+
+	/// The number of steps taken.
+	std::size_t steps;
+
+	/// The number of steps rejected because their error was too large.
+	std::size_t rejected;
+
+	/// Whether the integration reached the end. If not, the step became too
+	/// small for the resolution of the time, which happens at a singularity
+	/// or when the derivative function returns NaN.
+	bool completed;
+};
+
+
+/// The state at @c t1, by the classical Runge-Kutta method of order 4.
+/**
+ * The integration takes equal steps no longer than @c dt from @c t0 to
+ * @c t1, and calls <tt>observer(t, state)</tt> after each of them.
+ */
+template <typename F, typename Time, typename... Quantities, typename Observer>
+std::tuple<Quantities...> rk4(const F& f, const std::tuple<Quantities...>& y0, const Time& t0, const Time& t1,
+                              const Time& dt, Observer observer)
+{
+	typedef _ode::system<Time, Quantities...> System;
+	typedef typename System::raw Raw;
+
+	Raw y, k1, k2, k3, k4, stage;
+	System::pack(y0, y);
+	const double span = t1.value - t0.value;
+	const std::size_t steps = span > 0 ? std::size_t(std::ceil(span / dt.value)) : 0;
+	const double h = span / steps;
+
+	const double one[] = { 1 };
+	const double weights[] = { 1, 2, 2, 1 };
+	for(std::size_t i = 0; i < steps; i++) {
+		const double t = t0.value + h * i;
+		System::rates(f, t, y, k1);
+		const Raw* const after1[] = { &k1 };
+		_ode::combine(y, h / 2, one, after1, stage);
+		System::rates(f, t + h / 2, stage, k2);
+		const Raw* const after2[] = { &k2 };
+		_ode::combine(y, h / 2, one, after2, stage);
+		System::rates(f, t + h / 2, stage, k3);
+		const Raw* const after3[] = { &k3 };
+		_ode::combine(y, h, one, after3, stage);
+		System::rates(f, t + h, stage, k4);
+		const Raw* const all[] = { &k1, &k2, &k3, &k4 };
+		_ode::combine(y, h / 6, weights, all, y);
+		observer(i + 1 == steps ? t1 : Time(t0.value + h * (i + 1)), System::unpack(y));
+	}
+	return System::unpack(y);
+}
+
+/// The state at @c t1, by the classical Runge-Kutta method of order 4.
+template <typename F, typename Time, typename... Quantities>
+std::tuple<Quantities...> rk4(const F& f, const std::tuple<Quantities...>& y0, const Time& t0, const Time& t1,
+                              const Time& dt)
+{
+	return rk4(f, y0, t0, t1, dt, _ode::ignore());
+}
+
+
+/// The state at @c t1, by the Dormand-Prince method of order 5 with an adaptive step.
+/**
+ * Each step is accepted when the root mean square of the estimated errors of
+ * the quantities, each relative to <tt>absolute + relative * |value|</tt>, is
+ * at most 1, and the next step is adjusted from it. The first step is
+ * estimated from the state and its rates. The last rates of a step are the
+ * first of the next one, so an accepted step takes 6 evaluations of the
+ * derivative function.
+ *
+ * For a batch of systems, the step is chosen for the system with the largest
+ * error.
+ *
+ * @param relative The relative tolerance.
+ * @param absolute The absolute tolerance of each quantity.
+ * @param observer Called as <tt>observer(t, state)</tt> after each accepted step.
+ */
+template <typename F, typename Time, typename... Quantities, typename Observer>
+solution<Time, Quantities...> dormand_prince(const F& f, const std::tuple<Quantities...>& y0, const Time& t0,
+                                             const Time& t1, double relative,
+                                             const std::tuple<Quantities...>& absolute, Observer observer)
+{
+	typedef _ode::system<Time, Quantities...> System;
+	typedef typename System::raw Raw;
+
+	static const double c2 = 1.0 / 5, c3 = 3.0 / 10, c4 = 4.0 / 5, c5 = 8.0 / 9;
+	static const double a2[] = { 1.0 / 5 };
+	static const double a3[] = { 3.0 / 40, 9.0 / 40 };
+	static const double a4[] = { 44.0 / 45, -56.0 / 15, 32.0 / 9 };
+	static const double a5[] = { 19372.0 / 6561, -25360.0 / 2187, 64448.0 / 6561, -212.0 / 729 };
+	static const double a6[] = { 9017.0 / 3168, -355.0 / 33, 46732.0 / 5247, 49.0 / 176, -5103.0 / 18656 };
+	// The solution of order 5, without k2 whose weight is 0
+	static const double b[] = { 35.0 / 384, 500.0 / 1113, 125.0 / 192, -2187.0 / 6784, 11.0 / 84 };
+	// The difference with the solution of order 4, without k2
+	static const double e[] = {
+		71.0 / 57600, -71.0 / 16695, 71.0 / 1920, -17253.0 / 339200, 22.0 / 525, -1.0 / 40
+	};
+
+	Raw y, next, k1, k2, k3, k4, k5, k6, k7, stage, error, tolerance;
+	System::pack(y0, y);
+	System::pack(absolute, tolerance);
+
+	solution<Time, Quantities...> result = { y0, t0, 0, 0, true };
+	double t = t0.value;
+	const double end = t1.value;
+	if(!(t < end)) {
+		return result;
+	}
+
+	// A step for which the explicit Euler method changes the state by 1% of
+	// its magnitude, as in Hairer, Nørsett and Wanner.
+	System::rates(f, t, y, k1);
+	const double d0 = _ode::error_norm(y, y, y, tolerance, relative);
+	const double d1 = _ode::error_norm(k1, y, y, tolerance, relative);
+	double h = d0 < 1e-5  ||  d1 < 1e-5 ? 1e-6 * (end - t) : 0.01 * d0 / d1;
+
+	const Raw* const s2[] = { &k1 };
+	const Raw* const s3[] = { &k1, &k2 };
+	const Raw* const s4[] = { &k1, &k2, &k3 };
+	const Raw* const s5[] = { &k1, &k2, &k3, &k4 };
+	const Raw* const s6[] = { &k1, &k2, &k3, &k4, &k5 };
+	const Raw* const sb[] = { &k1, &k3, &k4, &k5, &k6 };
+	const Raw* const se[] = { &k1, &k3, &k4, &k5, &k6, &k7 };
+	while(t < end) {
+		const bool last = h >= end - t;
+		if(last) {
+			h = end - t;
+		}
+		if(!(h > 16 * std::numeric_limits<double>::epsilon() * std::fabs(t))) {
+			result.completed = false;
+			break;
+		}
+
+		_ode::combine(y, h, a2, s2, stage);
+		System::rates(f, t + c2 * h, stage, k2);
+		_ode::combine(y, h, a3, s3, stage);
+		System::rates(f, t + c3 * h, stage, k3);
+		_ode::combine(y, h, a4, s4, stage);
+		System::rates(f, t + c4 * h, stage, k4);
+		_ode::combine(y, h, a5, s5, stage);
+		System::rates(f, t + c5 * h, stage, k5);
+		_ode::combine(y, h, a6, s6, stage);
+		System::rates(f, t + h, stage, k6);
+		_ode::combine(y, h, b, sb, next);
+		System::rates(f, t + h, next, k7);
+		_ode::weighted_sum(h, e, se, error);
+
+		// The next step is scaled by 0.9 / norm^(1/5), within [0.2, 5].
+		const double norm = _ode::error_norm(error, y, next, tolerance, relative);
+		if(norm <= 1) {
+			t = last ? end : t + h;
+			y = next;
+			k1 = k7;
+			result.steps++;
+			observer(Time(t), System::unpack(y));
+			const double grow = norm > 0 ? 0.9 * std::pow(norm, -0.2) : 5;
+			h *= grow < 5 ? grow : 5;
+		} else {
+			result.rejected++;
+			const double shrink = 0.9 * std::pow(norm, -0.2);
+			h *= shrink > 0.2 ? shrink : 0.2;
+		}
+	}
+
+	result.state = System::unpack(y);
+	result.time = Time(t);
+	return result;
+}
+
+/// The state at @c t1, by the Dormand-Prince method of order 5 with an adaptive step.
+template <typename F, typename Time, typename... Quantities>
+solution<Time, Quantities...> dormand_prince(const F& f, const std::tuple<Quantities...>& y0, const Time& t0,
+                                             const Time& t1, double relative,
+                                             const std::tuple<Quantities...>& absolute)
+{
+	return dormand_prince(f, y0, t0, t1, relative, absolute, _ode::ignore());
+}
+
+
+} /* namespace si::ode */
+
+
+} /* namespace si */
+
+
+#endif /* SI_ODE_HPP_ */
@@ -2,10 +2,12 @@
 #define SI_OPERATIONS_HPP_
 
 
-#include <ratio>
 #include <cmath>
+#include <cstdint>
+#include <ratio>
+#include <type_traits>
+#include "dimension_code.hpp"
 #include "forward.hpp"
-#include "int_list.hpp"
 
 
 namespace si {
@@ -29,25 +31,21 @@ public:
 };
 
 
-template <typename ValueType1, typename Ratio1, int... Dimensions1,
-          typename ValueType2, typename Ratio2, int... Dimensions2>
-struct addition<SIValue<ValueType1, Ratio1, Dimensions1...>,
-                SIValue<ValueType2, Ratio2, Dimensions2...>>
+template <typename ValueType1, typename Ratio1, dimension_code Dimensions1,
+          typename ValueType2, typename Ratio2, dimension_code Dimensions2>
+struct addition<SIValue<ValueType1, Ratio1, Dimensions1>,
+                SIValue<ValueType2, Ratio2, Dimensions2>>
 {
 private:
-	static_assert(std::is_same<int_list<Dimensions1...>,
-	                           int_list<Dimensions2...>>::value,
-	              "The units must be the same on the addition");
+	static_assert(Dimensions1 == Dimensions2, "The units must be the same on the addition");
 
 	typedef typename addition<ValueType1, ValueType2>::type _NewValueType;
 	static const unsigned int _new_num = 1;
 	static const unsigned int _new_den = std::ratio_add<Ratio1, Ratio2>::type::den;
 	typedef std::ratio<_new_num, _new_den> _NewRatio;
 
-	typedef int_list<Dimensions1...> _NewDimensionsList;
-
 public:
-	typedef typename make_value<_NewValueType, _NewRatio, _NewDimensionsList>::type type;
+	typedef SIValue<_NewValueType, _NewRatio, Dimensions1> type;
 };
 
 
@@ -62,6 +60,7 @@ public:
  * @code
  *   typedef typename ::si::multiplication<Length_cm, Area_cm2>::type Volume_cm3;
  * @endcode
+ * In C++20, the same type is also <tt>::si::unit<"cm³", int></tt> (see @c unit).
  */
 template <typename T1, typename T2>
 struct multiplication {
@@ -79,21 +78,17 @@ public:
 
 
 
-template <typename ValueType1, typename Ratio1, int... Dimensions1,
-          typename ValueType2, typename Ratio2, int... Dimensions2>
-struct multiplication<SIValue<ValueType1, Ratio1, Dimensions1...>,
-                      SIValue<ValueType2, Ratio2, Dimensions2...>>
+template <typename ValueType1, typename Ratio1, dimension_code Dimensions1,
+          typename ValueType2, typename Ratio2, dimension_code Dimensions2>
+struct multiplication<SIValue<ValueType1, Ratio1, Dimensions1>,
+                      SIValue<ValueType2, Ratio2, Dimensions2>>
 {
 private:
 	typedef typename multiplication<ValueType1, ValueType2>::type _NewValueType;
 	typedef typename std::ratio_multiply<Ratio1, Ratio2>::type _NewRatio;
 
-	typedef int_list<Dimensions1...> _DimensionsList1;
-	typedef int_list<Dimensions2...> _DimensionsList2;
-	typedef typename int_list_add<_DimensionsList1, _DimensionsList2>::type _NewDimensionsList;
-
 public:
-	typedef typename make_value<_NewValueType, _NewRatio, _NewDimensionsList>::type type;
+	typedef SIValue<_NewValueType, _NewRatio, add_dimensions(Dimensions1, Dimensions2)> type;
 };
 
 
@@ -114,38 +109,160 @@ struct division {
 };
 
 
-template <typename ValueType1, typename Ratio1, int... Dimensions1,
-          typename ValueType2, typename Ratio2, int... Dimensions2>
-struct division<SIValue<ValueType1, Ratio1, Dimensions1...>,
-                SIValue<ValueType2, Ratio2, Dimensions2...>>
+template <typename ValueType1, typename Ratio1, dimension_code Dimensions1,
+          typename ValueType2, typename Ratio2, dimension_code Dimensions2>
+struct division<SIValue<ValueType1, Ratio1, Dimensions1>,
+                SIValue<ValueType2, Ratio2, Dimensions2>>
 {
 private:
 	typedef typename division<ValueType1, ValueType2>::type _NewValueType;
 	typedef typename std::ratio_divide<Ratio1, Ratio2>::type _NewRatio;
 
-	typedef int_list<Dimensions1...> _DimensionsList1;
-	typedef int_list<Dimensions2...> _DimensionsList2;
-	typedef typename int_list_subtract<_DimensionsList1, _DimensionsList2>::type _NewDimensionsList;
+public:
+	typedef SIValue<_NewValueType, _NewRatio, subtract_dimensions(Dimensions1, Dimensions2)> type;
+};
+
+
+
+namespace _pow {
+
+
+// Tests if r^k <= n, for r >= 0, k >= 0 and n >= 0, without overflowing.
+constexpr bool power_at_most(std::intmax_t r, int k, std::intmax_t n) {
+	return k == 0 ? n >= 1
+	     : r == 0 ? true
+	     : power_at_most(r, k - 1, n / r);
+}
+
+// The largest r in [lo, hi] such that r^k <= n (binary search).
+constexpr std::intmax_t root_in(std::intmax_t n, int k, std::intmax_t lo, std::intmax_t hi) {
+	return lo == hi ? lo
+	     : power_at_most(lo + (hi - lo + 1) / 2, k, n) ? root_in(n, k, lo + (hi - lo + 1) / 2, hi)
+	                                                   : root_in(n, k, lo, lo + (hi - lo + 1) / 2 - 1);
+}
+
+// The integer k-th root of n >= 1, rounded down.
+constexpr std::intmax_t root(std::intmax_t n, int k) {
+	return root_in(n, k, 1, n);
+}
+
+// r^k, for r^k <= n.
+constexpr std::intmax_t power(std::intmax_t r, int k) {
+	return k == 0 ? 1 : r * power(r, k - 1);
+}
+
+constexpr bool is_exact_root(std::intmax_t n, int k) {
+	return power(root(n, k), k) == n;
+}
+
+constexpr int abs(int n) {
+	return n < 0 ? -n : n;
+}
+
+constexpr int gcd(int a, int b) {
+	return b == 0 ? a : gcd(b, a % b);
+}
+
+
+} /* namespace si::_pow */
+
+
+
+/// Raises a ratio to an integer power.
+template <typename Ratio, int N, bool _Negative = (N < 0)>
+struct ratio_power {
+private:
+	typedef typename ratio_power<Ratio, N / 2>::type _Half;
+	typedef typename std::ratio_multiply<_Half, _Half>::type _Square;
+	typedef typename std::conditional<N % 2 == 1, Ratio, std::ratio<1>>::type _Odd;
 
 public:
-	typedef typename make_value<_NewValueType, _NewRatio, _NewDimensionsList>::type type;
+	typedef typename std::ratio_multiply<_Square, _Odd>::type type;
 };
 
+template <typename Ratio>
+struct ratio_power<Ratio, 0, false> {
+	typedef std::ratio<1> type;
+};
 
+template <typename Ratio, int N>
+struct ratio_power<Ratio, N, true> {
+	typedef typename std::ratio_divide<std::ratio<1>, typename ratio_power<Ratio, -N>::type>::type type;
+};
+
+
+/// Computes the @c N-th root of a ratio, if it is exact.
+/**
+ * The root is exact when both the numerator and the denominator are perfect
+ * @c N-th powers. For instance, the square root of <tt>std::ratio<1000000></tt>
+ * is exact, but the square root of <tt>std::ratio<1000></tt> is not.
+ */
+template <typename Ratio, int N>
+struct ratio_root {
+	static_assert(N > 0, "The root index must be positive");
+
+	/// Tells if the root is exact.
+	static const bool exact = _pow::is_exact_root(Ratio::num, N)  &&  _pow::is_exact_root(Ratio::den, N);
+
+	/// The root, or <tt>std::ratio<1></tt> if it is not exact.
+	typedef typename std::conditional<exact,
+		std::ratio<_pow::root(Ratio::num, N), _pow::root(Ratio::den, N)>,
+		std::ratio<1>
+	>::type type;
+};
+
+
+
+/// Provides the return type of an SI value raised to the rational power <tt>Num/Den</tt>.
+/**
+ * The powers of the base units are multiplied by the exponent, so they must
+ * remain integers. The ratio is raised to the exponent as well when that is
+ * exact (see @c ratio_root); otherwise the result has ratio 1 and the value is
+ * scaled at runtime.
+ *
+ * The underlying type is kept for non-negative integer exponents, so integer
+ * values stay integers. Otherwise it is the type returned by @c std::sqrt for
+ * the underlying type.
+ */
+template <typename SIValue, int Num, int Den = 1>
+struct pow_function {
+	static_assert(Den > 0, "The exponent denominator must be positive");
+
+	/// The exponent numerator, in lowest terms.
+	static const int num = Num / _pow::gcd(_pow::abs(Num), Den);
+	/// The exponent denominator, in lowest terms.
+	static const int den = Den / _pow::gcd(_pow::abs(Num), Den);
+
+	static_assert(dimensions_divisible(multiply_dimensions(SIValue::Dimensions, num), den),
+	              "The base unit powers must remain integers");
+
+	/// Tells if the ratio of the result is exact.
+	static const bool exact_ratio = ratio_root<typename SIValue::Ratio, den>::exact;
 
-template <typename SIValue>
-struct sqrt_function {
 private:
 	typedef typename SIValue::ValueType _Ptr;
-	typedef decltype(sqrt(*static_cast<_Ptr*>(nullptr))) _NewValueType;
+	typedef typename std::conditional<(den == 1  &&  num >= 0),
+		_Ptr,
+		decltype(sqrt(*static_cast<_Ptr*>(nullptr)))
+	>::type _NewValueType;
 
-	typedef ::std::ratio<1> _NewRatio;
+	typedef typename ratio_root<typename SIValue::Ratio, den>::type _Root;
+	typedef typename ratio_power<_Root, num>::type _NewRatio;
 
-	typedef typename SIValue::DimensionsList _DimensionsList;
-	typedef typename int_list_half<_DimensionsList>::type _NewDimensionsList;
+	static const dimension_code _new_dimensions = divide_dimensions(multiply_dimensions(SIValue::Dimensions, num), den);
 
 public:
-	typedef typename make_value<_NewValueType, _NewRatio, _NewDimensionsList>::type type;
+	typedef ::si::SIValue<_NewValueType, _NewRatio, _new_dimensions> type;
+};
+
+
+/// Provides the return type of the square root of an SI value.
+/**
+ * @see pow_function
+ */
+template <typename SIValue>
+struct sqrt_function {
+	typedef typename pow_function<SIValue, 1, 2>::type type;
 };
 
 
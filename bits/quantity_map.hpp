@@ -0,0 +1,229 @@
+#ifndef SI_QUANTITY_MAP_HPP_
+#define SI_QUANTITY_MAP_HPP_
+
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include "hash.hpp"
+
+
+namespace si {
+
+
+/**
+ * @brief A hash map with SI values as keys, stored in a flat array.
+ *
+ * @details All the keys have the same type, so they are equal only if their
+ * underlying values are equal, and they are hashed by their underlying values
+ * without normalizing them (see @c std::hash<SIValue>). A key of another
+ * ratio or underlying type is converted to @c Key before it is looked up.
+ *
+ * The entries are stored in a single array, with open addressing and linear
+ * probing: an entry is stored at the first free slot from the position given
+ * by the hash of its key. When an entry is erased, the following entries of
+ * the same probe sequence are shifted back, so there are no tombstones and
+ * lookups never probe past an empty slot. The array has a power of two size,
+ * and grows when it is 3/4 full.
+ *
+ * Unlike @c std::unordered_map, references and pointers to the values are
+ * invalidated by insertions and erasures. The mapped type must be default
+ * constructible. A NaN key can be inserted but never found.
+ *
+ * @tparam Key The type of the keys, an SI value type.
+ * @tparam T The type of the mapped values.
+ */
+template <typename Key, typename T>
+class quantity_map {
+public:
+	typedef Key key_type;
+	typedef T mapped_type;
+
+	quantity_map() : _size(0), _mask(0) {}
+
+	/// A map with room for @c count entries before it grows.
+	explicit quantity_map(std::size_t count) : _size(0), _mask(0) {
+		reserve(count);
+	}
+
+
+	std::size_t size() const {
+		return _size;
+	}
+
+	bool empty() const {
+		return _size == 0;
+	}
+
+	/// Makes room for @c count entries, so they can be inserted without growing.
+	void reserve(std::size_t count) {
+		std::size_t capacity = min_capacity;
+		while(capacity * max_load_num < count * max_load_den) {
+			capacity *= 2;
+		}
+		if(capacity > _slots.size()) {
+			rehash(capacity);
+		}
+	}
+
+	/// Removes all the entries, keeping the allocated memory.
+	void clear() {
+		for(slot& s : _slots) {
+			s.used = false;
+		}
+		_size = 0;
+	}
+
+
+	/// Returns a pointer to the value mapped to the key, or @c nullptr if there is none.
+	T* find(const Key& key) {
+		const std::size_t i = position(key);
+		return i == npos ? nullptr : &_slots[i].value;
+	}
+
+	/// Returns a pointer to the value mapped to the key, or @c nullptr if there is none.
+	const T* find(const Key& key) const {
+		const std::size_t i = position(key);
+		return i == npos ? nullptr : &_slots[i].value;
+	}
+
+	bool contains(const Key& key) const {
+		return position(key) != npos;
+	}
+
+
+	/// Maps the key to the value, unless the key is already in the map.
+	/**
+	 * @return Whether the entry was inserted.
+	 */
+	bool insert(const Key& key, const T& value) {
+		grow_for_one();
+		std::size_t i = home(key);
+		for(; _slots[i].used; i = (i + 1) & _mask) {
+			if(_slots[i].key.value == key.value) {
+				return false;
+			}
+		}
+		_slots[i].key = key;
+		_slots[i].value = value;
+		_slots[i].used = true;
+		_size++;
+		return true;
+	}
+
+	/// Returns the value mapped to the key, inserting a default value if there is none.
+	T& operator[](const Key& key) {
+		grow_for_one();
+		std::size_t i = home(key);
+		for(; _slots[i].used; i = (i + 1) & _mask) {
+			if(_slots[i].key.value == key.value) {
+				return _slots[i].value;
+			}
+		}
+		_slots[i].key = key;
+		_slots[i].value = T();
+		_slots[i].used = true;
+		_size++;
+		return _slots[i].value;
+	}
+
+
+	/// Removes the entry of the key.
+	/**
+	 * @return Whether there was an entry.
+	 */
+	bool erase(const Key& key) {
+		std::size_t hole = position(key);
+		if(hole == npos) {
+			return false;
+		}
+
+		// Backward shift: an entry after the hole moves into it unless its home
+		// position is in the cyclic range (hole, entry], so it stays reachable.
+		for(std::size_t i = (hole + 1) & _mask; _slots[i].used; i = (i + 1) & _mask) {
+			const std::size_t h = home(_slots[i].key);
+			if(((i - h) & _mask) >= ((i - hole) & _mask)) {
+				_slots[hole] = _slots[i];
+				hole = i;
+			}
+		}
+		_slots[hole] = slot();
+		_size--;
+		return true;
+	}
+
+
+	/// Calls <tt>f(key, value)</tt> for each entry, in no particular order.
+	template <typename F>
+	void for_each(F f) const {
+		for(std::size_t i = 0; i < _slots.size(); i++) {
+			if(_slots[i].used) {
+				f(_slots[i].key, _slots[i].value);
+			}
+		}
+	}
+
+private:
+	static const std::size_t npos = std::size_t(-1);
+	static const std::size_t min_capacity = 16;
+	static const std::size_t max_load_num = 3;
+	static const std::size_t max_load_den = 4;
+
+	// The flag is next to the entry, so a probe reads a single cache line.
+	struct slot {
+		Key key;
+		T value;
+		bool used;
+
+		slot() : key(), value(), used(false) {}
+	};
+
+	std::vector<slot> _slots;
+	std::size_t _size;
+	std::size_t _mask;
+
+
+	std::size_t home(const Key& key) const {
+		return std::size_t(_hash::raw(key.value)) & _mask;
+	}
+
+	std::size_t position(const Key& key) const {
+		if(_size == 0) {
+			return npos;
+		}
+		for(std::size_t i = home(key); _slots[i].used; i = (i + 1) & _mask) {
+			if(_slots[i].key.value == key.value) {
+				return i;
+			}
+		}
+		return npos;
+	}
+
+	void grow_for_one() {
+		if((_size + 1) * max_load_den > _slots.size() * max_load_num) {
+			rehash(_slots.empty() ? min_capacity : 2 * _slots.size());
+		}
+	}
+
+	void rehash(std::size_t capacity) {
+		std::vector<slot> slots(capacity);
+		slots.swap(_slots);
+		_mask = capacity - 1;
+
+		for(std::size_t j = 0; j < slots.size(); j++) {
+			if(slots[j].used) {
+				std::size_t i = home(slots[j].key);
+				while(_slots[i].used) {
+					i = (i + 1) & _mask;
+				}
+				_slots[i] = slots[j];
+			}
+		}
+	}
+};
+
+
+} /* namespace si */
+
+
+#endif /* SI_QUANTITY_MAP_HPP_ */
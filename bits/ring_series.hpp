@@ -0,0 +1,248 @@
+#ifndef SI_RING_SERIES_HPP_
+#define SI_RING_SERIES_HPP_
+
+
+#include <atomic>
+#include <cstddef>
+#include <ratio>
+#include "si_value.hpp"
+
+
+namespace si {
+
+
+namespace _ring_series {
+
+
+// Number of independent accumulators used by the reduction kernel. Keeping
+// them in a fixed-size array lets the compiler map them to SIMD lanes.
+const std::size_t lanes = 8;
+
+
+// Accumulates the minimum, maximum and sum of n > 0 raw values.
+template <typename ValueType>
+void summarize(const ValueType* values, std::size_t n, ValueType& min, ValueType& max, double& sum) {
+	ValueType mins[lanes];
+	ValueType maxs[lanes];
+	double sums[lanes];
+	for(std::size_t l = 0; l < lanes; l++) {
+		mins[l] = values[0];
+		maxs[l] = values[0];
+		sums[l] = 0.0;
+	}
+
+	std::size_t i = 0;
+	for(; i + lanes <= n; i += lanes) {
+		for(std::size_t l = 0; l < lanes; l++) {
+			const ValueType v = values[i + l];
+			mins[l] = v < mins[l] ? v : mins[l];
+			maxs[l] = v > maxs[l] ? v : maxs[l];
+			sums[l] += v;
+		}
+	}
+	for(; i < n; i++) {
+		const ValueType v = values[i];
+		mins[0] = v < mins[0] ? v : mins[0];
+		maxs[0] = v > maxs[0] ? v : maxs[0];
+		sums[0] += v;
+	}
+
+	for(std::size_t l = 0; l < lanes; l++) {
+		min = mins[l] < min ? mins[l] : min;
+		max = maxs[l] > max ? maxs[l] : max;
+		sum += sums[l];
+	}
+}
+
+
+} /* namespace si::_ring_series */
+
+
+
+/**
+ * @brief A fixed-capacity time series of SI values.
+ *
+ * @details Samples are stored as two contiguous columns (timestamps and
+ * values) in a ring of @c Capacity entries. One producer thread can push
+ * samples while one consumer thread reads, discards and downsamples them;
+ * neither side ever blocks or takes a lock.
+ *
+ * The producer may only call @c push. Every other member function must be
+ * called from the consumer.
+ *
+ * @tparam SIValueType The type of the values.
+ * @tparam Capacity The maximum number of samples. Must be a power of two.
+ * @tparam TimeType The type of the timestamps. Must be a time value.
+ */
+template <typename SIValueType, std::size_t Capacity,
+          typename TimeType = SIValue<double, std::ratio<1>, time_dimensions>>
+class ring_series {
+	static_assert(Capacity > 0  &&  (Capacity & (Capacity - 1)) == 0, "The capacity must be a power of two");
+	static_assert(TimeType::Dimensions == time_dimensions, "The timestamps must be time values");
+
+public:
+	typedef SIValueType value_type;
+	typedef TimeType    time_type;
+
+	/// The type of the mean of a window of values.
+	typedef SIValue<double, typename SIValueType::Ratio, SIValueType::Dimensions> mean_type;
+
+	/// Summary of a window of samples, as computed by @c downsample.
+	struct window {
+		/// Timestamp of the first sample in the window.
+		time_type start;
+		/// Number of samples in the window.
+		std::size_t count;
+		value_type min;
+		value_type max;
+		mean_type mean;
+	};
+
+	static const std::size_t capacity = Capacity;
+
+
+	ring_series() : _head(0), _tail(0) {}
+
+	ring_series(const ring_series&) = delete;
+	ring_series& operator=(const ring_series&) = delete;
+
+
+	/// Appends a sample. Producer only.
+	/**
+	 * @return @c false if the series is full, in which case the sample is dropped.
+	 */
+	bool push(const time_type& time, const value_type& value) {
+		const std::size_t head = _head.load(std::memory_order_relaxed);
+		if(head - _tail.load(std::memory_order_acquire) == Capacity) {
+			return false;
+		}
+		_times[head & _mask] = time.value;
+		_values[head & _mask] = value.value;
+		_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+
+	/// Number of samples available to the consumer.
+	std::size_t size() const {
+		return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_relaxed);
+	}
+
+	bool empty() const {
+		return size() == 0;
+	}
+
+	/// Timestamp of the i-th oldest sample.
+	time_type time(std::size_t i) const {
+		return time_type(_times[(_tail.load(std::memory_order_relaxed) + i) & _mask]);
+	}
+
+	/// Value of the i-th oldest sample.
+	value_type value(std::size_t i) const {
+		return value_type(_values[(_tail.load(std::memory_order_relaxed) + i) & _mask]);
+	}
+
+
+	/// Removes the oldest sample.
+	/**
+	 * @return @c false if the series is empty.
+	 */
+	bool pop(time_type& time, value_type& value) {
+		const std::size_t tail = _tail.load(std::memory_order_relaxed);
+		if(_head.load(std::memory_order_acquire) == tail) {
+			return false;
+		}
+		time = time_type(_times[tail & _mask]);
+		value = value_type(_values[tail & _mask]);
+		_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// Removes the n oldest samples, or all of them if there are less than n.
+	void discard(std::size_t n) {
+		const std::size_t tail = _tail.load(std::memory_order_relaxed);
+		const std::size_t available = _head.load(std::memory_order_acquire) - tail;
+		_tail.store(tail + (n < available ? n : available), std::memory_order_release);
+	}
+
+	/// Removes the samples with timestamps older than @c time.
+	/**
+	 * Timestamps are expected to be pushed in non-decreasing order.
+	 * @return The number of removed samples.
+	 */
+	template <typename TimeType2>
+	std::size_t discard_before(const TimeType2& time) {
+		const time_type limit = time;
+		const std::size_t tail = _tail.load(std::memory_order_relaxed);
+		const std::size_t head = _head.load(std::memory_order_acquire);
+		std::size_t i = tail;
+		while(i != head  &&  _times[i & _mask] < limit.value) {
+			i++;
+		}
+		_tail.store(i, std::memory_order_release);
+		return i - tail;
+	}
+
+
+	/// Summarizes consecutive windows of samples.
+	/**
+	 * The available samples, from the oldest, are split in windows of
+	 * @c samples_per_window (> 0) samples (the last one may be shorter) and the
+	 * minimum, maximum and mean of each window are computed. The samples are
+	 * not removed.
+	 *
+	 * @return The number of windows written to @c out, at most @c max_windows.
+	 */
+	std::size_t downsample(std::size_t samples_per_window, window* out, std::size_t max_windows) const {
+		const std::size_t tail = _tail.load(std::memory_order_relaxed);
+		const std::size_t head = _head.load(std::memory_order_acquire);
+
+		std::size_t count = 0;
+		for(std::size_t begin = tail; begin != head  &&  count < max_windows; count++) {
+			const std::size_t n = (head - begin < samples_per_window) ? head - begin : samples_per_window;
+
+			// The window may wrap around the end of the ring.
+			const std::size_t first = begin & _mask;
+			const std::size_t n1 = (Capacity - first < n) ? Capacity - first : n;
+
+			raw_value_type min = _values[first];
+			raw_value_type max = _values[first];
+			double sum = 0.0;
+			_ring_series::summarize(_values + first, n1, min, max, sum);
+			if(n1 < n) {
+				_ring_series::summarize(_values, n - n1, min, max, sum);
+			}
+
+			window& w = out[count];
+			w.start = time_type(_times[first]);
+			w.count = n;
+			w.min = value_type(min);
+			w.max = value_type(max);
+			w.mean = mean_type(sum / n);
+
+			begin += n;
+		}
+		return count;
+	}
+
+private:
+	typedef typename value_type::ValueType raw_value_type;
+	typedef typename time_type::ValueType  raw_time_type;
+
+	static const std::size_t _mask = Capacity - 1;
+
+	alignas(64) std::atomic<std::size_t> _head;
+	alignas(64) std::atomic<std::size_t> _tail;
+	alignas(64) raw_time_type  _times[Capacity];
+	alignas(64) raw_value_type _values[Capacity];
+};
+
+
+template <typename SIValueType, std::size_t Capacity, typename TimeType>
+const std::size_t ring_series<SIValueType, Capacity, TimeType>::capacity;
+
+
+} /* namespace si */
+
+
+#endif /* SI_RING_SERIES_HPP_ */
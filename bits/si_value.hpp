@@ -2,16 +2,62 @@
 #define SI_VALUE_HPP_
 
 
+#include <chrono>
 #include <ratio>
+#include <type_traits>
+#include <utility>
 
+#include "config.hpp"
+#include "dimension_code.hpp"
 #include "int_list.hpp"
 #include "operations.hpp"
 
+#ifdef SI_TRACK_CONVERSIONS
+ #include "conversions.hpp"
+#endif
+#ifdef SI_AUDIT_CONVERSIONS
+ #include "audit.hpp"
+#endif
+
 
 /// The namespace where the SI library is defined.
 namespace si {
 
 
+namespace _scalar {
+
+
+template <typename T>
+struct is_si_value : std::false_type {};
+
+template <typename ValueType, typename Ratio, dimension_code Dimensions>
+struct is_si_value<SIValue<ValueType, Ratio, Dimensions>> : std::true_type {};
+
+
+// Whether the operators of SI values with scalars are enabled for Scalar: any
+// type but the SI values, which have their own operators. Product is the type
+// of the product or quotient of an underlying value and the scalar, so the
+// operators are also disabled if it is ill-formed.
+template <typename Scalar, typename Product>
+struct is_scalar {
+	static const bool value = !is_si_value<Scalar>::value;
+};
+
+
+// Whether the product or quotient of a temporary value of ValueType and a
+// scalar can be stored in it by the compound assignment (or the assignment of
+// the product, for a scalar on the left), whose type is Assignment: it must
+// be well-formed, and the result must be a ValueType.
+template <typename ValueType, typename Scalar, typename Product, typename Assignment>
+struct in_place {
+	static const bool value = !is_si_value<Scalar>::value  &&  std::is_same<Product, ValueType>::value;
+};
+
+
+} /* namespace si::_scalar */
+
+
+
 /**
  * @brief This class defines a type for storing an SI value.
  *
@@ -26,16 +72,27 @@ namespace si {
  *         well (@c std::centi, @c std::milli, @c std::micro, @c std::kilo,
  *         @c std::mega, etc. See documentation for the standard
  *         <tt>\<ratio\></tt> header file).
- * @tparam _Dimensions... The powers of each SI base unit.
+ * @tparam _Dimensions The powers of each SI base unit, packed in a
+ *         @c dimension_code (see @c pack_dimensions).
  *
  * @see http://en.wikipedia.org/wiki/International_System_of_Units
  */
-template <typename _ValueType, typename _Ratio, int... _Dimensions>
+template <typename _ValueType, typename _Ratio, dimension_code _Dimensions>
 class SIValue {
 public:
 	typedef _ValueType ValueType;
 	typedef _Ratio Ratio;
-	typedef int_list<_Dimensions...> DimensionsList;
+	/// The dimension code of the unit.
+	static const dimension_code Dimensions = _Dimensions;
+
+	/// The powers of each SI base unit, unpacked from the dimension code.
+	typedef int_list<unpack_dimension(_Dimensions, 0),
+	                 unpack_dimension(_Dimensions, 1),
+	                 unpack_dimension(_Dimensions, 2),
+	                 unpack_dimension(_Dimensions, 3),
+	                 unpack_dimension(_Dimensions, 4),
+	                 unpack_dimension(_Dimensions, 5),
+	                 unpack_dimension(_Dimensions, 6)> DimensionsList;
 
 
 	// Defines a new SI type from this type by specifying a different ratio.
@@ -56,7 +113,7 @@ public:
 	template <typename NewRatio>
 	struct with_ratio {
 		/// The new defined type.
-		typedef SIValue<ValueType, NewRatio, _Dimensions...> type;
+		typedef SIValue<ValueType, NewRatio, _Dimensions> type;
 	};
 
 	/// Defines a new SI type from this type by applying another ratio.
@@ -84,62 +141,120 @@ public:
 
 
 	/// Default constructor
-	SIValue() : value() {}
+	SI_INLINE SIValue() noexcept(std::is_nothrow_default_constructible<ValueType>::value) : value() {}
 
 	/// Copy constructor
 	SIValue(const SIValue& v) = default;
 
+	/// Move constructor
+	SIValue(SIValue&& v) = default;
+
+	/// Copy assignment
+	SIValue& operator=(const SIValue& v) = default;
+
+	/// Move assignment
+	SIValue& operator=(SIValue&& v) = default;
+
 	/// Copy constructor from different ratio or underlying type.
 	/**
 	 * The value is converted according to the ratios and the underlying types.
 	 * A value can only be copied from another value of the same unit.
 	 */
 	template <typename ValueTypeFrom, typename RatioFrom>
-	SIValue(const SIValue<ValueTypeFrom, RatioFrom, _Dimensions...>& v)
+	SI_INLINE
+	SIValue(const SIValue<ValueTypeFrom, RatioFrom, _Dimensions>& v)
 		: value(convertFrom<ValueTypeFrom, RatioFrom>(v.value))
 	{}
 
 	/// Constructor from underlying type value.
-	explicit
-	SIValue(const ValueType& value) : value(value) {}
+	SI_INLINE explicit
+	SIValue(const ValueType& value) noexcept(std::is_nothrow_copy_constructible<ValueType>::value)
+		: value(value)
+	{}
+
+	/// Constructor from underlying type value, which is moved.
+	SI_INLINE explicit
+	SIValue(ValueType&& value) noexcept(std::is_nothrow_move_constructible<ValueType>::value)
+		: value(std::move(value))
+	{}
+
+	/// Constructor from a @c std::chrono::duration.
+	/**
+	 * Only time values can be constructed from a duration. The value is
+	 * converted exactly as @c std::chrono::duration_cast does.
+	 */
+	template <typename Rep, typename Period,
+	          dimension_code _TimeDimensions = _Dimensions,
+	          typename = typename std::enable_if<_TimeDimensions == time_dimensions>::type>
+	SI_INLINE constexpr
+	SIValue(const std::chrono::duration<Rep, Period>& d)
+		: value(std::chrono::duration_cast<std::chrono::duration<ValueType, Ratio>>(d).count())
+	{}
+
+
+	/// Conversion to a @c std::chrono::duration.
+	/**
+	 * Only time values can be converted to a duration. The value is converted
+	 * exactly as @c std::chrono::duration_cast does.
+	 */
+	template <typename Rep, typename Period,
+	          dimension_code _TimeDimensions = _Dimensions,
+	          typename = typename std::enable_if<_TimeDimensions == time_dimensions>::type>
+	SI_INLINE constexpr explicit
+	operator std::chrono::duration<Rep, Period>() const {
+		return std::chrono::duration_cast<std::chrono::duration<Rep, Period>>(std::chrono::duration<ValueType, Ratio>(value));
+	}
 
 
 	/// Positive operator
-	SIValue operator+() const {
+	SI_INLINE SIValue operator+() const {
 		return SIValue(+value);
 	}
 
 	/// Negative operator
-	SIValue operator-() const {
+	SI_INLINE SIValue operator-() const {
 		return SIValue(-value);
 	}
 
-	/// Multiplication assignment by an integer.
-	SIValue& operator*=(int n) {
-		value *= n;
-		return *this;
-	}
-
-	/// Multiplication assignment by a double.
-	SIValue& operator*=(double n) {
+	/// Multiplication assignment by a scalar.
+	/**
+	 * The scalar can be of any type whose values multiply the underlying
+	 * values, like @c int, @c float or @c double, but not an SI value.
+	 */
+	template <typename Scalar,
+	          typename = typename std::enable_if<_scalar::is_scalar<Scalar, decltype(std::declval<ValueType&>() *= std::declval<const Scalar&>())>::value>::type>
+	SI_INLINE SIValue& operator*=(const Scalar& n)
+		noexcept(noexcept(std::declval<ValueType&>() *= std::declval<const Scalar&>()))
+	{
+#ifdef SI_AUDIT_CONVERSIONS
+		_audit::scaler<SIValue, Scalar>::multiply(value, n);
+#else
 		value *= n;
+#endif
 		return *this;
 	}
 
-	/// Division assignment by an integer.
-	SIValue& operator/=(int n) {
-		value /= n;
-		return *this;
-	}
-
-	/// Division assignment by a double.
-	SIValue& operator/=(double n) {
+	/// Division assignment by a scalar.
+	/**
+	 * @see operator*=(const Scalar&)
+	 */
+	template <typename Scalar,
+	          typename = typename std::enable_if<_scalar::is_scalar<Scalar, decltype(std::declval<ValueType&>() /= std::declval<const Scalar&>())>::value>::type>
+	SI_INLINE SIValue& operator/=(const Scalar& n)
+		noexcept(noexcept(std::declval<ValueType&>() /= std::declval<const Scalar&>()))
+	{
+#ifdef SI_AUDIT_CONVERSIONS
+		_audit::scaler<SIValue, Scalar>::divide(value, n);
+#else
 		value /= n;
+#endif
 		return *this;
 	}
 
 	/// Addition assignment with a value with same type.
-	SIValue& operator+=(const SIValue& v) {
+	SI_INLINE SIValue& operator+=(const SIValue& v)
+		noexcept(noexcept(std::declval<ValueType&>() += std::declval<const ValueType&>()))
+	{
 		value += v.value;
 		return *this;
 	}
@@ -150,13 +265,15 @@ public:
 	 * A value can only be added to another value of the same unit.
 	 */
 	template <typename ValueType2, typename Ratio2>
-	SIValue& operator+=(const SIValue<ValueType2, Ratio2, _Dimensions...>& v) {
+	SI_INLINE SIValue& operator+=(const SIValue<ValueType2, Ratio2, _Dimensions>& v) {
 		value += convertFrom<ValueType2, Ratio2>(v.value);
 		return *this;
 	}
 
 	/// Subtraction assignment with a value with same type.
-	SIValue& operator-=(const SIValue& v) {
+	SI_INLINE SIValue& operator-=(const SIValue& v)
+		noexcept(noexcept(std::declval<ValueType&>() -= std::declval<const ValueType&>()))
+	{
 		value -= v.value;
 		return *this;
 	}
@@ -167,14 +284,14 @@ public:
 	 * A value can only be subtracted from another value of the same unit.
 	 */
 	template <typename ValueType2, typename Ratio2>
-	SIValue& operator-=(const SIValue<ValueType2, Ratio2, _Dimensions...>& v) {
+	SI_INLINE SIValue& operator-=(const SIValue<ValueType2, Ratio2, _Dimensions>& v) {
 		value -= convertFrom<ValueType2, Ratio2>(v.value);
 		return *this;
 	}
 
 private:
 	template <typename ValueTypeFrom, typename RatioFrom>
-	static ValueType convertFrom(ValueTypeFrom value) {
+	SI_INLINE static ValueType convertFrom(ValueTypeFrom value) {
 		/*
 		result = value * Ratio::den * RatioFrom::num / (Ratio::num * RatioFrom::den)
 		       = value * (Ratio::den / RatioFrom::den) * (RatioFrom::num / Ratio::num)
@@ -187,26 +304,54 @@ private:
 
 		typedef typename std::ratio_multiply<factor1, factor2>::type mult;
 
-		const double num = mult::num;
-		const double den = mult::den;
+#ifdef SI_TRACK_CONVERSIONS
+		_conversions::record<SIValue<ValueTypeFrom, RatioFrom, _Dimensions>, SIValue>();
+#endif
+#ifdef SI_AUDIT_CONVERSIONS
+		typedef SIValue<ValueTypeFrom, RatioFrom, _Dimensions> From;
+		ValueType result;
+		if(_audit::in_range<From, SIValue>(value, mult(), result)) {
+			result = scale(value, mult());
+			_audit::check<From, SIValue>(value, mult(), result);
+		}
+		return result;
+#else
+		return scale(value, mult());
+#endif
+	}
+
+	// Same ratio: only the underlying type is converted.
+	template <typename ValueTypeFrom>
+	SI_INLINE static ValueType scale(ValueTypeFrom value, std::ratio<1>) {
+		return value;
+	}
+
+	template <typename ValueTypeFrom, typename Mult>
+	SI_INLINE static ValueType scale(ValueTypeFrom value, Mult) {
+		const double num = Mult::num;
+		const double den = Mult::den;
 		return value * num / den;
 	}
 };
 
 
+template <typename _ValueType, typename _Ratio, dimension_code _Dimensions>
+const dimension_code SIValue<_ValueType, _Ratio, _Dimensions>::Dimensions;
+
+
 // Defines an SI Value type from a unit_list type.
 template <typename ValueType, typename Ratio, int... Dimensions>
 struct make_value<ValueType, Ratio, int_list<Dimensions...>> {
-	typedef SIValue<ValueType, Ratio, Dimensions...> type;
+	typedef SIValue<ValueType, Ratio, pack_dimensions(Dimensions...)> type;
 };
 
 
 
 // This specialization compares values with same ratios, so no conversion is needed.
-template <typename ValueType1, typename ValueType2, typename Ratio, int... Dimensions>
-bool
-operator==(const SIValue<ValueType1, Ratio, Dimensions...>& v1,
-           const SIValue<ValueType2, Ratio, Dimensions...>& v2)
+template <typename ValueType1, typename ValueType2, typename Ratio, dimension_code Dimensions>
+SI_INLINE bool
+operator==(const SIValue<ValueType1, Ratio, Dimensions>& v1,
+           const SIValue<ValueType2, Ratio, Dimensions>& v2)
 {
 	return v1.value == v2.value;
 }
@@ -218,18 +363,17 @@ operator==(const SIValue<ValueType1, Ratio, Dimensions...>& v1,
  * Conversion of underlying types and ratios are performed as needed.
  *
  * @relates SIValue
- * @todo Cross-simplify num and den.
  */
 template <typename ValueType1, typename Ratio1,
           typename ValueType2, typename Ratio2,
-          int... Dimensions>
-bool
-operator==(const SIValue<ValueType1, Ratio1, Dimensions...>& v1,
-           const SIValue<ValueType2, Ratio2, Dimensions...>& v2)
+          dimension_code Dimensions>
+SI_INLINE bool
+operator==(const SIValue<ValueType1, Ratio1, Dimensions>& v1,
+           const SIValue<ValueType2, Ratio2, Dimensions>& v2)
 {
-	const auto n1 = v1.value * Ratio1::num * Ratio2::den;
-	const auto n2 = v2.value * Ratio2::num * Ratio1::den;
-	return n1 == n2;
+	// v1 * Ratio1 == v2 * Ratio2  <=>  v1 * (Ratio1 / Ratio2) == v2
+	typedef typename std::ratio_divide<Ratio1, Ratio2>::type CrossRatio;
+	return v1.value * CrossRatio::num == v2.value * CrossRatio::den;
 }
 
 
@@ -242,20 +386,20 @@ operator==(const SIValue<ValueType1, Ratio1, Dimensions...>& v1,
  */
 template <typename ValueType1, typename Ratio1,
           typename ValueType2, typename Ratio2,
-          int... Dimensions>
-bool
-operator!=(const SIValue<ValueType1, Ratio1, Dimensions...>& v1,
-           const SIValue<ValueType2, Ratio2, Dimensions...>& v2)
+          dimension_code Dimensions>
+SI_INLINE bool
+operator!=(const SIValue<ValueType1, Ratio1, Dimensions>& v1,
+           const SIValue<ValueType2, Ratio2, Dimensions>& v2)
 {
 	return !(v1 == v2);
 }
 
 
 // This specialization compares values with same ratios, so no conversion is needed.
-template <typename ValueType1, typename ValueType2, typename Ratio, int... Dimensions>
-bool
-operator<(const SIValue<ValueType1, Ratio, Dimensions...>& v1,
-          const SIValue<ValueType2, Ratio, Dimensions...>& v2)
+template <typename ValueType1, typename ValueType2, typename Ratio, dimension_code Dimensions>
+SI_INLINE bool
+operator<(const SIValue<ValueType1, Ratio, Dimensions>& v1,
+          const SIValue<ValueType2, Ratio, Dimensions>& v2)
 {
 	return v1.value < v2.value;
 }
@@ -267,18 +411,16 @@ operator<(const SIValue<ValueType1, Ratio, Dimensions...>& v1,
  * Conversion of underlying types and ratios are performed as needed.
  *
  * @relates SIValue
- * @todo Cross-simplify ratios.
  */
 template <typename ValueType1, typename Ratio1,
           typename ValueType2, typename Ratio2,
-          int... Dimensions>
-bool
-operator<(const SIValue<ValueType1, Ratio1, Dimensions...>& v1,
-          const SIValue<ValueType2, Ratio2, Dimensions...>& v2)
+          dimension_code Dimensions>
+SI_INLINE bool
+operator<(const SIValue<ValueType1, Ratio1, Dimensions>& v1,
+          const SIValue<ValueType2, Ratio2, Dimensions>& v2)
 {
-	const auto n1 = v1.value * Ratio1::num * Ratio2::den;
-	const auto n2 = v2.value * Ratio2::num * Ratio1::den;
-	return n1 < n2;
+	typedef typename std::ratio_divide<Ratio1, Ratio2>::type CrossRatio;
+	return v1.value * CrossRatio::num < v2.value * CrossRatio::den;
 }
 
 
@@ -292,10 +434,10 @@ operator<(const SIValue<ValueType1, Ratio1, Dimensions...>& v1,
  */
 template <typename ValueType1, typename Ratio1,
           typename ValueType2, typename Ratio2,
-          int... Dimensions>
-bool
-operator>(const SIValue<ValueType1, Ratio1, Dimensions...>& v1,
-          const SIValue<ValueType2, Ratio2, Dimensions...>& v2)
+          dimension_code Dimensions>
+SI_INLINE bool
+operator>(const SIValue<ValueType1, Ratio1, Dimensions>& v1,
+          const SIValue<ValueType2, Ratio2, Dimensions>& v2)
 {
 	return v2 < v1;
 }
@@ -311,10 +453,10 @@ operator>(const SIValue<ValueType1, Ratio1, Dimensions...>& v1,
  */
 template <typename ValueType1, typename Ratio1,
           typename ValueType2, typename Ratio2,
-          int... Dimensions>
-bool
-operator<=(const SIValue<ValueType1, Ratio1, Dimensions...>& v1,
-           const SIValue<ValueType2, Ratio2, Dimensions...>& v2)
+          dimension_code Dimensions>
+SI_INLINE bool
+operator<=(const SIValue<ValueType1, Ratio1, Dimensions>& v1,
+           const SIValue<ValueType2, Ratio2, Dimensions>& v2)
 {
 	return !(v1 > v2);
 }
@@ -329,85 +471,102 @@ operator<=(const SIValue<ValueType1, Ratio1, Dimensions...>& v1,
  */
 template <typename ValueType1, typename Ratio1,
           typename ValueType2, typename Ratio2,
-          int... Dimensions>
-bool
-operator>=(const SIValue<ValueType1, Ratio1, Dimensions...>& v1,
-           const SIValue<ValueType2, Ratio2, Dimensions...>& v2)
+          dimension_code Dimensions>
+SI_INLINE bool
+operator>=(const SIValue<ValueType1, Ratio1, Dimensions>& v1,
+           const SIValue<ValueType2, Ratio2, Dimensions>& v2)
 {
 	return !(v1 < v2);
 }
 
 
 
-/// Multiplies an SI value to an int value.
+/// Multiplies an SI value by a scalar.
 /**
+ * The scalar can be of any type whose values multiply the underlying values,
+ * like @c int, @c float or @c double, but not an SI value. A @c float value
+ * multiplied by a @c float stays a @c float.
+ *
  * @return The product of the arguments. The type of the returned value is an
  *         SI value with same ratio and unit of the left operand. The underlying
  *         type of the returned value is the same type resulting from multiplying
- *         a value of the underlying type of the left operator to an int value.
+ *         a value of the underlying type of the left operator to the scalar.
  * @relates SIValue
  */
-template <typename ValueType, typename Ratio, int... Dimensions>
-SIValue<typename multiplication<ValueType, int>::type, Ratio, Dimensions...>
-operator*(const SIValue<ValueType, Ratio, Dimensions...>& v, int i) {
+template <typename ValueType, typename Ratio, dimension_code Dimensions, typename Scalar,
+          typename = typename std::enable_if<_scalar::is_scalar<Scalar, decltype(std::declval<const ValueType&>() * std::declval<const Scalar&>())>::value>::type>
+SI_INLINE SIValue<typename multiplication<ValueType, Scalar>::type, Ratio, Dimensions>
+operator*(const SIValue<ValueType, Ratio, Dimensions>& v, const Scalar& s)
+	noexcept(noexcept(SIValue<typename multiplication<ValueType, Scalar>::type, Ratio, Dimensions>(v.value * s)))
+{
 	typedef
-		SIValue<typename multiplication<ValueType, int>::type, Ratio, Dimensions...>
+		SIValue<typename multiplication<ValueType, Scalar>::type, Ratio, Dimensions>
 		ResultType;
-	return ResultType(v.value * i);
+	return ResultType(v.value * s);
 }
 
 
-/// Multiplies an int value to an SI value.
+/// Multiplies a scalar by an SI value.
 /**
  * @return The product of the arguments. The type of the returned value is an
  *         SI value with same ratio and unit of the right operand. The underlying
  *         type of the returned value is the same type resulting from multiplying
- *         an int value to a value of the underlying type of the right operator.
+ *         the scalar to a value of the underlying type of the right operator.
+ * @see operator*(const SIValue&, const Scalar&)
  * @relates SIValue
  */
-template <typename ValueType, typename Ratio, int... Dimensions>
-SIValue<typename multiplication<int, ValueType>::type, Ratio, Dimensions...>
-operator*(int i, const SIValue<ValueType, Ratio, Dimensions...>& v) {
+template <typename Scalar, typename ValueType, typename Ratio, dimension_code Dimensions,
+          typename = typename std::enable_if<_scalar::is_scalar<Scalar, decltype(std::declval<const Scalar&>() * std::declval<const ValueType&>())>::value>::type>
+SI_INLINE SIValue<typename multiplication<Scalar, ValueType>::type, Ratio, Dimensions>
+operator*(const Scalar& s, const SIValue<ValueType, Ratio, Dimensions>& v)
+	noexcept(noexcept(SIValue<typename multiplication<Scalar, ValueType>::type, Ratio, Dimensions>(s * v.value)))
+{
 	typedef
-		SIValue<typename multiplication<int, ValueType>::type, Ratio, Dimensions...>
+		SIValue<typename multiplication<Scalar, ValueType>::type, Ratio, Dimensions>
 		ResultType;
-	return ResultType(i * v.value);
+	return ResultType(s * v.value);
 }
 
 
-/// Multiplies an SI value to a double value.
+
+/// Multiplies a temporary SI value by a scalar.
 /**
- * @return The product of the arguments. The type of the returned value is an
- *         SI value with same ratio and unit of the left operand. The underlying
- *         type of the returned value is the same type resulting from multiplying
- *         a value of the underlying type of the left operator to a double value.
+ * The product is computed in place, so a heavyweight underlying type (like
+ * @c std::valarray) is not allocated again. It is used when the product of
+ * the underlying value and the scalar has the underlying type.
+ * @see operator*(const SIValue&, const Scalar&)
  * @relates SIValue
  */
-template <typename ValueType, typename Ratio, int... Dimensions>
-SIValue<typename multiplication<ValueType, double>::type, Ratio, Dimensions...>
-operator*(const SIValue<ValueType, Ratio, Dimensions...>& v, double d) {
-	typedef
-		SIValue<typename multiplication<ValueType, double>::type, Ratio, Dimensions...>
-		ResultType;
-	return ResultType(v.value * d);
+template <typename ValueType, typename Ratio, dimension_code Dimensions, typename Scalar,
+          typename = typename std::enable_if<_scalar::in_place<ValueType, Scalar,
+                                                               decltype(std::declval<const ValueType&>() * std::declval<const Scalar&>()),
+                                                               decltype(std::declval<ValueType&>() *= std::declval<const Scalar&>())>::value>::type>
+SI_INLINE SIValue<ValueType, Ratio, Dimensions>
+operator*(SIValue<ValueType, Ratio, Dimensions>&& v, const Scalar& s)
+	noexcept(noexcept(v *= s)  &&  std::is_nothrow_move_constructible<ValueType>::value)
+{
+	v *= s;
+	return std::move(v);
 }
 
 
-/// Multiplies a double value to an SI value.
+/// Multiplies a scalar by a temporary SI value.
 /**
- * @return The product of the arguments. The type of the returned value is an
- *         SI value with same ratio and unit of the right operand. The underlying
- *         type of the returned value is the same type resulting from multiplying
- *         a double value to a value of the underlying type of the right operator.
+ * The product is computed in the order of the operands, as they may not
+ * commute, and it is moved into the temporary.
+ * @see operator*(SIValue&&, const Scalar&)
  * @relates SIValue
  */
-template <typename ValueType, typename Ratio, int... Dimensions>
-SIValue<typename multiplication<double, ValueType>::type, Ratio, Dimensions...>
-operator*(double d, const SIValue<ValueType, Ratio, Dimensions...>& v) {
-	typedef
-		SIValue<typename multiplication<double, ValueType>::type, Ratio, Dimensions...>
-		ResultType;
-	return ResultType(d * v.value);
+template <typename Scalar, typename ValueType, typename Ratio, dimension_code Dimensions,
+          typename = typename std::enable_if<_scalar::in_place<ValueType, Scalar,
+                                                               decltype(std::declval<const Scalar&>() * std::declval<const ValueType&>()),
+                                                               decltype(std::declval<ValueType&>() = std::declval<const Scalar&>() * std::declval<const ValueType&>())>::value>::type>
+SI_INLINE SIValue<ValueType, Ratio, Dimensions>
+operator*(const Scalar& s, SIValue<ValueType, Ratio, Dimensions>&& v)
+	noexcept(noexcept(v.value = s * v.value)  &&  std::is_nothrow_move_constructible<ValueType>::value)
+{
+	v.value = s * v.value;
+	return std::move(v);
 }
 
 
@@ -421,16 +580,19 @@ operator*(double d, const SIValue<ValueType, Ratio, Dimensions...>& v) {
  *         underlying type and ratio, given its unit is compatible.
  * @relates SIValue
  */
-template <typename ValueType1, typename Ratio1, int... Dimensions1,
-          typename ValueType2, typename Ratio2, int... Dimensions2>
-typename multiplication<SIValue<ValueType1, Ratio1, Dimensions1...>,
-                        SIValue<ValueType2, Ratio2, Dimensions2...>>::type
-operator*(const SIValue<ValueType1, Ratio1, Dimensions1...>& v1,
-          const SIValue<ValueType2, Ratio2, Dimensions2...>& v2)
+template <typename ValueType1, typename Ratio1, dimension_code Dimensions1,
+          typename ValueType2, typename Ratio2, dimension_code Dimensions2>
+SI_INLINE
+typename multiplication<SIValue<ValueType1, Ratio1, Dimensions1>,
+                        SIValue<ValueType2, Ratio2, Dimensions2>>::type
+operator*(const SIValue<ValueType1, Ratio1, Dimensions1>& v1,
+          const SIValue<ValueType2, Ratio2, Dimensions2>& v2)
+	noexcept(noexcept(typename multiplication<SIValue<ValueType1, Ratio1, Dimensions1>,
+	                                          SIValue<ValueType2, Ratio2, Dimensions2>>::type(v1.value * v2.value)))
 {
 	typedef
-		typename multiplication<SIValue<ValueType1, Ratio1, Dimensions1...>,
-		                        SIValue<ValueType2, Ratio2, Dimensions2...>>::type
+		typename multiplication<SIValue<ValueType1, Ratio1, Dimensions1>,
+		                        SIValue<ValueType2, Ratio2, Dimensions2>>::type
 		ResultType;
 
 	return ResultType(v1.value * v2.value);
@@ -438,75 +600,145 @@ operator*(const SIValue<ValueType1, Ratio1, Dimensions1...>& v1,
 
 
 
-/// Divides an SI value by an int value.
+/// Multiplies a temporary SI value by an SI value.
 /**
- * @return The quotient of the arguments. The type of the returned value is an
- *         SI value with same ratio and unit of the left operand. The underlying
- *         type of the returned value is the same type resulting from dividing
- *         a value of the underlying type of the left operator by an int value.
+ * The product is computed in place, if its underlying type is the underlying
+ * type of the temporary, so a heavyweight underlying type is not allocated
+ * again.
+ * @see operator*(const SIValue&, const SIValue&)
  * @relates SIValue
  */
-template <typename ValueType, typename Ratio, int... Dimensions>
-SIValue<typename division<ValueType, int>::type, Ratio, Dimensions...>
-operator/(const SIValue<ValueType, Ratio, Dimensions...>& v, int i) {
+template <typename ValueType1, typename Ratio1, dimension_code Dimensions1,
+          typename ValueType2, typename Ratio2, dimension_code Dimensions2,
+          typename = typename std::enable_if<std::is_same<typename multiplication<ValueType1, ValueType2>::type, ValueType1>::value,
+                                             decltype(std::declval<ValueType1&>() *= std::declval<const ValueType2&>())>::type>
+SI_INLINE
+typename multiplication<SIValue<ValueType1, Ratio1, Dimensions1>,
+                        SIValue<ValueType2, Ratio2, Dimensions2>>::type
+operator*(SIValue<ValueType1, Ratio1, Dimensions1>&& v1,
+          const SIValue<ValueType2, Ratio2, Dimensions2>& v2)
+	noexcept(noexcept(v1.value *= v2.value)  &&  std::is_nothrow_move_constructible<ValueType1>::value)
+{
 	typedef
-		SIValue<typename division<ValueType, int>::type, Ratio, Dimensions...>
+		typename multiplication<SIValue<ValueType1, Ratio1, Dimensions1>,
+		                        SIValue<ValueType2, Ratio2, Dimensions2>>::type
 		ResultType;
-	return ResultType(v.value / i);
+
+	v1.value *= v2.value;
+	return ResultType(std::move(v1.value));
 }
 
 
-/// Divides an int value by an SI value.
+/// Multiplies two temporary SI values.
 /**
- * @return The quotient of the arguments. The type of the returned value is a
- *         derived SI value. The underlying type of the returned value is the
- *         same type resulting from dividing an int value by a value of the
- *         underlying type of the right operator.
+ * The product is computed in place in the left operand.
+ * @see operator*(SIValue&&, const SIValue&)
  * @relates SIValue
  */
-template <typename ValueType, typename Ratio, int... Dimensions>
-SIValue<typename division<int, ValueType>::type, Ratio, Dimensions...>
-operator/(int i, const SIValue<ValueType, Ratio, Dimensions...>& v) {
+template <typename ValueType1, typename Ratio1, dimension_code Dimensions1,
+          typename ValueType2, typename Ratio2, dimension_code Dimensions2,
+          typename = typename std::enable_if<std::is_same<typename multiplication<ValueType1, ValueType2>::type, ValueType1>::value,
+                                             decltype(std::declval<ValueType1&>() *= std::declval<const ValueType2&>())>::type>
+SI_INLINE
+typename multiplication<SIValue<ValueType1, Ratio1, Dimensions1>,
+                        SIValue<ValueType2, Ratio2, Dimensions2>>::type
+operator*(SIValue<ValueType1, Ratio1, Dimensions1>&& v1,
+          SIValue<ValueType2, Ratio2, Dimensions2>&& v2)
+	noexcept(noexcept(std::move(v1) * v2))
+{
+	return std::move(v1) * v2;
+}
+
+
+/// Multiplies an SI value by a temporary SI value.
+/**
+ * The product is computed in the order of the operands, as they may not
+ * commute, and it is moved into the right operand.
+ * @see operator*(SIValue&&, const SIValue&)
+ * @relates SIValue
+ */
+template <typename ValueType1, typename Ratio1, dimension_code Dimensions1,
+          typename ValueType2, typename Ratio2, dimension_code Dimensions2,
+          typename = typename std::enable_if<std::is_same<typename multiplication<ValueType1, ValueType2>::type, ValueType2>::value,
+                                             decltype(std::declval<ValueType2&>() = std::declval<const ValueType1&>() * std::declval<const ValueType2&>())>::type>
+SI_INLINE
+typename multiplication<SIValue<ValueType1, Ratio1, Dimensions1>,
+                        SIValue<ValueType2, Ratio2, Dimensions2>>::type
+operator*(const SIValue<ValueType1, Ratio1, Dimensions1>& v1,
+          SIValue<ValueType2, Ratio2, Dimensions2>&& v2)
+	noexcept(noexcept(v2.value = v1.value * v2.value)  &&  std::is_nothrow_move_constructible<ValueType2>::value)
+{
 	typedef
-		SIValue<typename division<int, ValueType>::type, Ratio, Dimensions...>
+		typename multiplication<SIValue<ValueType1, Ratio1, Dimensions1>,
+		                        SIValue<ValueType2, Ratio2, Dimensions2>>::type
 		ResultType;
-	return ResultType(i / v.value);
+
+	v2.value = v1.value * v2.value;
+	return ResultType(std::move(v2.value));
 }
 
 
-/// Divides an SI value by a double value.
+
+/// Divides an SI value by a scalar.
 /**
  * @return The quotient of the arguments. The type of the returned value is an
  *         SI value with same ratio and unit of the left operand. The underlying
  *         type of the returned value is the same type resulting from dividing
- *         a value of the underlying type of the left operator by a double value.
+ *         a value of the underlying type of the left operator by the scalar.
+ * @see operator*(const SIValue&, const Scalar&)
  * @relates SIValue
  */
-template <typename ValueType, typename Ratio, int... Dimensions>
-SIValue<typename division<ValueType, double>::type, Ratio, Dimensions...>
-operator/(const SIValue<ValueType, Ratio, Dimensions...>& v, double d) {
+template <typename ValueType, typename Ratio, dimension_code Dimensions, typename Scalar,
+          typename = typename std::enable_if<_scalar::is_scalar<Scalar, decltype(std::declval<const ValueType&>() / std::declval<const Scalar&>())>::value>::type>
+SI_INLINE SIValue<typename division<ValueType, Scalar>::type, Ratio, Dimensions>
+operator/(const SIValue<ValueType, Ratio, Dimensions>& v, const Scalar& s)
+	noexcept(noexcept(SIValue<typename division<ValueType, Scalar>::type, Ratio, Dimensions>(v.value / s)))
+{
 	typedef
-		SIValue<typename division<ValueType, double>::type, Ratio, Dimensions...>
+		SIValue<typename division<ValueType, Scalar>::type, Ratio, Dimensions>
 		ResultType;
-	return ResultType(v.value / d);
+	return ResultType(v.value / s);
 }
 
 
-/// Divides a double value by an SI value.
+/// Divides a temporary SI value by a scalar.
+/**
+ * The quotient is computed in place.
+ * @see operator*(SIValue&&, const Scalar&)
+ * @relates SIValue
+ */
+template <typename ValueType, typename Ratio, dimension_code Dimensions, typename Scalar,
+          typename = typename std::enable_if<_scalar::in_place<ValueType, Scalar,
+                                                               decltype(std::declval<const ValueType&>() / std::declval<const Scalar&>()),
+                                                               decltype(std::declval<ValueType&>() /= std::declval<const Scalar&>())>::value>::type>
+SI_INLINE SIValue<ValueType, Ratio, Dimensions>
+operator/(SIValue<ValueType, Ratio, Dimensions>&& v, const Scalar& s)
+	noexcept(noexcept(v /= s)  &&  std::is_nothrow_move_constructible<ValueType>::value)
+{
+	v /= s;
+	return std::move(v);
+}
+
+
+/// Divides a scalar by an SI value.
 /**
  * @return The quotient of the arguments. The type of the returned value is a
  *         derived SI value. The underlying type of the returned value is the
- *         same type resulting from dividing a double value by a value of the
+ *         same type resulting from dividing the scalar by a value of the
  *         underlying type of the right operator.
+ * @see operator*(const SIValue&, const Scalar&)
  * @relates SIValue
  */
-template <typename ValueType, typename Ratio, int... Dimensions>
-SIValue<typename division<double, ValueType>::type, Ratio, Dimensions...>
-operator/(double d, const SIValue<ValueType, Ratio, Dimensions...>& v) {
+template <typename Scalar, typename ValueType, typename Ratio, dimension_code Dimensions,
+          typename = typename std::enable_if<_scalar::is_scalar<Scalar, decltype(std::declval<const Scalar&>() / std::declval<const ValueType&>())>::value>::type>
+SI_INLINE SIValue<typename division<Scalar, ValueType>::type, typename std::ratio_divide<std::ratio<1>, Ratio>::type, negate_dimensions(Dimensions)>
+operator/(const Scalar& s, const SIValue<ValueType, Ratio, Dimensions>& v)
+	noexcept(noexcept(SIValue<typename division<Scalar, ValueType>::type, typename std::ratio_divide<std::ratio<1>, Ratio>::type, negate_dimensions(Dimensions)>(s / v.value)))
+{
 	typedef
-		SIValue<typename division<double, ValueType>::type, Ratio, Dimensions...>
+		SIValue<typename division<Scalar, ValueType>::type, typename std::ratio_divide<std::ratio<1>, Ratio>::type, negate_dimensions(Dimensions)>
 		ResultType;
-	return ResultType(d / v.value);
+	return ResultType(s / v.value);
 }
 
 
@@ -517,22 +749,24 @@ operator/(double d, const SIValue<ValueType, Ratio, Dimensions...>& v) {
  *         proportion of the arguments. The type of the returned value is the
  *         same type of the quotient of values of the underlying types of the
  *         arguments.
- * @todo Cross-simplify ratios.
  * @relates SIValue
  */
 template <typename ValueType1, typename Ratio1,
           typename ValueType2, typename Ratio2,
-          int... Dimensions>
-typename division<ValueType1, ValueType2>::type
-operator/(const SIValue<ValueType1, Ratio1, Dimensions...>& v1,
-          const SIValue<ValueType2, Ratio2, Dimensions...>& v2)
+          dimension_code Dimensions>
+SI_INLINE typename division<ValueType1, ValueType2>::type
+operator/(const SIValue<ValueType1, Ratio1, Dimensions>& v1,
+          const SIValue<ValueType2, Ratio2, Dimensions>& v2)
+	noexcept(std::is_arithmetic<ValueType1>::value  &&  std::is_arithmetic<ValueType2>::value)
 {
 	/*
 	result = (v1.value * Ratio1::num / Ratio1::den) / (v2.value * Ratio2::num / Ratio2::den)
 	       = (v1.value * Ratio1::num / Ratio1::den) * (Ratio2::den / v2.value * Ratio2::num)
 	       = v1.value * Ratio1::num * Ratio2::den / (v2.value * Ratio2::num * Ratio1::den)
+	       = v1.value * CrossRatio::num / (v2.value * CrossRatio::den)
 	*/
-	return v1.value * Ratio1::num * Ratio2::den / (v2.value * Ratio2::num * Ratio1::den);
+	typedef typename std::ratio_divide<Ratio1, Ratio2>::type CrossRatio;
+	return v1.value * CrossRatio::num / (v2.value * CrossRatio::den);
 }
 
 
@@ -547,16 +781,19 @@ operator/(const SIValue<ValueType1, Ratio1, Dimensions...>& v1,
  * @relates SIValue
  * @todo Cross-simplify ratios.
  */
-template <typename ValueType1, typename Ratio1, int... Dimensions1,
-          typename ValueType2, typename Ratio2, int... Dimensions2>
-typename division<SIValue<ValueType1, Ratio1, Dimensions1...>,
-                  SIValue<ValueType2, Ratio2, Dimensions2...>>::type
-operator/(const SIValue<ValueType1, Ratio1, Dimensions1...>& v1,
-          const SIValue<ValueType2, Ratio2, Dimensions2...>& v2)
+template <typename ValueType1, typename Ratio1, dimension_code Dimensions1,
+          typename ValueType2, typename Ratio2, dimension_code Dimensions2>
+SI_INLINE
+typename division<SIValue<ValueType1, Ratio1, Dimensions1>,
+                  SIValue<ValueType2, Ratio2, Dimensions2>>::type
+operator/(const SIValue<ValueType1, Ratio1, Dimensions1>& v1,
+          const SIValue<ValueType2, Ratio2, Dimensions2>& v2)
+	noexcept(noexcept(typename division<SIValue<ValueType1, Ratio1, Dimensions1>,
+	                                    SIValue<ValueType2, Ratio2, Dimensions2>>::type(v1.value / v2.value)))
 {
 	typedef
-		typename division<SIValue<ValueType1, Ratio1, Dimensions1...>,
-		                  SIValue<ValueType2, Ratio2, Dimensions2...>>::type
+		typename division<SIValue<ValueType1, Ratio1, Dimensions1>,
+		                  SIValue<ValueType2, Ratio2, Dimensions2>>::type
 		ResultType;
 
 	return ResultType(v1.value / v2.value);
@@ -564,12 +801,98 @@ operator/(const SIValue<ValueType1, Ratio1, Dimensions1...>& v1,
 
 
 
-template <typename ValueType, typename Ratio, int... Dimensions>
-SIValue<ValueType, Ratio, Dimensions...>
-operator+(const SIValue<ValueType, Ratio, Dimensions...>& v1,
-          const SIValue<ValueType, Ratio, Dimensions...>& v2)
+/// Divides a temporary SI value by an SI value with a different unit.
+/**
+ * The quotient is computed in place, if its underlying type is the underlying
+ * type of the temporary.
+ * @see operator*(SIValue&&, const SIValue&)
+ * @relates SIValue
+ */
+template <typename ValueType1, typename Ratio1, dimension_code Dimensions1,
+          typename ValueType2, typename Ratio2, dimension_code Dimensions2,
+          typename = typename std::enable_if<Dimensions1 != Dimensions2  &&
+                                             std::is_same<typename division<ValueType1, ValueType2>::type, ValueType1>::value,
+                                             decltype(std::declval<ValueType1&>() /= std::declval<const ValueType2&>())>::type>
+SI_INLINE
+typename division<SIValue<ValueType1, Ratio1, Dimensions1>,
+                  SIValue<ValueType2, Ratio2, Dimensions2>>::type
+operator/(SIValue<ValueType1, Ratio1, Dimensions1>&& v1,
+          const SIValue<ValueType2, Ratio2, Dimensions2>& v2)
+	noexcept(noexcept(v1.value /= v2.value)  &&  std::is_nothrow_move_constructible<ValueType1>::value)
+{
+	typedef
+		typename division<SIValue<ValueType1, Ratio1, Dimensions1>,
+		                  SIValue<ValueType2, Ratio2, Dimensions2>>::type
+		ResultType;
+
+	v1.value /= v2.value;
+	return ResultType(std::move(v1.value));
+}
+
+
+
+// The sums and differences of values of the same type need no conversion.
+// When the left operand is a temporary, the result is computed in place in
+// it, so a heavyweight underlying type (like std::valarray) is not allocated
+// again. A temporary right operand only receives the result.
+
+template <typename ValueType, typename Ratio, dimension_code Dimensions>
+SI_INLINE SIValue<ValueType, Ratio, Dimensions>
+operator+(const SIValue<ValueType, Ratio, Dimensions>& v1,
+          const SIValue<ValueType, Ratio, Dimensions>& v2)
+	noexcept(noexcept(SIValue<ValueType, Ratio, Dimensions>(v1.value + v2.value)))
+{
+	return SIValue<ValueType, Ratio, Dimensions>(v1.value + v2.value);
+}
+
+template <typename ValueType, typename Ratio, dimension_code Dimensions>
+SI_INLINE SIValue<ValueType, Ratio, Dimensions>
+operator+(SIValue<ValueType, Ratio, Dimensions>&& v1,
+          const SIValue<ValueType, Ratio, Dimensions>& v2)
+	noexcept(noexcept(v1 += v2)  &&  std::is_nothrow_move_constructible<ValueType>::value)
+{
+	v1 += v2;
+	return std::move(v1);
+}
+
+// In the order of the operands, as they may not commute.
+template <typename ValueType, typename Ratio, dimension_code Dimensions>
+SI_INLINE SIValue<ValueType, Ratio, Dimensions>
+operator+(const SIValue<ValueType, Ratio, Dimensions>& v1,
+          SIValue<ValueType, Ratio, Dimensions>&& v2)
+	noexcept(noexcept(v2.value = v1.value + v2.value)  &&  std::is_nothrow_move_constructible<ValueType>::value)
 {
-	return SIValue<ValueType, Ratio, Dimensions...>(v1.value + v2.value);
+	v2.value = v1.value + v2.value;
+	return std::move(v2);
+}
+
+template <typename ValueType, typename Ratio, dimension_code Dimensions>
+SI_INLINE SIValue<ValueType, Ratio, Dimensions>
+operator+(SIValue<ValueType, Ratio, Dimensions>&& v1,
+          SIValue<ValueType, Ratio, Dimensions>&& v2)
+	noexcept(noexcept(v1 += v2)  &&  std::is_nothrow_move_constructible<ValueType>::value)
+{
+	v1 += v2;
+	return std::move(v1);
+}
+
+template <typename ValueType, typename Ratio, dimension_code Dimensions>
+SI_INLINE SIValue<ValueType, Ratio, Dimensions>
+operator-(const SIValue<ValueType, Ratio, Dimensions>& v1,
+          const SIValue<ValueType, Ratio, Dimensions>& v2)
+	noexcept(noexcept(SIValue<ValueType, Ratio, Dimensions>(v1.value - v2.value)))
+{
+	return SIValue<ValueType, Ratio, Dimensions>(v1.value - v2.value);
+}
+
+template <typename ValueType, typename Ratio, dimension_code Dimensions>
+SI_INLINE SIValue<ValueType, Ratio, Dimensions>
+operator-(SIValue<ValueType, Ratio, Dimensions>&& v1,
+          const SIValue<ValueType, Ratio, Dimensions>& v2)
+	noexcept(noexcept(v1 -= v2)  &&  std::is_nothrow_move_constructible<ValueType>::value)
+{
+	v1 -= v2;
+	return std::move(v1);
 }
 
 
@@ -586,20 +909,25 @@ operator+(const SIValue<ValueType, Ratio, Dimensions...>& v1,
  */
 template <typename ValueType1, typename Ratio1,
           typename ValueType2, typename Ratio2,
-          int... Dimensions>
-typename addition<SIValue<ValueType1, Ratio1, Dimensions...>,
-                  SIValue<ValueType2, Ratio2, Dimensions...>>::type
-operator+(const SIValue<ValueType1, Ratio1, Dimensions...>& v1,
-          const SIValue<ValueType2, Ratio2, Dimensions...>& v2)
+          dimension_code Dimensions>
+SI_INLINE
+typename addition<SIValue<ValueType1, Ratio1, Dimensions>,
+                  SIValue<ValueType2, Ratio2, Dimensions>>::type
+operator+(const SIValue<ValueType1, Ratio1, Dimensions>& v1,
+          const SIValue<ValueType2, Ratio2, Dimensions>& v2)
+	noexcept(std::is_arithmetic<ValueType1>::value  &&  std::is_arithmetic<ValueType2>::value)
 {
 	typedef
-		typename addition<SIValue<ValueType1, Ratio1, Dimensions...>,
-		                  SIValue<ValueType2, Ratio2, Dimensions...>>::type
+		typename addition<SIValue<ValueType1, Ratio1, Dimensions>,
+		                  SIValue<ValueType2, Ratio2, Dimensions>>::type
 		ResultType;
 
+	typedef typename std::ratio_divide<Ratio1, typename ResultType::Ratio>::type Factor1;
+	typedef typename std::ratio_divide<Ratio2, typename ResultType::Ratio>::type Factor2;
+
 	return ResultType(
-		  v1.value * Ratio1::num * ResultType::Ratio::den / (Ratio1::den * ResultType::Ratio::num)
-		+ v2.value * Ratio2::num * ResultType::Ratio::den / (Ratio2::den * ResultType::Ratio::num)
+		  v1.value * Factor1::num / Factor1::den
+		+ v2.value * Factor2::num / Factor2::den
 	);
 }
 
@@ -618,13 +946,26 @@ operator+(const SIValue<ValueType1, Ratio1, Dimensions...>& v1,
  */
 template <typename ValueType1, typename Ratio1,
           typename ValueType2, typename Ratio2,
-          int... Dimensions>
-typename addition<SIValue<ValueType1, Ratio1, Dimensions...>,
-                  SIValue<ValueType2, Ratio2, Dimensions...>>::type
-operator-(const SIValue<ValueType1, Ratio1, Dimensions...>& v1,
-          const SIValue<ValueType2, Ratio2, Dimensions...>& v2)
+          dimension_code Dimensions>
+SI_INLINE
+typename addition<SIValue<ValueType1, Ratio1, Dimensions>,
+                  SIValue<ValueType2, Ratio2, Dimensions>>::type
+operator-(const SIValue<ValueType1, Ratio1, Dimensions>& v1,
+          const SIValue<ValueType2, Ratio2, Dimensions>& v2)
+	noexcept(std::is_arithmetic<ValueType1>::value  &&  std::is_arithmetic<ValueType2>::value)
 {
-	return v1 + -v2;
+	typedef
+		typename addition<SIValue<ValueType1, Ratio1, Dimensions>,
+		                  SIValue<ValueType2, Ratio2, Dimensions>>::type
+		ResultType;
+
+	typedef typename std::ratio_divide<Ratio1, typename ResultType::Ratio>::type Factor1;
+	typedef typename std::ratio_divide<Ratio2, typename ResultType::Ratio>::type Factor2;
+
+	return ResultType(
+		  v1.value * Factor1::num / Factor1::den
+		- v2.value * Factor2::num / Factor2::den
+	);
 }
 
 
@@ -0,0 +1,936 @@
+#ifndef SI_SIMD_HPP_
+#define SI_SIMD_HPP_
+
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include "config.hpp"
+
+#if SI_SIMD_X86
+ #include <immintrin.h>
+#endif
+
+
+namespace si {
+
+
+// Kernels that work on arrays of raw values.
+//
+// Each operation is a struct with a scalar version and, on x86, SSE2 and
+// AVX2 versions working on 2 and 4 values at a time. The map functions pick
+// the widest version supported by the CPU at runtime; the AVX2 versions are
+// compiled for that target regardless of the compiler flags.
+namespace _simd {
+
+
+enum level {
+	scalar_level,
+	sse2_level,
+	avx2_level,
+};
+
+
+inline level detect_level() {
+#if SI_SIMD_X86
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2")  &&  __builtin_cpu_supports("fma")) {
+		return avx2_level;
+	}
+	return sse2_level;
+#else
+	return scalar_level;
+#endif
+}
+
+
+// The level used by the map functions. Detected once.
+inline level supported_level() {
+	static const level l = detect_level();
+	return l;
+}
+
+
+
+template <typename Op>
+void map_scalar(const double* in, double* out, std::size_t n, const Op& op) {
+	for(std::size_t i = 0; i < n; i++) {
+		out[i] = op.scalar(in[i]);
+	}
+}
+
+template <typename Op>
+void map_scalar(const double* a, const double* b, double* out, std::size_t n, const Op& op) {
+	for(std::size_t i = 0; i < n; i++) {
+		out[i] = op.scalar(a[i], b[i]);
+	}
+}
+
+template <typename Op>
+void map_scalar(const double* a, const double* b, const double* c, double* out, std::size_t n, const Op& op) {
+	for(std::size_t i = 0; i < n; i++) {
+		out[i] = op.scalar(a[i], b[i], c[i]);
+	}
+}
+
+
+#if SI_SIMD_X86
+
+template <typename Op>
+void map_sse2(const double* in, double* out, std::size_t n, const Op& op) {
+	std::size_t i = 0;
+	for(; i + 2 <= n; i += 2) {
+		_mm_storeu_pd(out + i, op.sse2(_mm_loadu_pd(in + i)));
+	}
+	map_scalar(in + i, out + i, n - i, op);
+}
+
+template <typename Op>
+void map_sse2(const double* a, const double* b, double* out, std::size_t n, const Op& op) {
+	std::size_t i = 0;
+	for(; i + 2 <= n; i += 2) {
+		_mm_storeu_pd(out + i, op.sse2(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+	}
+	map_scalar(a + i, b + i, out + i, n - i, op);
+}
+
+template <typename Op>
+void map_sse2(const double* a, const double* b, const double* c, double* out, std::size_t n, const Op& op) {
+	std::size_t i = 0;
+	for(; i + 2 <= n; i += 2) {
+		_mm_storeu_pd(out + i, op.sse2(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i), _mm_loadu_pd(c + i)));
+	}
+	map_scalar(a + i, b + i, c + i, out + i, n - i, op);
+}
+
+
+// Two vectors per iteration, to hide the latency of the operations.
+template <typename Op>
+SI_TARGET_AVX2 void map_avx2(const double* in, double* out, std::size_t n, const Op& op) {
+	std::size_t i = 0;
+	for(; i + 8 <= n; i += 8) {
+		const __m256d x0 = _mm256_loadu_pd(in + i);
+		const __m256d x1 = _mm256_loadu_pd(in + i + 4);
+		_mm256_storeu_pd(out + i,     op.avx2(x0));
+		_mm256_storeu_pd(out + i + 4, op.avx2(x1));
+	}
+	for(; i + 4 <= n; i += 4) {
+		_mm256_storeu_pd(out + i, op.avx2(_mm256_loadu_pd(in + i)));
+	}
+	map_scalar(in + i, out + i, n - i, op);
+}
+
+template <typename Op>
+SI_TARGET_AVX2 void map_avx2(const double* a, const double* b, double* out, std::size_t n, const Op& op) {
+	std::size_t i = 0;
+	for(; i + 8 <= n; i += 8) {
+		const __m256d r0 = op.avx2(_mm256_loadu_pd(a + i),     _mm256_loadu_pd(b + i));
+		const __m256d r1 = op.avx2(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4));
+		_mm256_storeu_pd(out + i,     r0);
+		_mm256_storeu_pd(out + i + 4, r1);
+	}
+	for(; i + 4 <= n; i += 4) {
+		_mm256_storeu_pd(out + i, op.avx2(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+	}
+	map_scalar(a + i, b + i, out + i, n - i, op);
+}
+
+template <typename Op>
+SI_TARGET_AVX2 void map_avx2(const double* a, const double* b, const double* c, double* out, std::size_t n, const Op& op) {
+	std::size_t i = 0;
+	for(; i + 8 <= n; i += 8) {
+		const __m256d r0 = op.avx2(_mm256_loadu_pd(a + i),     _mm256_loadu_pd(b + i),     _mm256_loadu_pd(c + i));
+		const __m256d r1 = op.avx2(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), _mm256_loadu_pd(c + i + 4));
+		_mm256_storeu_pd(out + i,     r0);
+		_mm256_storeu_pd(out + i + 4, r1);
+	}
+	for(; i + 4 <= n; i += 4) {
+		_mm256_storeu_pd(out + i, op.avx2(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), _mm256_loadu_pd(c + i)));
+	}
+	map_scalar(a + i, b + i, c + i, out + i, n - i, op);
+}
+
+#endif /* SI_SIMD_X86 */
+
+
+template <typename Op>
+void map(const double* in, double* out, std::size_t n, const Op& op) {
+#if SI_SIMD_X86
+	switch(supported_level()) {
+	case avx2_level: map_avx2(in, out, n, op); return;
+	case sse2_level: map_sse2(in, out, n, op); return;
+	default: break;
+	}
+#endif
+	map_scalar(in, out, n, op);
+}
+
+template <typename Op>
+void map(const double* a, const double* b, double* out, std::size_t n, const Op& op) {
+#if SI_SIMD_X86
+	switch(supported_level()) {
+	case avx2_level: map_avx2(a, b, out, n, op); return;
+	case sse2_level: map_sse2(a, b, out, n, op); return;
+	default: break;
+	}
+#endif
+	map_scalar(a, b, out, n, op);
+}
+
+template <typename Op>
+void map(const double* a, const double* b, const double* c, double* out, std::size_t n, const Op& op) {
+#if SI_SIMD_X86
+	switch(supported_level()) {
+	case avx2_level: map_avx2(a, b, c, out, n, op); return;
+	case sse2_level: map_sse2(a, b, c, out, n, op); return;
+	default: break;
+	}
+#endif
+	map_scalar(a, b, c, out, n, op);
+}
+
+
+
+// sqrt(x) * scale
+struct sqrt_op {
+	double scale;
+
+	double scalar(double x) const {
+		return std::sqrt(x) * scale;
+	}
+#if SI_SIMD_X86
+	__m128d sse2(__m128d x) const {
+		return _mm_mul_pd(_mm_sqrt_pd(x), _mm_set1_pd(scale));
+	}
+	SI_TARGET_AVX2 __m256d avx2(__m256d x) const {
+		return _mm256_mul_pd(_mm256_sqrt_pd(x), _mm256_set1_pd(scale));
+	}
+#endif
+};
+
+
+// |x| * scale
+struct abs_op {
+	double scale;
+
+	double scalar(double x) const {
+		return std::fabs(x) * scale;
+	}
+#if SI_SIMD_X86
+	__m128d sse2(__m128d x) const {
+		return _mm_mul_pd(_mm_andnot_pd(_mm_set1_pd(-0.0), x), _mm_set1_pd(scale));
+	}
+	SI_TARGET_AVX2 __m256d avx2(__m256d x) const {
+		return _mm256_mul_pd(_mm256_andnot_pd(_mm256_set1_pd(-0.0), x), _mm256_set1_pd(scale));
+	}
+#endif
+};
+
+
+// min(max(x, lo), hi) * scale. Unbounded sides are infinities. A NaN stays
+// NaN: maxpd and minpd return their second operand when either is NaN, so x
+// goes second, as in the scalar version.
+struct clamp_op {
+	double lo;
+	double hi;
+	double scale;
+
+	double scalar(double x) const {
+		const double low = x < lo ? lo : x;
+		return (low > hi ? hi : low) * scale;
+	}
+#if SI_SIMD_X86
+	__m128d sse2(__m128d x) const {
+		const __m128d low = _mm_max_pd(_mm_set1_pd(lo), x);
+		return _mm_mul_pd(_mm_min_pd(_mm_set1_pd(hi), low), _mm_set1_pd(scale));
+	}
+	SI_TARGET_AVX2 __m256d avx2(__m256d x) const {
+		const __m256d low = _mm256_max_pd(_mm256_set1_pd(lo), x);
+		return _mm256_mul_pd(_mm256_min_pd(_mm256_set1_pd(hi), low), _mm256_set1_pd(scale));
+	}
+#endif
+};
+
+
+// sqrt((a * scale_a)² + (b * scale_b)²). No fused multiply-add, so the
+// result does not depend on the instruction set.
+struct hypot_op {
+	double scale_a;
+	double scale_b;
+
+	double scalar(double a, double b) const {
+		const double sa = a * scale_a;
+		const double sb = b * scale_b;
+		return std::sqrt(sa * sa + sb * sb);
+	}
+#if SI_SIMD_X86
+	__m128d sse2(__m128d a, __m128d b) const {
+		const __m128d sa = _mm_mul_pd(a, _mm_set1_pd(scale_a));
+		const __m128d sb = _mm_mul_pd(b, _mm_set1_pd(scale_b));
+		return _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(sa, sa), _mm_mul_pd(sb, sb)));
+	}
+	SI_TARGET_AVX2 __m256d avx2(__m256d a, __m256d b) const {
+		const __m256d sa = _mm256_mul_pd(a, _mm256_set1_pd(scale_a));
+		const __m256d sb = _mm256_mul_pd(b, _mm256_set1_pd(scale_b));
+		return _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(sa, sa), _mm256_mul_pd(sb, sb)));
+	}
+#endif
+};
+
+
+// (a * scale_ab) * b + c * scale_c, with the product and the sum rounded once.
+struct fma_op {
+	double scale_ab;
+	double scale_c;
+
+	double scalar(double a, double b, double c) const {
+		return std::fma(a * scale_ab, b, c * scale_c);
+	}
+#if SI_SIMD_X86
+	// SSE2 has no fused multiply-add, so the scalar version is used.
+	__m128d sse2(__m128d a, __m128d b, __m128d c) const {
+		double ra[2], rb[2], rc[2];
+		_mm_storeu_pd(ra, a);
+		_mm_storeu_pd(rb, b);
+		_mm_storeu_pd(rc, c);
+		return _mm_set_pd(scalar(ra[1], rb[1], rc[1]), scalar(ra[0], rb[0], rc[0]));
+	}
+	SI_TARGET_AVX2 __m256d avx2(__m256d a, __m256d b, __m256d c) const {
+		return _mm256_fmadd_pd(_mm256_mul_pd(a, _mm256_set1_pd(scale_ab)), b, _mm256_mul_pd(c, _mm256_set1_pd(scale_c)));
+	}
+#endif
+};
+
+
+
+// Comparisons of arrays with a threshold, producing one bit per value in
+// 64-bit words (bit i % 64 of word i / 64). Only the two non-strict
+// comparisons are needed, as the thresholds are adjusted by the callers.
+
+enum comparison {
+	at_least, // value >= threshold
+	at_most,  // value <= threshold
+};
+
+
+inline int count_trailing_zeros(std::uint64_t word) {
+#if defined(__GNUC__)
+	return __builtin_ctzll(word);
+#else
+	int count = 0;
+	for(; !(word & 1); word >>= 1) {
+		count++;
+	}
+	return count;
+#endif
+}
+
+
+template <comparison C, typename T>
+bool compare(T value, T threshold) {
+	return C == at_least ? value >= threshold : value <= threshold;
+}
+
+
+// The bits of up to 64 values.
+template <comparison C, typename T>
+std::uint64_t compare_word_scalar(const T* in, std::size_t n, T threshold) {
+	std::uint64_t word = 0;
+	for(std::size_t i = 0; i < n; i++) {
+		word |= std::uint64_t(compare<C>(in[i], threshold)) << i;
+	}
+	return word;
+}
+
+
+#if SI_SIMD_X86
+
+template <comparison C>
+std::uint64_t compare_word_sse2(const double* in, std::size_t n, double threshold) {
+	const __m128d t = _mm_set1_pd(threshold);
+	std::uint64_t word = 0;
+	std::size_t i = 0;
+	for(; i + 2 <= n; i += 2) {
+		const __m128d x = _mm_loadu_pd(in + i);
+		const __m128d m = C == at_least ? _mm_cmpge_pd(x, t) : _mm_cmple_pd(x, t);
+		word |= std::uint64_t(_mm_movemask_pd(m)) << i;
+	}
+	if(i < n) {
+		word |= compare_word_scalar<C>(in + i, n - i, threshold) << i;
+	}
+	return word;
+}
+
+// SSE2 has only the strict integer comparisons, so their results are inverted.
+template <comparison C>
+std::uint64_t compare_word_sse2(const int* in, std::size_t n, int threshold) {
+	const __m128i t = _mm_set1_epi32(threshold);
+	std::uint64_t word = 0;
+	std::size_t i = 0;
+	for(; i + 4 <= n; i += 4) {
+		const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+		const __m128i m = C == at_least ? _mm_cmpgt_epi32(t, x) : _mm_cmpgt_epi32(x, t);
+		word |= std::uint64_t(~_mm_movemask_ps(_mm_castsi128_ps(m)) & 0xF) << i;
+	}
+	if(i < n) {
+		word |= compare_word_scalar<C>(in + i, n - i, threshold) << i;
+	}
+	return word;
+}
+
+
+template <comparison C>
+SI_TARGET_AVX2 std::uint64_t compare_word_avx2(const double* in, std::size_t n, double threshold) {
+	const __m256d t = _mm256_set1_pd(threshold);
+	std::uint64_t word = 0;
+	if(n == 64) {
+		// 16 values per step, to shorten the chain of shifts
+		for(std::size_t i = 0; i < 64; i += 16) {
+			const int m0 = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(in + i),      t, C == at_least ? _CMP_GE_OQ : _CMP_LE_OQ));
+			const int m1 = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(in + i + 4),  t, C == at_least ? _CMP_GE_OQ : _CMP_LE_OQ));
+			const int m2 = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(in + i + 8),  t, C == at_least ? _CMP_GE_OQ : _CMP_LE_OQ));
+			const int m3 = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(in + i + 12), t, C == at_least ? _CMP_GE_OQ : _CMP_LE_OQ));
+			word |= std::uint64_t(m0 | m1 << 4 | m2 << 8 | m3 << 12) << i;
+		}
+		return word;
+	}
+	std::size_t i = 0;
+	for(; i + 4 <= n; i += 4) {
+		const __m256d x = _mm256_loadu_pd(in + i);
+		const __m256d m = _mm256_cmp_pd(x, t, C == at_least ? _CMP_GE_OQ : _CMP_LE_OQ);
+		word |= std::uint64_t(_mm256_movemask_pd(m)) << i;
+	}
+	if(i < n) {
+		word |= compare_word_scalar<C>(in + i, n - i, threshold) << i;
+	}
+	return word;
+}
+
+template <comparison C>
+SI_TARGET_AVX2 std::uint64_t compare_word_avx2(const int* in, std::size_t n, int threshold) {
+	const __m256i t = _mm256_set1_epi32(threshold);
+	std::uint64_t word = 0;
+	if(n == 64) {
+		// 16 values per step, to shorten the chain of shifts. The results are inverted once.
+		for(std::size_t i = 0; i < 64; i += 16) {
+			const __m256i x0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+			const __m256i x1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i + 8));
+			const __m256i m0 = C == at_least ? _mm256_cmpgt_epi32(t, x0) : _mm256_cmpgt_epi32(x0, t);
+			const __m256i m1 = C == at_least ? _mm256_cmpgt_epi32(t, x1) : _mm256_cmpgt_epi32(x1, t);
+			const int bits = _mm256_movemask_ps(_mm256_castsi256_ps(m0))
+			               | _mm256_movemask_ps(_mm256_castsi256_ps(m1)) << 8;
+			word |= std::uint64_t(bits) << i;
+		}
+		return ~word;
+	}
+	std::size_t i = 0;
+	for(; i + 8 <= n; i += 8) {
+		const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+		const __m256i m = C == at_least ? _mm256_cmpgt_epi32(t, x) : _mm256_cmpgt_epi32(x, t);
+		word |= std::uint64_t(~_mm256_movemask_ps(_mm256_castsi256_ps(m)) & 0xFF) << i;
+	}
+	if(i < n) {
+		word |= compare_word_scalar<C>(in + i, n - i, threshold) << i;
+	}
+	return word;
+}
+
+
+template <comparison C, typename T>
+SI_TARGET_AVX2 void compare_avx2(const T* in, std::size_t n, T threshold, std::uint64_t* words) {
+	for(std::size_t i = 0; i < n; i += 64) {
+		words[i / 64] = compare_word_avx2<C>(in + i, n - i < 64 ? n - i : 64, threshold);
+	}
+}
+
+template <comparison C, typename T>
+void compare_sse2(const T* in, std::size_t n, T threshold, std::uint64_t* words) {
+	for(std::size_t i = 0; i < n; i += 64) {
+		words[i / 64] = compare_word_sse2<C>(in + i, n - i < 64 ? n - i : 64, threshold);
+	}
+}
+
+#endif /* SI_SIMD_X86 */
+
+
+template <comparison C, typename T>
+void compare_scalar(const T* in, std::size_t n, T threshold, std::uint64_t* words) {
+	for(std::size_t i = 0; i < n; i += 64) {
+		words[i / 64] = compare_word_scalar<C>(in + i, n - i < 64 ? n - i : 64, threshold);
+	}
+}
+
+
+// Writes the (n + 63) / 64 words with the results of comparing n values.
+template <comparison C, typename T>
+void compare(const T* in, std::size_t n, T threshold, std::uint64_t* words) {
+	compare_scalar<C>(in, n, threshold, words);
+}
+
+template <comparison C>
+void compare(const double* in, std::size_t n, double threshold, std::uint64_t* words) {
+#if SI_SIMD_X86
+	switch(supported_level()) {
+	case avx2_level: compare_avx2<C>(in, n, threshold, words); return;
+	case sse2_level: compare_sse2<C>(in, n, threshold, words); return;
+	default: break;
+	}
+#endif
+	compare_scalar<C>(in, n, threshold, words);
+}
+
+template <comparison C>
+void compare(const int* in, std::size_t n, int threshold, std::uint64_t* words) {
+#if SI_SIMD_X86
+	switch(supported_level()) {
+	case avx2_level: compare_avx2<C>(in, n, threshold, words); return;
+	case sse2_level: compare_sse2<C>(in, n, threshold, words); return;
+	default: break;
+	}
+#endif
+	compare_scalar<C>(in, n, threshold, words);
+}
+
+
+
+// The number of values that satisfy the comparison. The vector comparison
+// results (all bits set, that is -1) are subtracted from lane counters.
+template <comparison C, typename T>
+std::size_t count_scalar(const T* in, std::size_t n, T threshold) {
+	std::size_t count = 0;
+	for(std::size_t i = 0; i < n; i++) {
+		count += compare<C>(in[i], threshold);
+	}
+	return count;
+}
+
+
+#if SI_SIMD_X86
+
+// Values per block of integer counting, so the 32-bit lane counters can't overflow.
+const std::size_t count_block = std::size_t(1) << 20;
+
+
+template <comparison C>
+std::size_t count_sse2(const double* in, std::size_t n, double threshold) {
+	const __m128d t = _mm_set1_pd(threshold);
+	__m128i counts = _mm_setzero_si128();
+	std::size_t i = 0;
+	for(; i + 2 <= n; i += 2) {
+		const __m128d x = _mm_loadu_pd(in + i);
+		const __m128d m = C == at_least ? _mm_cmpge_pd(x, t) : _mm_cmple_pd(x, t);
+		counts = _mm_sub_epi64(counts, _mm_castpd_si128(m));
+	}
+	std::uint64_t lanes[2];
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), counts);
+	return std::size_t(lanes[0] + lanes[1]) + count_scalar<C>(in + i, n - i, threshold);
+}
+
+// Counts the failed (strict) comparisons, and subtracts them.
+template <comparison C>
+std::size_t count_sse2(const int* in, std::size_t n, int threshold) {
+	const __m128i t = _mm_set1_epi32(threshold);
+	std::size_t count = 0;
+	std::size_t i = 0;
+	while(i + 4 <= n) {
+		const std::size_t end = std::min(n, i + count_block);
+		const std::size_t begin = i;
+		__m128i failed = _mm_setzero_si128();
+		for(; i + 4 <= end; i += 4) {
+			const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+			failed = _mm_sub_epi32(failed, C == at_least ? _mm_cmpgt_epi32(t, x) : _mm_cmpgt_epi32(x, t));
+		}
+		std::uint32_t lanes[4];
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), failed);
+		count += (i - begin) - (std::size_t(lanes[0]) + lanes[1] + lanes[2] + lanes[3]);
+	}
+	return count + count_scalar<C>(in + i, n - i, threshold);
+}
+
+
+// Two vectors per iteration, with separate counters.
+template <comparison C>
+SI_TARGET_AVX2 std::size_t count_avx2(const double* in, std::size_t n, double threshold) {
+	const __m256d t = _mm256_set1_pd(threshold);
+	__m256i counts0 = _mm256_setzero_si256();
+	__m256i counts1 = _mm256_setzero_si256();
+	std::size_t i = 0;
+	for(; i + 8 <= n; i += 8) {
+		const __m256d m0 = _mm256_cmp_pd(_mm256_loadu_pd(in + i),     t, C == at_least ? _CMP_GE_OQ : _CMP_LE_OQ);
+		const __m256d m1 = _mm256_cmp_pd(_mm256_loadu_pd(in + i + 4), t, C == at_least ? _CMP_GE_OQ : _CMP_LE_OQ);
+		counts0 = _mm256_sub_epi64(counts0, _mm256_castpd_si256(m0));
+		counts1 = _mm256_sub_epi64(counts1, _mm256_castpd_si256(m1));
+	}
+	std::uint64_t lanes[4];
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), _mm256_add_epi64(counts0, counts1));
+	return std::size_t(lanes[0] + lanes[1] + lanes[2] + lanes[3]) + count_scalar<C>(in + i, n - i, threshold);
+}
+
+template <comparison C>
+SI_TARGET_AVX2 std::size_t count_avx2(const int* in, std::size_t n, int threshold) {
+	const __m256i t = _mm256_set1_epi32(threshold);
+	std::size_t count = 0;
+	std::size_t i = 0;
+	while(i + 16 <= n) {
+		const std::size_t end = std::min(n, i + count_block);
+		const std::size_t begin = i;
+		__m256i failed0 = _mm256_setzero_si256();
+		__m256i failed1 = _mm256_setzero_si256();
+		for(; i + 16 <= end; i += 16) {
+			const __m256i x0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+			const __m256i x1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i + 8));
+			failed0 = _mm256_sub_epi32(failed0, C == at_least ? _mm256_cmpgt_epi32(t, x0) : _mm256_cmpgt_epi32(x0, t));
+			failed1 = _mm256_sub_epi32(failed1, C == at_least ? _mm256_cmpgt_epi32(t, x1) : _mm256_cmpgt_epi32(x1, t));
+		}
+		std::uint32_t lanes[8];
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), _mm256_add_epi32(failed0, failed1));
+		std::size_t failed = 0;
+		for(int l = 0; l < 8; l++) {
+			failed += lanes[l];
+		}
+		count += (i - begin) - failed;
+	}
+	return count + count_scalar<C>(in + i, n - i, threshold);
+}
+
+#endif /* SI_SIMD_X86 */
+
+
+template <comparison C, typename T>
+std::size_t count(const T* in, std::size_t n, T threshold) {
+	return count_scalar<C>(in, n, threshold);
+}
+
+template <comparison C>
+std::size_t count(const double* in, std::size_t n, double threshold) {
+#if SI_SIMD_X86
+	switch(supported_level()) {
+	case avx2_level: return count_avx2<C>(in, n, threshold);
+	case sse2_level: return count_sse2<C>(in, n, threshold);
+	default: break;
+	}
+#endif
+	return count_scalar<C>(in, n, threshold);
+}
+
+template <comparison C>
+std::size_t count(const int* in, std::size_t n, int threshold) {
+#if SI_SIMD_X86
+	switch(supported_level()) {
+	case avx2_level: return count_avx2<C>(in, n, threshold);
+	case sse2_level: return count_sse2<C>(in, n, threshold);
+	default: break;
+	}
+#endif
+	return count_scalar<C>(in, n, threshold);
+}
+
+
+// Kernels over series whose terms are computed from their index: the sum of
+// the terms, their running sums, and the terms themselves. Each op has a
+// scalar(i) version and, on x86, sse2(i) and avx2(i) versions computing the
+// terms i to i + 1 and i to i + 3. The kernels call the vector versions with
+// even indices only.
+
+template <typename Op>
+double sum_scalar(const Op& op, std::size_t i, std::size_t n) {
+	double sum = 0;
+	for(; i < n; i++) {
+		sum += op.scalar(i);
+	}
+	return sum;
+}
+
+// Writes carry + op(begin) + ... + op(i) to out[i], for begin <= i < n.
+template <typename Op>
+void scan_scalar(const Op& op, std::size_t i, std::size_t n, double* out, double carry) {
+	for(; i < n; i++) {
+		carry += op.scalar(i);
+		out[i] = carry;
+	}
+}
+
+template <typename Op>
+void each_scalar(const Op& op, std::size_t i, std::size_t n, double* out) {
+	for(; i < n; i++) {
+		out[i] = op.scalar(i);
+	}
+}
+
+
+#if SI_SIMD_X86
+
+// Two accumulators, to hide the latency of the additions.
+template <typename Op>
+double sum_sse2(const Op& op, std::size_t n) {
+	__m128d s0 = _mm_setzero_pd();
+	__m128d s1 = _mm_setzero_pd();
+	std::size_t i = 0;
+	for(; i + 4 <= n; i += 4) {
+		s0 = _mm_add_pd(s0, op.sse2(i));
+		s1 = _mm_add_pd(s1, op.sse2(i + 2));
+	}
+	double lanes[2];
+	_mm_storeu_pd(lanes, _mm_add_pd(s0, s1));
+	return lanes[0] + lanes[1] + sum_scalar(op, i, n);
+}
+
+// The running sums of each pair of terms are computed in the register, and
+// only the sum of the previous pairs (broadcast to both lanes) is carried
+// from one step to the next.
+template <typename Op>
+void scan_sse2(const Op& op, std::size_t n, double* out) {
+	__m128d carry = _mm_setzero_pd();
+	std::size_t i = 0;
+	for(; i + 2 <= n; i += 2) {
+		const __m128d t = op.sse2(i);
+		const __m128d r = _mm_add_pd(_mm_add_pd(t, _mm_unpacklo_pd(_mm_setzero_pd(), t)), carry);
+		_mm_storeu_pd(out + i, r);
+		carry = _mm_unpackhi_pd(r, r);
+	}
+	scan_scalar(op, i, n, out, _mm_cvtsd_f64(carry));
+}
+
+template <typename Op>
+void each_sse2(const Op& op, std::size_t n, double* out) {
+	std::size_t i = 0;
+	for(; i + 2 <= n; i += 2) {
+		_mm_storeu_pd(out + i, op.sse2(i));
+	}
+	each_scalar(op, i, n, out);
+}
+
+
+template <typename Op>
+SI_TARGET_AVX2 double sum_avx2(const Op& op, std::size_t n) {
+	__m256d s0 = _mm256_setzero_pd();
+	__m256d s1 = _mm256_setzero_pd();
+	std::size_t i = 0;
+	for(; i + 8 <= n; i += 8) {
+		s0 = _mm256_add_pd(s0, op.avx2(i));
+		s1 = _mm256_add_pd(s1, op.avx2(i + 4));
+	}
+	double lanes[4];
+	_mm256_storeu_pd(lanes, _mm256_add_pd(s0, s1));
+	return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + sum_scalar(op, i, n);
+}
+
+// The running sums of 4 values: two steps of shifting by 1 and 2 lanes and adding.
+SI_TARGET_AVX2 inline __m256d running_sums_avx2(__m256d x) {
+	const __m256d zero = _mm256_setzero_pd();
+	x = _mm256_add_pd(x, _mm256_blend_pd(_mm256_permute4x64_pd(x, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x1));
+	return _mm256_add_pd(x, _mm256_blend_pd(_mm256_permute4x64_pd(x, _MM_SHUFFLE(1, 0, 0, 0)), zero, 0x3));
+}
+
+SI_TARGET_AVX2 inline __m256d broadcast_last_avx2(__m256d x) {
+	return _mm256_permute4x64_pd(x, _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+// Blocks of 8 terms, whose two halves are summed in the registers
+// independently. The carry from one block to the next is a single addition.
+template <typename Op>
+SI_TARGET_AVX2 void scan_avx2(const Op& op, std::size_t n, double* out) {
+	__m256d carry = _mm256_setzero_pd();
+	std::size_t i = 0;
+	for(; i + 8 <= n; i += 8) {
+		const __m256d t0 = running_sums_avx2(op.avx2(i));
+		const __m256d t1 = running_sums_avx2(op.avx2(i + 4));
+		const __m256d c0 = broadcast_last_avx2(t0);
+		_mm256_storeu_pd(out + i,     _mm256_add_pd(t0, carry));
+		_mm256_storeu_pd(out + i + 4, _mm256_add_pd(t1, _mm256_add_pd(carry, c0)));
+		carry = _mm256_add_pd(carry, _mm256_add_pd(c0, broadcast_last_avx2(t1)));
+	}
+	scan_scalar(op, i, n, out, _mm256_cvtsd_f64(carry));
+}
+
+template <typename Op>
+SI_TARGET_AVX2 void each_avx2(const Op& op, std::size_t n, double* out) {
+	std::size_t i = 0;
+	for(; i + 8 <= n; i += 8) {
+		const __m256d r0 = op.avx2(i);
+		const __m256d r1 = op.avx2(i + 4);
+		_mm256_storeu_pd(out + i,     r0);
+		_mm256_storeu_pd(out + i + 4, r1);
+	}
+	for(; i + 4 <= n; i += 4) {
+		_mm256_storeu_pd(out + i, op.avx2(i));
+	}
+	each_scalar(op, i, n, out);
+}
+
+#endif /* SI_SIMD_X86 */
+
+
+// The sum of the terms 0 to n - 1.
+template <typename Op>
+double sum(const Op& op, std::size_t n) {
+#if SI_SIMD_X86
+	switch(supported_level()) {
+	case avx2_level: return sum_avx2(op, n);
+	case sse2_level: return sum_sse2(op, n);
+	default: break;
+	}
+#endif
+	return sum_scalar(op, 0, n);
+}
+
+// Writes the sum of the terms 0 to i to out[i], for i < n.
+template <typename Op>
+void scan(const Op& op, std::size_t n, double* out) {
+#if SI_SIMD_X86
+	switch(supported_level()) {
+	case avx2_level: scan_avx2(op, n, out); return;
+	case sse2_level: scan_sse2(op, n, out); return;
+	default: break;
+	}
+#endif
+	scan_scalar(op, 0, n, out, 0);
+}
+
+// Writes the term i to out[i], for i < n.
+template <typename Op>
+void each(const Op& op, std::size_t n, double* out) {
+#if SI_SIMD_X86
+	switch(supported_level()) {
+	case avx2_level: each_avx2(op, n, out); return;
+	case sse2_level: each_sse2(op, n, out); return;
+	default: break;
+	}
+#endif
+	each_scalar(op, 0, n, out);
+}
+
+
+
+// (y[i] + y[i + 1]) * (x[i + 1] - x[i]) * scale: twice the area of the
+// trapezoid i, scaled.
+struct trapezoid_op {
+	const double* x;
+	const double* y;
+	double scale;
+
+	double scalar(std::size_t i) const {
+		return (y[i] + y[i + 1]) * (x[i + 1] - x[i]) * scale;
+	}
+#if SI_SIMD_X86
+	__m128d sse2(std::size_t i) const {
+		const __m128d sum = _mm_add_pd(_mm_loadu_pd(y + i), _mm_loadu_pd(y + i + 1));
+		const __m128d width = _mm_sub_pd(_mm_loadu_pd(x + i + 1), _mm_loadu_pd(x + i));
+		return _mm_mul_pd(_mm_mul_pd(sum, width), _mm_set1_pd(scale));
+	}
+	SI_TARGET_AVX2 __m256d avx2(std::size_t i) const {
+		const __m256d sum = _mm256_add_pd(_mm256_loadu_pd(y + i), _mm256_loadu_pd(y + i + 1));
+		const __m256d width = _mm256_sub_pd(_mm256_loadu_pd(x + i + 1), _mm256_loadu_pd(x + i));
+		return _mm256_mul_pd(_mm256_mul_pd(sum, width), _mm256_set1_pd(scale));
+	}
+#endif
+};
+
+
+// (y[i] + y[i + 1]) * scale: the trapezoid i over a constant step, scaled.
+struct uniform_trapezoid_op {
+	const double* y;
+	double scale;
+
+	double scalar(std::size_t i) const {
+		return (y[i] + y[i + 1]) * scale;
+	}
+#if SI_SIMD_X86
+	__m128d sse2(std::size_t i) const {
+		return _mm_mul_pd(_mm_add_pd(_mm_loadu_pd(y + i), _mm_loadu_pd(y + i + 1)), _mm_set1_pd(scale));
+	}
+	SI_TARGET_AVX2 __m256d avx2(std::size_t i) const {
+		return _mm256_mul_pd(_mm256_add_pd(_mm256_loadu_pd(y + i), _mm256_loadu_pd(y + i + 1)), _mm256_set1_pd(scale));
+	}
+#endif
+};
+
+
+// y[i] * even or y[i] * odd, by the parity of i: the weights of the Simpson rule.
+struct alternating_op {
+	const double* y;
+	double even;
+	double odd;
+
+	double scalar(std::size_t i) const {
+		return y[i] * (i % 2 ? odd : even);
+	}
+#if SI_SIMD_X86
+	__m128d sse2(std::size_t i) const {
+		return _mm_mul_pd(_mm_loadu_pd(y + i), _mm_set_pd(odd, even));
+	}
+	SI_TARGET_AVX2 __m256d avx2(std::size_t i) const {
+		return _mm256_mul_pd(_mm256_loadu_pd(y + i), _mm256_set_pd(odd, even, odd, even));
+	}
+#endif
+};
+
+
+// The derivative at i + 1 from its neighbours, with a constant step:
+// (y[i + 2] - y[i]) * scale.
+struct central_difference_op {
+	const double* y;
+	double scale;
+
+	double scalar(std::size_t i) const {
+		return (y[i + 2] - y[i]) * scale;
+	}
+#if SI_SIMD_X86
+	__m128d sse2(std::size_t i) const {
+		return _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(y + i + 2), _mm_loadu_pd(y + i)), _mm_set1_pd(scale));
+	}
+	SI_TARGET_AVX2 __m256d avx2(std::size_t i) const {
+		return _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(y + i + 2), _mm256_loadu_pd(y + i)), _mm256_set1_pd(scale));
+	}
+#endif
+};
+
+
+// The derivative at i + 1 from its neighbours: the average of the slopes on
+// both sides, each weighted by the width of the other side, with a single
+// division. Exact for a parabola. Unfused, like hypot_op, so that all the
+// instruction sets give the same result.
+//     (a² (y[i + 2] - y[i + 1]) + b² (y[i + 1] - y[i])) / (a b (a + b)) * scale
+// where a and b are the widths of the intervals before and after i + 1.
+struct gradient_op {
+	const double* x;
+	const double* y;
+	double scale;
+
+	double scalar(std::size_t i) const {
+		const double a = x[i + 1] - x[i];
+		const double b = x[i + 2] - x[i + 1];
+		const double s = a * a * (y[i + 2] - y[i + 1]) + b * b * (y[i + 1] - y[i]);
+		return s / (a * b * (a + b)) * scale;
+	}
+#if SI_SIMD_X86
+	__m128d sse2(std::size_t i) const {
+		const __m128d x0 = _mm_loadu_pd(x + i), x1 = _mm_loadu_pd(x + i + 1), x2 = _mm_loadu_pd(x + i + 2);
+		const __m128d y0 = _mm_loadu_pd(y + i), y1 = _mm_loadu_pd(y + i + 1), y2 = _mm_loadu_pd(y + i + 2);
+		const __m128d a = _mm_sub_pd(x1, x0);
+		const __m128d b = _mm_sub_pd(x2, x1);
+		const __m128d s = _mm_add_pd(_mm_mul_pd(_mm_mul_pd(a, a), _mm_sub_pd(y2, y1)),
+		                             _mm_mul_pd(_mm_mul_pd(b, b), _mm_sub_pd(y1, y0)));
+		const __m128d d = _mm_mul_pd(_mm_mul_pd(a, b), _mm_add_pd(a, b));
+		return _mm_mul_pd(_mm_div_pd(s, d), _mm_set1_pd(scale));
+	}
+	SI_TARGET_AVX2 __m256d avx2(std::size_t i) const {
+		const __m256d x0 = _mm256_loadu_pd(x + i), x1 = _mm256_loadu_pd(x + i + 1), x2 = _mm256_loadu_pd(x + i + 2);
+		const __m256d y0 = _mm256_loadu_pd(y + i), y1 = _mm256_loadu_pd(y + i + 1), y2 = _mm256_loadu_pd(y + i + 2);
+		const __m256d a = _mm256_sub_pd(x1, x0);
+		const __m256d b = _mm256_sub_pd(x2, x1);
+		const __m256d s = _mm256_add_pd(_mm256_mul_pd(_mm256_mul_pd(a, a), _mm256_sub_pd(y2, y1)),
+		                                _mm256_mul_pd(_mm256_mul_pd(b, b), _mm256_sub_pd(y1, y0)));
+		const __m256d d = _mm256_mul_pd(_mm256_mul_pd(a, b), _mm256_add_pd(a, b));
+		return _mm256_mul_pd(_mm256_div_pd(s, d), _mm256_set1_pd(scale));
+	}
+#endif
+};
+
+
+} /* namespace si::_simd */
+} /* namespace si */
+
+
+#endif /* SI_SIMD_HPP_ */
@@ -0,0 +1,268 @@
+#ifndef SI_SORTING_HPP_
+#define SI_SORTING_HPP_
+
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "span.hpp"
+
+
+namespace si {
+
+
+namespace _sorting {
+
+
+// Maps the values of an underlying type to unsigned keys with the same order.
+template <typename T, bool _Integral = std::is_integral<T>::value>
+struct key_traits;
+
+// Unsigned integers are their own keys. The sign bit of signed integers is
+// flipped, so negative values come first.
+template <typename T>
+struct key_traits<T, true> {
+	typedef typename std::make_unsigned<T>::type Key;
+	static const Key flip = std::is_signed<T>::value ? Key(Key(1) << (sizeof(T) * 8 - 1)) : Key(0);
+
+	static Key to_key(T value) {
+		return Key(value) ^ flip;
+	}
+	static T from_key(Key key) {
+		return T(key ^ flip);
+	}
+};
+
+// The sign bit of positive floating point values is set, and all the bits
+// of negative values are inverted, so their order is reversed and they come
+// first. NaNs with the sign bit set come first, and the others last.
+template <typename T>
+struct key_traits<T, false> {
+	static_assert(std::is_floating_point<T>::value  &&  (sizeof(T) == 4  ||  sizeof(T) == 8),
+	              "Radix sort requires an integer, float or double underlying type");
+	typedef typename std::conditional<sizeof(T) == 4, std::uint32_t, std::uint64_t>::type Key;
+	static const Key sign = Key(Key(1) << (sizeof(T) * 8 - 1));
+
+	static Key to_key(T value) {
+		Key bits;
+		std::memcpy(&bits, &value, sizeof(T));
+		return bits & sign ? ~bits : bits | sign;
+	}
+	static T from_key(Key key) {
+		const Key bits = key & sign ? key ^ sign : ~key;
+		T value;
+		std::memcpy(&value, &bits, sizeof(T));
+		return value;
+	}
+};
+
+
+const int radix_bits = 8;
+const std::size_t radix = std::size_t(1) << radix_bits;
+
+
+// LSD radix sort of keys by bytes. The histograms of all the bytes are
+// counted in a single pass, and the bytes with the same value in all keys
+// are skipped. Returns the array with the sorted keys, which is either
+// keys or buffer.
+template <typename Key>
+Key* radix_sort(Key* keys, Key* buffer, std::size_t n) {
+	const int digits = sizeof(Key);
+	std::vector<std::size_t> counts(digits * radix, 0);
+	for(std::size_t i = 0; i < n; i++) {
+		for(int d = 0; d < digits; d++) {
+			counts[d * radix + ((keys[i] >> (d * radix_bits)) & (radix - 1))]++;
+		}
+	}
+
+	for(int d = 0; d < digits; d++) {
+		std::size_t* const count = &counts[d * radix];
+		if(n == 0  ||  count[(keys[0] >> (d * radix_bits)) & (radix - 1)] == n) {
+			continue;
+		}
+
+		// Counts to offsets
+		std::size_t offset = 0;
+		for(std::size_t b = 0; b < radix; b++) {
+			const std::size_t c = count[b];
+			count[b] = offset;
+			offset += c;
+		}
+
+		for(std::size_t i = 0; i < n; i++) {
+			buffer[count[(keys[i] >> (d * radix_bits)) & (radix - 1)]++] = keys[i];
+		}
+		std::swap(keys, buffer);
+	}
+	return keys;
+}
+
+
+// Merges two sorted arrays. The loop selects the next value without a
+// branch, as which array it comes from is unpredictable.
+template <typename T>
+void merge_two(const T* a, const T* a_end, const T* b, const T* b_end, T* out) {
+	while(a != a_end  &&  b != b_end) {
+		const bool take_b = *b < *a;
+		*out++ = take_b ? *b : *a;
+		b += take_b;
+		a += !take_b;
+	}
+	out = std::copy(a, a_end, out);
+	std::copy(b, b_end, out);
+}
+
+
+// Appends the values of a run converted to OutType.
+template <typename OutType, typename SIValueType>
+void append(std::vector<typename OutType::ValueType>& values, std::vector<std::size_t>& bounds,
+            quantity_span<SIValueType> run) {
+	static_assert(std::remove_const<SIValueType>::type::Dimensions == OutType::Dimensions,
+	              "The runs must have the dimensions of the output");
+	for(std::size_t i = 0; i < run.size(); i++) {
+		values.push_back(OutType(run[i]).value);
+	}
+	bounds.push_back(values.size());
+}
+
+
+} /* namespace si::_sorting */
+
+
+
+/**
+ * @name Sorting spans
+ *
+ * All the values of a span have the same ratio, so they are ordered as their
+ * underlying values, and these functions work on the underlying values
+ * without any conversion. Runs of values with different ratios are first
+ * converted to a common type by @c merge.
+ */
+///@{
+
+
+/// Sorts the values in ascending order.
+template <typename SIValueType>
+void sort(quantity_span<SIValueType> values) {
+	std::sort(values.raw(), values.raw() + values.size());
+}
+
+
+/// Sorts the values in ascending order with an LSD radix sort.
+/**
+ * The underlying values are mapped to unsigned integer keys with the same
+ * order, which are sorted byte by byte in linear time. It is faster than
+ * @c sort for large spans, and needs memory for two copies of the keys.
+ *
+ * The underlying type must be an integer, @c float or @c double. Negative
+ * zero comes before positive zero, and NaNs come first or last depending on
+ * their sign bit.
+ */
+template <typename SIValueType>
+void radix_sort(quantity_span<SIValueType> values) {
+	typedef typename SIValueType::ValueType T;
+	typedef _sorting::key_traits<T> Traits;
+	typedef typename Traits::Key Key;
+
+	const std::size_t n = values.size();
+	T* const raw = values.raw();
+	std::vector<Key> keys(n), buffer(n);
+	for(std::size_t i = 0; i < n; i++) {
+		keys[i] = Traits::to_key(raw[i]);
+	}
+
+	const Key* const sorted = _sorting::radix_sort(keys.data(), buffer.data(), n);
+	for(std::size_t i = 0; i < n; i++) {
+		raw[i] = Traits::from_key(sorted[i]);
+	}
+}
+
+
+/// Reorders the values so the value at @c nth is the one that would be there if they were sorted.
+/**
+ * The values before it are not greater, and the values after it are not
+ * less, like @c std::nth_element.
+ */
+template <typename SIValueType>
+void nth_element(quantity_span<SIValueType> values, std::size_t nth) {
+	typename SIValueType::ValueType* const raw = values.raw();
+	std::nth_element(raw, raw + nth, raw + values.size());
+}
+
+
+/// Copies the largest values in descending order.
+/**
+ * As many values are copied as fit in @c out, up to the size of @c in.
+ *
+ * @return The number of values copied.
+ */
+template <typename SIValueType>
+std::size_t top_k(quantity_span<SIValueType> in, quantity_span<typename std::remove_const<SIValueType>::type> out) {
+	typedef typename std::remove_const<SIValueType>::type::ValueType T;
+	T* const end = std::partial_sort_copy(in.raw(), in.raw() + in.size(),
+	                                      out.raw(), out.raw() + out.size(),
+	                                      std::greater<T>());
+	return end - out.raw();
+}
+
+
+/// Merges sorted runs of values with any ratios and underlying types.
+/**
+ * Each value is converted once to the type of the output, and the runs are
+ * then merged by their underlying values, in pairs. The output must be as large as all the runs together,
+ * and its type should be able to represent all the values (for instance, an
+ * integer in centimeters for runs in centimeters and in kilometers).
+ *
+ * For example: @code
+ *     si::merge(si::quantity_span<Length_cm>(all), si::quantity_span<const Length_km>(km),
+ *               si::quantity_span<const Length_cm>(cm));
+ * @endcode
+ */
+template <typename OutType, typename... SIValueTypes>
+void merge(quantity_span<OutType> out, quantity_span<SIValueTypes>... runs) {
+	typedef typename OutType::ValueType T;
+
+	std::vector<T> values;
+	values.reserve(out.size());
+	std::vector<std::size_t> bounds(1, 0);
+	const int expand[] = { 0, (_sorting::append<OutType>(values, bounds, runs), 0)... };
+	(void)expand;
+
+	// Adjacent runs are merged in pairs, back and forth between the values
+	// and the output, until there is a single run.
+	T* source = values.data();
+	T* destination = out.raw();
+	while(bounds.size() > 2) {
+		std::vector<std::size_t> merged_bounds(1, 0);
+		for(std::size_t r = 0; r + 1 < bounds.size(); r += 2) {
+			if(r + 2 < bounds.size()) {
+				_sorting::merge_two(source + bounds[r], source + bounds[r + 1],
+				                    source + bounds[r + 1], source + bounds[r + 2],
+				                    destination + bounds[r]);
+				merged_bounds.push_back(bounds[r + 2]);
+			} else {
+				std::copy(source + bounds[r], source + bounds[r + 1], destination + bounds[r]);
+				merged_bounds.push_back(bounds[r + 1]);
+			}
+		}
+		bounds.swap(merged_bounds);
+		std::swap(source, destination);
+	}
+	if(source != out.raw()) {
+		std::copy(values.begin(), values.end(), out.raw());
+	}
+}
+
+
+///@}
+
+
+} /* namespace si */
+
+
+#endif /* SI_SORTING_HPP_ */
@@ -0,0 +1,108 @@
+#ifndef SI_SPAN_HPP_
+#define SI_SPAN_HPP_
+
+
+#include <cstddef>
+#include <type_traits>
+#include "si_value.hpp"
+
+
+namespace si {
+
+
+/**
+ * @brief A non-owning view of a contiguous array of SI values.
+ *
+ * @details The bulk operations over SI values take their arguments as spans.
+ * A span of constant values (<tt>quantity_span<const Length_m></tt>) can be
+ * built from a span of mutable values, from an array, or from any container
+ * with contiguous storage and @c data() and @c size() members (like
+ * @c std::vector).
+ *
+ * The underlying values can be accessed directly with @c raw(), since an SI
+ * value has the same layout as its underlying type.
+ *
+ * @tparam SIValueType The type of the values, possibly const-qualified.
+ */
+template <typename SIValueType>
+class quantity_span {
+public:
+	typedef SIValueType element_type;
+	typedef typename std::remove_const<SIValueType>::type value_type;
+
+	/// The underlying type of the values, const-qualified like the values.
+	typedef typename std::conditional<std::is_const<SIValueType>::value,
+		const typename value_type::ValueType,
+		typename value_type::ValueType
+	>::type raw_type;
+
+	static_assert(std::is_standard_layout<value_type>::value  &&
+	              sizeof(value_type) == sizeof(typename value_type::ValueType),
+	              "An SI value must have the same layout as its underlying type");
+
+
+	/// An empty span.
+	quantity_span() : _data(nullptr), _size(0) {}
+
+	quantity_span(SIValueType* data, std::size_t size) : _data(data), _size(size) {}
+
+	template <std::size_t N>
+	quantity_span(SIValueType (&array)[N]) : _data(array), _size(N) {}
+
+	/// A view of a container with contiguous storage.
+	template <typename Container,
+	          typename = typename std::enable_if<
+	              std::is_convertible<decltype(std::declval<Container&>().data()), SIValueType*>::value
+	          >::type>
+	quantity_span(Container& container) : _data(container.data()), _size(container.size()) {}
+
+	/// Conversion from a span of mutable values to a span of constant values.
+	template <typename SIValueType2,
+	          typename = typename std::enable_if<std::is_convertible<SIValueType2*, SIValueType*>::value>::type>
+	quantity_span(const quantity_span<SIValueType2>& other) : _data(other.data()), _size(other.size()) {}
+
+
+	SIValueType* data() const {
+		return _data;
+	}
+
+	std::size_t size() const {
+		return _size;
+	}
+
+	bool empty() const {
+		return _size == 0;
+	}
+
+	SIValueType& operator[](std::size_t i) const {
+		return _data[i];
+	}
+
+	SIValueType* begin() const {
+		return _data;
+	}
+
+	SIValueType* end() const {
+		return _data + _size;
+	}
+
+	/// The underlying values.
+	raw_type* raw() const {
+		return reinterpret_cast<raw_type*>(_data);
+	}
+
+	/// A view of @c count values starting at @c offset.
+	quantity_span subspan(std::size_t offset, std::size_t count) const {
+		return quantity_span(_data + offset, count);
+	}
+
+private:
+	SIValueType* _data;
+	std::size_t _size;
+};
+
+
+} /* namespace si */
+
+
+#endif /* SI_SPAN_HPP_ */
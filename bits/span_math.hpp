@@ -0,0 +1,272 @@
+#ifndef SI_SPAN_MATH_HPP_
+#define SI_SPAN_MATH_HPP_
+
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include "dimension_code.hpp"
+#include "operations.hpp"
+#include "funcs.hpp"
+#include "simd.hpp"
+#include "span.hpp"
+
+
+namespace si {
+
+
+namespace _span_math {
+
+
+template <typename Ratio>
+double ratio_value() {
+	return double(Ratio::num) / Ratio::den;
+}
+
+// The factor that converts a double in RatioFrom to a double in RatioTo.
+template <typename RatioFrom, typename RatioTo>
+double scale() {
+	return ratio_value<typename std::ratio_divide<RatioFrom, RatioTo>::type>();
+}
+
+
+// Whether all the SI value types have double as the underlying type, which
+// selects the vectorized versions of the operations.
+template <typename... SIValueTypes>
+struct all_double;
+
+template <>
+struct all_double<> : std::true_type {};
+
+template <typename SIValueType, typename... SIValueTypes>
+struct all_double<SIValueType, SIValueTypes...>
+	: std::integral_constant<bool,
+		std::is_same<typename std::remove_const<SIValueType>::type::ValueType, double>::value  &&
+		all_double<SIValueTypes...>::value>
+{};
+
+
+template <typename In, typename Out>
+void sqrt(quantity_span<In> in, quantity_span<Out> out, std::true_type) {
+	typedef typename std::remove_const<In>::type InType;
+	const _simd::sqrt_op op = {
+		std::sqrt(ratio_value<typename InType::Ratio>()) / ratio_value<typename Out::Ratio>()
+	};
+	_simd::map(in.raw(), out.raw(), in.size(), op);
+}
+
+template <typename In, typename Out>
+void sqrt(quantity_span<In> in, quantity_span<Out> out, std::false_type) {
+	for(std::size_t i = 0; i < in.size(); i++) {
+		out[i] = std::sqrt(in[i]);
+	}
+}
+
+
+template <typename In, typename Out>
+void abs(quantity_span<In> in, quantity_span<Out> out, std::true_type) {
+	typedef typename std::remove_const<In>::type InType;
+	const _simd::abs_op op = { scale<typename InType::Ratio, typename Out::Ratio>() };
+	_simd::map(in.raw(), out.raw(), in.size(), op);
+}
+
+template <typename In, typename Out>
+void abs(quantity_span<In> in, quantity_span<Out> out, std::false_type) {
+	for(std::size_t i = 0; i < in.size(); i++) {
+		out[i] = std::abs(in[i]);
+	}
+}
+
+
+// The bounds are already converted to the type of the input.
+template <typename In, typename Out, typename Bound>
+void clamp(quantity_span<In> in, const Bound& lo, const Bound& hi, quantity_span<Out> out, std::true_type) {
+	const _simd::clamp_op op = {
+		lo.value, hi.value,
+		scale<typename Bound::Ratio, typename Out::Ratio>()
+	};
+	_simd::map(in.raw(), out.raw(), in.size(), op);
+}
+
+template <typename In, typename Out, typename Bound>
+void clamp(quantity_span<In> in, const Bound& lo, const Bound& hi, quantity_span<Out> out, std::false_type) {
+	for(std::size_t i = 0; i < in.size(); i++) {
+		out[i] = in[i] < lo ? lo : (hi < in[i] ? hi : in[i]);
+	}
+}
+
+
+template <typename In1, typename In2, typename Out>
+void hypot(quantity_span<In1> a, quantity_span<In2> b, quantity_span<Out> out, std::true_type) {
+	typedef typename std::remove_const<In1>::type InType1;
+	typedef typename std::remove_const<In2>::type InType2;
+	const _simd::hypot_op op = {
+		scale<typename InType1::Ratio, typename Out::Ratio>(),
+		scale<typename InType2::Ratio, typename Out::Ratio>()
+	};
+	_simd::map(a.raw(), b.raw(), out.raw(), a.size(), op);
+}
+
+template <typename In1, typename In2, typename Out>
+void hypot(quantity_span<In1> a, quantity_span<In2> b, quantity_span<Out> out, std::false_type) {
+	for(std::size_t i = 0; i < a.size(); i++) {
+		out[i] = std::hypot(a[i], b[i]);
+	}
+}
+
+
+template <typename In1, typename In2, typename In3, typename Out>
+void fma(quantity_span<In1> a, quantity_span<In2> b, quantity_span<In3> c, quantity_span<Out> out, std::true_type) {
+	typedef typename std::remove_const<In1>::type InType1;
+	typedef typename std::remove_const<In2>::type InType2;
+	typedef typename std::remove_const<In3>::type InType3;
+	typedef typename std::ratio_multiply<typename InType1::Ratio, typename InType2::Ratio>::type ProductRatio;
+	const _simd::fma_op op = {
+		scale<ProductRatio, typename Out::Ratio>(),
+		scale<typename InType3::Ratio, typename Out::Ratio>()
+	};
+	_simd::map(a.raw(), b.raw(), c.raw(), out.raw(), a.size(), op);
+}
+
+template <typename In1, typename In2, typename In3, typename Out>
+void fma(quantity_span<In1> a, quantity_span<In2> b, quantity_span<In3> c, quantity_span<Out> out, std::false_type) {
+	for(std::size_t i = 0; i < a.size(); i++) {
+		out[i] = a[i] * b[i] + c[i];
+	}
+}
+
+
+} /* namespace si::_span_math */
+
+
+
+/**
+ * @name Operations over spans
+ *
+ * These functions apply an operation to each value of the input spans and
+ * store the results in the output span, which must be at least as large as
+ * the (first) input span. The output may be one of the inputs.
+ *
+ * The inputs and the output may have different ratios, which are converted by
+ * factors computed once per call. The output must have the dimensions of the
+ * result of the operation, which is checked at compile time.
+ *
+ * When all the underlying types are @c double, the values are processed with
+ * AVX2 or SSE2 instructions, selected at runtime (see @c SI_SIMD_X86).
+ * Otherwise each result is computed as the operation on single values would.
+ */
+///@{
+
+
+/// Square root of each value.
+/**
+ * The square of the dimensions of @c Out must be the dimensions of @c In.
+ *
+ * @see std::sqrt(const SIValue&)
+ */
+template <typename In, typename Out>
+void sqrt(quantity_span<In> in, quantity_span<Out> out) {
+	typedef typename std::remove_const<In>::type InType;
+	static_assert(all_dimensions_even(InType::Dimensions),
+	              "The square root requires even powers in the dimensions");
+	static_assert(Out::Dimensions == half_dimensions(InType::Dimensions),
+	              "The result must have half the dimensions of the argument");
+	_span_math::sqrt(in, out, _span_math::all_double<In, Out>());
+}
+
+
+/// Absolute value of each value.
+template <typename In, typename Out>
+void abs(quantity_span<In> in, quantity_span<Out> out) {
+	typedef typename std::remove_const<In>::type InType;
+	static_assert(Out::Dimensions == InType::Dimensions,
+	              "The result must have the dimensions of the argument");
+	_span_math::abs(in, out, _span_math::all_double<In, Out>());
+}
+
+
+/// Each value limited to the range [@c lo, @c hi].
+/**
+ * The bounds are converted once to the type of the input values.
+ */
+template <typename In, typename Out, typename Bound>
+void clamp(quantity_span<In> in, const Bound& lo, const Bound& hi, quantity_span<Out> out) {
+	typedef typename std::remove_const<In>::type InType;
+	static_assert(Out::Dimensions == InType::Dimensions  &&  Bound::Dimensions == InType::Dimensions,
+	              "The bounds and the result must have the dimensions of the argument");
+	_span_math::clamp(in, InType(lo), InType(hi), out, _span_math::all_double<In, Out>());
+}
+
+
+/// The lesser of each value and @c bound.
+template <typename In, typename Out, typename Bound>
+void min(quantity_span<In> in, const Bound& bound, quantity_span<Out> out) {
+	typedef typename std::remove_const<In>::type InType;
+	typedef typename InType::ValueType ValueType;
+	static_assert(Out::Dimensions == InType::Dimensions  &&  Bound::Dimensions == InType::Dimensions,
+	              "The bound and the result must have the dimensions of the argument");
+	const InType lowest(std::numeric_limits<ValueType>::has_infinity ?
+	                    -std::numeric_limits<ValueType>::infinity() :
+	                    std::numeric_limits<ValueType>::lowest());
+	_span_math::clamp(in, lowest, InType(bound), out, _span_math::all_double<In, Out>());
+}
+
+
+/// The greater of each value and @c bound.
+template <typename In, typename Out, typename Bound>
+void max(quantity_span<In> in, const Bound& bound, quantity_span<Out> out) {
+	typedef typename std::remove_const<In>::type InType;
+	typedef typename InType::ValueType ValueType;
+	static_assert(Out::Dimensions == InType::Dimensions  &&  Bound::Dimensions == InType::Dimensions,
+	              "The bound and the result must have the dimensions of the argument");
+	const InType highest(std::numeric_limits<ValueType>::has_infinity ?
+	                     std::numeric_limits<ValueType>::infinity() :
+	                     std::numeric_limits<ValueType>::max());
+	_span_math::clamp(in, InType(bound), highest, out, _span_math::all_double<In, Out>());
+}
+
+
+/// <tt>sqrt(a² + b²)</tt> of each pair of values.
+/**
+ * Unlike @c std::hypot, the vectorized version does not avoid overflow or
+ * underflow of the intermediate squares.
+ *
+ * @see std::hypot(const SIValue&, const SIValue&)
+ */
+template <typename In1, typename In2, typename Out>
+void hypot(quantity_span<In1> a, quantity_span<In2> b, quantity_span<Out> out) {
+	typedef typename std::remove_const<In1>::type InType1;
+	typedef typename std::remove_const<In2>::type InType2;
+	static_assert(InType2::Dimensions == InType1::Dimensions  &&  Out::Dimensions == InType1::Dimensions,
+	              "The arguments and the result must have the same dimensions");
+	_span_math::hypot(a, b, out, _span_math::all_double<In1, In2, Out>());
+}
+
+
+/// <tt>a * b + c</tt> of each triple of values.
+/**
+ * The dimensions of @c c and of the result must be the dimensions of the
+ * product <tt>a * b</tt>. The vectorized version fuses the product and the
+ * sum like @c std::fma, but @c a and @c c are first scaled to the unit of the
+ * result, which rounds unless their ratios already match.
+ */
+template <typename In1, typename In2, typename In3, typename Out>
+void fma(quantity_span<In1> a, quantity_span<In2> b, quantity_span<In3> c, quantity_span<Out> out) {
+	typedef typename std::remove_const<In1>::type InType1;
+	typedef typename std::remove_const<In2>::type InType2;
+	typedef typename std::remove_const<In3>::type InType3;
+	const dimension_code ProductDimensions = add_dimensions(InType1::Dimensions, InType2::Dimensions);
+	static_assert(InType3::Dimensions == ProductDimensions  &&  Out::Dimensions == ProductDimensions,
+	              "The addend and the result must have the dimensions of the product");
+	_span_math::fma(a, b, c, out, _span_math::all_double<In1, In2, In3, Out>());
+}
+
+
+///@}
+
+
+} /* namespace si */
+
+
+#endif /* SI_SPAN_MATH_HPP_ */
@@ -0,0 +1,333 @@
+#ifndef SI_THRESHOLDS_HPP_
+#define SI_THRESHOLDS_HPP_
+
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ratio>
+#include <type_traits>
+#include "dimension_code.hpp"
+#include "simd.hpp"
+#include "span.hpp"
+
+
+namespace si {
+
+
+namespace _threshold {
+
+
+enum comparison {
+	greater,
+	greater_equal,
+	less,
+	less_equal,
+};
+
+
+// The values are compared with the threshold by one of the non-strict kernel
+// comparisons, as the threshold is adjusted when it is converted.
+template <comparison C>
+struct kernel_comparison {
+	static const _simd::comparison value =
+		(C == greater  ||  C == greater_equal) ? _simd::at_least : _simd::at_most;
+};
+
+
+// A threshold converted to the ratio and underlying type of a column.
+template <typename T>
+struct raw_threshold {
+	T value;
+	bool none; // No value can satisfy the comparison.
+};
+
+
+template <typename Ratio, typename Bound>
+void integral_bounds(const Bound& bound, long double& floor, long double& ceil, std::false_type) {
+	typedef typename std::ratio_divide<typename Bound::Ratio, Ratio>::type Factor;
+	const long double value = (long double)bound.value * Factor::num / Factor::den;
+	floor = std::floor(value);
+	ceil = std::ceil(value);
+}
+
+// The integers below and above the bound expressed in Ratio. Exact for an
+// integer bound, unless its product by the numerator of the factor does not
+// fit in intmax_t. The result is then computed in long double, as for a
+// floating point bound.
+template <typename Ratio, typename Bound>
+void integral_bounds(const Bound& bound, long double& floor, long double& ceil, std::true_type) {
+	typedef typename std::ratio_divide<typename Bound::Ratio, Ratio>::type Factor;
+	const long double limit = std::numeric_limits<std::intmax_t>::max() / Factor::num;
+	if(std::fabs((long double)bound.value) > limit) {
+		integral_bounds<Ratio>(bound, floor, ceil, std::false_type());
+		return;
+	}
+	const std::intmax_t p = std::intmax_t(bound.value) * Factor::num;
+	const std::intmax_t quotient = p / Factor::den;
+	const std::intmax_t remainder = p % Factor::den;
+	floor = (long double)(remainder < 0 ? quotient - 1 : quotient);
+	ceil = (long double)(remainder > 0 ? quotient + 1 : quotient);
+}
+
+
+// For an integer column, a strict comparison with x is the non-strict
+// comparison with the next integer past x, so the threshold is rounded in
+// the direction that keeps the result exact:
+//     v > x   <=>  v >= floor(x) + 1
+//     v >= x  <=>  v >= ceil(x)
+//     v < x   <=>  v <= ceil(x) - 1
+//     v <= x  <=>  v <= floor(x)
+// Then it is saturated to the range of the type.
+template <comparison C, typename T, typename Ratio, typename Bound>
+raw_threshold<T> convert(const Bound& bound, std::true_type) {
+	long double floor, ceil;
+	integral_bounds<Ratio>(bound, floor, ceil, std::is_integral<typename Bound::ValueType>());
+
+	long double value = C == greater ? floor + 1 :
+	                    C == greater_equal ? ceil :
+	                    C == less ? ceil - 1 :
+	                    floor;
+	const long double lowest = std::numeric_limits<T>::lowest();
+	const long double highest = std::numeric_limits<T>::max();
+
+	raw_threshold<T> result = { T(), value != value };
+	if(result.none) {
+		return result;
+	}
+	if(kernel_comparison<C>::value == _simd::at_least) {
+		result.none = value > highest;
+		value = std::max(value, lowest);
+	} else {
+		result.none = value < lowest;
+		value = std::min(value, highest);
+	}
+	if(!result.none) {
+		result.value = T(value);
+	}
+	return result;
+}
+
+// For a floating point column, a strict comparison with x is the non-strict
+// comparison with the next representable value past x.
+template <comparison C, typename T, typename Ratio, typename Bound>
+raw_threshold<T> convert(const Bound& bound, std::false_type) {
+	typedef typename std::ratio_divide<typename Bound::Ratio, Ratio>::type Factor;
+	const T value = T((long double)bound.value * Factor::num / Factor::den);
+
+	raw_threshold<T> result = {
+		C == greater ? std::nextafter(value, std::numeric_limits<T>::infinity()) :
+		C == less ? std::nextafter(value, -std::numeric_limits<T>::infinity()) :
+		value,
+		value != value
+	};
+	return result;
+}
+
+
+// Values processed per call to the comparison kernel.
+const std::size_t chunk_size = 4096;
+
+
+// Compares the values with the threshold, and calls f(word, offset) with
+// each word of results and the index of the value of its first bit.
+template <comparison C, typename T, typename F>
+void for_each_word(const T* in, std::size_t n, const raw_threshold<T>& threshold, F f) {
+	if(threshold.none) {
+		return;
+	}
+
+	std::uint64_t words[chunk_size / 64];
+	for(std::size_t begin = 0; begin < n; begin += chunk_size) {
+		const std::size_t count = std::min(chunk_size, n - begin);
+		_simd::compare<kernel_comparison<C>::value>(in + begin, count, threshold.value, words);
+		for(std::size_t w = 0; w * 64 < count; w++) {
+			f(words[w], begin + w * 64);
+		}
+	}
+}
+
+
+} /* namespace si::_threshold */
+
+
+
+/// A predicate that compares SI values with a bound.
+/**
+ * It is built by @c above, @c at_least, @c below or @c at_most, and applied
+ * to a single value with @c operator() or to a span of values with
+ * @c count_if, @c mask, @c select, @c filter or @c partition.
+ *
+ * For a span, the bound is converted once to the ratio and the underlying
+ * type of the values, so only the raw values are compared. For an integer
+ * underlying type the converted bound is rounded so the results are the same
+ * as comparing each value with the bound, even for a bound that is not an
+ * integer in the ratio of the values (like 100 km/h over speeds in m/s). For
+ * a floating point underlying type the bound is rounded to nearest.
+ *
+ * Spans of @c double and @c int are compared with SSE2 or AVX2 instructions,
+ * selected at runtime.
+ */
+template <typename Bound, _threshold::comparison C>
+struct threshold {
+	Bound bound;
+
+	template <typename SIValueType>
+	bool operator()(const SIValueType& v) const {
+		return C == _threshold::greater ? v > bound :
+		       C == _threshold::greater_equal ? v >= bound :
+		       C == _threshold::less ? v < bound :
+		       v <= bound;
+	}
+};
+
+
+/// Predicate for values greater than @c bound.
+template <typename Bound>
+threshold<Bound, _threshold::greater> above(const Bound& bound) {
+	const threshold<Bound, _threshold::greater> t = { bound };
+	return t;
+}
+
+/// Predicate for values greater than or equal to @c bound.
+template <typename Bound>
+threshold<Bound, _threshold::greater_equal> at_least(const Bound& bound) {
+	const threshold<Bound, _threshold::greater_equal> t = { bound };
+	return t;
+}
+
+/// Predicate for values less than @c bound.
+template <typename Bound>
+threshold<Bound, _threshold::less> below(const Bound& bound) {
+	const threshold<Bound, _threshold::less> t = { bound };
+	return t;
+}
+
+/// Predicate for values less than or equal to @c bound.
+template <typename Bound>
+threshold<Bound, _threshold::less_equal> at_most(const Bound& bound) {
+	const threshold<Bound, _threshold::less_equal> t = { bound };
+	return t;
+}
+
+
+namespace _threshold {
+
+
+template <typename SIValueType, typename Bound, comparison C>
+raw_threshold<typename std::remove_const<SIValueType>::type::ValueType>
+convert(const threshold<Bound, C>& t) {
+	typedef typename std::remove_const<SIValueType>::type ValueType_;
+	typedef typename ValueType_::ValueType T;
+	static_assert(Bound::Dimensions == ValueType_::Dimensions,
+	              "The bound must have the dimensions of the values");
+	return convert<C, T, typename ValueType_::Ratio>(t.bound, std::is_integral<T>());
+}
+
+
+} /* namespace si::_threshold */
+
+
+
+/// Counts the values that satisfy the predicate.
+template <typename SIValueType, typename Bound, _threshold::comparison C>
+std::size_t count_if(quantity_span<SIValueType> in, const threshold<Bound, C>& predicate) {
+	typedef typename std::remove_const<SIValueType>::type::ValueType T;
+	const _threshold::raw_threshold<T> t = _threshold::convert<SIValueType>(predicate);
+	if(t.none) {
+		return 0;
+	}
+	return _simd::count<_threshold::kernel_comparison<C>::value>(in.raw(), in.size(), t.value);
+}
+
+
+/// Counts the values greater than @c bound.
+template <typename SIValueType, typename Bound>
+std::size_t count_if_greater(quantity_span<SIValueType> in, const Bound& bound) {
+	return count_if(in, above(bound));
+}
+
+
+/// Sets a bit for each value that satisfies the predicate.
+/**
+ * Bit <tt>i % 64</tt> of <tt>words[i / 64]</tt> is the result for the value
+ * @c i. All the <tt>(in.size() + 63) / 64</tt> words are written, and the
+ * bits past the last value are zero.
+ */
+template <typename SIValueType, typename Bound, _threshold::comparison C>
+void mask(quantity_span<SIValueType> in, const threshold<Bound, C>& predicate, std::uint64_t* words) {
+	std::fill(words, words + (in.size() + 63) / 64, std::uint64_t(0));
+	_threshold::for_each_word<C>(in.raw(), in.size(), _threshold::convert<SIValueType>(predicate),
+		[&](std::uint64_t word, std::size_t offset) {
+			words[offset / 64] = word;
+		});
+}
+
+
+/// Writes the indices of the values that satisfy the predicate, in order.
+/**
+ * @c indices must have room for the indices of all the matching values, and
+ * the span must have fewer than 2³² values.
+ *
+ * @return The number of indices written.
+ */
+template <typename SIValueType, typename Bound, _threshold::comparison C>
+std::size_t select(quantity_span<SIValueType> in, const threshold<Bound, C>& predicate, std::uint32_t* indices) {
+	std::size_t count = 0;
+	_threshold::for_each_word<C>(in.raw(), in.size(), _threshold::convert<SIValueType>(predicate),
+		[&](std::uint64_t word, std::size_t offset) {
+			for(; word; word &= word - 1) {
+				indices[count++] = std::uint32_t(offset + _simd::count_trailing_zeros(word));
+			}
+		});
+	return count;
+}
+
+
+/// Copies the values that satisfy the predicate, in order.
+/**
+ * @c out must have room for all the matching values.
+ *
+ * @return The number of values copied.
+ */
+template <typename SIValueType, typename Bound, _threshold::comparison C>
+std::size_t filter(quantity_span<SIValueType> in, const threshold<Bound, C>& predicate,
+                   quantity_span<typename std::remove_const<SIValueType>::type> out) {
+	std::size_t count = 0;
+	_threshold::for_each_word<C>(in.raw(), in.size(), _threshold::convert<SIValueType>(predicate),
+		[&](std::uint64_t word, std::size_t offset) {
+			for(; word; word &= word - 1) {
+				out[count++] = in[offset + _simd::count_trailing_zeros(word)];
+			}
+		});
+	return count;
+}
+
+
+/// Reorders the values so the ones that satisfy the predicate come first.
+/**
+ * Like @c std::partition, the relative order of the values is not kept.
+ *
+ * @return The number of values that satisfy the predicate.
+ */
+template <typename SIValueType, typename Bound, _threshold::comparison C>
+std::size_t partition(quantity_span<SIValueType> values, const threshold<Bound, C>& predicate) {
+	typedef typename SIValueType::ValueType T;
+	const _threshold::raw_threshold<T> t = _threshold::convert<SIValueType>(predicate);
+	if(t.none) {
+		return 0;
+	}
+
+	T* const raw = values.raw();
+	return std::partition(raw, raw + values.size(), [&](T value) {
+		return _simd::compare<_threshold::kernel_comparison<C>::value>(value, t.value);
+	}) - raw;
+}
+
+
+} /* namespace si */
+
+
+#endif /* SI_THRESHOLDS_HPP_ */
@@ -0,0 +1,558 @@
+#ifndef SI_UNCERTAIN_HPP_
+#define SI_UNCERTAIN_HPP_
+
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "batch.hpp"
+#include "config.hpp"
+#include "dimension_code.hpp"
+#include "int_list.hpp"
+#include "si_value.hpp"
+
+
+namespace si {
+
+
+/**
+ * @brief A value with its standard uncertainty, propagated to first order.
+ *
+ * @details Each operation computes the value as usual, and the standard
+ * deviation of the result from the deviations of the operands by the linear
+ * approximation of the operation around their values: for <tt>z = f(x, y)</tt>,
+ * <tt>σz² = (∂f/∂x σx)² + (∂f/∂y σy)²</tt>. This is exact for sums, and good
+ * when the deviations are small relative to the curvature of the operations.
+ *
+ * The operands of each operation are taken as independent, so the uncertainty
+ * of an expression that uses a variable more than once is wrong: <tt>x - x</tt>
+ * has a deviation of <tt>√2 σx</tt>. Use @c dual numbers to track the
+ * correlations, or @c monte_carlo for nonlinear models.
+ *
+ * It can be the underlying type of SI values, like
+ * <tt>Voltage_V<uncertain<double>></tt>.
+ *
+ * Comparisons compare only the values.
+ *
+ * @tparam T The type of the value and of the deviation. Must be a floating
+ *           point type.
+ */
+template <typename T>
+struct uncertain {
+	static_assert(std::is_floating_point<T>::value, "The type of an uncertain value must be a floating point type");
+
+	/// The value.
+	T value;
+	/// The standard deviation.
+	T sigma;
+
+
+	/// Zero, without uncertainty.
+	SI_INLINE uncertain() noexcept : value(), sigma() {}
+
+	/// An exact value.
+	SI_INLINE uncertain(const T& value) noexcept : value(value), sigma() {}
+
+	/// A value with a standard deviation.
+	SI_INLINE uncertain(const T& value, const T& sigma) noexcept : value(value), sigma(sigma) {}
+
+	/// Conversion from an uncertain value of another type.
+	template <typename U>
+	SI_INLINE uncertain(const uncertain<U>& x) noexcept : value(x.value), sigma(x.sigma) {}
+
+
+	SI_INLINE uncertain& operator+=(const uncertain& x) noexcept {
+		value += x.value;
+		sigma = std::sqrt(sigma * sigma + x.sigma * x.sigma);
+		return *this;
+	}
+
+	SI_INLINE uncertain& operator-=(const uncertain& x) noexcept {
+		value -= x.value;
+		sigma = std::sqrt(sigma * sigma + x.sigma * x.sigma);
+		return *this;
+	}
+
+	// σ(x y)² = (y σx)² + (x σy)²
+	SI_INLINE uncertain& operator*=(const uncertain& x) noexcept {
+		const T a = sigma * x.value;
+		const T b = value * x.sigma;
+		value *= x.value;
+		sigma = std::sqrt(a * a + b * b);
+		return *this;
+	}
+
+	// σ(x / y)² = (σx / y)² + (x σy / y²)²
+	SI_INLINE uncertain& operator/=(const uncertain& x) noexcept {
+		const T inverse = T(1) / x.value;
+		value *= inverse;
+		const T a = sigma * inverse;
+		const T b = value * x.sigma * inverse;
+		sigma = std::sqrt(a * a + b * b);
+		return *this;
+	}
+
+	SI_INLINE uncertain& operator+=(const T& c) noexcept {
+		value += c;
+		return *this;
+	}
+
+	SI_INLINE uncertain& operator-=(const T& c) noexcept {
+		value -= c;
+		return *this;
+	}
+
+	SI_INLINE uncertain& operator*=(const T& c) noexcept {
+		value *= c;
+		sigma *= c < 0 ? -c : c;
+		return *this;
+	}
+
+	SI_INLINE uncertain& operator/=(const T& c) noexcept {
+		return *this *= T(1) / c;
+	}
+
+
+	// As for dual numbers, the binary operators are hidden friends that accept
+	// anything convertible to T on either side.
+
+	SI_INLINE friend uncertain operator+(const uncertain& x) noexcept { return x; }
+	SI_INLINE friend uncertain operator-(const uncertain& x) noexcept { return uncertain(-x.value, x.sigma); }
+
+	SI_INLINE friend uncertain operator+(uncertain x, const uncertain& y) noexcept { return x += y; }
+	SI_INLINE friend uncertain operator-(uncertain x, const uncertain& y) noexcept { return x -= y; }
+	SI_INLINE friend uncertain operator*(uncertain x, const uncertain& y) noexcept { return x *= y; }
+	SI_INLINE friend uncertain operator/(uncertain x, const uncertain& y) noexcept { return x /= y; }
+
+	SI_INLINE friend uncertain operator+(uncertain x, const T& c) noexcept { return x += c; }
+	SI_INLINE friend uncertain operator-(uncertain x, const T& c) noexcept { return x -= c; }
+	SI_INLINE friend uncertain operator*(uncertain x, const T& c) noexcept { return x *= c; }
+	SI_INLINE friend uncertain operator/(uncertain x, const T& c) noexcept { return x /= c; }
+
+	SI_INLINE friend uncertain operator+(const T& c, uncertain x) noexcept { return x += c; }
+	SI_INLINE friend uncertain operator-(const T& c, const uncertain& x) noexcept { return uncertain(c) -= x; }
+	SI_INLINE friend uncertain operator*(const T& c, uncertain x) noexcept { return x *= c; }
+	SI_INLINE friend uncertain operator/(const T& c, const uncertain& x) noexcept { return uncertain(c) /= x; }
+
+	SI_INLINE friend bool operator==(const uncertain& x, const uncertain& y) noexcept { return x.value == y.value; }
+	SI_INLINE friend bool operator!=(const uncertain& x, const uncertain& y) noexcept { return x.value != y.value; }
+	SI_INLINE friend bool operator<(const uncertain& x, const uncertain& y) noexcept { return x.value < y.value; }
+	SI_INLINE friend bool operator>(const uncertain& x, const uncertain& y) noexcept { return x.value > y.value; }
+	SI_INLINE friend bool operator<=(const uncertain& x, const uncertain& y) noexcept { return x.value <= y.value; }
+	SI_INLINE friend bool operator>=(const uncertain& x, const uncertain& y) noexcept { return x.value >= y.value; }
+};
+
+
+
+namespace _uncertain {
+
+
+// The result of f(x), given f(x) and f'(x).
+template <typename T>
+SI_INLINE uncertain<T> chain(const uncertain<T>& x, const T& f, const T& df) noexcept {
+	return uncertain<T>(f, std::fabs(df) * x.sigma);
+}
+
+
+} /* namespace si::_uncertain */
+
+
+
+/// Returns the square root of an uncertain value.
+/** @relates uncertain */
+template <typename T>
+SI_INLINE uncertain<T> sqrt(const uncertain<T>& x) noexcept {
+	const T root = std::sqrt(x.value);
+	return _uncertain::chain(x, root, T(0.5) / root);
+}
+
+/// Returns the cube root of an uncertain value.
+/** @relates uncertain */
+template <typename T>
+SI_INLINE uncertain<T> cbrt(const uncertain<T>& x) noexcept {
+	const T root = std::cbrt(x.value);
+	return _uncertain::chain(x, root, T(1) / (3 * root * root));
+}
+
+/// Returns an uncertain value raised to an exact power.
+/** @relates uncertain */
+template <typename T>
+SI_INLINE uncertain<T> pow(const uncertain<T>& x, const T& p) noexcept {
+	return _uncertain::chain(x, std::pow(x.value, p), p == 0 ? T(0) : p * std::pow(x.value, p - 1));
+}
+
+/// Returns the absolute value of an uncertain value.
+/** @relates uncertain */
+template <typename T>
+SI_INLINE uncertain<T> abs(const uncertain<T>& x) noexcept {
+	return uncertain<T>(std::fabs(x.value), x.sigma);
+}
+
+/// Returns the square root of the sum of the squares of two uncertain values.
+/** @relates uncertain */
+template <typename T>
+SI_INLINE uncertain<T> hypot(const uncertain<T>& x, const uncertain<T>& y) noexcept {
+	const T h = std::hypot(x.value, y.value);
+	const T a = x.value / h * x.sigma;
+	const T b = y.value / h * y.sigma;
+	return uncertain<T>(h, std::sqrt(a * a + b * b));
+}
+
+/// Returns e raised to an uncertain value.
+/** @relates uncertain */
+template <typename T>
+SI_INLINE uncertain<T> exp(const uncertain<T>& x) noexcept {
+	const T e = std::exp(x.value);
+	return _uncertain::chain(x, e, e);
+}
+
+/// Returns the natural logarithm of an uncertain value.
+/** @relates uncertain */
+template <typename T>
+SI_INLINE uncertain<T> log(const uncertain<T>& x) noexcept {
+	return _uncertain::chain(x, std::log(x.value), T(1) / x.value);
+}
+
+/// Returns the sine of an uncertain value.
+/** @relates uncertain */
+template <typename T>
+SI_INLINE uncertain<T> sin(const uncertain<T>& x) noexcept {
+	return _uncertain::chain(x, std::sin(x.value), std::cos(x.value));
+}
+
+/// Returns the cosine of an uncertain value.
+/** @relates uncertain */
+template <typename T>
+SI_INLINE uncertain<T> cos(const uncertain<T>& x) noexcept {
+	return _uncertain::chain(x, std::cos(x.value), std::sin(x.value));
+}
+
+
+
+namespace _monte_carlo {
+
+
+// Standard normal samples by the ziggurat method of Marsaglia and Tsang, with
+// 128 layers: 99% of the samples take one 32-bit draw, a multiplication and a
+// comparison, where std::normal_distribution takes logarithms and square roots.
+struct ziggurat {
+	std::uint32_t k[128]; // The thresholds of the fast path in each layer
+	double w[128];        // The width of each layer, scaled by 2^-31
+	double f[128];        // The density at the edge of each layer
+
+	ziggurat() {
+		const double m = 2147483648.0;
+		const double v = 9.91256303526217e-3;
+		double d = 3.442619855899;
+		double t = d;
+		const double q = v / std::exp(-0.5 * d * d);
+		k[0] = std::uint32_t(d / q * m);
+		k[1] = 0;
+		w[0] = q / m;
+		w[127] = d / m;
+		f[0] = 1.0;
+		f[127] = std::exp(-0.5 * d * d);
+		for(int i = 126; i >= 1; i--) {
+			d = std::sqrt(-2.0 * std::log(v / d + std::exp(-0.5 * d * d)));
+			k[i + 1] = std::uint32_t(d / t * m);
+			t = d;
+			f[i] = std::exp(-0.5 * d * d);
+			w[i] = d / m;
+		}
+	}
+};
+
+inline const ziggurat& tables() {
+	static const ziggurat z;
+	return z;
+}
+
+template <typename Engine>
+SI_INLINE std::int32_t bits(Engine& engine) {
+	static_assert(Engine::max() - Engine::min() >= 0xffffffffu, "The engine must draw at least 32 bits");
+	return std::int32_t(std::uint32_t(engine() - Engine::min()));
+}
+
+// A uniform sample in (0, 1).
+template <typename Engine>
+SI_INLINE double uniform(Engine& engine) {
+	return (double(std::uint32_t(bits(engine))) + 0.5) * (1.0 / 4294967296.0);
+}
+
+// The layers and the tail, out of the fast path.
+template <typename Engine>
+SI_NOINLINE double normal_slow(Engine& engine, const ziggurat& z, std::int32_t h, int i) {
+	const double r = 3.442619855899;
+	for(;;) {
+		const double x = h * z.w[i];
+		if(i == 0) {
+			double tail, y;
+			do {
+				tail = -std::log(uniform(engine)) / r;
+				y = -std::log(uniform(engine));
+			} while(y + y < tail * tail);
+			return h > 0 ? r + tail : -r - tail;
+		}
+		if(z.f[i] + uniform(engine) * (z.f[i - 1] - z.f[i]) < std::exp(-0.5 * x * x)) {
+			return x;
+		}
+		h = bits(engine);
+		i = h & 127;
+		if(std::uint32_t(h < 0 ? -std::int64_t(h) : h) < z.k[i]) {
+			return h * z.w[i];
+		}
+	}
+}
+
+// The sample for the 32 bits h. Further bits are drawn only out of the fast path.
+template <typename Engine>
+SI_INLINE double normal(std::int32_t h, Engine& engine, const ziggurat& z) {
+	const int i = h & 127;
+	if(std::uint32_t(h < 0 ? -std::int64_t(h) : h) < z.k[i]) {
+		return h * z.w[i];
+	}
+	return normal_slow(engine, z, h, i);
+}
+
+template <typename Engine>
+SI_INLINE double normal(Engine& engine, const ziggurat& z) {
+	return normal(bits(engine), engine, z);
+}
+
+
+// Fills the lanes with normal samples of mean and standard deviation sigma.
+// Engines that draw 64 bits at a time, like std::mt19937_64, give two samples
+// per draw.
+template <typename Engine,
+          bool _Wide = (Engine::max() - Engine::min() == 0xffffffffffffffffull)>
+struct filler {
+	template <typename T, std::size_t N>
+	SI_INLINE static void fill(T (&lanes)[N], const T& mean, const T& sigma, Engine& engine, const ziggurat& z) {
+		for(std::size_t i = 0; i < N; i++) {
+			lanes[i] = mean + sigma * T(normal(engine, z));
+		}
+	}
+};
+
+template <typename Engine>
+struct filler<Engine, true> {
+	template <typename T, std::size_t N>
+	SI_INLINE static void fill(T (&lanes)[N], const T& mean, const T& sigma, Engine& engine, const ziggurat& z) {
+		std::size_t i = 0;
+		for(; i + 2 <= N; i += 2) {
+			const std::uint64_t u = std::uint64_t(engine() - Engine::min());
+			lanes[i] = mean + sigma * T(normal(std::int32_t(std::uint32_t(u)), engine, z));
+			lanes[i + 1] = mean + sigma * T(normal(std::int32_t(std::uint32_t(u >> 32)), engine, z));
+		}
+		if(i < N) {
+			lanes[i] = mean + sigma * T(normal(engine, z));
+		}
+	}
+};
+
+
+// The batch of N samples of an input: uncertain values are drawn from their
+// normal distributions, and the other values are the same in every lane.
+template <std::size_t N, typename T>
+struct sampled {
+	static_assert(std::is_arithmetic<T>::value, "The inputs must be SI values, uncertain values or numbers");
+
+	typedef batch<T, N> type;
+
+	template <typename Engine>
+	static type draw(const T& input, Engine&, const ziggurat&) {
+		return type(input);
+	}
+};
+
+template <std::size_t N, typename T, typename Ratio, dimension_code Dimensions>
+struct sampled<N, SIValue<uncertain<T>, Ratio, Dimensions>> {
+	typedef SIValue<batch<T, N>, Ratio, Dimensions> type;
+
+	template <typename Engine>
+	static type draw(const SIValue<uncertain<T>, Ratio, Dimensions>& input, Engine& engine, const ziggurat& z) {
+		type result;
+		filler<Engine>::fill(result.value.v, input.value.value, input.value.sigma, engine, z);
+		return result;
+	}
+};
+
+template <std::size_t N, typename T, typename Ratio, dimension_code Dimensions>
+struct sampled<N, SIValue<T, Ratio, Dimensions>> {
+	typedef SIValue<batch<T, N>, Ratio, Dimensions> type;
+
+	template <typename Engine>
+	static type draw(const SIValue<T, Ratio, Dimensions>& input, Engine&, const ziggurat&) {
+		return type(batch<T, N>(input.value));
+	}
+};
+
+template <std::size_t N, typename T>
+struct sampled<N, uncertain<T>> {
+	typedef batch<T, N> type;
+
+	template <typename Engine>
+	static type draw(const uncertain<T>& input, Engine& engine, const ziggurat& z) {
+		type result;
+		filler<Engine>::fill(result.v, input.value, input.sigma, engine, z);
+		return result;
+	}
+};
+
+
+template <typename F, typename Samples, std::size_t... I>
+auto evaluate(const F& f, const Samples& samples, index_list<I...>) -> decltype(f(std::get<I>(samples)...)) {
+	return f(std::get<I>(samples)...);
+}
+
+
+// The mean and the standard deviation of the lanes of batches.
+template <typename T, std::size_t N>
+struct statistics {
+	// The sums of the lanes, shifted by the first result so they do not cancel.
+	batch<T, N> sum;
+	batch<T, N> squares;
+	T shift;
+	std::size_t count;
+
+	statistics() : shift(), count(0) {}
+
+	void add(const batch<T, N>& results, std::size_t lanes) {
+		if(count == 0) {
+			shift = results.v[0];
+		}
+		if(lanes == N) {
+			for(std::size_t i = 0; i < N; i++) {
+				const T x = results.v[i] - shift;
+				sum.v[i] += x;
+				squares.v[i] += x * x;
+			}
+		} else {
+			for(std::size_t i = 0; i < lanes; i++) {
+				const T x = results.v[i] - shift;
+				sum.v[i] += x;
+				squares.v[i] += x * x;
+			}
+		}
+		count += lanes;
+	}
+
+	uncertain<T> result() const {
+		T s = T(), q = T();
+		for(std::size_t i = 0; i < N; i++) {
+			s += sum.v[i];
+			q += squares.v[i];
+		}
+		const T n = T(count);
+		const T variance = count > 1 ? (q - s * s / n) / (n - 1) : T();
+		return uncertain<T>(shift + s / n, std::sqrt(variance > 0 ? variance : T()));
+	}
+};
+
+
+// The statistics of the results of type Batched, as SI values or numbers.
+template <typename Batched>
+struct summary;
+
+template <typename T, std::size_t N, typename Ratio, dimension_code Dimensions>
+struct summary<SIValue<batch<T, N>, Ratio, Dimensions>> {
+	typedef SIValue<uncertain<T>, Ratio, Dimensions> type;
+
+	statistics<T, N> lanes;
+
+	void add(const SIValue<batch<T, N>, Ratio, Dimensions>& results, std::size_t count) {
+		lanes.add(results.value, count);
+	}
+
+	type result() const {
+		return type(lanes.result());
+	}
+};
+
+template <typename T, std::size_t N>
+struct summary<batch<T, N>> {
+	typedef uncertain<T> type;
+
+	statistics<T, N> lanes;
+
+	void add(const batch<T, N>& results, std::size_t count) {
+		lanes.add(results, count);
+	}
+
+	type result() const {
+		return lanes.result();
+	}
+};
+
+
+} /* namespace si::_monte_carlo */
+
+
+
+/// Estimates the distribution of the result of a function of uncertain SI values by sampling.
+/**
+ * The uncertain inputs, of types <tt>SIValue<uncertain<T>, ...></tt> and
+ * <tt>uncertain<T></tt>, are drawn from independent normal distributions,
+ * with their values as means and their deviations as standard deviations; the
+ * other inputs, SI values and numbers, are constants. The function is called
+ * on batches of @c N samples at once: each SI value is passed as an SI value
+ * of the same unit whose underlying type is <tt>batch<T, N></tt>, each number
+ * as a <tt>batch<T, N></tt>, and the function returns a batch of results. So the
+ * model is written once, as a template on the underlying type, and evaluates
+ * @c N samples with vectorized loops per call instead of one:
+ * @code
+ *   struct pressure {
+ *       template <typename T>
+ *       si::Pressure_Pa<T> operator()(const si::Force_N<T>& force, const si::Length_m<T>& radius) const {
+ *           return force / (3.14159265358979 * radius * radius);
+ *       }
+ *   };
+ *
+ *   std::mt19937_64 engine(42);
+ *   const si::Pressure_Pa<si::uncertain<double>> p =
+ *       si::monte_carlo<256>(pressure(), 100000, engine, force, radius);
+ * @endcode
+ *
+ * The normal samples are drawn by the ziggurat method, from 32 bits of
+ * @c engine per sample in most cases (so two samples per draw of a 64-bit
+ * engine), input by input and lane by lane, so the results depend only on the
+ * state of @c engine.
+ *
+ * @tparam N The number of samples per call of @c f.
+ * @param f The function, called with the batches of the inputs.
+ * @param samples The number of samples, which is rounded up to a multiple of
+ *                @c N for the calls of @c f. Only the first @c samples results
+ *                are used.
+ * @param engine The random number engine, like @c std::mt19937_64. It must
+ *               draw at least 32 bits at a time.
+ * @return The mean and the standard deviation of the results, as an SI value
+ *         of @c uncertain or an @c uncertain number.
+ * @relates uncertain
+ */
+template <std::size_t N, typename F, typename Engine, typename... Inputs>
+typename _monte_carlo::summary<
+	decltype(std::declval<const F&>()(std::declval<const typename _monte_carlo::sampled<N, Inputs>::type&>()...))
+>::type
+monte_carlo(const F& f, std::size_t samples, Engine& engine, const Inputs&... inputs) {
+	typedef std::tuple<typename _monte_carlo::sampled<N, Inputs>::type...> Samples;
+	typedef decltype(f(std::declval<const typename _monte_carlo::sampled<N, Inputs>::type&>()...)) Batched;
+
+	const _monte_carlo::ziggurat& z = _monte_carlo::tables();
+	_monte_carlo::summary<Batched> summary;
+	for(std::size_t done = 0; done < samples; done += N) {
+		// The braces draw the inputs in order.
+		const Samples drawn{ _monte_carlo::sampled<N, Inputs>::draw(inputs, engine, z)... };
+		const Batched results = _monte_carlo::evaluate(f, drawn, typename make_index_list<sizeof...(Inputs)>::type());
+		summary.add(results, samples - done < N ? samples - done : N);
+	}
+	return summary.result();
+}
+
+
+} /* namespace si */
+
+
+#endif /* SI_UNCERTAIN_HPP_ */
@@ -0,0 +1,452 @@
+#ifndef SI_UNIT_STRING_HPP_
+#define SI_UNIT_STRING_HPP_
+
+
+#include "config.hpp"
+
+#if SI_UNIT_STRINGS
+
+#include <cstddef>
+#include <cstdint>
+#include <ratio>
+#include "dimension_code.hpp"
+#include "ratio_table.hpp"
+#include "si_value.hpp"
+#include "symbol_table.hpp"
+
+
+namespace si {
+
+
+namespace _unit_string {
+
+
+// A unit string as a template argument, with its terminating NUL.
+template <std::size_t N>
+struct fixed_string {
+	char text[N];
+
+	constexpr fixed_string(const char (&s)[N]) : text() {
+		for(std::size_t i = 0; i < N; i++) {
+			text[i] = s[i];
+		}
+	}
+
+#ifdef __cpp_char8_t
+	constexpr fixed_string(const char8_t (&s)[N]) : text() {
+		for(std::size_t i = 0; i < N; i++) {
+			text[i] = char(s[i]);
+		}
+	}
+#endif
+};
+
+
+enum class error {
+	none,
+	empty,
+	syntax,
+	unknown_symbol,
+	ambiguous,
+	power_range,
+	ratio_overflow,
+};
+
+
+// The powers of the base units and the ratio of a unit.
+struct factor {
+	int powers[7];
+	std::intmax_t num;
+	std::intmax_t den;
+};
+
+constexpr factor one() {
+	return { { 0, 0, 0, 0, 0, 0, 0 }, 1, 1 };
+}
+
+
+constexpr std::intmax_t gcd(std::intmax_t a, std::intmax_t b) {
+	while(b != 0) {
+		const std::intmax_t r = a % b;
+		a = b;
+		b = r;
+	}
+	return a;
+}
+
+
+// The prefixes that apply to the units below, longest first for "da". Those
+// beyond 10^18 would overflow the ratios.
+struct prefix {
+	const char* text;
+	std::intmax_t num;
+	std::intmax_t den;
+};
+
+constexpr prefix prefixes[] = {
+	{ "da", 10, 1 },
+	{ "h", 100, 1 },
+	{ "k", 1000, 1 },
+	{ "M", 1000000, 1 },
+	{ "G", 1000000000, 1 },
+	{ "T", 1000000000000, 1 },
+	{ "P", 1000000000000000, 1 },
+	{ "E", 1000000000000000000, 1 },
+	{ "d", 1, 10 },
+	{ "c", 1, 100 },
+	{ "m", 1, 1000 },
+	{ "u", 1, 1000000 },
+	{ "μ", 1, 1000000 },
+	{ "n", 1, 1000000000 },
+	{ "p", 1, 1000000000000 },
+	{ "f", 1, 1000000000000000 },
+	{ "a", 1, 1000000000000000000 },
+};
+
+// The units of the symbol table that take any prefix. The others (min, h, d)
+// and the prefixed ones (kg, km, ...) must be written as in the table.
+constexpr const char* prefixable[] = {
+	"m", "g", "s", "A", "K", "mol", "cd",
+	"Hz", "N", "Pa", "J", "W", "C", "V", "F", "Ω", "ohm", "S", "Wb", "T", "H", "Sv", "kat",
+};
+
+
+// Compares a NUL-terminated string with a string of the given length, as
+// _json::compare does at runtime.
+constexpr int compare(const char* text, const char* s, std::size_t length) {
+	for(std::size_t i = 0; i < length; i++) {
+		if(text[i] != s[i]) {
+			return text[i] == '\0' ? -1 : (unsigned char)text[i] < (unsigned char)s[i] ? -1 : 1;
+		}
+	}
+	return text[length] == '\0' ? 0 : 1;
+}
+
+// The index of the unit spelled by the symbol, or unit_count if there is none.
+constexpr std::size_t find_unit(const char* symbol, std::size_t length) {
+	std::size_t begin = 0, end = _symbol_table::spelling_count;
+	while(begin < end) {
+		const std::size_t middle = (begin + end) / 2;
+		const int c = compare(_symbol_table::spellings[middle].text, symbol, length);
+		if(c == 0) {
+			return _symbol_table::spellings[middle].unit;
+		}
+		if(c < 0) {
+			begin = middle + 1;
+		} else {
+			end = middle;
+		}
+	}
+	return _symbol_table::unit_count;
+}
+
+constexpr bool is_prefixable(const char* symbol, std::size_t length) {
+	for(const char* p : prefixable) {
+		if(compare(p, symbol, length) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+
+// A recursive descent parser of the grammar
+//   expression = term { ("·" | "⋅" | "*" | "/") term }
+//   term       = ("(" expression ")" | "1" | symbol) [ "^" ["-"] digits | superscripts ]
+// where a symbol is a run of letters, μ, µ and Ω. As the SI brochure advises,
+// nothing may follow a division but a closing parenthesis, so "J/kg·K" is
+// ambiguous and must be written "J/(kg·K)".
+struct parser {
+	const char* text;
+	std::size_t size;
+	std::size_t at;
+	error failure;
+
+
+	constexpr bool fail(error e) {
+		if(failure == error::none) {
+			failure = e;
+		}
+		return false;
+	}
+
+	constexpr bool next_is(const char* s) const {
+		std::size_t i = 0;
+		for(; s[i] != '\0'; i++) {
+			if(at + i >= size  ||  text[at + i] != s[i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	constexpr bool accept(const char* s) {
+		if(!next_is(s)) {
+			return false;
+		}
+		while(*s++ != '\0') {
+			at++;
+		}
+		return true;
+	}
+
+
+	// a = a * b^sign, with the fraction kept reduced.
+	constexpr bool multiply(factor& a, const factor& b, int sign) {
+		for(int i = 0; i < 7; i++) {
+			a.powers[i] += sign * b.powers[i];
+			if(a.powers[i] < -128  ||  a.powers[i] > 127) {
+				return fail(error::power_range);
+			}
+		}
+		const std::intmax_t num = sign > 0 ? b.num : b.den;
+		const std::intmax_t den = sign > 0 ? b.den : b.num;
+		const std::intmax_t g1 = gcd(num, a.den);
+		const std::intmax_t g2 = gcd(a.num, den);
+		if(num / g1 > INTMAX_MAX / (a.num / g2)  ||  den / g2 > INTMAX_MAX / (a.den / g1)) {
+			return fail(error::ratio_overflow);
+		}
+		a.num = (a.num / g2) * (num / g1);
+		a.den = (a.den / g1) * (den / g2);
+		return true;
+	}
+
+	constexpr bool power(factor& a, int n) {
+		const factor base = a;
+		a = one();
+		for(int i = 0; i < (n < 0 ? -n : n); i++) {
+			if(!multiply(a, base, n < 0 ? -1 : 1)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+
+	// The exponent after a term, 1 if there is none.
+	constexpr bool exponent(int& n) {
+		constexpr const char* superscripts[] = { "⁰", "¹", "²", "³", "⁴", "⁵", "⁶", "⁷", "⁸", "⁹" };
+		n = 1;
+		bool negative = false;
+		int digits = 0;
+		int value = 0;
+		if(accept("^")) {
+			negative = accept("-");
+			for(; at < size  &&  text[at] >= '0'  &&  text[at] <= '9'; at++, digits++) {
+				value = 10 * value + (text[at] - '0');
+				if(value > 127) {
+					return fail(error::power_range);
+				}
+			}
+		} else {
+			negative = accept("⁻");
+			for(bool found = true; found; ) {
+				found = false;
+				for(int d = 0; d < 10  &&  !found; d++) {
+					if(accept(superscripts[d])) {
+						value = 10 * value + d;
+						if(value > 127) {
+							return fail(error::power_range);
+						}
+						digits++;
+						found = true;
+					}
+				}
+			}
+			if(digits == 0  &&  !negative) {
+				return true;
+			}
+		}
+		if(digits == 0) {
+			return fail(error::syntax);
+		}
+		n = negative ? -value : value;
+		return true;
+	}
+
+
+	// The length of the run of symbol characters at the position.
+	constexpr std::size_t symbol_length() const {
+		std::size_t i = at;
+		while(i < size) {
+			const char c = text[i];
+			if((c >= 'a'  &&  c <= 'z')  ||  (c >= 'A'  &&  c <= 'Z')) {
+				i++;
+			} else if(i + 1 < size  &&  ((c == "μ"[0]  &&  text[i + 1] == "μ"[1])
+			                         ||  (c == "µ"[0]  &&  text[i + 1] == "µ"[1])
+			                         ||  (c == "Ω"[0]  &&  text[i + 1] == "Ω"[1]))) {
+				i += 2;
+			} else {
+				break;
+			}
+		}
+		return i - at;
+	}
+
+	constexpr bool symbol(factor& f) {
+		const std::size_t length = symbol_length();
+		if(length == 0) {
+			return fail(size == 0 ? error::empty : error::syntax);
+		}
+
+		// The micro sign is spelled as the Greek letter in the table.
+		char s[32] = {};
+		if(length >= sizeof(s)) {
+			return fail(error::unknown_symbol);
+		}
+		for(std::size_t i = 0; i < length; i++) {
+			s[i] = text[at + i];
+			if(s[i] == "µ"[0]  &&  text[at + i + 1] == "µ"[1]) {
+				s[i] = "μ"[0];
+				s[++i] = "μ"[1];
+			}
+		}
+		at += length;
+
+		std::size_t unit = find_unit(s, length);
+		std::intmax_t num = 1, den = 1;
+		for(std::size_t p = 0; unit == _symbol_table::unit_count  &&  p < sizeof(prefixes) / sizeof(prefixes[0]); p++) {
+			std::size_t n = 0;
+			while(prefixes[p].text[n] != '\0'  &&  prefixes[p].text[n] == s[n]) {
+				n++;
+			}
+			if(prefixes[p].text[n] == '\0'  &&  n < length  &&  is_prefixable(s + n, length - n)) {
+				unit = find_unit(s + n, length - n);
+				num = prefixes[p].num;
+				den = prefixes[p].den;
+			}
+		}
+		if(unit == _symbol_table::unit_count) {
+			return fail(error::unknown_symbol);
+		}
+
+		const _symbol_table::unit& u = _symbol_table::units[unit];
+		f = one();
+		for(int i = 0; i < 7; i++) {
+			f.powers[i] = unpack_dimension(u.dimensions, i);
+		}
+		f.num = _ratio_table::num[u.ratio];
+		f.den = _ratio_table::den[u.ratio];
+		const factor scale = { { 0, 0, 0, 0, 0, 0, 0 }, num, den };
+		return multiply(f, scale, 1);
+	}
+
+
+	constexpr bool term(factor& f) {
+		if(accept("(")) {
+			if(!expression(f)) {
+				return false;
+			}
+			if(!accept(")")) {
+				return fail(error::syntax);
+			}
+		} else if(accept("1")) {
+			f = one();
+		} else if(!symbol(f)) {
+			return false;
+		}
+		int n = 1;
+		return exponent(n)  &&  (n == 1  ||  power(f, n));
+	}
+
+	constexpr bool expression(factor& f) {
+		if(!term(f)) {
+			return false;
+		}
+		bool divided = false;
+		while(at < size  &&  !next_is(")")) {
+			int sign = 1;
+			if(accept("/")) {
+				sign = -1;
+			} else if(!accept("·")  &&  !accept("⋅")  &&  !accept("*")) {
+				return fail(error::syntax);
+			}
+			if(divided) {
+				return fail(error::ambiguous);
+			}
+			divided = sign < 0;
+			factor g = one();
+			if(!term(g)  ||  !multiply(f, g, sign)) {
+				return false;
+			}
+		}
+		return true;
+	}
+};
+
+
+struct result {
+	factor unit;
+	error failure;
+};
+
+constexpr result parse(const char* text, std::size_t size) {
+	parser p = { text, size, 0, error::none };
+	factor f = one();
+	if(p.expression(f)  &&  p.at != size) {
+		p.fail(error::syntax);
+	}
+	return { p.failure == error::none ? f : one(), p.failure };
+}
+
+
+// The ratio and dimensions of the unit of a string.
+template <fixed_string Text>
+struct unit_of {
+	static constexpr result value = parse(Text.text, sizeof(Text.text) - 1);
+
+	static_assert(value.failure != error::empty, "The unit string is empty");
+	static_assert(value.failure != error::syntax, "The unit string is malformed");
+	static_assert(value.failure != error::unknown_symbol, "The unit string has an unknown symbol");
+	static_assert(value.failure != error::ambiguous,
+	              "The unit string has a product or quotient after a quotient: use parentheses");
+	static_assert(value.failure != error::power_range, "The unit string has a power out of [-128, 127]");
+	static_assert(value.failure != error::ratio_overflow, "The ratio of the unit string overflows");
+
+	typedef typename std::ratio<value.unit.num, value.unit.den>::type ratio;
+
+	static constexpr dimension_code dimensions = pack_dimensions(
+		value.unit.powers[0], value.unit.powers[1], value.unit.powers[2], value.unit.powers[3],
+		value.unit.powers[4], value.unit.powers[5], value.unit.powers[6]);
+};
+
+
+} /* namespace si::_unit_string */
+
+
+
+/// The SI value type of a unit written as a string, in C++20.
+/**
+ * The string is parsed at compile time into the ratio and dimensions of the
+ * unit, so the type is the same as the generated one or the one computed by
+ * @c multiplication and @c division:
+ * @code
+ *   static_assert(std::is_same<si::unit<"kg·m/s²">, si::Force_N<double>>::value, "");
+ *   typedef si::unit<"kW·h"> Energy_kWh;           // 3600000 J
+ *   typedef si::unit<"m^3/s", float> Flow_m3_s;
+ * @endcode
+ *
+ * The symbols are those of the symbol table, in UTF-8 or in their ASCII
+ * spellings (u for μ, ohm for Ω). The units of the SI take any prefix from a
+ * (10^-18) to E (10^18), as in "kN" or "mPa·s"; the micro sign µ may be used
+ * for μ. The terms are multiplied by ·, ⋅ or *, and a single division may end
+ * an expression or a parenthesized one: "W/(m²·K)". The powers are written with
+ * superscripts (m², s⁻¹) or ^ (m^2, s^-1), and "1/s" is the inverse of a second.
+ * Malformed strings, unknown symbols and ratios that overflow fail with a
+ * static assertion.
+ *
+ * Only defined if @c SI_UNIT_STRINGS is 1.
+ *
+ * @tparam Symbol The unit, as a string literal.
+ * @tparam ValueType The underlying type.
+ */
+template <_unit_string::fixed_string Symbol, typename ValueType = double>
+using unit = SIValue<ValueType, typename _unit_string::unit_of<Symbol>::ratio, _unit_string::unit_of<Symbol>::dimensions>;
+
+
+} /* namespace si */
+
+
+#endif /* SI_UNIT_STRINGS */
+
+#endif /* SI_UNIT_STRING_HPP_ */
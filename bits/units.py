@@ -2,12 +2,47 @@
 # -*- encoding: utf-8 -*-
 
 from __future__ import print_function
+import errno
+import os
 import sys
+from collections import OrderedDict
 from fractions import Fraction
 
 
 TEMPLATE_ALIASES = True
 
+# Directory (relative to this one) where the per-quantity headers are generated.
+QUANTITY_HEADERS_DIR = '../si'
+
+# Underlying types for which the SIValue types are explicitly instantiated once
+# (in instances.cpp) instead of in every translation unit.
+INSTANTIATED_VALUE_TYPES = ['int', 'long long', 'float', 'double']
+
+# The ratios of the units, in the order of their ids in the binary format
+# (see wire.hpp). The ids are written in messages, so this list must only be
+# appended to, whatever the order of the definitions of the units.
+WIRE_RATIOS = [
+	Fraction(1, 10**9),
+	Fraction(1, 10**6),
+	Fraction(1, 10**3),
+	Fraction(1, 10**2),
+	Fraction(1),
+	Fraction(10**3),
+	Fraction(1, 10**12),
+	Fraction(60),
+	Fraction(3600),
+	Fraction(86400),
+	Fraction(1, 10**4),
+	Fraction(10**6),
+	Fraction(5, 18),
+	Fraction(10**5),
+	Fraction(10**9),
+	Fraction(10**12),
+	Fraction(10**15),
+	Fraction(1, 10**15),
+	Fraction(1, 10**5),
+]
+
 
 def generate_types():
 	with file('types.hpp', 'w') as f:
@@ -19,32 +54,13 @@ def generate_types():
 		print('')
 		
 		if TEMPLATE_ALIASES:
-		
-			print('#include "si_value.hpp"')
-			print('')
-			print('')
+			
 			print('/** @file */')
 			print('')
 			print('')
-			print('namespace si {')
-			
-			for unit in UNITS:
-				print('')
-				print('')
-				print(unit.header_doc())
-				print('//@{')
-				
-				multiples_symbols = [unit.symbol] + [multiple.symbol() for multiple in unit.multiples if multiple.symbol() != unit.symbol]
-				for multiple_symbol in multiples_symbols:
-					multiple = ALL_MULTIPLES[multiple_symbol]
-					print('/// %s in %s' % (unit.quantities[0].capitalize(), multiple.name_plural()))
-					print('template <typename ValueType> using %s = %s;' % (multiple.type_name(), multiple.definition_str))
-				
-				print('//@}')
 			
-			print('')
-			print('')
-			print('} /* namespace si */')
+			for header_name in quantity_headers():
+				print('#include "%s/%s"' % (QUANTITY_HEADERS_DIR, header_name))
 			
 		else:
 			print('/*')
@@ -158,11 +174,278 @@ def generate_units():
 		sys.stdout = sys.__stdout__
 		
 
+def generate_quantity_headers():
+	# Under make -j the script may run once per generated file, concurrently,
+	# so the directory may be created between the test and the creation.
+	try:
+		os.mkdir(QUANTITY_HEADERS_DIR)
+	except OSError as e:
+		if e.errno != errno.EEXIST or not os.path.isdir(QUANTITY_HEADERS_DIR):
+			raise
+	
+	headers = quantity_headers()
+	for header_name, units in headers.iteritems():
+		with file(os.path.join(QUANTITY_HEADERS_DIR, header_name), 'w') as f:
+			sys.stdout = f
+			
+			guard = 'SI_QUANTITY_%s_' % header_name.replace('.', '_').upper()
+			print('#ifndef %s' % guard)
+			print('#define %s' % guard)
+			print('')
+			print('')
+			if TEMPLATE_ALIASES:
+				print('#include "../bits/si_value.hpp"')
+			else:
+				print('#include "../bits/defs.hpp"')
+			print('')
+			print('')
+			print('/** @file */')
+			print('')
+			print('')
+			print('namespace si {')
+			
+			if TEMPLATE_ALIASES:
+				for unit in units:
+					print('')
+					print('')
+					print(unit.header_doc())
+					print('//@{')
+					
+					multiples_symbols = [unit.symbol] + [multiple.symbol() for multiple in unit.multiples if multiple.symbol() != unit.symbol]
+					for multiple_symbol in multiples_symbols:
+						multiple = ALL_MULTIPLES[multiple_symbol]
+						print('/// %s in %s' % (unit.quantities[0].capitalize(), multiple.name_plural()))
+						print('template <typename ValueType> using %s = %s;' % (multiple.type_name(), multiple.definition_str))
+					
+					print('//@}')
+			
+			print('')
+			print('')
+			print('#ifdef SI_EXTERN_TEMPLATES')
+			for value_type in INSTANTIATED_VALUE_TYPES:
+				for definition in canonical_definitions(units):
+					print('extern template class %s;' % instance_name(definition, value_type))
+			print('#endif')
+			
+			print('')
+			print('')
+			print('namespace units {')
+			for unit in units:
+				print('')
+				for multiple in unit.multiples:
+					print('extern const %s\t%s;' % (multiple.const_declaration(), multiple.clean_symbol()))
+			print('')
+			print('} /* namespace si::units */')
+			print('} /* namespace si */')
+			print('')
+			print('')
+			print('#endif /* %s */' % guard)
+			
+			sys.stdout = sys.__stdout__
+
+
+def generate_instances():
+	with file('instances.cpp', 'w') as f:
+		sys.stdout = f
+		
+		print('#include "types.hpp"')
+		print('')
+		print('')
+		print('/*')
+		print(' * Explicit instantiations of the SI value types declared as extern templates')
+		print(' * in the per-quantity headers. Units with the same dimensions and ratio (like')
+		print(' * joules and newton meters) are the same type, so it is instantiated once.')
+		print(' */')
+		print('')
+		
+		for value_type in INSTANTIATED_VALUE_TYPES:
+			print('')
+			for definition in canonical_definitions(UNITS):
+				print('template class %s;' % instance_name(definition, value_type))
+		
+		sys.stdout = sys.__stdout__
+
+
+def generate_ratio_table():
+	with file('ratio_table.hpp', 'w') as f:
+		sys.stdout = f
+		
+		ratios = unit_ratios(UNITS)
+		
+		print('#ifndef SI_RATIO_TABLE_HPP_')
+		print('#define SI_RATIO_TABLE_HPP_')
+		print('')
+		print('')
+		print('#include <cstddef>')
+		print('#include <cstdint>')
+		print('')
+		print('')
+		print('namespace si {')
+		print('')
+		print('')
+		print('/*')
+		print(' * The ratios of the units (WIRE_RATIOS in units.py). Their indices identify')
+		print(' * them in the binary format (see wire.hpp), so new ratios are appended.')
+		print(' */')
+		print('namespace _ratio_table {')
+		print('')
+		print('')
+		print('const std::size_t size = %d;' % len(ratios))
+		print('')
+		print('constexpr std::intmax_t num[size] = {')
+		for ratio in ratios:
+			print('\t%d,' % ratio.numerator)
+		print('};')
+		print('')
+		print('constexpr std::intmax_t den[size] = {')
+		for ratio in ratios:
+			print('\t%d,' % ratio.denominator)
+		print('};')
+		print('')
+		print('')
+		print('// The index of a ratio in the table, or size if it isn\'t there.')
+		print('constexpr std::size_t index_of(std::intmax_t n, std::intmax_t d, std::size_t i = 0) {')
+		print('\treturn i == size ? size :')
+		print('\t       num[i] == n  &&  den[i] == d ? i :')
+		print('\t       index_of(n, d, i + 1);')
+		print('}')
+		print('')
+		print('')
+		print('} /* namespace si::_ratio_table */')
+		print('')
+		print('')
+		print('} /* namespace si */')
+		print('')
+		print('')
+		print('#endif /* SI_RATIO_TABLE_HPP_ */')
+		
+		sys.stdout = sys.__stdout__
+
+
+def generate_symbol_table():
+	with file('symbol_table.hpp', 'w') as f:
+		sys.stdout = f
+		
+		ratios = unit_ratios(UNITS)
+		multiples = [multiple for unit in UNITS for multiple in unit.multiples]
+		spellings = []
+		for index, multiple in enumerate(multiples):
+			spellings.append((multiple.symbol(), index))
+			if multiple.ascii_symbol() != multiple.symbol():
+				spellings.append((multiple.ascii_symbol(), index))
+		spellings.sort()
+		
+		print('#ifndef SI_SYMBOL_TABLE_HPP_')
+		print('#define SI_SYMBOL_TABLE_HPP_')
+		print('')
+		print('')
+		print('#include <cstddef>')
+		print('#include "dimension_code.hpp"')
+		print('')
+		print('')
+		print('namespace si {')
+		print('')
+		print('')
+		print('/*')
+		print(' * The symbols of the units, in UTF-8, and their ASCII spellings (with u for')
+		print(' * μ, ohm for Ω, * for · and ^ for the powers).')
+		print(' */')
+		print('namespace _symbol_table {')
+		print('')
+		print('')
+		print('struct unit {')
+		print('\tconst char* symbol;')
+		print('\tdimension_code dimensions;')
+		print('\tstd::size_t ratio; // Index in _ratio_table')
+		print('};')
+		print('')
+		print('struct spelling {')
+		print('\tconst char* text;')
+		print('\tstd::size_t unit; // Index in units')
+		print('};')
+		print('')
+		print('')
+		print('const std::size_t unit_count = %d;' % len(multiples))
+		print('const std::size_t spelling_count = %d;' % len(spellings))
+		print('')
+		print('// The units, in the order in which they are defined.')
+		print('constexpr unit units[unit_count] = {')
+		for multiple in multiples:
+			print('\t{ "%s", ::si::pack_dimensions(%s), %d },' % (multiple.symbol(), ', '.join(str(power) for power in multiple.dimensions), ratios.index(multiple.ratio)))
+		print('};')
+		print('')
+		print('// The spellings of the symbols, sorted by their bytes.')
+		print('constexpr spelling spellings[spelling_count] = {')
+		for text, index in spellings:
+			print('\t{ "%s", %d },' % (text, index))
+		print('};')
+		print('')
+		print('')
+		print('// The index of the first unit with the dimensions and ratio, or unit_count if there is none.')
+		print('constexpr std::size_t find(dimension_code dimensions, std::size_t ratio, std::size_t i = 0) {')
+		print('\treturn i == unit_count ? unit_count :')
+		print('\t       units[i].dimensions == dimensions  &&  units[i].ratio == ratio ? i :')
+		print('\t       find(dimensions, ratio, i + 1);')
+		print('}')
+		print('')
+		print('')
+		print('} /* namespace si::_symbol_table */')
+		print('')
+		print('')
+		print('} /* namespace si */')
+		print('')
+		print('')
+		print('#endif /* SI_SYMBOL_TABLE_HPP_ */')
+		
+		sys.stdout = sys.__stdout__
+
+
+def unit_ratios(units):
+	for unit in units:
+		for multiple in unit.multiples:
+			if multiple.ratio not in WIRE_RATIOS:
+				raise ValueError('The ratio %s of %s is not in WIRE_RATIOS, where it must be appended'
+				                 % (multiple.ratio, multiple.symbol()))
+	return WIRE_RATIOS
+
+
+def canonical_definitions(units):
+	definitions = []
+	for unit in units:
+		for multiple in unit.multiples:
+			if multiple.definition_str not in definitions:
+				definitions.append(multiple.definition_str)
+	return definitions
+
+
+def instance_name(definition, value_type):
+	return definition.replace('ValueType', value_type, 1)
+
+
+def canonical_definition(dimensions, ratio):
+	if ratio.denominator == 1:
+		ratio_str = '%d' % ratio.numerator
+	else:
+		ratio_str = '%d, %d' % (ratio.numerator, ratio.denominator)
+	return '::si::SIValue<ValueType, ::std::ratio<%s>, ::si::pack_dimensions(%s)>' % (ratio_str, ', '.join(str(power) for power in dimensions))
+
+
+def quantity_headers():
+	headers = OrderedDict()
+	for unit in UNITS:
+		headers.setdefault(unit.header_name(), []).append(unit)
+	return headers
+
+
 def main():
+	generate_quantity_headers()
 	generate_types()
 	generate_macros()
 	generate_units_header()
 	generate_units()
+	generate_instances()
+	generate_ratio_table()
+	generate_symbol_table()
 
 
 ################################################################################
@@ -174,20 +457,21 @@ ALL_MULTIPLES = {}
 
 
 class Prefix(object):
-	def __init__(self, symbol):
+	def __init__(self, symbol, factor):
 		self.symbol = symbol
+		self.factor = factor
 
 PREFIXES = {
-		'pico' : Prefix('p'),
-		'nano' : Prefix('n'),
-		'micro': Prefix('μ'),
-		'milli': Prefix('m'),
-		'centi': Prefix('c'),
-		'hecto': Prefix('h'),
-		'kilo' : Prefix('k'),
-		'mega' : Prefix('M'),
-		'giga' : Prefix('G'),
-		'tera' : Prefix('T'),
+		'pico' : Prefix('p', Fraction(1, 10**12)),
+		'nano' : Prefix('n', Fraction(1, 10**9)),
+		'micro': Prefix('μ', Fraction(1, 10**6)),
+		'milli': Prefix('m', Fraction(1, 10**3)),
+		'centi': Prefix('c', Fraction(1, 10**2)),
+		'hecto': Prefix('h', Fraction(10**2)),
+		'kilo' : Prefix('k', Fraction(10**3)),
+		'mega' : Prefix('M', Fraction(10**6)),
+		'giga' : Prefix('G', Fraction(10**9)),
+		'tera' : Prefix('T', Fraction(10**12)),
 }
 
 
@@ -197,12 +481,14 @@ SELF = object()
 
 class UnitMultiple(object):
 	
-	def __init__(self, unit, symbol, name, name_plural, definition_str):
+	def __init__(self, unit, symbol, name, name_plural, dimensions, ratio):
 		self.unit = unit
 		self._symbol = symbol
 		self._name = name
 		self._name_plural = name_plural
-		self.definition_str = definition_str
+		self.dimensions = dimensions
+		self.ratio = ratio
+		self.definition_str = canonical_definition(dimensions, ratio)
 	
 	def symbol(self):
 		return self._symbol
@@ -230,6 +516,20 @@ class UnitMultiple(object):
 			symbol = symbol.replace(key, val)
 		return symbol
 	
+	def ascii_symbol(self):
+		REPLACEMENT = {
+				'μ' : 'u',
+				'Ω' : 'ohm',
+				'·' : '*',
+				'²' : '^2',
+				'³' : '^3',
+		}
+		
+		symbol = self._symbol
+		for key, val in REPLACEMENT.iteritems():
+			symbol = symbol.replace(key, val)
+		return symbol
+	
 	def type_name(self):
 		name_parts = self.unit.quantities[0].split(' ')
 		type_name = ''.join(name_part.capitalize() for name_part in name_parts)
@@ -249,12 +549,6 @@ class UnitMultiple(object):
 			return self.type_name() + '<int>'
 		else:
 			return self.macro_name() + '(int)'
-	
-	def definition_from(self):
-		if TEMPLATE_ALIASES:
-			return '::si::%s<ValueType>' % self.type_name()
-		else:
-			return '%s(ValueType)' % self.macro_name()
 
 
 
@@ -281,27 +575,23 @@ class Unit(object):
 				elif isinstance(multiple_spec, str):
 					prefix = multiple_spec
 					p = PREFIXES[prefix]
-					definition_from = main_multiple.definition_from()
 					multiple = UnitMultiple(
 									unit=self,
 									symbol=p.symbol + self.symbol,
 									name=prefix + self.name(),
 									name_plural=prefix + self.name_plural(),
-									definition_str='typename %s::%sapply_ratio< ::std::%s>::type' % (definition_from, 'template ' if TEMPLATE_ALIASES else '', prefix),
+									dimensions=main_multiple.dimensions,
+									ratio=main_multiple.ratio * p.factor,
 								)
 				elif isinstance(multiple_spec, Ratio):
 					ratio = multiple_spec
-					definition_from = main_multiple.definition_from()
-					if isinstance(ratio.multiplier, Fraction):
-						ratio_str = '%d, %d' % (ratio.multiplier.numerator, ratio.multiplier.denominator)
-					else:
-						ratio_str = int(ratio.multiplier)
 					multiple = UnitMultiple(
 									unit=self,
 									symbol=ratio.symbol,
 									name=ratio.name,
 									name_plural=ratio.name + 's',
-									definition_str='typename %s::%sapply_ratio< ::std::ratio<%s>>::type' % (definition_from, 'template ' if TEMPLATE_ALIASES else '', ratio_str),
+									dimensions=main_multiple.dimensions,
+									ratio=main_multiple.ratio * Fraction(ratio.multiplier),
 								)
 				elif isinstance(multiple_spec, Definition):
 					definition = multiple_spec
@@ -310,7 +600,8 @@ class Unit(object):
 									symbol=definition.symbol(),
 									name=definition.name(),
 									name_plural=definition.name_plural(),
-									definition_str=definition.str()
+									dimensions=definition.dimensions(),
+									ratio=definition.ratio(),
 								)
 				else:
 					raise NotImplementedError(multiple_spec)
@@ -335,6 +626,9 @@ class Unit(object):
 	
 	def quantities_str(self):
 		return ', '.join(self.quantities)
+	
+	def header_name(self):
+		return self.quantities[0].replace(' ', '_') + '.hpp'
 
 
 
@@ -354,7 +648,8 @@ class BaseUnit(Unit):
 							symbol=symbol,
 							name=name,
 							name_plural=name + 's',
-							definition_str='::si::SIValue<ValueType, ::std::ratio<1>, %s>' % ', '.join(str(power) for power in dimensions)
+							dimensions=dimensions,
+							ratio=Fraction(1),
 						)
 		
 		multiples_specs = multiples
@@ -393,7 +688,8 @@ class DerivedUnit(Unit):
 							symbol=symbol,
 							name=name,
 							name_plural=name_plural,
-							definition_str=definition.str()
+							dimensions=definition.dimensions(),
+							ratio=definition.ratio(),
 						)
 		
 		multiples_specs = multiples
@@ -419,12 +715,6 @@ class Definition(object):
 	def name_plural(self):
 		return self.name() + 's'
 	
-	def definition_from(self):
-		symbol = self.symbol()
-		if symbol in ALL_MULTIPLES:
-			return ALL_MULTIPLES[symbol].definition_from()
-		else:
-			return self.str()
 
 
 class BinaryOperation(Definition):
@@ -437,6 +727,19 @@ class BinaryOperation(Definition):
 	
 	def operand2(self):
 		return ALL_MULTIPLES[self._operand2] if isinstance(self._operand2, str) else self._operand2
+	
+	def operands_dimensions_and_ratios(self):
+		result = []
+		for operand in (self._operand1, self._operand2):
+			if operand is 1:
+				result.append(([0] * 7, Fraction(1)))
+			else:
+				operand = ALL_MULTIPLES[operand] if isinstance(operand, str) else operand
+				if isinstance(operand, UnitMultiple):
+					result.append((operand.dimensions, operand.ratio))
+				else:
+					result.append((operand.dimensions(), operand.ratio()))
+		return result
 
 
 class Multiplication(BinaryOperation):
@@ -449,10 +752,13 @@ class Multiplication(BinaryOperation):
 	def name(self):
 		return self.operand1().name() + ' ' + self.operand2().name()
 	
-	def str(self):
-		type1 = self.operand1().definition_from()
-		type2 = self.operand2().definition_from()
-		return '%s::si::multiplication< %s, %s>::type' % ('typename ' if TEMPLATE_ALIASES else '', type1, type2)
+	def dimensions(self):
+		(dimensions1, _), (dimensions2, _) = self.operands_dimensions_and_ratios()
+		return [d1 + d2 for d1, d2 in zip(dimensions1, dimensions2)]
+	
+	def ratio(self):
+		(_, ratio1), (_, ratio2) = self.operands_dimensions_and_ratios()
+		return ratio1 * ratio2
 
 
 class Square(Multiplication):
@@ -503,13 +809,13 @@ class Division(BinaryOperation):
 	def name_plural(self):
 		return self.operand1().name_plural() + ' per ' + self.operand2().name()
 	
-	def str(self):
-		if self._operand1 is 1:
-			t1 = 'ValueType'
-		else:
-			t1 = self.operand1().definition_from()
-		
-		return '%s::si::division< %s, %s>::type' % ('typename ' if TEMPLATE_ALIASES else '', t1, self.operand2().definition_from())
+	def dimensions(self):
+		(dimensions1, _), (dimensions2, _) = self.operands_dimensions_and_ratios()
+		return [d1 - d2 for d1, d2 in zip(dimensions1, dimensions2)]
+	
+	def ratio(self):
+		(_, ratio1), (_, ratio2) = self.operands_dimensions_and_ratios()
+		return ratio1 / ratio2
 
 
 ################################################################################
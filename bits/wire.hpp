@@ -0,0 +1,501 @@
+#ifndef SI_WIRE_HPP_
+#define SI_WIRE_HPP_
+
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <ratio>
+#include <type_traits>
+#include <vector>
+#include "dimension_code.hpp"
+#include "ratio_table.hpp"
+#include "si_value.hpp"
+#include "span.hpp"
+
+
+namespace si {
+
+
+/**
+ * @brief A compact binary format for SI values.
+ *
+ * @details A message is a sequence of items, each one a single value (a
+ * record) or an array of values with the same type (a column). An item
+ * starts with a tag that identifies the type of its values:
+ *   - The powers of the base units, each one zigzag-encoded in 4 bits (so in
+ *     the range [-8, 7]), starting at the least significant bits with the
+ *     meter, as a varint.
+ *   - <tt>(ratio id << 3) | (column << 2) | kind</tt> as a varint, where the
+ *     ratio id is the index of the ratio in the table of the ratios of the
+ *     units plus one, and the kind is the underlying type (see
+ *     @c value_kind). A ratio id of 0 is followed by the numerator and the
+ *     denominator of the ratio, as varints.
+ *
+ * Varints are LEB128: 7 bits per byte, least significant first, with the
+ * high bit set on all the bytes but the last. Meters and kilometers have a
+ * 2 byte tag, and meters per second a 3 byte tag.
+ *
+ * A record is its tag followed by the value. A column is its tag followed by
+ * the number of values as a varint, zero bytes up to a multiple of the size
+ * of the values (counted from the start of the message), and the values.
+ * Values are little-endian, in two's complement or IEEE 754.
+ *
+ * A column is written with a single copy of its underlying values, and, on a
+ * little-endian machine, read without any copy when the values have the
+ * type that is requested and are aligned in memory, which is the case when
+ * the message is read from a buffer allocated with @c new or @c malloc.
+ */
+namespace wire {
+
+
+/// The underlying type of the values of an item.
+enum value_kind {
+	int32 = 0,
+	int64 = 1,
+	float32 = 2,
+	float64 = 3,
+};
+
+
+/// The type of the values of an item.
+struct unit_tag {
+	dimension_code dimensions;
+	std::intmax_t num;
+	std::intmax_t den;
+	value_kind kind;
+};
+
+
+} /* namespace si::wire */
+
+
+
+namespace _wire {
+
+
+#if defined(__BYTE_ORDER__)  &&  __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+const bool big_endian = true;
+#else
+const bool big_endian = false;
+#endif
+
+
+const int power_bits = 4;
+const int column_bit = 4;
+const int ratio_shift = 3;
+const int max_varint_size = 10;
+
+
+template <typename T>
+struct kind_of {
+	static_assert(std::is_floating_point<T>::value ? sizeof(T) == 4  ||  sizeof(T) == 8 :
+	              std::is_signed<T>::value  &&  (sizeof(T) == 4  ||  sizeof(T) == 8),
+	              "The binary format supports 32 and 64 bit signed integers, float and double");
+	static const wire::value_kind value =
+		std::is_floating_point<T>::value ?
+			(sizeof(T) == 4 ? wire::float32 : wire::float64) :
+			(sizeof(T) == 4 ? wire::int32 : wire::int64);
+};
+
+inline std::size_t size_of(wire::value_kind kind) {
+	return kind == wire::int32  ||  kind == wire::float32 ? 4 : 8;
+}
+
+
+// The id of a ratio: its index in the table plus one, or 0 if it isn't there.
+constexpr unsigned ratio_id(std::intmax_t num, std::intmax_t den) {
+	return (_ratio_table::index_of(num, den) + 1) % (_ratio_table::size + 1);
+}
+
+
+constexpr std::uint64_t zigzag(int power) {
+	return power < 0 ? std::uint64_t(-2 * power - 1) : std::uint64_t(2 * power);
+}
+
+constexpr bool powers_fit(dimension_code code, int index = 0) {
+	return index == 7  ||
+	       (zigzag(unpack_dimension(code, index)) < (1u << power_bits)  &&  powers_fit(code, index + 1));
+}
+
+constexpr std::uint64_t packed_powers(dimension_code code, int index = 0) {
+	return index == 7 ? 0 :
+	       zigzag(unpack_dimension(code, index)) << (power_bits * index) | packed_powers(code, index + 1);
+}
+
+inline dimension_code unpack_powers(std::uint64_t packed) {
+	dimension_code code = 0;
+	for(int index = 0; index < 7; index++) {
+		const unsigned z = unsigned(packed >> (power_bits * index)) & ((1u << power_bits) - 1);
+		const int power = z & 1 ? -int(z >> 1) - 1 : int(z >> 1);
+		code |= _dimension_code::field(power, index);
+	}
+	return code;
+}
+
+
+inline void put_varint(std::vector<unsigned char>& out, std::uint64_t value) {
+	while(value >= 0x80) {
+		out.push_back((unsigned char)(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back((unsigned char)value);
+}
+
+// Reads a varint at position, and moves position past it.
+inline bool get_varint(const unsigned char* data, std::size_t size, std::size_t& position, std::uint64_t& value) {
+	value = 0;
+	for(int i = 0; i < max_varint_size  &&  position < size; i++) {
+		const unsigned char byte = data[position++];
+		value |= std::uint64_t(byte & 0x7F) << (7 * i);
+		if(!(byte & 0x80)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+
+template <typename SIValueType>
+void put_tag(std::vector<unsigned char>& out, bool column) {
+	typedef typename SIValueType::Ratio Ratio;
+	static_assert(powers_fit(SIValueType::Dimensions),
+	              "The binary format supports powers of the base units in the range [-8, 7]");
+	const unsigned id = ratio_id(Ratio::num, Ratio::den);
+
+	put_varint(out, packed_powers(SIValueType::Dimensions));
+	put_varint(out, std::uint64_t(id) << ratio_shift
+	                | (column ? column_bit : 0)
+	                | kind_of<typename SIValueType::ValueType>::value);
+	if(id == 0) {
+		put_varint(out, std::uint64_t(Ratio::num));
+		put_varint(out, std::uint64_t(Ratio::den));
+	}
+}
+
+inline bool get_tag(const unsigned char* data, std::size_t size, std::size_t& position,
+                    wire::unit_tag& tag, bool& column) {
+	std::uint64_t powers, info;
+	if(!get_varint(data, size, position, powers)  ||  powers >> (7 * power_bits)  ||
+	   !get_varint(data, size, position, info)) {
+		return false;
+	}
+	tag.dimensions = unpack_powers(powers);
+	tag.kind = wire::value_kind(info & 3);
+	column = (info & column_bit) != 0;
+
+	const std::uint64_t id = info >> ratio_shift;
+	if(id > _ratio_table::size) {
+		return false;
+	}
+	if(id > 0) {
+		tag.num = _ratio_table::num[id - 1];
+		tag.den = _ratio_table::den[id - 1];
+		return true;
+	}
+	std::uint64_t num, den;
+	if(!get_varint(data, size, position, num)  ||  !get_varint(data, size, position, den)  ||
+	   num == 0  ||  den == 0  ||  num > std::uint64_t(INTMAX_MAX)  ||  den > std::uint64_t(INTMAX_MAX)) {
+		return false;
+	}
+	tag.num = std::intmax_t(num);
+	tag.den = std::intmax_t(den);
+	return true;
+}
+
+
+// Copies values between memory and the little-endian format.
+inline void copy_little_endian(unsigned char* to, const unsigned char* from, std::size_t count, std::size_t size) {
+	if(!big_endian) {
+		std::memcpy(to, from, count * size);
+		return;
+	}
+	for(std::size_t i = 0; i < count; i++) {
+		for(std::size_t b = 0; b < size; b++) {
+			to[i * size + b] = from[i * size + size - 1 - b];
+		}
+	}
+}
+
+
+template <typename T>
+void put_values(std::vector<unsigned char>& out, const T* values, std::size_t count) {
+	if(count == 0) {
+		return;
+	}
+	const std::size_t offset = out.size();
+	out.resize(offset + count * sizeof(T));
+	copy_little_endian(&out[offset], reinterpret_cast<const unsigned char*>(values), count, sizeof(T));
+}
+
+
+inline std::intmax_t gcd(std::intmax_t a, std::intmax_t b) {
+	while(b != 0) {
+		const std::intmax_t r = a % b;
+		a = b;
+		b = r;
+	}
+	return a;
+}
+
+
+// Converts values from a tag to a type with the same dimensions. Values of
+// integer kinds are converted to integer types exactly when the factor is an
+// integer, and truncated like the conversions between SI values otherwise.
+// The tags and the values come from the message, so the factor and the
+// converted values are checked for overflow.
+template <typename SIValueType>
+struct converter {
+	typedef typename SIValueType::ValueType T;
+	typedef typename SIValueType::Ratio Ratio;
+
+	wire::value_kind kind;
+	std::intmax_t num; // The factor from the ratio of the tag to Ratio
+	std::intmax_t den;
+	bool valid;        // The factor fits in intmax_t
+
+	explicit converter(const wire::unit_tag& tag) : kind(tag.kind), num(1), den(1), valid(false) {
+		const std::intmax_t g1 = gcd(tag.num, Ratio::num);
+		const std::intmax_t g2 = gcd(tag.den, Ratio::den);
+		if(tag.num / g1 > INTMAX_MAX / (Ratio::den / g2)  ||  tag.den / g2 > INTMAX_MAX / (Ratio::num / g1)) {
+			return;
+		}
+		num = (tag.num / g1) * (Ratio::den / g2);
+		den = (tag.den / g2) * (Ratio::num / g1);
+		valid = true;
+	}
+
+	// Converts a value, or returns false if it doesn't fit in T.
+	bool operator()(const unsigned char* bytes, T& value) const {
+		unsigned char raw[8];
+		copy_little_endian(raw, bytes, 1, size_of(kind));
+		switch(kind) {
+		case wire::int32:   return convert_integer(load<std::int32_t>(raw), value, std::is_integral<T>());
+		case wire::int64:   return convert_integer(load<std::int64_t>(raw), value, std::is_integral<T>());
+		case wire::float32: return convert_floating(double(load<float>(raw)) * num / den, value, std::is_integral<T>());
+		default:            return convert_floating(load<double>(raw) * num / den, value, std::is_integral<T>());
+		}
+	}
+
+	template <typename U>
+	static U load(const unsigned char* raw) {
+		U value;
+		std::memcpy(&value, raw, sizeof(U));
+		return value;
+	}
+
+	bool convert_integer(std::int64_t raw, T& value, std::true_type) const {
+		if(raw > INTMAX_MAX / num  ||  raw < -(INTMAX_MAX / num)) {
+			return false;
+		}
+		const std::intmax_t scaled = den == 1 ? raw * num : raw * num / den;
+		if(scaled < 0 ? scaled < std::intmax_t(std::numeric_limits<T>::min())
+		              : std::uintmax_t(scaled) > std::uintmax_t(std::numeric_limits<T>::max())) {
+			return false;
+		}
+		value = T(scaled);
+		return true;
+	}
+
+	bool convert_integer(std::int64_t raw, T& value, std::false_type) const {
+		return convert_floating(double(raw) * num / den, value, std::false_type());
+	}
+
+	// The conversion of NaN or of a value out of range to an integer is undefined.
+	bool convert_floating(double raw, T& value, std::true_type) const {
+		const double lowest = double(std::numeric_limits<T>::lowest());
+		if(!(raw >= lowest  &&  raw < -lowest)) {
+			return false;
+		}
+		value = T(raw);
+		return true;
+	}
+
+	// A finite value beyond the range of T (a float) would become an infinity.
+	bool convert_floating(double raw, T& value, std::false_type) const {
+		if(std::isfinite(raw)  &&  std::fabs(raw) > double(std::numeric_limits<T>::max())) {
+			return false;
+		}
+		value = T(raw);
+		return true;
+	}
+};
+
+
+} /* namespace si::_wire */
+
+
+
+namespace wire {
+
+
+/// Appends a record with a single value to a message.
+template <typename SIValueType>
+void write(std::vector<unsigned char>& out, const SIValueType& value) {
+	_wire::put_tag<SIValueType>(out, false);
+	_wire::put_values(out, &value.value, 1);
+}
+
+
+/// Appends a column with the values of a span to a message.
+/**
+ * The underlying values are copied to the message with a single
+ * @c memcpy (on a little-endian machine).
+ */
+template <typename SIValueType>
+void write(std::vector<unsigned char>& out, quantity_span<SIValueType> values) {
+	typedef typename std::remove_const<SIValueType>::type::ValueType T;
+	_wire::put_tag<typename std::remove_const<SIValueType>::type>(out, true);
+	_wire::put_varint(out, values.size());
+	out.resize((out.size() + sizeof(T) - 1) / sizeof(T) * sizeof(T), 0);
+	_wire::put_values(out, values.raw(), values.size());
+}
+
+
+
+/// Reads the items of a message.
+/**
+ * The reader doesn't copy the message, which must outlive it and the views
+ * returned by @c read.
+ *
+ * The functions that read an item return @c false, without moving past the
+ * item, if it is malformed or truncated, if it has other dimensions than the
+ * type that is requested, or if its values overflow that type once they are
+ * converted.
+ */
+class reader {
+public:
+	reader(const unsigned char* data, std::size_t size) : _data(data), _size(size), _position(0) {}
+
+	explicit reader(const std::vector<unsigned char>& message) :
+		_data(message.data()), _size(message.size()), _position(0) {}
+
+
+	/// The offset of the next item from the start of the message.
+	std::size_t position() const {
+		return _position;
+	}
+
+	bool at_end() const {
+		return _position == _size;
+	}
+
+
+	/// Reads the tag of the next item, without moving past it.
+	bool peek(unit_tag& tag, bool& column) const {
+		std::size_t position = _position;
+		return _wire::get_tag(_data, _size, position, tag, column);
+	}
+
+
+	/// Reads a record, converted to the ratio and the underlying type of @c value.
+	template <typename SIValueType>
+	bool read(SIValueType& value) {
+		std::size_t position = _position;
+		unit_tag tag;
+		bool column;
+		if(!_wire::get_tag(_data, _size, position, tag, column)  ||  column  ||
+		   tag.dimensions != SIValueType::Dimensions  ||
+		   _size - position < _wire::size_of(tag.kind)) {
+			return false;
+		}
+		const _wire::converter<SIValueType> convert(tag);
+		if(!convert.valid  ||  !convert(_data + position, value.value)) {
+			return false;
+		}
+		_position = position + _wire::size_of(tag.kind);
+		return true;
+	}
+
+
+	/// Reads a column of values.
+	/**
+	 * If the values have the ratio and the underlying type of @c SIValueType
+	 * and they are aligned, @c view points to them in the message. Otherwise
+	 * they are converted into @c storage, and @c view points to it.
+	 */
+	template <typename SIValueType>
+	bool read(quantity_span<const SIValueType>& view, std::vector<SIValueType>& storage) {
+		typedef typename SIValueType::ValueType T;
+		typedef typename SIValueType::Ratio Ratio;
+
+		std::size_t position = _position;
+		unit_tag tag;
+		bool column;
+		std::uint64_t count;
+		if(!_wire::get_tag(_data, _size, position, tag, column)  ||  !column  ||
+		   tag.dimensions != SIValueType::Dimensions  ||
+		   !_wire::get_varint(_data, _size, position, count)) {
+			return false;
+		}
+		const std::size_t size = _wire::size_of(tag.kind);
+		position = (position + size - 1) / size * size;
+		if(position > _size  ||  count > (_size - position) / size) {
+			return false;
+		}
+		const unsigned char* const values = _data + position;
+		const std::size_t end = position + std::size_t(count) * size;
+
+		if(!_wire::big_endian  &&  tag.kind == _wire::kind_of<T>::value  &&
+		   tag.num == Ratio::num  &&  tag.den == Ratio::den  &&
+		   std::uintptr_t(values) % alignof(SIValueType) == 0) {
+			view = quantity_span<const SIValueType>(reinterpret_cast<const SIValueType*>(values), std::size_t(count));
+			_position = end;
+			return true;
+		}
+
+		const _wire::converter<SIValueType> convert(tag);
+		if(!convert.valid) {
+			return false;
+		}
+		storage.resize(std::size_t(count));
+		for(std::size_t i = 0; i < count; i++) {
+			if(!convert(values + i * size, storage[i].value)) {
+				return false;
+			}
+		}
+		view = quantity_span<const SIValueType>(storage.data(), storage.size());
+		_position = end;
+		return true;
+	}
+
+
+	/// Moves past the next item.
+	bool skip() {
+		std::size_t position = _position;
+		unit_tag tag;
+		bool column;
+		if(!_wire::get_tag(_data, _size, position, tag, column)) {
+			return false;
+		}
+		const std::size_t size = _wire::size_of(tag.kind);
+		std::uint64_t count = 1;
+		if(column) {
+			if(!_wire::get_varint(_data, _size, position, count)) {
+				return false;
+			}
+			position = (position + size - 1) / size * size;
+		}
+		if(position > _size  ||  count > (_size - position) / size) {
+			return false;
+		}
+		_position = position + std::size_t(count) * size;
+		return true;
+	}
+
+private:
+	const unsigned char* _data;
+	std::size_t _size;
+	std::size_t _position;
+};
+
+
+} /* namespace si::wire */
+
+
+} /* namespace si */
+
+
+#endif /* SI_WIRE_HPP_ */
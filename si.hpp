@@ -7,6 +7,28 @@
 #include "bits/units.hpp"
 #include "bits/types.hpp"
 #include "bits/funcs.hpp"
+#include "bits/chrono.hpp"
+#include "bits/ring_series.hpp"
+#include "bits/matrix.hpp"
+#include "bits/span.hpp"
+#include "bits/span_math.hpp"
+#include "bits/thresholds.hpp"
+#include "bits/sorting.hpp"
+#include "bits/hash.hpp"
+#include "bits/quantity_map.hpp"
+#include "bits/wire.hpp"
+#include "bits/json.hpp"
+#include "bits/arrow.hpp"
+#include "bits/conversions.hpp"
+#include "bits/audit.hpp"
+#include "bits/dual.hpp"
+#include "bits/interval.hpp"
+#include "bits/batch.hpp"
+#include "bits/uncertain.hpp"
+#include "bits/calculus.hpp"
+#include "bits/ode.hpp"
+#include "bits/filters.hpp"
+#include "bits/unit_string.hpp"
 
 
 #endif /* SI_HPP_ */
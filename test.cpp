@@ -2,6 +2,7 @@
 #include "si.hpp"
 
 #include <iostream>
+#include <thread>
 
 using namespace std;
 using namespace si::units;
@@ -56,6 +57,27 @@ typedef SI_FREQUENCY_Hz(double)  FrequencyDbl_Hz;
 #include "tests/divisions.hpp"
 #include "tests/math.hpp"
 #include "tests/units.hpp"
+#include "tests/matrix.hpp"
+#include "tests/durations.hpp"
+#include "tests/ring_series.hpp"
+#include "tests/types.hpp"
+#include "tests/spans.hpp"
+#include "tests/thresholds.hpp"
+#include "tests/sorting.hpp"
+#include "tests/hashing.hpp"
+#include "tests/wire.hpp"
+#include "tests/json.hpp"
+#include "tests/arrow.hpp"
+#include "tests/conversions.hpp"
+#include "tests/audit.hpp"
+#include "tests/moves.hpp"
+#include "tests/dual.hpp"
+#include "tests/interval.hpp"
+#include "tests/uncertain.hpp"
+#include "tests/calculus.hpp"
+#include "tests/ode.hpp"
+#include "tests/filters.hpp"
+#include "tests/unit_strings.hpp"
 
 
 
@@ -68,6 +90,27 @@ int main() {
 	divisions::test();
 	math::test();
 	units::test();
+	matrix::test();
+	durations::test();
+	ring_series::test();
+	types::test();
+	spans::test();
+	thresholds::test();
+	sorting::test();
+	hashing::test();
+	wire::test();
+	json::test();
+	arrow::test();
+	conversions::test();
+	audit::test();
+	moves::test();
+	dual::test();
+	interval::test();
+	uncertain::test();
+	calculus::test();
+	ode::test();
+	filters::test();
+	unit_strings::test();
 
 	cout << "OK" << endl;
 }
@@ -0,0 +1,178 @@
+#ifndef ARROW_HPP_
+#define ARROW_HPP_
+
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+
+namespace arrow {
+
+
+typedef si::Speed_km_h<double> SpeedDbl_km_h;
+typedef si::Mass_kg<int> Mass_kg;
+
+
+// A consumer that only knows the Arrow C data interface: it reads the field
+// and the values from the structs, then releases them.
+struct column {
+	std::string format;
+	std::string name;
+	std::map<std::string, std::string> metadata;
+	const void* data;
+	double sum;
+};
+
+column consume(ArrowSchema* schema, ArrowArray* array) {
+	column c;
+	c.format = schema->format;
+	c.name = schema->name;
+
+	const char* p = schema->metadata;
+	std::int32_t pairs, length;
+	std::memcpy(&pairs, p, 4);
+	p += 4;
+	for(std::int32_t i = 0; i < pairs; i++) {
+		std::memcpy(&length, p, 4);
+		const std::string key(p + 4, length);
+		p += 4 + length;
+		std::memcpy(&length, p, 4);
+		c.metadata[key] = std::string(p + 4, length);
+		p += 4 + length;
+	}
+
+	assert(array->n_buffers == 2  &&  array->buffers[0] == nullptr  &&  array->null_count == 0);
+	c.data = array->buffers[1];
+	c.sum = 0;
+	for(std::int64_t i = array->offset; i < array->offset + array->length; i++) {
+		switch(c.format[0]) {
+		case 'i': c.sum += static_cast<const std::int32_t*>(c.data)[i]; break;
+		case 'l': c.sum += static_cast<const std::int64_t*>(c.data)[i]; break;
+		case 'f': c.sum += static_cast<const float*>(c.data)[i]; break;
+		case 'g': c.sum += static_cast<const double*>(c.data)[i]; break;
+		}
+	}
+
+	schema->release(schema);
+	array->release(array);
+	assert(schema->release == nullptr  &&  array->release == nullptr);
+	return c;
+}
+
+
+void exports() {
+	// A span: the values stay with the producer.
+	const SpeedDbl_km_h speeds[] = { SpeedDbl_km_h(36), SpeedDbl_km_h(72), SpeedDbl_km_h(0.5) };
+	ArrowSchema schema;
+	ArrowArray array;
+	si::arrow::export_column(si::quantity_span<const SpeedDbl_km_h>(speeds), &array, &schema, "speed");
+	column c = consume(&schema, &array);
+	assert(c.format == "g"  &&  c.name == "speed");
+	assert(c.metadata.size() == 3);
+	assert(c.metadata["si.dimensions"] == "1,0,-1,0,0,0,0");
+	assert(c.metadata["si.ratio"] == "5/18");
+	assert(c.metadata["si.unit"] == "km/h");
+	assert(c.data == speeds);
+	assert(c.sum == 108.5);
+
+	// A vector: the values move into the array, and are freed when it is released.
+	std::vector<Mass_kg> masses;
+	for(int i = 1; i <= 1000; i++) {
+		masses.push_back(Mass_kg(i));
+	}
+	const void* const data = masses.data();
+	si::arrow::export_column(std::move(masses), &array, &schema);
+	c = consume(&schema, &array);
+	assert(c.format == "i"  &&  c.name.empty());
+	assert(c.metadata["si.dimensions"] == "0,1,0,0,0,0,0");
+	assert(c.metadata["si.ratio"] == "1000");
+	assert(c.metadata["si.unit"] == "kg");
+	assert(c.data == data);
+	assert(c.sum == 500500);
+
+	// A unit without a symbol
+	const Area_cm2 areas[] = { Area_cm2(1LL << 40) };
+	std::vector<decltype(Area_cm2() * Time_h())> products(1, areas[0] * Time_h(2));
+	si::arrow::export_column(si::quantity_span<const Area_cm2>(areas), &array, &schema);
+	c = consume(&schema, &array);
+	assert(c.format == "l"  &&  c.metadata["si.ratio"] == "1/10000"  &&  c.sum == double(1LL << 40));
+	si::arrow::export_column(std::move(products), &array, &schema);
+	c = consume(&schema, &array);
+	assert(c.metadata.size() == 2);
+	assert(c.metadata["si.dimensions"] == "2,0,1,0,0,0,0"  &&  c.metadata["si.ratio"] == "9/25");
+}
+
+
+void imports() {
+	std::vector<SpeedDbl_km_h> speeds(100, SpeedDbl_km_h(1.5));
+	ArrowSchema schema;
+	ArrowArray array;
+	si::arrow::export_column(si::quantity_span<const SpeedDbl_km_h>(speeds), &array, &schema);
+
+	si::quantity_span<const SpeedDbl_km_h> view;
+	assert(si::arrow::import_column(schema, array, view));
+	assert(view.data() == speeds.data()  &&  view.size() == 100);
+
+	si::quantity_span<const SpeedDbl_m_s> otherRatio;
+	si::quantity_span<const si::Speed_km_h<float>> otherType;
+	si::quantity_span<const TimeDbl_s> otherDimensions;
+	assert(!si::arrow::import_column(schema, array, otherRatio));
+	assert(!si::arrow::import_column(schema, array, otherType));
+	assert(!si::arrow::import_column(schema, array, otherDimensions));
+	schema.release(&schema);
+	array.release(&array);
+	assert(!si::arrow::import_column(schema, array, view));
+
+	// From another producer: other metadata, an offset, and an unknown null count without nulls.
+	const std::int32_t values[] = { 7, 1, 2, 3 };
+	const void* buffers[] = { nullptr, values };
+	std::string metadata;
+	const char* const pairs[][2] = { { "origin", "sensor" }, { "si.ratio", "1/100" }, { "si.dimensions", "1,0,0,0,0,0,0" } };
+	const std::int32_t count = 3;
+	metadata.append((const char*)&count, 4);
+	for(const auto& pair : pairs) {
+		for(const char* text : pair) {
+			const std::int32_t length = std::int32_t(std::strlen(text));
+			metadata.append((const char*)&length, 4);
+			metadata += text;
+		}
+	}
+	ArrowSchema foreignSchema = { "i", "length", metadata.data(), ARROW_FLAG_NULLABLE, 0, nullptr, nullptr,
+	                              [](ArrowSchema* s) { s->release = nullptr; }, nullptr };
+	ArrowArray foreignArray = { 3, -1, 1, 2, 0, buffers, nullptr, nullptr,
+	                            [](ArrowArray* a) { a->release = nullptr; }, nullptr };
+
+	si::quantity_span<const Length_cm> lengths;
+	assert(si::arrow::import_column(foreignSchema, foreignArray, lengths));
+	assert(lengths.size() == 3  &&  lengths.raw() == values + 1);
+	assert(lengths[0] == Length_cm(1)  &&  lengths[2] == Length_cm(3));
+
+	const std::uint8_t validity[] = { 0x0F };
+	buffers[0] = validity;
+	assert(!si::arrow::import_column(foreignSchema, foreignArray, lengths));
+	foreignArray.null_count = 0;
+	assert(si::arrow::import_column(foreignSchema, foreignArray, lengths));
+	foreignArray.null_count = 1;
+	assert(!si::arrow::import_column(foreignSchema, foreignArray, lengths));
+
+	foreignSchema.metadata = nullptr;
+	foreignArray.null_count = 0;
+	assert(!si::arrow::import_column(foreignSchema, foreignArray, lengths));
+	foreignSchema.release(&foreignSchema);
+	foreignArray.release(&foreignArray);
+}
+
+
+void test() {
+	exports();
+	imports();
+}
+
+
+} /* namespace arrow */
+
+
+#endif /* ARROW_HPP_ */
@@ -0,0 +1,156 @@
+#ifndef AUDIT_HPP_
+#define AUDIT_HPP_
+
+
+#include <sys/wait.h>
+#include <unistd.h>
+#include <csignal>
+#include <cmath>
+#include <limits>
+#include <string>
+
+
+namespace audit {
+
+
+typedef si::Length_mm<int>       Length_mm;
+typedef si::Length_m<long long>  LengthLL_m;
+typedef si::Length_m<unsigned>   LengthUns_m;
+typedef si::Length_m<float>      LengthFlt_m;
+typedef si::Area_cm2<double>     AreaDbl_cm2;
+
+
+#ifdef SI_AUDIT_CONVERSIONS
+ const bool audited = true;
+#else
+ const bool audited = false;
+#endif
+
+
+// The number of losses expected when the conversions are audited.
+bool losses(unsigned long long truncations, unsigned long long narrowings, unsigned long long roundings) {
+	if(!audited) {
+		truncations = narrowings = roundings = 0;
+	}
+	const bool result = si::audit::losses(si::audit::truncation) == truncations
+	                 && si::audit::losses(si::audit::narrowing) == narrowings
+	                 && si::audit::losses(si::audit::rounding) == roundings;
+	si::audit::reset();
+	return result;
+}
+
+
+void kinds() {
+	si::audit::reset();
+
+	// The truncations documented in the other tests
+	assert(Length_km(7*m).value == 0);
+	assert(Length_m(7.2*m).value == 7);
+	assert(Length_m(Length_cm(7)).value == 0);
+	Length_m len_m(4);
+	len_m += Length_cm(123);
+	len_m *= 2.7;
+	assert(len_m.value == 13);
+	assert(losses(5, 0, 0));
+
+	// Conversions that lose nothing
+	assert(Length_km(4000*m).value == 4);
+	assert(Length_cm(Length_m(7)).value == 700);
+	assert(LengthDbl_km(Length_m(7)).value == 0.007);
+	assert(LengthFlt_m(LengthDbl_m(0.5)).value == 0.5f);
+	len_m *= 2.0;
+	len_m /= 2.0;
+	LengthDbl_m lenDbl_m(0.1);
+	lenDbl_m *= 0.1;
+	assert(LengthFlt_m(LengthDbl_m(std::nan(""))).value != 0);
+	assert(losses(0, 0, 0));
+
+	// Narrowing
+	assert(Length_mm(Length_km(2000)).value == 2000000000);
+	(void)Length_m(LengthLL_m(1LL << 40));
+	(void)Length_m(LengthLL_m(-(1LL << 31) - 1));
+	(void)LengthUns_m(Length_m(-1));
+	assert(losses(0, 3, 0));
+
+	// Narrowing from floating point, undefined without the audit. The range
+	// is checked before the conversion, and the nearest bound is stored.
+	if(audited) {
+		const int highest = std::numeric_limits<int>::max();
+		const int lowest = std::numeric_limits<int>::min();
+		assert(Length_m(LengthDbl_m(1e20)).value == highest);
+		assert(Length_m(LengthDbl_m(-1e20)).value == lowest);
+		assert(Length_mm(Length_km(3000)).value == highest);
+		Length_m scaled(2);
+		scaled *= 1e30;
+		assert(scaled.value == highest);
+		scaled /= -1e-30;
+		assert(scaled.value == lowest);
+		assert(losses(0, 5, 0));
+	}
+
+	// Rounding
+	assert(LengthFlt_m(LengthDbl_m(0.1)).value == 0.1f);
+	assert(LengthFlt_m(Length_m(16777217)).value == 16777216);
+	assert(AreaDbl_cm2(Area_cm2((1LL << 60) + 1)).value == std::ldexp(1.0, 60));
+	assert(AreaDbl_cm2(Area_cm2(1LL << 60)).value == std::ldexp(1.0, 60));
+	assert(losses(0, 0, 3));
+}
+
+
+si::audit::loss last;
+int logged = 0;
+
+void record(const si::audit::loss& l) {
+	last = l;
+	logged++;
+}
+
+
+void modes() {
+	assert(si::audit::get_mode() == si::audit::count);
+	si::audit::set_handler(&record);
+	si::audit::set_mode(si::audit::log);
+	(void)Length_km(7*m);
+	assert(Length_cm(Length_m(7)).value == 700);
+	si::audit::set_mode(si::audit::count);
+	(void)Length_km(7*m);
+	si::audit::set_handler(nullptr);
+	assert(logged == (audited ? 1 : 0));
+	assert(losses(2, 0, 0));
+	if(audited) {
+		assert(last.what == si::audit::truncation);
+		assert(si::conversions::name(last.from) == "m (int)"  &&  si::conversions::name(last.to) == "km (int)");
+		assert(std::fabs(double(last.value) - 0.007) < 1e-15);
+		assert(last.stored == 0);
+	}
+
+	// The trap aborts the conversion in a child process.
+	const pid_t child = fork();
+	assert(child >= 0);
+	if(child == 0) {
+		si::audit::set_handler(&record);
+		si::audit::set_mode(si::audit::trap);
+		(void)Length_km(Length_m(4000));
+		(void)Length_km(Length_m(4001));
+		_exit(0);
+	}
+	int status;
+	waitpid(child, &status, 0);
+	if(audited) {
+		assert(WIFSIGNALED(status)  &&  WTERMSIG(status) == SIGABRT);
+	} else {
+		assert(WIFEXITED(status)  &&  WEXITSTATUS(status) == 0);
+	}
+}
+
+
+void test() {
+	kinds();
+	modes();
+}
+
+
+} /* namespace audit */
+
+
+#endif /* AUDIT_HPP_ */
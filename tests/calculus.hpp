@@ -0,0 +1,218 @@
+#ifndef CALCULUS_HPP_
+#define CALCULUS_HPP_
+
+
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+
+namespace calculus {
+
+
+typedef si::Power_W<double>            Power_W;
+typedef si::Power_kW<double>           Power_kW;
+typedef si::Energy_J<double>           Energy_J;
+typedef si::Energy_kJ<double>          Energy_kJ;
+typedef si::Time_ms<double>            Time_ms;
+typedef si::Speed_km_h<double>         Speed_km_h;
+typedef si::Acceleration_m_s2<double>  Acceleration_m_s2;
+
+
+// Sizes around the vector widths and the blocks of the running sums, so all
+// the tails are exercised.
+const std::size_t max_size = 19;
+
+
+bool near(double a, double b) {
+	return std::fabs(a - b) <= 1e-12 * (1 + std::fabs(b));
+}
+
+
+// Uneven times: t = i + i² / 10
+double uneven(std::size_t i) {
+	return i + i * i / 10.0;
+}
+
+
+void integrals() {
+	for(std::size_t n = 0; n <= max_size; n++) {
+		std::vector<TimeDbl_s> times, unevenTimes;
+		std::vector<Power_W> linear, quadratic, cubic, unevenQuadratic;
+		for(std::size_t i = 0; i < n; i++) {
+			const double t = 0.5 * i, u = uneven(i);
+			times.push_back(TimeDbl_s(t));
+			unevenTimes.push_back(TimeDbl_s(u));
+			linear.push_back(Power_W(4 * t + 1));
+			quadratic.push_back(Power_W(3 * t * t + 1));
+			cubic.push_back(Power_W(4 * t * t * t - 1));
+			unevenQuadratic.push_back(Power_W(3 * u * u + 1));
+		}
+		const si::quantity_span<const TimeDbl_s> x(times), unevenX(unevenTimes);
+		const TimeDbl_s dx(0.5);
+		const double end = n ? times.back().value : 0;
+		const double unevenEnd = n ? unevenTimes.back().value : 0;
+
+		// The trapezoidal rule is exact for a line.
+		const Energy_J energy = si::trapezoid(si::quantity_span<const Power_W>(linear), x);
+		assert(near(energy.value, 2 * end * end + end));
+		assert(near(si::trapezoid(si::quantity_span<const Power_W>(linear), dx).value, 2 * end * end + end));
+
+		// Simpson's rule is exact for a parabola, and for a cubic over an even
+		// number of intervals.
+		if(n != 2) {
+			assert(near(si::simpson(si::quantity_span<const Power_W>(quadratic), x).value, end * end * end + end));
+			assert(near(si::simpson(si::quantity_span<const Power_W>(quadratic), dx).value, end * end * end + end));
+			assert(near(si::simpson(si::quantity_span<const Power_W>(unevenQuadratic), unevenX).value,
+			            unevenEnd * unevenEnd * unevenEnd + unevenEnd));
+		}
+		if(n % 2) {
+			assert(near(si::simpson(si::quantity_span<const Power_W>(cubic), dx).value, end * end * end * end - end));
+			assert(near(si::simpson(si::quantity_span<const Power_W>(cubic), x).value, end * end * end * end - end));
+		}
+	}
+
+	// The types of the results come from the product of the types.
+	std::vector<Power_kW> power(3, Power_kW(2));
+	const Time_ms times[] = { Time_ms(0), Time_ms(500), Time_ms(1500) };
+	const auto energy = si::trapezoid(si::quantity_span<const Power_kW>(power), si::quantity_span<const Time_ms>(times));
+	static_assert(std::is_same<decltype(energy), const Energy_J>::value, "");
+	assert(energy == Energy_J(3000));
+	static_assert(std::is_same<decltype(si::simpson(si::quantity_span<const Power_W>(), TimeDbl_s(1))), Energy_J>::value, "");
+
+	// Not vectorized
+	{
+		const Speed_m_s speeds[] = { Speed_m_s(1), Speed_m_s(3), Speed_m_s(5) };
+		const Time_s instants[] = { Time_s(0), Time_s(1), Time_s(2) };
+		const si::quantity_span<const Speed_m_s> y(speeds);
+		assert(si::trapezoid(y, si::quantity_span<const Time_s>(instants)) == Length_m(6));
+		assert(si::trapezoid(y, Time_s(1)) == Length_m(6));
+		assert(si::simpson(y, Time_s(3)) == Length_m(18));
+		assert(si::simpson(si::quantity_span<const SpeedDbl_m_s>(), si::quantity_span<const TimeDbl_s>()) == LengthDbl_m(0));
+	}
+
+	CANT_COMPILE(si::simpson(si::quantity_span<const Speed_m_s>(), si::quantity_span<const Time_s>()));
+}
+
+
+void cumulativeIntegrals() {
+	for(std::size_t n = 0; n <= max_size; n++) {
+		std::vector<TimeDbl_s> times;
+		std::vector<Power_W> power;
+		for(std::size_t i = 0; i < n; i++) {
+			times.push_back(TimeDbl_s(uneven(i)));
+			power.push_back(Power_W(std::cos(0.3 * i) * 100));
+		}
+		const si::quantity_span<const Power_W> y(power);
+		const si::quantity_span<const TimeDbl_s> x(times);
+
+		std::vector<Energy_kJ> energy(n, Energy_kJ(-1));
+		si::cumulative_integral(y, x, si::quantity_span<Energy_kJ>(energy));
+		std::vector<Energy_J> uniform(n, Energy_J(-1));
+		si::cumulative_integral(y, TimeDbl_s(0.25), si::quantity_span<Energy_J>(uniform));
+		for(std::size_t i = 0; i < n; i++) {
+			assert(near(energy[i].value, si::trapezoid(y.subspan(0, i + 1), x.subspan(0, i + 1)).value / 1000));
+			assert(near(uniform[i].value, si::trapezoid(y.subspan(0, i + 1), TimeDbl_s(0.25)).value));
+		}
+		if(n) {
+			assert(energy[0] == Energy_kJ(0)  &&  uniform[0] == Energy_J(0));
+		}
+	}
+
+	// Many blocks
+	{
+		const std::size_t n = 100000;
+		std::vector<Power_W> power(n, Power_W(2));
+		std::vector<Energy_J> energy(n);
+		si::cumulative_integral(si::quantity_span<const Power_W>(power), TimeDbl_s(0.001), si::quantity_span<Energy_J>(energy));
+		assert(near(energy[n / 2].value, 0.002 * (n / 2)));
+		assert(std::fabs(energy[n - 1].value - 0.002 * (n - 1)) < 1e-9);
+	}
+
+	// Not vectorized
+	{
+		const Speed_m_s speeds[] = { Speed_m_s(1), Speed_m_s(3), Speed_m_s(5) };
+		const Time_s instants[] = { Time_s(0), Time_s(1), Time_s(3) };
+		Length_m lengths[3];
+		si::cumulative_integral(si::quantity_span<const Speed_m_s>(speeds), si::quantity_span<const Time_s>(instants),
+		                        si::quantity_span<Length_m>(lengths));
+		assert(lengths[0] == Length_m(0)  &&  lengths[1] == Length_m(2)  &&  lengths[2] == Length_m(10));
+		si::cumulative_integral(si::quantity_span<const Speed_m_s>(speeds), Time_s(2), si::quantity_span<Length_m>(lengths));
+		assert(lengths[0] == Length_m(0)  &&  lengths[1] == Length_m(4)  &&  lengths[2] == Length_m(12));
+	}
+
+	CANT_COMPILE(si::cumulative_integral(si::quantity_span<const Power_W>(), TimeDbl_s(1), si::quantity_span<Power_W>()));
+}
+
+
+void gradients() {
+	for(std::size_t n = 1; n <= max_size; n++) {
+		std::vector<TimeDbl_s> times;
+		std::vector<LengthDbl_m> positions, evenPositions;
+		for(std::size_t i = 0; i < n; i++) {
+			const double t = uneven(i);
+			times.push_back(TimeDbl_s(t));
+			positions.push_back(LengthDbl_m(3 * t * t + 2 * t));
+			evenPositions.push_back(LengthDbl_m(3 * 0.25 * i * i + 2 * 0.5 * i));
+		}
+		const si::quantity_span<const TimeDbl_s> x(times);
+
+		// Exact inside for a parabola, even over uneven steps
+		std::vector<SpeedDbl_m_s> speeds(n);
+		si::gradient(si::quantity_span<const LengthDbl_m>(positions), x, si::quantity_span<SpeedDbl_m_s>(speeds));
+		std::vector<Speed_km_h> evenSpeeds(n);
+		si::gradient(si::quantity_span<const LengthDbl_m>(evenPositions), TimeDbl_s(0.5), si::quantity_span<Speed_km_h>(evenSpeeds));
+		for(std::size_t i = 1; i + 1 < n; i++) {
+			assert(near(speeds[i].value, 6 * times[i].value + 2));
+			assert(near(evenSpeeds[i].value, (6 * 0.5 * i + 2) * 3.6));
+		}
+		if(n == 1) {
+			assert(speeds[0] == SpeedDbl_m_s(0)  &&  evenSpeeds[0] == Speed_km_h(0));
+			continue;
+		}
+
+		// The slopes of the first and last intervals at the ends
+		assert(near(speeds[0].value, (positions[1] - positions[0]).value / times[1].value));
+		assert(near(speeds[n - 1].value, (positions[n - 1] - positions[n - 2]).value / (times[n - 1] - times[n - 2]).value));
+		assert(near(evenSpeeds[0].value, 3.6 * (0.75 + 1) / 0.5));
+
+		// The derivative of a line is exact everywhere.
+		std::vector<SpeedDbl_m_s> exactSpeeds;
+		for(std::size_t i = 0; i < n; i++) {
+			exactSpeeds.push_back(SpeedDbl_m_s(6 * times[i].value + 2));
+		}
+		std::vector<Acceleration_m_s2> accelerations(n);
+		si::gradient(si::quantity_span<const SpeedDbl_m_s>(exactSpeeds), x, si::quantity_span<Acceleration_m_s2>(accelerations));
+		for(std::size_t i = 0; i < n; i++) {
+			assert(near(accelerations[i].value, 6));
+		}
+	}
+
+	// Not vectorized
+	{
+		const Length_m lengths[] = { Length_m(0), Length_m(1), Length_m(4), Length_m(9) };
+		const Time_s instants[] = { Time_s(0), Time_s(1), Time_s(2), Time_s(3) };
+		Speed_m_s speeds[4];
+		si::gradient(si::quantity_span<const Length_m>(lengths), Time_s(1), si::quantity_span<Speed_m_s>(speeds));
+		assert(speeds[0] == Speed_m_s(1)  &&  speeds[1] == Speed_m_s(2)  &&  speeds[2] == Speed_m_s(4)  &&  speeds[3] == Speed_m_s(5));
+		Speed_m_s unevenSpeeds[4];
+		si::gradient(si::quantity_span<const Length_m>(lengths), si::quantity_span<const Time_s>(instants),
+		             si::quantity_span<Speed_m_s>(unevenSpeeds));
+		assert(unevenSpeeds[1] == Speed_m_s(2)  &&  unevenSpeeds[3] == Speed_m_s(5));
+	}
+
+	CANT_COMPILE(si::gradient(si::quantity_span<const LengthDbl_m>(), TimeDbl_s(1), si::quantity_span<LengthDbl_m>()));
+}
+
+
+void test() {
+	integrals();
+	cumulativeIntegrals();
+	gradients();
+}
+
+
+} /* namespace calculus */
+
+
+#endif /* CALCULUS_HPP_ */
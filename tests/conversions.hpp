@@ -0,0 +1,137 @@
+#ifndef CONVERSIONS_HPP_
+#define CONVERSIONS_HPP_
+
+
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace conversions {
+
+
+typedef si::Speed_km_h<double> SpeedDbl_km_h;
+typedef si::SIValue<float, std::milli, si::pack_dimensions(0, 0, 0, 0, 0, 0, 0)> Ratio_milli;
+
+
+// The count of conversions from From to To.
+template <typename From, typename To>
+unsigned long long count() {
+	const si::conversions::type_info from = si::_conversions::info<From>();
+	const si::conversions::type_info to = si::_conversions::info<To>();
+	for(const si::conversions::entry& e : si::conversions::counts()) {
+		if(si::conversions::name(e.from) == si::conversions::name(from)  &&
+		   si::conversions::name(e.to) == si::conversions::name(to)) {
+			return e.count;
+		}
+	}
+	return 0;
+}
+
+
+void names() {
+	assert(si::conversions::name(si::_conversions::info<SpeedDbl_km_h>()) == "km/h (double)");
+	assert(si::conversions::name(si::_conversions::info<Length_cm>()) == "cm (int)");
+	assert(si::conversions::name(si::_conversions::info<Area_cm2>()) == "cm² (long long)");
+	assert(si::conversions::name(si::_conversions::info<decltype(Area_cm2() * Time_h())>()) ==
+	       "m^2·s ×9/25 (long long)");
+	assert(si::conversions::name(si::_conversions::info<Ratio_milli>()) == "1 ×1/1000 (float)");
+}
+
+
+#ifdef SI_TRACK_CONVERSIONS
+struct late_converter {
+	void touch() {}
+
+	~late_converter() {
+		const Time_s time = Time_h(2);
+		(void)time;
+	}
+};
+#endif
+
+
+void counting() {
+	si::conversions::reset();
+	Length_cm total(0);
+	for(int i = 0; i < 1000; i++) {
+		const Length_m step = Length_cm(i);
+		total += step;
+	}
+	total -= Length_km(1);
+	SpeedDbl_m_s speed = Speed_m_s(3);
+	speed += SpeedDbl_km_h(36);
+
+	// Same types: nothing to count.
+	total += Length_cm(1);
+	const Length_cm copy = total;
+	(void)copy;
+
+#ifdef SI_TRACK_CONVERSIONS
+	// A thread that finishes keeps its counts, and threads count apart.
+	std::vector<std::thread> threads;
+	for(int t = 0; t < 4; t++) {
+		threads.push_back(std::thread([]() {
+			for(int i = 0; i < 250; i++) {
+				const Length_m length = Length_cm(i);
+				(void)length;
+			}
+		}));
+	}
+	for(std::thread& thread : threads) {
+		thread.join();
+	}
+
+	assert((count<Length_cm, Length_m>() == 2000));
+	assert((count<Length_m, Length_cm>() == 1000));
+	assert((count<Length_km, Length_cm>() == 1));
+	assert((count<Speed_m_s, SpeedDbl_m_s>() == 1));
+	assert((count<SpeedDbl_km_h, SpeedDbl_m_s>() == 1));
+	assert((count<Length_cm, Length_cm>() == 0));
+
+	const std::vector<si::conversions::entry> entries = si::conversions::counts();
+	assert(entries.size() == 5  &&  entries[0].count == 2000  &&  entries[1].count == 1000);
+
+	std::FILE* const file = std::tmpfile();
+	assert(file);
+	si::conversions::report(file);
+	std::rewind(file);
+	char text[512];
+	const std::size_t size = std::fread(text, 1, sizeof(text), file);
+	std::fclose(file);
+	assert(std::string(text, size).find(
+		"Conversions between SI value types:\n"
+		"        2000  cm (int) -> m (int)\n"
+		"        1000  m (int) -> cm (int)\n") == 0);
+
+	si::conversions::reset();
+	assert(si::conversions::counts().empty());
+
+	// A conversion by a thread_local object destroyed after the shard of its
+	// thread (as it was constructed before) is still counted.
+	std::thread([]() {
+		static thread_local late_converter late;
+		late.touch();
+		const Time_s time = Time_h(1);
+		(void)time;
+	}).join();
+	assert((count<Time_h, Time_s>() == 2));
+
+	si::conversions::reset();
+#else
+	assert(si::conversions::counts().empty());
+#endif
+}
+
+
+void test() {
+	names();
+	counting();
+}
+
+
+} /* namespace conversions */
+
+
+#endif /* CONVERSIONS_HPP_ */
@@ -2,6 +2,9 @@
 #define DIVISIONS_HPP_
 
 
+#include <type_traits>
+
+
 namespace divisions {
 
 
@@ -27,6 +30,20 @@ void scalar() {
 		time_s /= 1.6; // Truncated: int(12s / 1.6) = int(7.5s) = 7s
 		assert(time_s.value == 7);
 	}
+
+	{
+		// Floats stay floats.
+		const si::Time_s<float> time_s(12);
+		static_assert(std::is_same<decltype(time_s / 4.0f), si::Time_s<float>>::value, "");
+		static_assert(std::is_same<decltype(3.0f / time_s), si::Frequency_Hz<float>>::value, "");
+		static_assert(std::is_same<decltype(Time_s() / 2.0f), si::Time_s<float>>::value, "");
+		assert(time_s / 4.0f == si::Time_s<float>(3));
+		assert(3.0f / time_s == si::Frequency_Hz<float>(0.25f));
+
+		si::Time_s<float> time2_s = time_s;
+		time2_s /= 8.0f;
+		assert(time2_s.value == 1.5f);
+	}
 }
 
 
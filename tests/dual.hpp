@@ -0,0 +1,107 @@
+#ifndef DUAL_HPP_
+#define DUAL_HPP_
+
+
+#include <cmath>
+#include <type_traits>
+
+
+namespace dual {
+
+
+typedef si::dual<double, 2> Dual;
+
+
+bool near(double a, double b) {
+	return std::fabs(a - b) <= 1e-12 * std::fmax(1, std::fabs(b));
+}
+
+
+void numbers() {
+	// f(x, y) = x y + x / y - 3, at (2, 4)
+	const Dual x = Dual::variable(2, 0);
+	const Dual y = Dual::variable(4, 1);
+	const Dual f = x * y + x / y - 3.0;
+	assert(near(f.value, 5.5));
+	assert(near(f.d[0], 4 + 1 / 4.0));
+	assert(near(f.d[1], 2 - 2 / 16.0));
+
+	// Constants have no derivatives, and mix with dual numbers on either side.
+	const Dual g = 1.0 / x + 2 * y - Dual(7);
+	assert(near(g.value, 1.5));
+	assert(near(g.d[0], -1 / 4.0)  &&  near(g.d[1], 2));
+
+	// The chain rule through the functions
+	const Dual h = sqrt(x * y) + exp(x) * sin(y) - log(cbrt(y)) + pow(x, 3.0);
+	assert(near(h.d[0], 0.5 * y.value / std::sqrt(8) + std::exp(2) * std::sin(4) + 12));
+	assert(near(h.d[1], 0.5 * x.value / std::sqrt(8) + std::exp(2) * std::cos(4) - 1 / 12.0));
+	const Dual r = hypot(x, y);
+	assert(near(r.d[0], 2 / std::sqrt(20))  &&  near(r.d[1], 4 / std::sqrt(20)));
+	assert(abs(-x).d[0] == 1);
+
+	// Powers at 0
+	const Dual zero = Dual::variable(0, 0);
+	assert(pow(zero, 0.5).value == 0  &&  std::isinf(pow(zero, 0.5).d[0]));
+	assert(pow(zero, 0.0).value == 1  &&  pow(zero, 0.0).d[0] == 0);
+	assert(pow(zero, 2.0).value == 0  &&  pow(zero, 2.0).d[0] == 0);
+
+	// Comparisons compare the values only.
+	assert(x < y  &&  x == Dual(2)  &&  x == Dual::variable(2, 1));
+
+	const si::dual<float, 2> narrow(x);
+	assert(narrow.value == 2  &&  narrow.d[0] == 1  &&  narrow.d[1] == 0);
+}
+
+
+void values() {
+	typedef si::Mass_kg<double>    Mass_kg;
+	typedef si::Speed_m_s<double>  Speed_m_s;
+	typedef si::Energy_J<double>   Energy_J;
+	typedef si::Momentum_Ns<double> Momentum_Ns;
+
+	// The kinetic energy, and its derivatives by the mass and the speed
+	const auto m = si::variable<2>(Mass_kg(3), 0);
+	const auto v = si::variable<2>(Speed_m_s(4), 1);
+	const auto energy = 0.5 * m * v * v;
+	static_assert(std::is_same<decltype(energy), const si::Energy_J<Dual>>::value, "");
+	assert(si::primal(energy) == Energy_J(24));
+
+	const auto dE_dm = si::derivative<Mass_kg>(energy, 0);
+	const auto dE_dv = si::derivative<si::Speed_m_s<Dual>>(energy, 1);
+	static_assert(std::is_same<decltype(dE_dm), const decltype(Speed_m_s() * Speed_m_s())>::value, "");
+	static_assert(std::is_same<decltype(dE_dv), const Momentum_Ns>::value, "");
+	assert(dE_dm == Speed_m_s(4) * Speed_m_s(4) / 2.0);
+	assert(dE_dv == Momentum_Ns(12));
+
+	// Square roots and conversions keep the units and the derivatives.
+	const auto speed = std::sqrt(2.0 * energy / m);
+	static_assert(std::is_same<decltype(speed), const si::Speed_m_s<Dual>>::value, "");
+	assert(near(si::primal(speed).value, 4));
+	assert(near(si::derivative<Speed_m_s>(speed, 1).value, 1));
+	assert(near(si::derivative<Mass_kg>(speed, 0).value, 0));
+	const si::Speed_km_h<Dual> speed_km_h = speed;
+	assert(near(si::derivative<Speed_m_s>(speed_km_h, 1).value, 3.6));
+	const si::Speed_m_s<Dual> constant = Speed_m_s(2);
+	assert(constant.value.d[0] == 0  &&  constant.value.d[1] == 0);
+
+	// A derivative taken in another unit is that of the stored values, in the
+	// quotient of the units: 3.6 (km/h)/(m/s) is 1 when simplified.
+	const auto ratio = si::derivative<Speed_m_s>(speed_km_h, 1);
+	assert(near(ratio.value * decltype(ratio)::Ratio::num / decltype(ratio)::Ratio::den, 1));
+
+	CANT_COMPILE(
+		const si::Length_m<Dual> length = energy;
+	);
+}
+
+
+void test() {
+	numbers();
+	values();
+}
+
+
+} /* namespace dual */
+
+
+#endif /* DUAL_HPP_ */
@@ -0,0 +1,110 @@
+#ifndef DURATIONS_HPP_
+#define DURATIONS_HPP_
+
+
+namespace durations {
+
+
+typedef SI_TIME_ms(long long)  Time_ms;
+typedef SI_TIME_min(int)       Time_min;
+
+
+void fromDuration() {
+	{
+		const Time_s time = std::chrono::seconds(7);
+		assert(time.value == 7);
+	}
+
+	{
+		const Time_ms time = std::chrono::seconds(7);
+		assert(time.value == 7000);
+	}
+
+	{
+		const Time_s time = std::chrono::milliseconds(7900);
+		assert(time.value == 7); // Truncated, as by duration_cast
+	}
+
+	{
+		const TimeDbl_s time = std::chrono::milliseconds(7900);
+		assert(time.value == 7.9);
+	}
+
+	{
+		const auto time = si::from_duration(std::chrono::minutes(3));
+		assert(time == Time_min(3));
+		assert(time == Time_s(180));
+	}
+
+	CANT_COMPILE(
+		const Length_m len = std::chrono::seconds(7);
+	);
+}
+
+
+void toDuration() {
+	{
+		const auto d = static_cast<std::chrono::seconds>(Time_h(2));
+		assert(d.count() == 7200);
+	}
+
+	{
+		const auto d = static_cast<std::chrono::minutes>(Time_s(150));
+		assert(d.count() == 2); // Truncated, as by duration_cast
+	}
+
+	{
+		const auto d = si::to_duration(Time_ms(1500));
+		static_assert(std::is_same<decltype(d), const std::chrono::duration<long long, std::milli>>::value, "");
+		assert(d.count() == 1500);
+	}
+
+	CANT_COMPILE(
+		const std::chrono::seconds d = Time_s(1); // Implicit conversion
+	);
+
+	CANT_COMPILE(
+		static_cast<std::chrono::seconds>(Length_m(1));
+	);
+}
+
+
+void operators() {
+	{
+		const Frequency_Hz freq(3);
+		assert((freq * std::chrono::seconds(4)).value == 12); // Dimensionless
+		assert((std::chrono::seconds(4) * freq).value == 12);
+		assert((freq * std::chrono::milliseconds(500)).value == 1500); // Ratio: 1:1000
+	}
+
+	{
+		const Length_m len(12);
+		assert(len / std::chrono::seconds(4) == Speed_m_s(3));
+		assert(12 * Length_m(1) / std::chrono::seconds(4) == Speed_m_s(3));
+	}
+
+	{
+		const Time_s time(12);
+		assert(time / std::chrono::seconds(4) == 3);
+		assert(std::chrono::seconds(12) / Time_s(4) == 3);
+		assert(std::chrono::minutes(1) / Time_s(4) == 15);
+	}
+
+	{
+		const auto freq = 36 / TimeDbl_s(1) / std::chrono::hours(1) * std::chrono::seconds(1);
+		assert(freq == FrequencyDbl_Hz(0.01));
+	}
+}
+
+
+void test() {
+	fromDuration();
+	toDuration();
+	operators();
+}
+
+
+} /* namespace durations */
+
+
+#endif /* DURATIONS_HPP_ */
@@ -0,0 +1,204 @@
+#ifndef FILTERS_HPP_
+#define FILTERS_HPP_
+
+
+#include <chrono>
+#include <cmath>
+
+
+namespace filters {
+
+
+typedef si::Pressure_Pa<double> Pressure_Pa;
+typedef si::batch<double, 8> Batch;
+
+const double pi = 3.141592653589793;
+
+
+bool near(double a, double b, double tolerance) {
+	return std::fabs(a - b) <= tolerance * (1 + std::fabs(b));
+}
+
+
+// The amplitude of the output of a filter for a sine wave of a frequency, in
+// periods of 100 samples, after the transient.
+template <typename Filter>
+double amplitude(Filter filter, double frequency) {
+	const TimeDbl_s period(0.01);
+	double in_phase = 0, quadrature = 0;
+	for(int i = 0; i < 2000; i++) {
+		const double phase = 2 * pi * frequency * i * period.value;
+		const double y = filter(Pressure_Pa(std::sin(phase))).value;
+		if(i >= 1000) {
+			in_phase += y * std::sin(phase);
+			quadrature += y * std::cos(phase);
+		}
+	}
+	return std::sqrt(in_phase * in_phase + quadrature * quadrature) / 500;
+}
+
+
+void exponential() {
+	si::ema<Pressure_Pa> ema(TimeDbl_s(1), si::Time_ms<double>(100));
+	assert(near(ema.alpha(), 1 - std::exp(-0.1), 1e-15));
+	assert(ema.value() == Pressure_Pa(0));
+
+	// The first sample sets the average, and a step is followed to 63% after
+	// the time constant.
+	assert(ema(Pressure_Pa(101325)) == Pressure_Pa(101325));
+	Pressure_Pa y;
+	for(int i = 0; i < 10; i++) {
+		y = ema(Pressure_Pa(101425));
+	}
+	assert(near(y.value, 101325 + 100 * (1 - std::exp(-1.0)), 1e-12));
+	assert(ema.value() == y);
+
+	ema.reset();
+	assert(ema.value() == Pressure_Pa(0));
+	assert(ema(si::Pressure_kPa<double>(2)) == Pressure_Pa(2000));
+
+	const si::ema<Pressure_Pa> durations(std::chrono::seconds(1), std::chrono::milliseconds(100));
+	assert(near(durations.alpha(), ema.alpha(), 1e-15));
+
+	// A time constant of zero follows the input.
+	si::ema<Pressure_Pa> follower(TimeDbl_s(0), TimeDbl_s(1));
+	follower(Pressure_Pa(1));
+	assert(follower(Pressure_Pa(5)) == Pressure_Pa(5));
+
+	CANT_COMPILE(si::ema<Pressure_Pa>(LengthDbl_m(1), TimeDbl_s(1)));
+	CANT_COMPILE(si::ema<Length_m>(TimeDbl_s(1), TimeDbl_s(1)));
+}
+
+
+void movingAverage() {
+	si::moving_average<LengthDbl_m, 4> average;
+	assert(average.mean() == LengthDbl_m(0)  &&  average.size() == 0);
+	assert(average(LengthDbl_m(1)) == LengthDbl_m(1));
+	assert(average(LengthDbl_m(3)) == LengthDbl_m(2));
+	assert(average(LengthDbl_m(5)) == LengthDbl_m(3));
+	assert(!average.full());
+	assert(average(LengthDbl_m(7)) == LengthDbl_m(4));
+	assert(average.full());
+	assert(average(LengthDbl_m(9)) == LengthDbl_m(6)); // The 1 m left the window
+	assert(average(si::Length_km<double>(0.011)) == LengthDbl_m(8)); // Converted
+	assert(average.size() == 4);
+
+	average.reset();
+	assert(average.size() == 0  &&  average.mean() == LengthDbl_m(0));
+	assert(average(LengthDbl_m(2)) == LengthDbl_m(2));
+
+	// A long stream with a large offset: a plain running sum would be off by
+	// about one metre.
+	si::moving_average<LengthDbl_m, 10> offset;
+	double values[10];
+	LengthDbl_m mean;
+	for(int i = 0; i < 1000000; i++) {
+		values[i % 10] = 1e9 + 0.1 * (i % 7);
+		mean = offset(LengthDbl_m(values[i % 10]));
+	}
+	double sum = 0;
+	for(int i = 0; i < 10; i++) {
+		sum += values[i] - 1e9;
+	}
+	assert(std::fabs(mean.value - 1e9 - sum / 10) < 1e-6);
+
+	CANT_COMPILE((si::moving_average<Length_m, 4>()));
+}
+
+
+void biquads() {
+	const TimeDbl_s period(0.01);
+
+	// At a quarter of the sample rate, cos(w) = 0 and sin(w) = 1.
+	const si::biquad_coefficients c = si::biquad_coefficients::low_pass(FrequencyDbl_Hz(25), period);
+	const double a0 = 1 + std::sqrt(0.5);
+	assert(near(c.b0, 0.5 / a0, 1e-15)  &&  near(c.b1, 1 / a0, 1e-15)  &&  near(c.b2, 0.5 / a0, 1e-15));
+	assert(near(c.a1, 0, 1e-15)  &&  near(c.a2, (1 - std::sqrt(0.5)) / a0, 1e-15));
+	assert(near(c.dc_gain(), 1, 1e-15));
+	assert(near(si::biquad_coefficients::high_pass(FrequencyDbl_Hz(25), period).dc_gain(), 0, 1e-15));
+
+	// A constant input gives a constant output from the first sample.
+	si::biquad<Pressure_Pa> low(si::biquad_coefficients::low_pass(Frequency_Hz(1), period));
+	for(int i = 0; i < 100; i++) {
+		assert(near(low(Pressure_Pa(101325)).value, 101325, 1e-12));
+	}
+	si::biquad<Pressure_Pa> high(si::biquad_coefficients::high_pass(FrequencyDbl_Hz(1), si::Time_ms<double>(10)));
+	for(int i = 0; i < 100; i++) {
+		assert(high(Pressure_Pa(101325)) == Pressure_Pa(0));
+	}
+	low.reset();
+	assert(near(low(Pressure_Pa(7)).value, 7, 1e-12));
+
+	si::biquad<Pressure_Pa> identity;
+	assert(identity(Pressure_Pa(3)) == Pressure_Pa(3)  &&  identity(Pressure_Pa(4)) == Pressure_Pa(4));
+
+	// The Butterworth gain is 1 / sqrt(2) at the cutoff, and falls by about
+	// 24 dB per octave for the fourth order.
+	typedef si::biquad_cascade<Pressure_Pa, 2> Cascade;
+	const Cascade low_pass = Cascade::butterworth_low_pass(FrequencyDbl_Hz(2), period);
+	assert(near(low_pass.stage(0).coefficients().a2, si::biquad_coefficients::low_pass(FrequencyDbl_Hz(2), period,
+	            1 / (2 * std::cos(pi / 8))).a2, 1e-15));
+	assert(near(amplitude(low_pass, 2), std::sqrt(0.5), 1e-9));
+	assert(near(amplitude(low_pass, 0.2), 1, 1e-3));
+	assert(amplitude(low_pass, 20) < 1e-4);
+	assert(near(amplitude(si::biquad<Pressure_Pa>(si::biquad_coefficients::low_pass(FrequencyDbl_Hz(2), period)), 2),
+	            std::sqrt(0.5), 1e-9));
+
+	const Cascade high_pass = Cascade::butterworth_high_pass(FrequencyDbl_Hz(2), period);
+	assert(near(amplitude(high_pass, 2), std::sqrt(0.5), 1e-9));
+	assert(near(amplitude(high_pass, 20), 1, 1e-3));
+	assert(amplitude(high_pass, 0.2) < 1e-3);
+
+	CANT_COMPILE(si::biquad_coefficients::low_pass(TimeDbl_s(1), period));
+	CANT_COMPILE(si::biquad_coefficients::low_pass(FrequencyDbl_Hz(1), FrequencyDbl_Hz(100)));
+}
+
+
+void channels() {
+	typedef si::ElectricCurrent_A<Batch> Currents_A;
+	typedef si::ElectricCurrent_A<double> Current_A;
+
+	si::ema<Currents_A> ema(TimeDbl_s(0.5), TimeDbl_s(0.01));
+	si::moving_average<Currents_A, 16> average;
+	si::biquad_cascade<Currents_A, 2> cascade =
+		si::biquad_cascade<Currents_A, 2>::butterworth_low_pass(FrequencyDbl_Hz(5), TimeDbl_s(0.01));
+
+	const si::ema<Current_A> single(TimeDbl_s(0.5), TimeDbl_s(0.01));
+	const si::biquad_cascade<Current_A, 2> low_pass =
+		si::biquad_cascade<Current_A, 2>::butterworth_low_pass(FrequencyDbl_Hz(5), TimeDbl_s(0.01));
+	si::ema<Current_A> emas[8] = { single, single, single, single, single, single, single, single };
+	si::moving_average<Current_A, 16> averages[8];
+	si::biquad_cascade<Current_A, 2> cascades[8] = {
+		low_pass, low_pass, low_pass, low_pass, low_pass, low_pass, low_pass, low_pass
+	};
+
+	// Each lane is filtered as a single channel would be.
+	for(int i = 0; i < 200; i++) {
+		Batch x;
+		for(std::size_t l = 0; l < 8; l++) {
+			x[l] = (l + 1) * std::sin(0.1 * i + l) + 10 * l;
+		}
+		const Currents_A e = ema(Currents_A(x));
+		const Currents_A a = average(Currents_A(x));
+		const Currents_A b = cascade(Currents_A(x));
+		for(std::size_t l = 0; l < 8; l++) {
+			assert(e.value[l] == emas[l](Current_A(x[l])).value);
+			assert(a.value[l] == averages[l](Current_A(x[l])).value);
+			assert(b.value[l] == cascades[l](Current_A(x[l])).value);
+		}
+	}
+}
+
+
+void test() {
+	exponential();
+	movingAverage();
+	biquads();
+	channels();
+}
+
+
+} /* namespace filters */
+
+
+#endif /* FILTERS_HPP_ */
@@ -0,0 +1,142 @@
+#ifndef HASHING_HPP_
+#define HASHING_HPP_
+
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+
+
+namespace hashing {
+
+
+template <typename SIValueType>
+std::size_t hashOf(const SIValueType& v) {
+	return std::hash<SIValueType>()(v);
+}
+
+
+void stdHash() {
+	// Equal values in different ratios and underlying types
+	assert(hashOf(Length_km(1)) == hashOf(Length_m(1000)));
+	assert(hashOf(Length_km(1)) == hashOf(LengthDbl_m(1000)));
+	assert(hashOf(Length_km(1)) == hashOf(LengthDbl_km(1)));
+	assert(hashOf(Length_km(-3)) == hashOf(Length_cm(-300000)));
+	assert(hashOf(Length_cm(150)) == hashOf(LengthDbl_m(1.5)));
+	assert(hashOf(Length_cm(1)) == hashOf(LengthDbl_m(0.01)));
+	assert(hashOf(Time_h(1)) == hashOf(TimeDbl_s(3600)));
+	assert(hashOf(LengthDbl_m(0.0)) == hashOf(LengthDbl_m(-0.0)));
+	assert(hashOf(LengthDbl_m(0.0)) == hashOf(Length_m(0)));
+
+	// Too large to be normalized in intmax_t
+	const long long highest = std::numeric_limits<long long>::max();
+	assert(hashOf(si::Length_km<long long>(highest)) == hashOf(si::Length_km<double>(double(highest))));
+	assert(hashOf(si::Length_km<long long>(-highest)) != hashOf(si::Length_km<long long>(highest)));
+	assert(hashOf(si::Speed_km_h<long long>(highest)) == hashOf(si::Speed_km_h<double>(double(highest))));
+
+	assert(hashOf(Length_m(1)) != hashOf(Length_m(2)));
+	assert(hashOf(Length_km(1)) != hashOf(Length_m(1)));
+	assert(hashOf(LengthDbl_m(1.5)) != hashOf(LengthDbl_m(2.5)));
+
+	std::unordered_set<Length_m> lengths;
+	lengths.insert(Length_m(5));
+	lengths.insert(Length_m(5));
+	lengths.insert(Length_m(7));
+	assert(lengths.size() == 2);
+}
+
+
+typedef si::quantity_map<Frequency_Hz, int> Map;
+
+
+void map() {
+	Map map;
+	assert(map.empty());
+	assert(map.find(Frequency_Hz(1)) == nullptr);
+	assert(!map.erase(Frequency_Hz(1)));
+
+	assert(map.insert(Frequency_Hz(50), 1));
+	assert(!map.insert(Frequency_Hz(50), 2));
+	assert(*map.find(Frequency_Hz(50)) == 1);
+	map[Frequency_Hz(60)] += 5;
+	map[Frequency_Hz(60)] += 5;
+	assert(map[Frequency_Hz(60)] == 10);
+	assert(map.size() == 2);
+	assert(map.contains(Frequency_Hz(60)));
+
+	assert(map.erase(Frequency_Hz(50)));
+	assert(!map.contains(Frequency_Hz(50)));
+	assert(map.size() == 1);
+
+	int sum = 0;
+	map.for_each([&](const Frequency_Hz& key, int value) {
+		sum += key.value + value;
+	});
+	assert(sum == 70);
+
+	map.clear();
+	assert(map.empty());
+	assert(!map.contains(Frequency_Hz(60)));
+
+	si::quantity_map<LengthDbl_m, int> doubles;
+	doubles[LengthDbl_m(0.0)] = 1;
+	assert(doubles.contains(LengthDbl_m(-0.0)));
+	assert(doubles.contains(Length_km(0))); // Converted
+}
+
+
+// Random insertions and erasures, checked against std::unordered_map. The keys
+// are from a small range so the probe sequences collide and the erasures shift
+// many entries.
+void mapRandom() {
+	Map map;
+	std::unordered_map<int, int> reference;
+	std::uint64_t state = 1;
+	for(int step = 0; step < 20000; step++) {
+		state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		const int key = int((state >> 33) % 500);
+		switch((state >> 20) % 3) {
+		case 0:
+			assert(map.insert(Frequency_Hz(key), step) == reference.insert(std::make_pair(key, step)).second);
+			break;
+		case 1:
+			assert(map.erase(Frequency_Hz(key)) == (reference.erase(key) == 1));
+			break;
+		default:
+			map[Frequency_Hz(key)] += 1;
+			reference[key] += 1;
+			break;
+		}
+		assert(map.size() == reference.size());
+	}
+
+	for(int key = 0; key < 500; key++) {
+		const int* value = map.find(Frequency_Hz(key));
+		const auto it = reference.find(key);
+		assert((value == nullptr) == (it == reference.end()));
+		assert(value == nullptr  ||  *value == it->second);
+	}
+
+	Map reserved(1000);
+	for(int key = 0; key < 1000; key++) {
+		reserved.insert(Frequency_Hz(key * 1024), key);
+	}
+	for(int key = 0; key < 1000; key++) {
+		assert(*reserved.find(Frequency_Hz(key * 1024)) == key);
+	}
+}
+
+
+void test() {
+	stdHash();
+	map();
+	mapRandom();
+}
+
+
+} /* namespace hashing */
+
+
+#endif /* HASHING_HPP_ */
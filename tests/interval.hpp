@@ -0,0 +1,102 @@
+#ifndef INTERVAL_HPP_
+#define INTERVAL_HPP_
+
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+
+namespace interval {
+
+
+typedef si::interval<double> Interval;
+
+
+void bounds() {
+	// Exact results keep their bounds.
+	assert(Interval(1, 2) + Interval(3, 4) == Interval(4, 6));
+	assert(Interval(1, 2) - Interval(3, 4) == Interval(-3, -1));
+	assert(Interval(-1, 2) * Interval(3, 4) == Interval(-4, 8));
+	assert(Interval(-2, -1) * Interval(-3, 4) == Interval(-8, 6));
+	assert(Interval(1, 2) / Interval(4, 8) == Interval(0.125, 0.5));
+	assert(sqrt(Interval(4, 9)) == Interval(2, 3));
+	assert(abs(Interval(-3, 2)) == Interval(0, 3));
+	assert(2.0 * Interval(1, 2) + 1.0 == Interval(3, 5));
+
+	// Inexact results are rounded outward by one unit in the last place.
+	const Interval tenth = Interval(1) / Interval(10);
+	assert(tenth.lo < 0.1  ||  tenth.hi > 0.1);
+	assert(tenth.contains(0.1)  &&  std::nextafter(tenth.lo, 1.0) == tenth.hi);
+	Interval sum;
+	for(int i = 0; i < 10; i++) {
+		sum += tenth;
+	}
+	assert(sum.contains(1)  &&  sum.lo < 1  &&  sum.hi > 1);
+	const Interval third = Interval(1) / 3.0;
+	assert(third.lo * 3 <= 1  &&  third.hi * 3 >= 1  &&  third.lo < third.hi);
+	const Interval root = sqrt(Interval(2));
+	assert(root.lo * root.lo < 2  &&  root.hi * root.hi > 2);
+
+	// Narrowing to float rounds outward too.
+	const si::interval<float> narrow = tenth;
+	assert(double(narrow.lo) < 0.1  &&  double(narrow.hi) > 0.1);
+	assert(si::interval<float>(Interval(0.5, 2)) == si::interval<float>(0.5f, 2.0f));
+
+	// Division by an interval that contains 0
+	const Interval whole = Interval(1) / Interval(-1, 1);
+	assert(whole.lo == -std::numeric_limits<double>::infinity()  &&  whole.hi == std::numeric_limits<double>::infinity());
+
+	// Overflows and underflows still contain the exact result.
+	const double highest = std::numeric_limits<double>::max();
+	const double infinity = std::numeric_limits<double>::infinity();
+	const double tiniest = std::numeric_limits<double>::denorm_min();
+	assert(Interval(highest) + Interval(highest) == Interval(highest, infinity));
+	assert(Interval(-highest) - Interval(highest) == Interval(-infinity, -highest));
+	assert(Interval(highest) * Interval(2) == Interval(highest, infinity));
+	assert(Interval(1e-200) * Interval(1e-200) == Interval(0, tiniest));
+	assert(Interval(-1e-200) * Interval(1e-200) == Interval(-tiniest, 0));
+	assert(Interval(3 * tiniest) * Interval(0.5) == Interval(tiniest, 3 * tiniest));  // 1.5 rounded to 2
+	assert(Interval(1e-200) / Interval(1e200) == Interval(0, tiniest));
+	assert(Interval(1e300) / Interval(1e-300) == Interval(highest, infinity));
+
+	// Infinite bounds are exact.
+	assert(Interval(infinity) + Interval(1) == Interval(infinity));
+	assert(Interval(-infinity) * Interval(2) == Interval(-infinity));
+	assert(Interval(infinity) / Interval(2) == Interval(infinity));
+	assert((Interval(1, infinity) + Interval(1)).lo == 2);
+
+	assert(Interval::around(10, 0.5) == Interval(9.5, 10.5));
+	assert(Interval(1, 3).midpoint() == 2  &&  Interval(1, 3).width() == 2);
+}
+
+
+void values() {
+	typedef si::Voltage_V<Interval>  Voltage_V;
+	typedef si::ElectricCurrent_mA<Interval> Current_mA;
+
+	// A voltage from a current in milliamperes through a resistance, with the
+	// tolerances of both.
+	const Current_mA current(Interval::around(20, 0.1));
+	const si::ElectricResistance_ohm<Interval> resistance(Interval::around(250, 2.5));
+	const Voltage_V voltage = current * resistance;
+	assert(voltage.value.contains(5)  &&  voltage.value.lo >= 4.9  &&  voltage.value.hi <= 5.1);
+	assert(voltage.value.lo < 19.9 * 247.5 / 1000  &&  voltage.value.hi > 20.1 * 252.5 / 1000);
+
+	// The roots keep the units.
+	const auto side = std::sqrt(si::Area_m2<Interval>(Interval(4, 9)));
+	static_assert(std::is_same<decltype(side), const si::Length_m<Interval>>::value, "");
+	assert(side == si::Length_m<Interval>(Interval(2, 3)));
+}
+
+
+void test() {
+	bounds();
+	values();
+}
+
+
+} /* namespace interval */
+
+
+#endif /* INTERVAL_HPP_ */
@@ -0,0 +1,259 @@
+#ifndef JSON_HPP_
+#define JSON_HPP_
+
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+
+namespace json {
+
+
+typedef si::Speed_km_h<double> SpeedDbl_km_h;
+typedef si::Length_um<double> LengthDbl_um;
+
+
+struct string_sink {
+	std::string text;
+
+	void write(const char* data, std::size_t size) {
+		text.append(data, size);
+	}
+};
+
+
+// Reads the document a byte at a time, so every token is split between reads.
+struct byte_source {
+	const char* data;
+	std::size_t size;
+
+	std::size_t read(char* buffer, std::size_t) {
+		if(size == 0) {
+			return 0;
+		}
+		*buffer = *data++;
+		size--;
+		return 1;
+	}
+};
+
+
+// Records the elements as a string, and the quantities as SI values.
+struct recorder : si::json::handler {
+	std::string events;
+	std::vector<SpeedDbl_m_s> speeds;
+	std::vector<LengthDbl_m> lengths;
+	std::vector<Length_m> intLengths;
+
+	void start_object() { events += '{'; }
+	void end_object() { events += '}'; }
+	void start_array() { events += '['; }
+	void end_array() { events += ']'; }
+	void key(const char* text, std::size_t length) { events += "k:" + std::string(text, length) + ' '; }
+	void string(const char* text, std::size_t length) { events += "s:" + std::string(text, length) + ' '; }
+	void boolean(bool value) { events += value ? "true " : "false "; }
+	void null() { events += "null "; }
+
+	void number(double value) {
+		char text[32];
+		std::snprintf(text, sizeof(text), "n:%.17g ", value);
+		events += text;
+	}
+
+	void quantity(const si::json::quantity& q) {
+		events += "q:" + std::string(q.symbol) + ' ';
+		SpeedDbl_m_s speed;
+		LengthDbl_m length;
+		Length_m intLength;
+		if(q.get(speed)) {
+			speeds.push_back(speed);
+		}
+		if(q.get(length)  &&  q.get(intLength)) {
+			lengths.push_back(length);
+			intLengths.push_back(intLength);
+		}
+	}
+};
+
+
+recorder parse(const std::string& text, bool expected = true) {
+	recorder r;
+	const bool valid = si::json::parse(text.data(), text.size(), r);
+	assert(valid == expected);
+	(void)valid;
+
+	// Same result when every token is split between reads.
+	recorder bytes;
+	byte_source source = { text.data(), text.size() };
+	assert(si::json::parse(source, bytes) == expected);
+	assert(bytes.events == r.events);
+	return r;
+}
+
+
+void write() {
+	string_sink sink;
+	{
+		si::json::writer<string_sink> writer(sink);
+		writer.start_object();
+		writer.key("speed");
+		writer.quantity(SpeedDbl_km_h(12.5));
+		writer.key("lengths");
+		writer.start_array();
+		writer.quantity(Length_km(3));
+		writer.quantity(LengthDbl_um(0.1));
+		writer.quantity(Acceleration_m_s2(-10));
+		writer.start_array();
+		writer.end_array();
+		writer.end_array();
+		writer.key("name\"\n");
+		writer.string("a\\b\x01");
+		writer.key("numbers");
+		writer.start_array();
+		writer.number(1e300);
+		writer.number(-0.5);
+		writer.number(std::sqrt(2.0));
+		writer.number(100000000000000000LL);
+		writer.number(5);
+		writer.number(-3L);
+		writer.number(std::size_t(7));
+		writer.number(18446744073709551615ULL);
+		writer.number(std::nan(""));
+		writer.boolean(true);
+		writer.null();
+		writer.end_array();
+		writer.end_object();
+	}
+	assert(sink.text ==
+		"{\"speed\":{\"value\":12.5,\"unit\":\"km/h\"},"
+		"\"lengths\":[{\"value\":3,\"unit\":\"km\"},{\"value\":0.1,\"unit\":\"μm\"},"
+		"{\"value\":-10,\"unit\":\"m/s²\"},[]],"
+		"\"name\\\"\\u000a\":\"a\\\\b\\u0001\","
+		"\"numbers\":[1e+300,-0.5,1.4142135623730951,100000000000000000,5,-3,7,18446744073709551615,null,true,null]}");
+
+	// What is written reads back as the same values.
+	const recorder r = parse(sink.text);
+	assert(r.events ==
+		"{k:speed q:km/h k:lengths [q:km q:μm q:m/s² []]k:name\"\n s:a\\b\x01 "
+		"k:numbers [n:1.0000000000000001e+300 n:-0.5 n:1.4142135623730951 n:1e+17 n:5 n:-3 n:7 n:1.8446744073709552e+19 null true null ]}");
+	assert(r.speeds.size() == 1  &&  std::fabs(r.speeds[0].value - 12.5 / 3.6) < 1e-15);
+	assert(r.lengths.size() == 2  &&  r.lengths[0].value == 3000  &&  std::fabs(r.lengths[1].value - 1e-7) < 1e-22);
+	assert(r.intLengths[0] == Length_m(3000));
+
+	// A unit without a symbol
+	CANT_COMPILE(si::json::writer<string_sink>(sink).quantity(Length_m(1) * Time_s(1)));
+}
+
+
+void writeLimits() {
+	string_sink sink;
+	{
+		si::json::writer<string_sink> writer(sink);
+		writer.start_array();
+		writer.number(-0.0);
+		writer.quantity(LengthDbl_m(-0.0));
+		writer.end_array();
+	}
+	assert(sink.text == "[-0,{\"value\":-0,\"unit\":\"m\"}]");
+	const recorder r = parse(sink.text);
+	assert(r.lengths.size() == 1  &&  std::signbit(r.lengths[0].value));
+
+	// As deep as the reader accepts, and no deeper
+	sink.text.clear();
+	{
+		si::json::writer<string_sink> writer(sink);
+		for(int i = 0; i < 256; i++) {
+			assert(writer.start_array());
+		}
+		assert(!writer.start_array());
+		assert(!writer.start_object());
+		for(int i = 0; i < 256; i++) {
+			writer.end_array();
+		}
+	}
+	assert(sink.text == std::string(256, '[') + std::string(256, ']'));
+	parse(sink.text);
+}
+
+
+void read() {
+	// Spellings of the units, order and spacing of the members
+	recorder r = parse(" [ {\"unit\" : \"m/s^2\", \"value\": 2}, {\"value\":36,\"unit\":\"km/h\"},"
+	                   "{\"value\":-1.5e3,\"unit\":\"um\"}, {\"value\":5e-1,\"unit\":\"km\"}\n]\n");
+	assert(r.events == "[q:m/s² q:km/h q:μm q:km ]");
+	assert(r.speeds.size() == 1  &&  std::fabs(r.speeds[0].value - 10) < 1e-12);
+	assert(r.lengths.size() == 2);
+	assert(r.lengths[0].value == -1.5e-3  &&  r.lengths[1].value == 500);
+	assert(r.intLengths[0] == Length_m(0)  &&  r.intLengths[1] == Length_m(500));
+
+	// Objects that aren't quantities
+	r = parse("[{\"value\":1,\"unit\":\"parsec\"},{\"value\":1},{\"value\":1,\"unit\":\"m\",\"x\":0},"
+	          "{\"value\":\"1\",\"unit\":\"m\"},{\"value\":1,\"value\":2,\"unit\":\"m\"},{}]");
+	assert(r.events ==
+		"[{k:value n:1 k:unit s:parsec }{k:value n:1 }{k:value n:1 k:unit s:m k:x n:0 }"
+		"{k:value s:1 k:unit s:m }{k:value n:1 k:value n:2 k:unit s:m }{}]");
+	assert(r.lengths.empty());
+
+	// Escapes
+	r = parse("[\"\\u00e9\\ud83d\\ude00\\/\\t\", {\"value\": 1, \"unit\": \"\\u03bcm\"}]");
+	assert(r.events == "[s:\xC3\xA9\xF0\x9F\x98\x80/\t q:μm ]");
+
+	// Numbers
+	r = parse("[0, -0, 0.1, 1e-7, 123456789012345678901234, 1.7976931348623157e308, 4.9e-324, 0.000001e6]");
+	assert(r.events ==
+		"[n:0 n:-0 n:0.10000000000000001 n:9.9999999999999995e-08 n:1.2345678901234569e+23 "
+		"n:1.7976931348623157e+308 n:4.9406564584124654e-324 n:1 ]");
+
+	// Invalid documents
+	const char* const invalid[] = {
+		"", "[", "[1,]", "{\"a\"}", "{\"a\":1,}", "[01]", "[1.]", "[.5]", "[1e]", "-", "tru", "nul",
+		"\"a", "\"\\x\"", "\"\\u12\"", "\"\x01\"", "[1] 2", "{1:2}", "{\"value\":1,\"unit\":\"m\"",
+	};
+	for(const char* text : invalid) {
+		parse(text, false);
+	}
+	std::string deep(1000, '[');
+	parse(deep + std::string(1000, ']'), false);
+}
+
+
+void files() {
+	std::FILE* const file = std::tmpfile();
+	assert(file);
+	{
+		si::json::file_sink sink(file);
+		si::json::writer<si::json::file_sink> writer(sink);
+		writer.start_array();
+		for(int i = 0; i < 100000; i++) {
+			writer.quantity(Length_km(i));
+		}
+		writer.end_array();
+	}
+	std::rewind(file);
+
+	recorder r;
+	si::json::file_source source(file);
+	assert(si::json::parse(source, r));
+	assert(r.intLengths.size() == 100000);
+	for(int i = 0; i < 100000; i++) {
+		assert(r.intLengths[i] == Length_m(i * 1000));
+	}
+	std::fclose(file);
+}
+
+
+void test() {
+	write();
+	writeLimits();
+	read();
+	files();
+}
+
+
+} /* namespace json */
+
+
+#endif /* JSON_HPP_ */
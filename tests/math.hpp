@@ -40,6 +40,20 @@ void testSqrt() {
 		assert(side == Length_km(7));
 	}
 
+	{
+		// The ratio is kept when its square root is exact
+		static_assert(is_same<decltype(sqrt(Area_km2())), LengthDbl_km>::value, "");
+		static_assert(is_same<decltype(sqrt(Area_cm2())), si::Length_cm<double>>::value, "");
+	}
+
+	{
+		// Otherwise the value is scaled to ratio 1
+		typedef si::Area_m2<int>::apply_ratio<std::kilo>::type Area_1000m2;
+		const auto side = sqrt(Area_1000m2(4));
+		static_assert(is_same<decltype(side), const LengthDbl_m>::value, "");
+		assert(std::fabs(side.value - std::sqrt(4000.0)) < 1e-9);
+	}
+
 	CANT_COMPILE(
 		sqrt(Length_m());
 	);
@@ -50,10 +64,83 @@ void testSqrt() {
 }
 
 
+void testPow() {
+	{
+		const auto volume = si::pow<3>(Length_km(2));
+		static_assert(is_same<decltype(volume), const si::multiplication<Area_km2, Length_km>::type>::value, "");
+		assert(volume.value == 8);
+		assert(volume == si::Volume_m3<long long>(8000000000LL));
+	}
+
+	{
+		assert(si::square(Length_m(5)) == Area_m2(25));
+		assert(si::cube(Length_m(-2)) == Volume_m3(-8));
+		assert(si::pow<1>(Length_m(5)) == Length_m(5));
+		assert(si::pow<0>(Length_m(5)).value == 1);
+	}
+
+	{
+		const auto frequency = si::pow<-1>(Time_s(4));
+		static_assert(is_same<decltype(frequency), const FrequencyDbl_Hz>::value, "");
+		assert(frequency.value == 0.25);
+	}
+
+	{
+		const auto side = si::pow<2, 4>(Area_km2(49));
+		static_assert(is_same<decltype(side), const LengthDbl_km>::value, "");
+		assert(side.value == 7.0);
+	}
+
+	{
+		const auto power = si::pow<3, 2>(Area_m2(4));
+		static_assert(is_same<decltype(power), const si::Volume_m3<double>>::value, "");
+		assert(power.value == 8.0);
+	}
+
+	CANT_COMPILE(
+		(si::pow<1, 2>(Length_m()));
+	);
+}
+
+
+void testCbrt() {
+	{
+		const auto side = cbrt(Volume_m3(27));
+		static_assert(is_same<decltype(side), const LengthDbl_m>::value, "");
+		assert(std::fabs(side.value - 3.0) < 1e-12);
+	}
+
+	CANT_COMPILE(
+		cbrt(Area_m2());
+	);
+}
+
+
+void testHypot() {
+	{
+		const auto diagonal = hypot(Length_m(3), Length_m(4));
+		static_assert(is_same<decltype(diagonal), const LengthDbl_m>::value, "");
+		assert(diagonal.value == 5.0);
+	}
+
+	{
+		const auto diagonal = hypot(Length_m(3), Length_cm(400));
+		assert(diagonal == LengthDbl_m(5));
+	}
+
+	CANT_COMPILE(
+		hypot(Length_m(), Time_s());
+	);
+}
+
+
 void test() {
 	signal();
 	siAbs();
 	testSqrt();
+	testPow();
+	testCbrt();
+	testHypot();
 }
 
 
@@ -0,0 +1,135 @@
+#ifndef MATRIX_HPP_
+#define MATRIX_HPP_
+
+
+namespace matrix {
+
+
+typedef si::dimensions_lists_of<LengthDbl_m, SpeedDbl_m_s>::type StateUnits;
+typedef si::matrix<StateUnits, StateUnits>                      Transition;
+typedef si::column_vector<StateUnits>::type                     State;
+
+
+void elements() {
+	Transition a;
+	a(0, 0) = 1.0;
+	a.set<0, 1>(Time_h(1)); // Converted to base units
+	a(1, 1) = 1.0;
+
+	assert((a.get<0, 1>() == TimeDbl_s(3600)));
+	assert(a(0, 1) == 3600.0);
+
+	State x;
+	x.set<0, 0>(Length_cm(250)); // Converted to base units
+	x.set<1, 0>(SpeedDbl_m_s(3));
+	assert((x.get<0, 0>() == LengthDbl_m(2.5)));
+	assert(x(1, 0) == 3.0);
+
+	CANT_COMPILE(
+		(x.set<0, 0>(TimeDbl_s(1)));
+	);
+
+	CANT_COMPILE(
+		(x.get<2, 0>());
+	);
+}
+
+
+void multiplication() {
+	// x' = A * x, with x = (position, velocity) and a time step of 2s
+	Transition a;
+	a(0, 0) = 1.0;
+	a(0, 1) = 2.0;
+	a(1, 1) = 1.0;
+
+	State x;
+	x.set<0, 0>(LengthDbl_m(10));
+	x.set<1, 0>(SpeedDbl_m_s(3));
+
+	const State next = a * x;
+	assert((next.get<0, 0>() == LengthDbl_m(16))); // 10m + 2s * 3m/s
+	assert((next.get<1, 0>() == SpeedDbl_m_s(3)));
+
+	const Transition two_steps = a * a;
+	assert((two_steps.get<0, 1>() == TimeDbl_s(4)));
+
+	CANT_COMPILE(
+		x * a;
+	);
+}
+
+
+void solve() {
+	Transition a;
+	a(0, 0) = 1.0;
+	a(0, 1) = 2.0;
+	a(1, 1) = 1.0;
+
+	State b;
+	b.set<0, 0>(LengthDbl_m(16));
+	b.set<1, 0>(SpeedDbl_m_s(3));
+
+	State x;
+	assert(si::solve(a, b, x));
+	assert((x.get<0, 0>() == LengthDbl_m(10)));
+	assert((x.get<1, 0>() == SpeedDbl_m_s(3)));
+
+	Transition singular;
+	assert(!si::solve(singular, b, x));
+}
+
+
+void solveLarge() {
+	// A 40x40 system crosses the block boundary of the kernels.
+	typedef si::dimensions_lists_of<
+		LengthDbl_m, LengthDbl_m, LengthDbl_m, LengthDbl_m, LengthDbl_m, LengthDbl_m, LengthDbl_m, LengthDbl_m,
+		LengthDbl_m, LengthDbl_m, LengthDbl_m, LengthDbl_m, LengthDbl_m, LengthDbl_m, LengthDbl_m, LengthDbl_m,
+		LengthDbl_m, LengthDbl_m, LengthDbl_m, LengthDbl_m, LengthDbl_m, LengthDbl_m, LengthDbl_m, LengthDbl_m,
+		LengthDbl_m, LengthDbl_m, LengthDbl_m, LengthDbl_m, LengthDbl_m, LengthDbl_m, LengthDbl_m, LengthDbl_m,
+		LengthDbl_m, LengthDbl_m, LengthDbl_m, LengthDbl_m, LengthDbl_m, LengthDbl_m, LengthDbl_m, LengthDbl_m
+	>::type Units;
+	typedef si::matrix<Units, Units> Square;
+	typedef si::column_vector<Units>::type Vector;
+
+	Square a;
+	Vector expected;
+	for(std::size_t i = 0; i < Square::rows; i++) {
+		for(std::size_t j = 0; j < Square::cols; j++) {
+			a(i, j) = (i == j) ? 50.0 : double((i * 7 + j * 3) % 11) - 5.0;
+		}
+		expected(i, 0) = double(i) - 20.0;
+	}
+
+	// 40 columns: a full strip of the multiplication kernel and a partial one
+	const Square squared = a * a;
+	for(std::size_t i = 0; i < Square::rows; i++) {
+		for(std::size_t j = 0; j < Square::cols; j++) {
+			double sum = 0;
+			for(std::size_t k = 0; k < Square::cols; k++) {
+				sum += a(i, k) * a(k, j);
+			}
+			assert(std::fabs(squared(i, j) - sum) < 1e-9);
+		}
+	}
+
+	const Vector b = a * expected;
+	Vector x;
+	assert(si::solve(a, b, x));
+	for(std::size_t i = 0; i < Vector::rows; i++) {
+		assert(std::fabs(x(i, 0) - expected(i, 0)) < 1e-9);
+	}
+}
+
+
+void test() {
+	elements();
+	multiplication();
+	solve();
+	solveLarge();
+}
+
+
+} /* namespace matrix */
+
+
+#endif /* MATRIX_HPP_ */
@@ -0,0 +1,285 @@
+#ifndef MOVES_HPP_
+#define MOVES_HPP_
+
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace moves {
+
+
+// A heavyweight underlying type, like std::valarray: a buffer of samples,
+// which counts its allocations.
+struct samples {
+	static int allocations;
+	std::vector<double> values;
+
+	samples() {}
+
+	samples(std::size_t size, double value) : values(size, value) {
+		allocations++;
+	}
+
+	samples(const samples& s) : values(s.values) {
+		allocations++;
+	}
+
+	samples(samples&& s) noexcept : values(std::move(s.values)) {}
+
+	samples& operator=(const samples& s) {
+		values = s.values;
+		allocations++;
+		return *this;
+	}
+
+	samples& operator=(samples&& s) noexcept {
+		values = std::move(s.values);
+		return *this;
+	}
+
+	samples& operator+=(const samples& s) noexcept {
+		for(std::size_t i = 0; i < values.size(); i++) {
+			values[i] += s.values[i];
+		}
+		return *this;
+	}
+
+	samples& operator-=(const samples& s) noexcept {
+		for(std::size_t i = 0; i < values.size(); i++) {
+			values[i] -= s.values[i];
+		}
+		return *this;
+	}
+
+	samples& operator*=(const samples& s) noexcept {
+		for(std::size_t i = 0; i < values.size(); i++) {
+			values[i] *= s.values[i];
+		}
+		return *this;
+	}
+
+	samples& operator/=(const samples& s) noexcept {
+		for(std::size_t i = 0; i < values.size(); i++) {
+			values[i] /= s.values[i];
+		}
+		return *this;
+	}
+
+	samples& operator*=(double d) noexcept {
+		for(double& v : values) {
+			v *= d;
+		}
+		return *this;
+	}
+
+	samples& operator/=(double d) noexcept {
+		for(double& v : values) {
+			v /= d;
+		}
+		return *this;
+	}
+};
+
+int samples::allocations = 0;
+
+samples operator+(const samples& s1, const samples& s2) {
+	samples r(s1);
+	r += s2;
+	return r;
+}
+
+samples operator-(const samples& s1, const samples& s2) {
+	samples r(s1);
+	r -= s2;
+	return r;
+}
+
+samples operator*(const samples& s1, const samples& s2) {
+	samples r(s1);
+	r *= s2;
+	return r;
+}
+
+samples operator/(const samples& s1, const samples& s2) {
+	samples r(s1);
+	r /= s2;
+	return r;
+}
+
+samples operator*(const samples& s, double d) {
+	samples r(s);
+	r *= d;
+	return r;
+}
+
+samples operator*(double d, const samples& s) {
+	samples r(s);
+	r *= d;
+	return r;
+}
+
+samples operator/(const samples& s, double d) {
+	samples r(s);
+	r /= d;
+	return r;
+}
+
+
+typedef si::Length_m<samples> Lengths;
+typedef si::Time_s<samples>   Times;
+typedef si::Speed_m_s<samples> Speeds;
+typedef si::Area_m2<samples>  Areas;
+
+const std::size_t size = 1000;
+
+
+// The number of allocations made by f.
+template <typename F>
+int allocations(F f) {
+	samples::allocations = 0;
+	f();
+	return samples::allocations;
+}
+
+
+void chains() {
+	const Lengths a(samples(size, 1)), b(samples(size, 2)), c(samples(size, 3)), d(samples(size, 4));
+	const Times t(samples(size, 2));
+
+	// Only the first operation of a chain allocates: the next ones reuse its
+	// result. Copying the operands at each step (as when the operators only
+	// took constant references) made 2 allocations per operation.
+	Lengths sum;
+	assert(allocations([&]() { sum = a + b + c + d; }) == 1);
+	assert(sum.value.values[0] == 10  &&  sum.value.values[size - 1] == 10);
+
+	// Each named intermediate result is a new buffer.
+	assert(allocations([&]() {
+		const Lengths ab = a + b;
+		const Lengths abc = ab + c;
+		sum = abc + d;
+	}) == 3);
+
+	// Temporaries on the right side only receive the result, as the
+	// operations may not commute (see order).
+	assert(allocations([&]() { sum = a + (b + c); }) == 2);
+	assert(allocations([&]() { sum = (a + b) + (c + d); }) == 2);
+
+	Lengths difference;
+	assert(allocations([&]() { difference = (d - a) * 2.0 / 4.0 - b; }) == 1);
+	assert(difference.value.values[0] == -0.5);
+	assert(allocations([&]() { difference = 0.5 * (d - a); }) == 2);
+	assert(difference.value.values[0] == 1.5);
+
+	// Products and quotients with other units
+	Speeds speed;
+	assert(allocations([&]() { speed = (a + b) / t; }) == 1);
+	assert(speed.value.values[0] == 1.5);
+	Areas area;
+	assert(allocations([&]() { area = (a + b) * c; }) == 1);
+	assert(allocations([&]() { area = a * (b + c); }) == 2);
+	assert(allocations([&]() { area = (a + b) * (c + d); }) == 2);
+	assert(area.value.values[0] == 21);
+
+	// Compound assignments never allocate.
+	assert(allocations([&]() {
+		sum += a;
+		sum -= b;
+		sum *= 2.0;
+		sum /= 4.0;
+	}) == 0);
+	assert(sum.value.values[0] == 4.5);
+
+	// Moving a value moves its buffer.
+	assert(allocations([&]() {
+		Lengths moved(std::move(sum));
+		sum = std::move(moved);
+		Lengths fromBuffer(samples(size, 0));
+		(void)fromBuffer;
+	}) == 1);
+}
+
+
+// A 2x2 matrix, whose product doesn't commute.
+struct matrix2 {
+	int a, b, c, d;
+
+	matrix2& operator*=(const matrix2& m);
+};
+
+matrix2 operator*(const matrix2& m1, const matrix2& m2) {
+	const matrix2 r = {
+		m1.a * m2.a + m1.b * m2.c, m1.a * m2.b + m1.b * m2.d,
+		m1.c * m2.a + m1.d * m2.c, m1.c * m2.b + m1.d * m2.d
+	};
+	return r;
+}
+
+matrix2& matrix2::operator*=(const matrix2& m) {
+	return *this = *this * m;
+}
+
+bool operator==(const matrix2& m1, const matrix2& m2) {
+	return m1.a == m2.a  &&  m1.b == m2.b  &&  m1.c == m2.c  &&  m1.d == m2.d;
+}
+
+
+// The operators on temporaries keep the order of the operands.
+void order() {
+	const matrix2 m = { 1, 1, 0, 1 };
+	const matrix2 n = { 1, 0, 1, 1 };
+	const matrix2 mn = m * n;
+	const matrix2 nm = n * m;
+	assert(!(mn == nm));
+
+	typedef si::Length_m<matrix2> Lengths;
+	typedef si::Time_s<matrix2> Times;
+	assert((Lengths(m) * Times(n)).value == mn);
+	assert((Lengths(m) * std::move(Times(n))).value == mn);
+	assert((std::move(Lengths(m)) * Times(n)).value == mn);
+	assert((m * Lengths(n)).value == mn);
+	assert((Lengths(m) * n).value == mn);
+
+	typedef si::Length_m<std::string> Words;
+	const Words word(std::string("ab"));
+	assert((word + Words(std::string("cd"))).value == "abcd");
+	assert((Words(std::string("cd")) + word).value == "cdab");
+}
+
+
+void exceptions() {
+	// The operators can throw only if the operations of the underlying type can.
+	static_assert(noexcept(Length_m(1) + Length_m(2)), "");
+	static_assert(noexcept(Length_m(1) - Length_m(2)), "");
+	static_assert(noexcept(Length_m(1) * 2.5), "");
+	static_assert(noexcept(Length_m(1) / Time_s(2)), "");
+	static_assert(noexcept(std::declval<Length_m&>() += Length_m(1)), "");
+	static_assert(std::is_nothrow_move_constructible<Lengths>::value, "");
+	static_assert(std::is_nothrow_move_assignable<Lengths>::value, "");
+	static_assert(noexcept(std::declval<Lengths&>() += std::declval<const Lengths&>()), "");
+	static_assert(noexcept(std::declval<Lengths&>() *= 2.0), "");
+	static_assert(noexcept(std::declval<Lengths>() + std::declval<const Lengths&>()), "");
+	static_assert(noexcept(std::declval<Lengths>() * 2.0), "");
+	static_assert(!noexcept(std::declval<const Lengths&>() + std::declval<const Lengths&>()), "");
+	static_assert(!noexcept(Lengths(std::declval<const samples&>())), "");
+
+	// The SI values of scalars are still trivially copyable.
+	static_assert(std::is_trivially_copyable<Length_m>::value, "");
+}
+
+
+void test() {
+	chains();
+	order();
+	exceptions();
+}
+
+
+} /* namespace moves */
+
+
+#endif /* MOVES_HPP_ */
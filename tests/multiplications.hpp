@@ -2,9 +2,25 @@
 #define MULTIPLICATIONS_HPP_
 
 
+#include <string>
+#include <type_traits>
+
+
 namespace multiplications {
 
 
+typedef si::Length_m<float> LengthFlt_m;
+
+
+// A user type that scales doubles.
+struct gain {
+	double factor;
+};
+
+double operator*(double d, gain g) { return d * g.factor; }
+double operator*(gain g, double d) { return g.factor * d; }
+
+
 void scalar() {
 	{
 		const Length_m len_m(4);
@@ -25,6 +41,35 @@ void scalar() {
 		len_m *= 2.8; // Truncated: int(4m * 2.8) = int(11.2m) = 11m
 		assert(len_m.value == 11);
 	}
+
+	{
+		// The underlying type is the type of the product with the scalar, so floats stay floats.
+		const LengthFlt_m len(1.5f);
+		static_assert(std::is_same<decltype(len * 2.0f), LengthFlt_m>::value, "");
+		static_assert(std::is_same<decltype(2 * len), LengthFlt_m>::value, "");
+		static_assert(std::is_same<decltype(len * 2.0), LengthDbl_m>::value, "");
+		static_assert(std::is_same<decltype(Length_m() * 2LL), si::Length_m<long long>>::value, "");
+		static_assert(std::is_same<decltype(Length_m() * 0.5f), LengthFlt_m>::value, "");
+		assert(len * 2.0f == LengthFlt_m(3));
+		assert(4u * len == LengthFlt_m(6));
+
+		LengthFlt_m len2 = len;
+		len2 *= 4;
+		len2 *= 0.5f;
+		assert(len2.value == 3);
+	}
+
+	{
+		const gain g = { 2.5 };
+		assert(LengthDbl_m(2) * g == LengthDbl_m(5));
+		assert(g * LengthDbl_m(2) == LengthDbl_m(5));
+		LengthDbl_m len(4);
+		len *= 0.5;
+		assert(len.value == 2);
+
+		CANT_COMPILE(Length_m(1) * "2");
+		CANT_COMPILE(Length_m(1) * std::string("2"));
+	}
 }
 
 
@@ -0,0 +1,189 @@
+#ifndef ODE_HPP_
+#define ODE_HPP_
+
+
+#include <cmath>
+#include <tuple>
+#include <vector>
+
+
+namespace ode {
+
+
+typedef si::batch<double, 8> Batch;
+
+
+bool near(double a, double b, double tolerance) {
+	return std::fabs(a - b) <= tolerance * (1 + std::fabs(b));
+}
+
+
+// A mass of 2 kg on a spring of 8 N/m: x = x0 cos(2t)
+struct spring {
+	template <typename T>
+	std::tuple<si::Speed_m_s<T>, si::Acceleration_m_s2<T>>
+	operator()(const TimeDbl_s&, const std::tuple<si::Length_m<T>, si::Speed_m_s<T>>& y) const {
+		const auto stiffness = si::Force_N<double>(8) / si::Length_m<double>(1);
+		const si::Mass_kg<double> mass(2);
+		return std::make_tuple(std::get<1>(y), -(stiffness / mass) * std::get<0>(y));
+	}
+};
+
+
+// A constant speed of 36 km/h, for a state in m
+struct cruise {
+	std::tuple<si::Speed_km_h<double>>
+	operator()(const si::Time_ms<double>&, const std::tuple<LengthDbl_m>&) const {
+		return std::make_tuple(si::Speed_km_h<double>(36));
+	}
+};
+
+
+// A heater moving away from a wall, and cooling to 290 K with a time constant
+// of 50 s: the state has a length, a speed and a temperature.
+struct heater {
+	typedef si::Temperature_K<double> Temperature_K;
+	typedef si::division<Temperature_K, TimeDbl_s>::type Cooling_K_s;
+
+	std::tuple<SpeedDbl_m_s, si::Acceleration_m_s2<double>, Cooling_K_s>
+	operator()(const TimeDbl_s& t, const std::tuple<LengthDbl_m, SpeedDbl_m_s, Temperature_K>& y) const {
+		return std::make_tuple(std::get<1>(y),
+		                       si::Acceleration_m_s2<double>(0.5) * t / TimeDbl_s(1),
+		                       (Temperature_K(290) - std::get<2>(y)) / TimeDbl_s(50));
+	}
+};
+
+
+// dx/dt = x² / (1 m s), which reaches infinity at t = 1 s from x = 1 m
+struct blowup {
+	std::tuple<SpeedDbl_m_s> operator()(const TimeDbl_s&, const std::tuple<LengthDbl_m>& y) const {
+		return std::make_tuple(std::get<0>(y) * std::get<0>(y) / (LengthDbl_m(1) * TimeDbl_s(1)));
+	}
+};
+
+
+// The wrong dimensions for the rate of the speed
+struct wrong {
+	std::tuple<SpeedDbl_m_s, SpeedDbl_m_s> operator()(const TimeDbl_s&, const std::tuple<LengthDbl_m, SpeedDbl_m_s>& y) const {
+		return std::make_tuple(std::get<1>(y), std::get<1>(y));
+	}
+};
+
+
+struct counter {
+	std::vector<double>* times;
+
+	template <typename State>
+	void operator()(const TimeDbl_s& t, const State&) const {
+		times->push_back(t.value);
+	}
+};
+
+
+void rungeKutta() {
+	const double period = 3.141592653589793;
+	const auto y0 = std::make_tuple(LengthDbl_m(1), SpeedDbl_m_s(0));
+
+	std::vector<double> times;
+	const counter observer = { &times };
+	const auto y = si::ode::rk4(spring(), y0, TimeDbl_s(0), TimeDbl_s(period / 4), TimeDbl_s(0.001), observer);
+	assert(near(std::get<0>(y).value, 0, 1e-11));
+	assert(near(std::get<1>(y).value, -2, 1e-11));
+	assert(times.size() == 786  &&  times.back() == period / 4);
+
+	const auto full = si::ode::rk4(spring(), y0, TimeDbl_s(0), TimeDbl_s(period), TimeDbl_s(0.001));
+	assert(near(std::get<0>(full).value, 1, 1e-11));
+	assert(near(std::get<1>(full).value, 0, 1e-11));
+
+	// The rates are converted from their ratio, over times in ms.
+	const auto cruised = si::ode::rk4(cruise(), std::make_tuple(LengthDbl_m(5)),
+	                                  si::Time_ms<double>(0), si::Time_ms<double>(2000), si::Time_ms<double>(300));
+	assert(near(std::get<0>(cruised).value, 25, 1e-15));
+
+	// No step when the end is not after the start
+	assert(std::get<0>(si::ode::rk4(spring(), y0, TimeDbl_s(1), TimeDbl_s(1), TimeDbl_s(0.1))) == LengthDbl_m(1));
+
+	CANT_COMPILE(si::ode::rk4(wrong(), y0, TimeDbl_s(0), TimeDbl_s(1), TimeDbl_s(0.1)));
+}
+
+
+void dormandPrince() {
+	const double period = 3.141592653589793;
+	const auto y0 = std::make_tuple(LengthDbl_m(1), SpeedDbl_m_s(0));
+	const auto absolute = std::make_tuple(LengthDbl_m(1e-12), SpeedDbl_m_s(1e-12));
+
+	std::vector<double> times;
+	const counter observer = { &times };
+	const auto s = si::ode::dormand_prince(spring(), y0, TimeDbl_s(0), TimeDbl_s(period), 1e-10, absolute, observer);
+	assert(s.completed  &&  s.time == TimeDbl_s(period));
+	assert(near(std::get<0>(s.state).value, 1, 1e-8));
+	assert(near(std::get<1>(s.state).value, 0, 1e-8));
+	assert(s.steps == times.size()  &&  s.steps < 1000  &&  times.back() == period);
+	for(std::size_t i = 1; i < times.size(); i++) {
+		assert(times[i - 1] < times[i]);
+	}
+
+	// A looser tolerance takes fewer steps, and is still met.
+	const auto loose = si::ode::dormand_prince(spring(), y0, TimeDbl_s(0), TimeDbl_s(period), 1e-5,
+	                                           std::make_tuple(LengthDbl_m(1e-6), SpeedDbl_m_s(1e-6)));
+	assert(loose.steps < s.steps  &&  near(std::get<0>(loose.state).value, 1, 1e-4));
+
+	// Mixed quantities: x = t³ / 12, v = t² / 4, and T = 290 + 60 exp(-t / 50)
+	const auto h = si::ode::dormand_prince(heater(),
+		std::make_tuple(LengthDbl_m(0), SpeedDbl_m_s(0), si::Temperature_K<double>(350)),
+		TimeDbl_s(0), TimeDbl_s(10), 1e-10,
+		std::make_tuple(LengthDbl_m(1e-9), SpeedDbl_m_s(1e-9), si::Temperature_K<double>(1e-9)));
+	assert(h.completed);
+	assert(near(std::get<0>(h.state).value, 1000.0 / 12, 1e-9));
+	assert(near(std::get<1>(h.state).value, 25, 1e-9));
+	assert(near(std::get<2>(h.state).value, 290 + 60 * std::exp(-0.2), 1e-9));
+
+	// The step becomes too small at the singularity.
+	const auto b = si::ode::dormand_prince(blowup(), std::make_tuple(LengthDbl_m(1)), TimeDbl_s(0), TimeDbl_s(2),
+	                                       1e-6, std::make_tuple(LengthDbl_m(1e-6)));
+	assert(!b.completed  &&  near(b.time.value, 1, 1e-3));
+	assert(std::get<0>(b.state) > LengthDbl_m(1000));
+}
+
+
+void batches() {
+	typedef si::Length_m<Batch> Length_m;
+	typedef si::Speed_m_s<Batch> Speed_m_s;
+
+	Batch x0;
+	for(std::size_t i = 0; i < 8; i++) {
+		x0[i] = i + 1.0;
+	}
+	const auto y0 = std::make_tuple(Length_m(x0), Speed_m_s(Batch(0)));
+
+	// Each lane is computed as a single system would be.
+	const auto y = si::ode::rk4(spring(), y0, TimeDbl_s(0), TimeDbl_s(1), TimeDbl_s(0.01));
+	for(std::size_t i = 0; i < 8; i++) {
+		const auto single = si::ode::rk4(spring(), std::make_tuple(LengthDbl_m(x0[i]), SpeedDbl_m_s(0)),
+		                                 TimeDbl_s(0), TimeDbl_s(1), TimeDbl_s(0.01));
+		assert(std::get<0>(y).value[i] == std::get<0>(single).value);
+		assert(std::get<1>(y).value[i] == std::get<1>(single).value);
+	}
+
+	// The step is chosen for the largest error.
+	const auto s = si::ode::dormand_prince(spring(), y0, TimeDbl_s(0), TimeDbl_s(1), 1e-10,
+	                                       std::make_tuple(Length_m(Batch(1e-12)), Speed_m_s(Batch(1e-12))));
+	assert(s.completed);
+	for(std::size_t i = 0; i < 8; i++) {
+		assert(near(std::get<0>(s.state).value[i], x0[i] * std::cos(2.0), 1e-8));
+		assert(near(std::get<1>(s.state).value[i], -2 * x0[i] * std::sin(2.0), 1e-8));
+	}
+}
+
+
+void test() {
+	rungeKutta();
+	dormandPrince();
+	batches();
+}
+
+
+} /* namespace ode */
+
+
+#endif /* ODE_HPP_ */
@@ -0,0 +1,118 @@
+#ifndef RING_SERIES_HPP_
+#define RING_SERIES_HPP_
+
+
+namespace ring_series {
+
+
+typedef si::ring_series<Length_m, 8> Series;
+
+
+void pushPop() {
+	Series series;
+	assert(series.empty());
+
+	for(int i = 0; i < 8; i++) {
+		assert(series.push(TimeDbl_s(i), Length_m(10 * i)));
+	}
+	assert(!series.push(TimeDbl_s(8), Length_m(80))); // Full
+	assert(series.size() == 8);
+	assert(series.value(2) == Length_m(20));
+	assert(series.time(2) == TimeDbl_s(2));
+
+	TimeDbl_s time;
+	Length_m value;
+	assert(series.pop(time, value));
+	assert(time == TimeDbl_s(0));
+	assert(value == Length_m(0));
+
+	assert(series.push(Time_h(1), Length_km(1))); // Converted
+	assert(series.value(7) == Length_m(1000));
+	assert(series.time(7) == TimeDbl_s(3600));
+
+	series.discard(3);
+	assert(series.size() == 5);
+	assert(series.value(0) == Length_m(40));
+
+	assert(series.discard_before(TimeDbl_s(6)) == 2);
+	assert(series.value(0) == Length_m(60));
+
+	series.discard(100);
+	assert(series.empty());
+	assert(!series.pop(time, value));
+}
+
+
+void downsample() {
+	Series series;
+	const int values[] = { 5, -3, 7, 1, 2, 9, 4 };
+	for(int i = 0; i < 7; i++) {
+		series.push(TimeDbl_s(i), Length_m(values[i]));
+	}
+	series.discard(2);
+	for(int i = 7; i < 10; i++) { // Wraps around the end of the ring
+		series.push(TimeDbl_s(i), Length_m(i));
+	}
+
+	// Samples: 7 1 2 9 4 7 8 9
+	Series::window windows[4];
+	assert(series.downsample(3, windows, 4) == 3);
+
+	assert(windows[0].start == TimeDbl_s(2));
+	assert(windows[0].count == 3);
+	assert(windows[0].min == Length_m(1));
+	assert(windows[0].max == Length_m(7));
+	assert(windows[0].mean == LengthDbl_m(10.0 / 3));
+
+	assert(windows[1].start == TimeDbl_s(5));
+	assert(windows[1].min == Length_m(4));
+	assert(windows[1].max == Length_m(9));
+	assert(windows[1].mean == LengthDbl_m(20.0 / 3));
+
+	assert(windows[2].start == TimeDbl_s(8));
+	assert(windows[2].count == 2);
+	assert(windows[2].min == Length_m(8));
+	assert(windows[2].max == Length_m(9));
+
+	assert(series.downsample(3, windows, 1) == 1);
+	assert(series.size() == 8);
+}
+
+
+void concurrent() {
+	static si::ring_series<LengthDbl_m, 64> series;
+	const int samples = 100000;
+
+	std::thread producer([&]() {
+		for(int i = 0; i < samples; i++) {
+			while(!series.push(TimeDbl_s(i), LengthDbl_m(i))) {
+				std::this_thread::yield();
+			}
+		}
+	});
+
+	TimeDbl_s time;
+	LengthDbl_m value;
+	for(int i = 0; i < samples; i++) {
+		while(!series.pop(time, value)) {
+			std::this_thread::yield();
+		}
+		assert(time == TimeDbl_s(i));
+		assert(value == LengthDbl_m(i));
+	}
+	producer.join();
+	assert(series.empty());
+}
+
+
+void test() {
+	pushPop();
+	downsample();
+	concurrent();
+}
+
+
+} /* namespace ring_series */
+
+
+#endif /* RING_SERIES_HPP_ */
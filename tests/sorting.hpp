@@ -0,0 +1,152 @@
+#ifndef SORTING_HPP_
+#define SORTING_HPP_
+
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+
+namespace sorting {
+
+
+// Pseudo-random values in [-range, range).
+std::vector<int> randomInts(std::size_t n, int range) {
+	std::vector<int> values;
+	unsigned state = 12345;
+	for(std::size_t i = 0; i < n; i++) {
+		state = state * 1103515245 + 12345;
+		values.push_back(int((state >> 8) % (2 * range)) - range);
+	}
+	return values;
+}
+
+
+void sortInts() {
+	const std::size_t sizes[] = { 0, 1, 2, 100, 5000 };
+	const int ranges[] = { 1, 200, 1 << 20 };
+	for(std::size_t size : sizes) {
+		for(int range : ranges) {
+			const std::vector<int> raw = randomInts(size, range);
+			std::vector<int> expected(raw);
+			std::sort(expected.begin(), expected.end());
+
+			std::vector<Length_m> lengths;
+			for(int v : raw) {
+				lengths.push_back(Length_m(v));
+			}
+			std::vector<Length_m> sorted(lengths);
+			si::sort(si::quantity_span<Length_m>(sorted));
+			std::vector<Length_m> radixSorted(lengths);
+			si::radix_sort(si::quantity_span<Length_m>(radixSorted));
+			for(std::size_t i = 0; i < size; i++) {
+				assert(sorted[i] == Length_m(expected[i]));
+				assert(radixSorted[i] == Length_m(expected[i]));
+			}
+
+			if(size > 0) {
+				std::vector<Length_m> partial(lengths);
+				si::nth_element(si::quantity_span<Length_m>(partial), size / 2);
+				assert(partial[size / 2] == Length_m(expected[size / 2]));
+				for(std::size_t i = 0; i < size / 2; i++) {
+					assert(partial[i] <= partial[size / 2]);
+				}
+			}
+
+			std::vector<Length_m> top(10);
+			const std::size_t k = si::top_k(si::quantity_span<const Length_m>(lengths), si::quantity_span<Length_m>(top));
+			assert(k == std::min<std::size_t>(size, 10));
+			for(std::size_t i = 0; i < k; i++) {
+				assert(top[i] == Length_m(expected[size - 1 - i]));
+			}
+		}
+	}
+
+	// Other integer types
+	{
+		Area_cm2 areas[] = { Area_cm2(5), Area_cm2(-3000000000LL), Area_cm2(0), Area_cm2(3000000000LL), Area_cm2(-1) };
+		si::radix_sort(si::quantity_span<Area_cm2>(areas));
+		assert(areas[0] == Area_cm2(-3000000000LL));
+		assert(areas[1] == Area_cm2(-1));
+		assert(areas[2] == Area_cm2(0));
+		assert(areas[3] == Area_cm2(5));
+		assert(areas[4] == Area_cm2(3000000000LL));
+	}
+}
+
+
+void sortDoubles() {
+	const double inf = std::numeric_limits<double>::infinity();
+	std::vector<LengthDbl_m> lengths;
+	for(int v : randomInts(1000, 1 << 20)) {
+		lengths.push_back(LengthDbl_m(v / 1024.0));
+	}
+	lengths.push_back(LengthDbl_m(inf));
+	lengths.push_back(LengthDbl_m(-inf));
+	lengths.push_back(LengthDbl_m(1e-310)); // Subnormal
+	lengths.push_back(LengthDbl_m(-1e-310));
+	lengths.push_back(LengthDbl_m(0.0));
+
+	std::vector<LengthDbl_m> expected(lengths);
+	std::sort(expected.begin(), expected.end());
+	si::radix_sort(si::quantity_span<LengthDbl_m>(lengths));
+	for(std::size_t i = 0; i < lengths.size(); i++) {
+		assert(lengths[i] == expected[i]);
+	}
+	assert(lengths.front() == LengthDbl_m(-inf));
+	assert(lengths.back() == LengthDbl_m(inf));
+
+	// Negative zero first
+	LengthDbl_m zeros[] = { LengthDbl_m(0.0), LengthDbl_m(-0.0) };
+	si::radix_sort(si::quantity_span<LengthDbl_m>(zeros));
+	assert(std::signbit(zeros[0].value));
+	assert(!std::signbit(zeros[1].value));
+}
+
+
+void merge() {
+	const Length_km km[] = { Length_km(1), Length_km(3), Length_km(5) };
+	const Length_m m[] = { Length_m(-20), Length_m(2500), Length_m(2500), Length_m(4000) };
+	const Length_cm cm[] = { Length_cm(0), Length_cm(299999), Length_cm(600000) };
+
+	Length_cm all[10];
+	si::merge(si::quantity_span<Length_cm>(all), si::quantity_span<const Length_km>(km),
+	          si::quantity_span<const Length_m>(m), si::quantity_span<const Length_cm>(cm));
+	const int expected[] = { -2000, 0, 100000, 250000, 250000, 299999, 300000, 400000, 500000, 600000 };
+	for(int i = 0; i < 10; i++) {
+		assert(all[i] == Length_cm(expected[i]));
+	}
+
+	// Two runs, with different underlying types
+	LengthDbl_m two[6];
+	si::merge(si::quantity_span<LengthDbl_m>(two), si::quantity_span<const Length_km>(km),
+	          si::quantity_span<const Length_cm>(cm));
+	const double expectedTwo[] = { 0, 1000, 2999.99, 3000, 5000, 6000 };
+	for(int i = 0; i < 6; i++) {
+		assert(std::fabs(two[i].value - expectedTwo[i]) < 1e-9);
+	}
+
+	// One run, and empty runs
+	Length_m one[4];
+	si::merge(si::quantity_span<Length_m>(one), si::quantity_span<const Length_m>(m),
+	          si::quantity_span<const Length_km>(), si::quantity_span<const Length_cm>());
+	assert(std::equal(one, one + 4, m));
+	si::merge(si::quantity_span<Length_m>(one), si::quantity_span<const Length_m>(m));
+	assert(std::equal(one, one + 4, m));
+
+	CANT_COMPILE(si::merge(si::quantity_span<Length_m>(one), si::quantity_span<const Time_s>()));
+}
+
+
+void test() {
+	sortInts();
+	sortDoubles();
+	merge();
+}
+
+
+} /* namespace sorting */
+
+
+#endif /* SORTING_HPP_ */
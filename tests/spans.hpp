@@ -0,0 +1,285 @@
+#ifndef SPANS_HPP_
+#define SPANS_HPP_
+
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+
+namespace spans {
+
+
+// Sizes around the vector widths, so all the tails are exercised.
+const std::size_t max_size = 19;
+
+
+bool close(double a, double b) {
+	return std::fabs(a - b) <= 1e-12 * std::fabs(b);
+}
+
+
+void construction() {
+	std::vector<LengthDbl_m> values(5, LengthDbl_m(2));
+	si::quantity_span<LengthDbl_m> span(values);
+	assert(span.size() == 5);
+	assert(!span.empty());
+	assert(span.data() == values.data());
+
+	si::quantity_span<const LengthDbl_m> constSpan = span;
+	assert(constSpan.size() == 5);
+	assert(constSpan.raw()[4] == 2.0);
+
+	span[1] = LengthDbl_m(3);
+	assert(constSpan.subspan(1, 2).size() == 2);
+	assert(constSpan.subspan(1, 2)[0] == LengthDbl_m(3));
+
+	Length_m array[3] = { Length_m(1), Length_m(2), Length_m(3) };
+	si::quantity_span<const Length_m> arraySpan(array);
+	assert(arraySpan.size() == 3);
+	int sum = 0;
+	for(const Length_m& len : arraySpan) {
+		sum += len.value;
+	}
+	assert(sum == 6);
+
+	assert(si::quantity_span<const Length_m>().empty());
+}
+
+
+void testSqrt() {
+	for(std::size_t n = 0; n <= max_size; n++) {
+		std::vector<AreaDbl_m2> areas;
+		for(std::size_t i = 0; i < n; i++) {
+			areas.push_back(AreaDbl_m2(double(i * i)));
+		}
+
+		std::vector<LengthDbl_m> sides(n);
+		si::sqrt(si::quantity_span<const AreaDbl_m2>(areas), si::quantity_span<LengthDbl_m>(sides));
+		for(std::size_t i = 0; i < n; i++) {
+			assert(sides[i] == LengthDbl_m(double(i)));
+		}
+
+		std::vector<LengthDbl_km> sidesKm(n);
+		si::sqrt(si::quantity_span<const AreaDbl_m2>(areas), si::quantity_span<LengthDbl_km>(sidesKm));
+		for(std::size_t i = 0; i < n; i++) {
+			assert(close(sidesKm[i].value, i / 1000.0));
+		}
+	}
+
+	// Not vectorized
+	{
+		Area_m2 areas[] = { Area_m2(4), Area_m2(9), Area_m2(16) };
+		LengthDbl_m sides[3];
+		si::sqrt(si::quantity_span<const Area_m2>(areas), si::quantity_span<LengthDbl_m>(sides));
+		assert(sides[0] == LengthDbl_m(2));
+		assert(sides[2] == LengthDbl_m(4));
+	}
+
+	CANT_COMPILE(si::sqrt(si::quantity_span<AreaDbl_m2>(), si::quantity_span<AreaDbl_m2>()));
+	CANT_COMPILE(si::sqrt(si::quantity_span<Length_km>(), si::quantity_span<Length_km>()));
+}
+
+
+void testAbs() {
+	for(std::size_t n = 0; n <= max_size; n++) {
+		std::vector<LengthDbl_m> lengths;
+		for(std::size_t i = 0; i < n; i++) {
+			lengths.push_back(LengthDbl_m(i % 2 ? -double(i) : double(i)));
+		}
+
+		std::vector<LengthDbl_km> result(n);
+		si::abs(si::quantity_span<const LengthDbl_m>(lengths), si::quantity_span<LengthDbl_km>(result));
+		for(std::size_t i = 0; i < n; i++) {
+			assert(close(result[i].value, i / 1000.0));
+		}
+
+		// In place
+		si::quantity_span<LengthDbl_m> span(lengths);
+		si::abs(span, span);
+		for(std::size_t i = 0; i < n; i++) {
+			assert(lengths[i] == LengthDbl_m(double(i)));
+		}
+	}
+
+	{
+		Length_m lengths[] = { Length_m(-1), Length_m(2) };
+		si::abs(si::quantity_span<Length_m>(lengths), si::quantity_span<Length_m>(lengths));
+		assert(lengths[0] == Length_m(1));
+		assert(lengths[1] == Length_m(2));
+	}
+}
+
+
+void testBounds() {
+	for(std::size_t n = 0; n <= max_size; n++) {
+		std::vector<LengthDbl_m> lengths;
+		for(std::size_t i = 0; i < n; i++) {
+			lengths.push_back(LengthDbl_m(1000.0 * i));
+		}
+		const si::quantity_span<const LengthDbl_m> in(lengths);
+
+		std::vector<LengthDbl_km> result(n);
+		const si::quantity_span<LengthDbl_km> out(result);
+
+		si::min(in, Length_km(5), out);
+		for(std::size_t i = 0; i < n; i++) {
+			assert(result[i] == LengthDbl_km(i < 5 ? double(i) : 5.0));
+		}
+
+		si::max(in, Length_km(5), out);
+		for(std::size_t i = 0; i < n; i++) {
+			assert(result[i] == LengthDbl_km(i > 5 ? double(i) : 5.0));
+		}
+
+		si::clamp(in, Length_km(3), Length_km(7), out);
+		for(std::size_t i = 0; i < n; i++) {
+			assert(result[i] == LengthDbl_km(i < 3 ? 3.0 : i > 7 ? 7.0 : double(i)));
+		}
+	}
+
+	// A NaN stays NaN, whether it is in a vector or in the tail.
+	for(std::size_t n = 1; n <= max_size; n++) {
+		const std::vector<LengthDbl_m> lengths(n, LengthDbl_m(std::numeric_limits<double>::quiet_NaN()));
+		std::vector<LengthDbl_km> result(n);
+		const si::quantity_span<LengthDbl_km> out(result);
+
+		si::clamp(si::quantity_span<const LengthDbl_m>(lengths), Length_km(3), Length_km(7), out);
+		for(std::size_t i = 0; i < n; i++) {
+			assert(std::isnan(result[i].value));
+		}
+
+		si::min(si::quantity_span<const LengthDbl_m>(lengths), Length_km(5), out);
+		for(std::size_t i = 0; i < n; i++) {
+			assert(std::isnan(result[i].value));
+		}
+	}
+
+	{
+		Length_cm lengths[] = { Length_cm(50), Length_cm(150), Length_cm(250) };
+		Length_cm result[3];
+		si::clamp(si::quantity_span<const Length_cm>(lengths), Length_m(1), Length_m(2),
+		          si::quantity_span<Length_cm>(result));
+		assert(result[0] == Length_cm(100));
+		assert(result[1] == Length_cm(150));
+		assert(result[2] == Length_cm(200));
+
+		si::min(si::quantity_span<const Length_cm>(lengths), Length_m(1), si::quantity_span<Length_cm>(result));
+		assert(result[0] == Length_cm(50));
+		assert(result[2] == Length_cm(100));
+
+		CANT_COMPILE(si::min(si::quantity_span<const Length_cm>(lengths), Time_s(1), si::quantity_span<Length_cm>(result)));
+	}
+}
+
+
+void testHypot() {
+	for(std::size_t n = 0; n <= max_size; n++) {
+		std::vector<LengthDbl_m> a;
+		std::vector<LengthDbl_km> b;
+		for(std::size_t i = 0; i < n; i++) {
+			a.push_back(LengthDbl_m(3.0 * i));
+			b.push_back(LengthDbl_km(0.004 * i));
+		}
+
+		std::vector<LengthDbl_m> result(n);
+		si::hypot(si::quantity_span<const LengthDbl_m>(a), si::quantity_span<const LengthDbl_km>(b),
+		          si::quantity_span<LengthDbl_m>(result));
+		for(std::size_t i = 0; i < n; i++) {
+			assert(close(result[i].value, 5.0 * i));
+		}
+	}
+
+	{
+		Length_m a[] = { Length_m(3) };
+		Length_cm b[] = { Length_cm(400) };
+		LengthDbl_m result[1];
+		si::hypot(si::quantity_span<const Length_m>(a), si::quantity_span<const Length_cm>(b),
+		          si::quantity_span<LengthDbl_m>(result));
+		assert(result[0] == LengthDbl_m(5));
+
+		CANT_COMPILE(si::hypot(si::quantity_span<const Length_m>(a), si::quantity_span<const Length_m>(a),
+		                       si::quantity_span<Time_s>()));
+	}
+}
+
+
+void testFma() {
+	for(std::size_t n = 0; n <= max_size; n++) {
+		std::vector<SpeedDbl_m_s> speeds;
+		std::vector<TimeDbl_s> times;
+		std::vector<LengthDbl_km> starts;
+		for(std::size_t i = 0; i < n; i++) {
+			speeds.push_back(SpeedDbl_m_s(2.0 * i));
+			times.push_back(TimeDbl_s(10));
+			starts.push_back(LengthDbl_km(double(i)));
+		}
+
+		std::vector<LengthDbl_m> result(n);
+		si::fma(si::quantity_span<const SpeedDbl_m_s>(speeds), si::quantity_span<const TimeDbl_s>(times),
+		        si::quantity_span<const LengthDbl_km>(starts), si::quantity_span<LengthDbl_m>(result));
+		for(std::size_t i = 0; i < n; i++) {
+			assert(result[i] == LengthDbl_m(1020.0 * i));
+		}
+	}
+
+	{
+		Speed_m_s speeds[] = { Speed_m_s(2) };
+		Time_h times[] = { Time_h(1) };
+		Length_km starts[] = { Length_km(1) };
+		Length_m result[1];
+		si::fma(si::quantity_span<const Speed_m_s>(speeds), si::quantity_span<const Time_h>(times),
+		        si::quantity_span<const Length_km>(starts), si::quantity_span<Length_m>(result));
+		assert(result[0] == Length_m(8200));
+
+		CANT_COMPILE(si::fma(si::quantity_span<const Speed_m_s>(speeds), si::quantity_span<const Speed_m_s>(speeds),
+		                     si::quantity_span<const Length_km>(starts), si::quantity_span<Length_m>(result)));
+	}
+}
+
+
+// All the versions of a kernel give the same results.
+void levels() {
+	double in[max_size], scalar[max_size], out[max_size];
+	for(std::size_t i = 0; i < max_size; i++) {
+		in[i] = 1.5 * i;
+	}
+	const si::_simd::sqrt_op op = { 0.25 };
+	si::_simd::map_scalar(in, scalar, max_size, op);
+
+#if SI_SIMD_X86
+	si::_simd::map_sse2(in, out, max_size, op);
+	for(std::size_t i = 0; i < max_size; i++) {
+		assert(out[i] == scalar[i]);
+	}
+
+	if(si::_simd::supported_level() == si::_simd::avx2_level) {
+		si::_simd::map_avx2(in, out, max_size, op);
+		for(std::size_t i = 0; i < max_size; i++) {
+			assert(out[i] == scalar[i]);
+		}
+	}
+#endif
+
+	si::_simd::map(in, out, max_size, op);
+	for(std::size_t i = 0; i < max_size; i++) {
+		assert(out[i] == scalar[i]);
+	}
+}
+
+
+void test() {
+	construction();
+	testSqrt();
+	testAbs();
+	testBounds();
+	testHypot();
+	testFma();
+	levels();
+}
+
+
+} /* namespace spans */
+
+
+#endif /* SPANS_HPP_ */
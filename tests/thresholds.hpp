@@ -0,0 +1,178 @@
+#ifndef THRESHOLDS_HPP_
+#define THRESHOLDS_HPP_
+
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+
+namespace thresholds {
+
+
+// The bulk operations must give the same results as the predicate applied to
+// each value, which uses the comparison operators.
+template <typename SIValueType, typename Predicate>
+void check(const std::vector<SIValueType>& values, const Predicate& predicate) {
+	const si::quantity_span<const SIValueType> span(values);
+	const std::size_t n = values.size();
+	const std::size_t expected = std::count_if(values.begin(), values.end(), predicate);
+
+	assert(si::count_if(span, predicate) == expected);
+
+	std::vector<std::uint64_t> words((n + 63) / 64, ~std::uint64_t(0));
+	si::mask(span, predicate, words.data());
+	for(std::size_t i = 0; i < words.size() * 64; i++) {
+		const bool bit = (words[i / 64] >> (i % 64)) & 1;
+		assert(bit == (i < n  &&  predicate(values[i])));
+	}
+
+	std::vector<std::uint32_t> indices(n);
+	assert(si::select(span, predicate, indices.data()) == expected);
+	std::vector<SIValueType> filtered(n);
+	assert(si::filter(span, predicate, si::quantity_span<SIValueType>(filtered)) == expected);
+	std::size_t k = 0;
+	for(std::size_t i = 0; i < n; i++) {
+		if(predicate(values[i])) {
+			assert(indices[k] == i);
+			assert(filtered[k] == values[i]);
+			k++;
+		}
+	}
+
+	std::vector<SIValueType> partitioned(values);
+	assert(si::partition(si::quantity_span<SIValueType>(partitioned), predicate) == expected);
+	for(std::size_t i = 0; i < n; i++) {
+		assert(predicate(partitioned[i]) == (i < expected));
+	}
+}
+
+
+template <typename SIValueType, typename Bound>
+void checkAll(const std::vector<SIValueType>& values, const Bound& bound) {
+	check(values, si::above(bound));
+	check(values, si::at_least(bound));
+	check(values, si::below(bound));
+	check(values, si::at_most(bound));
+}
+
+
+void integers() {
+	// Sizes around the vector widths and the word size.
+	const std::size_t sizes[] = { 0, 1, 7, 8, 9, 63, 64, 65, 130, 5000 };
+	for(std::size_t size : sizes) {
+		std::vector<Speed_m_s> speeds;
+		for(std::size_t i = 0; i < size; i++) {
+			speeds.push_back(Speed_m_s(int(i * 7919 % 61) - 20));
+		}
+
+		// 100 km/h is 27.8 m/s, so the strict and non-strict comparisons round differently.
+		checkAll(speeds, si::Speed_km_h<int>(100));
+		checkAll(speeds, si::Speed_km_h<int>(-36));   // -10 m/s exactly
+		checkAll(speeds, si::Speed_km_h<int>(-37));
+		checkAll(speeds, si::Speed_km_h<double>(99.5));
+		checkAll(speeds, SpeedDbl_m_s(10.0));
+		checkAll(speeds, Speed_m_s(10));
+
+		// Saturated
+		checkAll(speeds, si::Speed_km_h<double>(1e12));
+		checkAll(speeds, si::Speed_km_h<double>(-1e12));
+		checkAll(speeds, si::Speed_km_h<long long>(std::numeric_limits<int>::max()));
+	}
+
+	{
+		std::vector<Speed_m_s> speeds(10, Speed_m_s(1));
+		const si::quantity_span<const Speed_m_s> span(speeds);
+		const double nan = std::numeric_limits<double>::quiet_NaN();
+		assert(si::count_if(span, si::above(SpeedDbl_m_s(nan))) == 0);
+		assert(si::count_if(span, si::at_most(SpeedDbl_m_s(nan))) == 0);
+		assert(si::count_if_greater(span, SpeedDbl_m_s(0.5)) == 10);
+
+		// The bound times the numerator of the factor (5/18) overflows intmax_t.
+		const long long highest = std::numeric_limits<long long>::max();
+		assert(si::count_if(span, si::below(si::Speed_km_h<long long>(highest))) == 10);
+		assert(si::count_if(span, si::above(si::Speed_km_h<long long>(-highest))) == 10);
+		assert(si::count_if(span, si::at_least(si::Speed_km_h<long long>(highest))) == 0);
+	}
+
+	// Not vectorized
+	{
+		std::vector<Area_cm2> areas;
+		for(int i = 0; i < 100; i++) {
+			areas.push_back(Area_cm2(i * 1000));
+		}
+		checkAll(areas, AreaDbl_m2(2.5));
+		checkAll(areas, Area_m2(3));
+	}
+}
+
+
+void floatingPoint() {
+	const std::size_t sizes[] = { 0, 1, 3, 4, 5, 64, 65, 130, 5000 };
+	for(std::size_t size : sizes) {
+		std::vector<SpeedDbl_m_s> speeds;
+		for(std::size_t i = 0; i < size; i++) {
+			speeds.push_back(SpeedDbl_m_s(double(int(i * 7919 % 61) - 20) / 2));
+		}
+
+		checkAll(speeds, si::Speed_km_h<int>(100));
+		checkAll(speeds, SpeedDbl_m_s(10.0));  // Equal to some values
+		checkAll(speeds, Speed_m_s(-3));
+	}
+
+	{
+		std::vector<SpeedDbl_m_s> speeds(10, SpeedDbl_m_s(1));
+		const si::quantity_span<const SpeedDbl_m_s> span(speeds);
+		assert(si::count_if(span, si::above(SpeedDbl_m_s(1))) == 0);
+		assert(si::count_if(span, si::at_least(SpeedDbl_m_s(1))) == 10);
+		assert(si::count_if(span, si::below(SpeedDbl_m_s(1))) == 0);
+		assert(si::count_if(span, si::at_most(SpeedDbl_m_s(1))) == 10);
+
+		CANT_COMPILE(si::count_if(span, si::above(Length_m(1))));
+	}
+}
+
+
+// All the versions of the kernels give the same results.
+template <si::_simd::comparison C, typename T>
+void levels(T threshold) {
+	const std::size_t n = 150;
+	T in[n];
+	for(std::size_t i = 0; i < n; i++) {
+		in[i] = T(int(i * 7919 % 61) - 20);
+	}
+	std::uint64_t scalar[3], words[3];
+	si::_simd::compare_scalar<C>(in, n, threshold, scalar);
+	const std::size_t count = si::_simd::count_scalar<C>(in, n, threshold);
+
+#if SI_SIMD_X86
+	si::_simd::compare_sse2<C>(in, n, threshold, words);
+	assert(std::equal(words, words + 3, scalar));
+	assert(si::_simd::count_sse2<C>(in, n, threshold) == count);
+
+	if(si::_simd::supported_level() == si::_simd::avx2_level) {
+		si::_simd::compare_avx2<C>(in, n, threshold, words);
+		assert(std::equal(words, words + 3, scalar));
+		assert(si::_simd::count_avx2<C>(in, n, threshold) == count);
+	}
+#endif
+	(void)count;
+	(void)words;
+}
+
+
+void test() {
+	integers();
+	floatingPoint();
+	levels<si::_simd::at_least>(3);
+	levels<si::_simd::at_most>(3);
+	levels<si::_simd::at_least>(3.0);
+	levels<si::_simd::at_most>(3.0);
+}
+
+
+} /* namespace thresholds */
+
+
+#endif /* THRESHOLDS_HPP_ */
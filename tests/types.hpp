@@ -0,0 +1,49 @@
+#ifndef TYPES_HPP_
+#define TYPES_HPP_
+
+
+#include <type_traits>
+
+
+namespace types {
+
+
+// The generated types name the SIValue types directly, so they must be the
+// same types that result from the operations.
+void test() {
+	using std::is_same;
+	using si::multiplication;
+	using si::division;
+
+	static_assert(is_same<si::Length_cm<int>::apply_ratio<std::ratio<100>>::type, si::Length_m<int>>::value, "");
+	static_assert(is_same<si::Length_km<int>::apply_ratio<std::milli>::type, si::Length_m<int>>::value, "");
+	static_assert(is_same<si::Length_cm<int>::apply_ratio<std::ratio<100000>>::type, si::Length_km<int>>::value, "");
+	static_assert(is_same<si::Area_cm2<int>::apply_ratio<std::ratio<100*100>>::type, si::Area_m2<int>>::value, "");
+	static_assert(is_same<si::Length_m<int>::apply_ratio<std::ratio<1609344, 1000>>::type,
+	                      si::Length_km<int>::apply_ratio<std::ratio<1609344, 1000000>>::type>::value, "");
+
+	static_assert(is_same<multiplication<si::Area_m2<int>, si::Length_m<int>>::type, si::Volume_m3<int>>::value, "");
+	static_assert(is_same<multiplication<si::Length_m<int>, si::Area_m2<int>>::type, si::Volume_m3<int>>::value, "");
+	static_assert(is_same<multiplication<si::Speed_m_s<int>, si::Time_s<int>>::type, si::Length_m<int>>::value, "");
+	static_assert(is_same<multiplication<si::Pressure_Pa<int>, si::Area_m2<int>>::type, si::Force_N<int>>::value, "");
+	static_assert(is_same<multiplication<si::Force_N<int>, si::Length_m<int>>::type, si::Energy_J<int>>::value, "");
+	static_assert(is_same<si::Torque_Nm<double>, si::Energy_J<double>>::value, "");
+
+	static_assert(is_same<division<si::Volume_m3<int>, si::Length_m<int>>::type, si::Area_m2<int>>::value, "");
+	static_assert(is_same<division<si::Volume_m3<int>, si::Area_m2<int>>::type, si::Length_m<int>>::value, "");
+	static_assert(is_same<division<si::Area_m2<int>, si::Length_m<int>>::type, si::Length_m<int>>::value, "");
+	static_assert(is_same<division<si::Speed_m_s<int>, si::Time_s<int>>::type, si::Acceleration_m_s2<int>>::value, "");
+	static_assert(is_same<division<si::Force_N<int>, si::Mass_kg<int>>::type, si::Acceleration_m_s2<int>>::value, "");
+	static_assert(is_same<division<si::Length_km<int>, si::Time_h<int>>::type, si::Speed_km_h<int>>::value, "");
+	static_assert(is_same<decltype(1 / si::Time_s<int>()), si::Frequency_Hz<int>>::value, "");
+	static_assert(is_same<decltype(1 / si::ElectricResistance_ohm<int>()), si::ElectricalConductance_S<int>>::value, "");
+	static_assert(is_same<decltype(1 / si::ElectricalConductance_S<int>()), si::ElectricResistance_ohm<int>>::value, "");
+
+	static_assert(is_same<si::sqrt_function<si::Area_m2<int>>::type, si::Length_m<double>>::value, "");
+}
+
+
+} /* namespace types */
+
+
+#endif /* TYPES_HPP_ */
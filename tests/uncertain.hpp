@@ -0,0 +1,147 @@
+#ifndef UNCERTAIN_HPP_
+#define UNCERTAIN_HPP_
+
+
+#include <cmath>
+#include <random>
+#include <type_traits>
+
+
+namespace uncertain {
+
+
+typedef si::uncertain<double> Uncertain;
+
+
+bool near(double a, double b, double tolerance) {
+	return std::fabs(a - b) <= tolerance * std::fabs(b);
+}
+
+
+void propagation() {
+	const Uncertain x(10, 0.3), y(5, 0.4);
+	assert((x + y).value == 15  &&  near((x + y).sigma, 0.5, 1e-15));
+	assert((x - y).value == 5  &&  near((x - y).sigma, 0.5, 1e-15));
+	assert((x * y).value == 50  &&  near((x * y).sigma, std::sqrt(1.5 * 1.5 + 4.0 * 4.0), 1e-15));
+	assert((x / y).value == 2  &&  near((x / y).sigma, std::sqrt(0.06 * 0.06 + 0.16 * 0.16), 1e-15));
+	assert((-3.0 * x).value == -30  &&  near((-3.0 * x).sigma, 0.9, 1e-15));
+	assert((x + 1.0).sigma == 0.3);
+	assert(near(sqrt(x).sigma, 0.3 / (2 * std::sqrt(10)), 1e-15));
+	assert(near(exp(y).sigma, std::exp(5) * 0.4, 1e-15));
+	assert(near(hypot(Uncertain(3, 0.1), Uncertain(4, 0.1)).sigma, 0.1, 1e-15));
+	assert(pow(Uncertain(0, 0.1), 0.5).value == 0  &&  pow(Uncertain(0, 0.1), 0.0).value == 1);
+	assert(pow(Uncertain(0, 0.1), 0.0).sigma == 0);
+	assert(pow(x, 2.0).value == 100  &&  near(pow(x, 2.0).sigma, 6, 1e-15));
+
+	// Comparisons compare the values only.
+	assert(x > y  &&  x == Uncertain(10, 1));
+}
+
+
+void values() {
+	typedef si::Voltage_V<Uncertain>           Voltage_V;
+	typedef si::ElectricCurrent_A<Uncertain>   Current_A;
+	typedef si::Pressure_Pa<Uncertain>         Pressure_Pa;
+
+	const Voltage_V voltage = Current_A(Uncertain(0.02, 0.0001)) * si::ElectricResistance_ohm<Uncertain>(Uncertain(250, 2.5));
+	assert(near(voltage.value.value, 5, 1e-15));
+	assert(near(voltage.value.sigma, 5 * std::sqrt(0.005 * 0.005 + 0.01 * 0.01), 1e-12));
+
+	const auto pressure = si::Force_N<Uncertain>(Uncertain(100, 1)) / si::Area_m2<Uncertain>(Uncertain(0.5, 0.005));
+	static_assert(std::is_same<decltype(pressure), const Pressure_Pa>::value, "");
+	assert(near(pressure.value.sigma, 200 * std::sqrt(2) * 0.01, 1e-12));
+}
+
+
+void batches() {
+	typedef si::batch<double, 8> Batch;
+	Batch a, b;
+	for(std::size_t i = 0; i < 8; i++) {
+		a[i] = double(i);
+		b[i] = 2;
+	}
+	const Batch c = (a + 1.0) * b - a / b;
+	for(std::size_t i = 0; i < 8; i++) {
+		assert(c[i] == (i + 1.0) * 2 - i / 2.0);
+	}
+
+	// As SI values, the batches have units.
+	const auto speeds = si::Length_m<Batch>(a) / si::Time_s<Batch>(b);
+	static_assert(std::is_same<decltype(speeds), const si::Speed_m_s<Batch>>::value, "");
+	assert(speeds.value[7] == 3.5);
+	const auto sides = std::sqrt(si::Area_m2<Batch>(a * a));
+	static_assert(std::is_same<decltype(sides), const si::Length_m<Batch>>::value, "");
+	assert(sides.value[5] == 5);
+}
+
+
+// The pressure on a piston, from the force and its radius.
+struct piston {
+	template <typename T>
+	si::Pressure_Pa<T> operator()(const si::Force_N<T>& force, const si::Length_m<T>& radius) const {
+		return force / (3.141592653589793 * radius * radius);
+	}
+};
+
+// A voltage divider, from the input voltage and the two resistances.
+struct divider {
+	template <typename T>
+	si::Voltage_V<T> operator()(const si::Voltage_V<T>& input, const si::ElectricResistance_ohm<T>& r1,
+	                            const si::ElectricResistance_ohm<T>& r2) const
+	{
+		return input * (r2 / (r1 + r2));
+	}
+};
+
+
+void sampling() {
+	const si::Force_N<Uncertain> force(Uncertain(1000, 10));
+	const si::Length_m<Uncertain> radius(Uncertain(0.1, 0.001));
+
+	std::mt19937_64 engine(42);
+	const si::Pressure_Pa<Uncertain> p = si::monte_carlo<256>(piston(), 100000, engine, force, radius);
+	assert(near(p.value.value, 1000 / (3.141592653589793 * 0.01), 0.001));
+	assert(near(p.value.sigma, p.value.value * std::sqrt(0.01 * 0.01 + 0.02 * 0.02), 0.02));
+
+	// The propagation to first order takes the two factors of the radius as
+	// independent, and underestimates the deviation.
+	const si::Pressure_Pa<Uncertain> linear = piston()(force, radius);
+	assert(near(linear.value.sigma, p.value.value * std::sqrt(0.01 * 0.01 + 2 * 0.01 * 0.01), 0.001));
+
+	// The same engine state gives the same results.
+	std::mt19937_64 again(42);
+	const si::Pressure_Pa<Uncertain> q = si::monte_carlo<256>(piston(), 100000, again, force, radius);
+	assert(p.value.value == q.value.value  &&  p.value.sigma == q.value.sigma);
+
+	// Engines of 32 bits draw one sample at a time.
+	std::mt19937 narrow(42);
+	const si::Pressure_Pa<Uncertain> r = si::monte_carlo<255>(piston(), 100000, narrow, force, radius);
+	assert(near(r.value.value, p.value.value, 0.001)  &&  near(r.value.sigma, p.value.sigma, 0.03));
+
+	// Constant inputs, and a number of samples that is not a multiple of the batch size
+	const si::Voltage_V<Uncertain> v = si::monte_carlo<64>(divider(), 50001, engine,
+		si::Voltage_V<Uncertain>(Uncertain(12, 0.1)),
+		si::ElectricResistance_ohm<double>(1000),
+		si::ElectricResistance_ohm<Uncertain>(Uncertain(2000, 20)));
+	assert(near(v.value.value, 8, 0.001));
+	assert(near(v.value.sigma, std::sqrt(0.1 * 2 / 3 * 0.1 * 2 / 3 + 20 * 12 * 1000 / 9e6 * 20 * 12 * 1000 / 9e6), 0.03));
+
+	// A single exact input has no deviation.
+	const si::Voltage_V<Uncertain> exact = si::monte_carlo<16>(divider(), 100, engine,
+		si::Voltage_V<double>(12), si::ElectricResistance_ohm<double>(1000), si::ElectricResistance_ohm<double>(3000));
+	assert(exact.value.value == 9  &&  exact.value.sigma == 0);
+}
+
+
+void test() {
+	propagation();
+	values();
+	batches();
+	sampling();
+}
+
+
+} /* namespace uncertain */
+
+
+#endif /* UNCERTAIN_HPP_ */
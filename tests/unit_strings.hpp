@@ -0,0 +1,80 @@
+#ifndef UNIT_STRINGS_HPP_
+#define UNIT_STRINGS_HPP_
+
+
+#include <type_traits>
+
+
+namespace unit_strings {
+
+
+#if SI_UNIT_STRINGS
+
+// The generated types, for the symbols of the table and their products.
+static_assert(std::is_same<si::unit<"m">, LengthDbl_m>::value, "");
+static_assert(std::is_same<si::unit<"s", int>, Time_s>::value, "");
+static_assert(std::is_same<si::unit<"kg·m/s²">, si::Force_N<double>>::value, "");
+static_assert(std::is_same<si::unit<"kg*m/s^2">, si::Force_N<double>>::value, "");
+static_assert(std::is_same<si::unit<"N·m">, si::unit<"J">>::value, "");
+static_assert(std::is_same<si::unit<"km/h">, si::Speed_km_h<double>>::value, "");
+static_assert(std::is_same<si::unit<"1/s">, FrequencyDbl_Hz>::value, "");
+static_assert(std::is_same<si::unit<"s⁻¹">, FrequencyDbl_Hz>::value, "");
+static_assert(std::is_same<si::unit<"J/(K·kg)">, si::unit<"J/(K*kg)">>::value, "");
+static_assert(std::is_same<si::unit<"W/(m²·K)">, si::division<si::unit<"W/m²">, si::Temperature_K<double>>::type>::value, "");
+static_assert(std::is_same<si::unit<"m^3/s", float>,
+                           si::division<si::Volume_m3<float>, si::Time_s<float>>::type>::value, "");
+static_assert(std::is_same<si::unit<"m/m">, si::division<LengthDbl_m, LengthDbl_m>::type>::value, "");
+
+// Prefixes, on any unit of the SI
+static_assert(std::is_same<si::unit<"kW·h">::Ratio, std::ratio<3600000000>>::value, ""); // In g, as for J
+static_assert(std::is_same<si::unit<"kN">::Ratio, std::ratio<1000000>>::value, "");
+static_assert(std::is_same<si::unit<"mPa·s">::Ratio, std::ratio<1>>::value, "");
+static_assert(std::is_same<si::unit<"dam">::Ratio, std::ratio<10>>::value, "");
+static_assert(std::is_same<si::unit<"hPa">, si::Pressure_hPa<double>>::value, "");
+static_assert(std::is_same<si::unit<"µs">, si::unit<"μs">>::value, "");
+static_assert(std::is_same<si::unit<"us">, si::unit<"μs">>::value, "");
+static_assert(std::is_same<si::unit<"kΩ">, si::unit<"kohm">>::value, "");
+static_assert(std::is_same<si::unit<u8"kΩ">, si::unit<"kohm">>::value, "");
+
+// Powers apply to the prefixed unit, and nest.
+static_assert(std::is_same<si::unit<"km²">, si::Area_km2<double>>::value, "");
+static_assert(std::is_same<si::unit<"(m/s)^2">, si::unit<"m²/s²">>::value, "");
+static_assert(std::is_same<si::unit<"((m))">, LengthDbl_m>::value, "");
+static_assert(std::is_same<si::unit<"m^0">, si::unit<"m/m">>::value, "");
+
+// Only an empty string is reported as empty; a missing operand is malformed.
+static_assert(si::_unit_string::parse("", 0).failure == si::_unit_string::error::empty, "");
+static_assert(si::_unit_string::parse("kg*", 3).failure == si::_unit_string::error::syntax, "");
+static_assert(si::_unit_string::parse("m/", 2).failure == si::_unit_string::error::syntax, "");
+static_assert(si::_unit_string::parse("()", 2).failure == si::_unit_string::error::syntax, "");
+
+#endif
+
+
+void test() {
+#if SI_UNIT_STRINGS
+	const si::unit<"kW·h"> energy(2);
+	assert(si::Energy_kJ<double>(energy) == si::Energy_kJ<double>(7200));
+	assert(si::unit<"km/h">(si::unit<"m/s">(10)) == si::Speed_km_h<double>(36));
+
+	CANT_COMPILE(si::unit<"">());
+	CANT_COMPILE(si::unit<"m//s">());
+	CANT_COMPILE(si::unit<"kg*">());
+	CANT_COMPILE(si::unit<"m/">());
+	CANT_COMPILE(si::unit<"m^">());
+	CANT_COMPILE(si::unit<"(m">());
+	CANT_COMPILE(si::unit<"furlong">());
+	CANT_COMPILE(si::unit<"kkm">());
+	CANT_COMPILE(si::unit<"kmin">());
+	CANT_COMPILE(si::unit<"J/kg·K">());
+	CANT_COMPILE(si::unit<"m/s/s">());
+	CANT_COMPILE(si::unit<"m^200">());
+	CANT_COMPILE(si::unit<"Em^9">());
+#endif
+}
+
+
+} /* namespace unit_strings */
+
+
+#endif /* UNIT_STRINGS_HPP_ */
@@ -0,0 +1,237 @@
+#ifndef WIRE_HPP_
+#define WIRE_HPP_
+
+
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cmath>
+#include <cstdint>
+#include <ratio>
+#include <thread>
+#include <vector>
+
+
+namespace wire {
+
+
+typedef si::SIValue<int, std::ratio<1852>, si::pack_dimensions(1, 0, 0, 0, 0, 0, 0)> Length_NM;
+typedef si::SIValue<double, std::ratio<1>, si::pack_dimensions(-9, 0, 0, 0, 0, 0, 0)> Unsupported;
+typedef si::SIValue<long long, std::ratio<INTMAX_MAX>, si::pack_dimensions(1, 0, 0, 0, 0, 0, 0)> Length_huge;
+
+
+// Sends the message through a socket pair from another thread, and returns
+// what is received.
+std::vector<unsigned char> sendAndReceive(const std::vector<unsigned char>& message) {
+	int sockets[2];
+	const int created = socketpair(AF_UNIX, SOCK_STREAM, 0, sockets);
+	assert(created == 0);
+	(void)created;
+
+	std::thread sender([&]() {
+		std::size_t sent = 0;
+		while(sent < message.size()) {
+			const ssize_t n = ::write(sockets[0], message.data() + sent, message.size() - sent);
+			assert(n > 0);
+			sent += std::size_t(n);
+		}
+		close(sockets[0]);
+	});
+
+	std::vector<unsigned char> received;
+	unsigned char buffer[4096];
+	ssize_t n;
+	while((n = ::read(sockets[1], buffer, sizeof(buffer))) > 0) {
+		received.insert(received.end(), buffer, buffer + n);
+	}
+	close(sockets[1]);
+	sender.join();
+	return received;
+}
+
+
+void tags() {
+	std::vector<unsigned char> message;
+	si::wire::write(message, Length_m(3));
+	assert(message.size() == 2 + 4);
+	message.clear();
+	si::wire::write(message, Length_km(3));
+	assert(message.size() == 2 + 4);
+	message.clear();
+	si::wire::write(message, SpeedDbl_m_s(3));
+	assert(message.size() == 3 + 8);
+
+	si::wire::reader reader(message);
+	si::wire::unit_tag tag;
+	bool column;
+	assert(reader.peek(tag, column));
+	assert(!column);
+	assert(tag.dimensions == Speed_m_s::Dimensions);
+	assert(tag.num == 1  &&  tag.den == 1);
+	assert(tag.kind == si::wire::float64);
+	assert(reader.position() == 0);
+
+	CANT_COMPILE(si::wire::write(message, Unsupported(1.0)));
+}
+
+
+void records() {
+	std::vector<unsigned char> message;
+	si::wire::write(message, Length_km(3));
+	si::wire::write(message, TimeDbl_s(-0.25));
+	si::wire::write(message, Length_NM(2));         // Ratio that isn't in the table
+	si::wire::write(message, Area_cm2(-5000000000LL));
+	si::wire::write(message, Length_cm(150));
+
+	const std::vector<unsigned char> received = sendAndReceive(message);
+	assert(received == message);
+
+	si::wire::reader reader(received);
+	Length_m m;
+	Time_s s;
+	assert(!reader.read(s));                        // Other dimensions
+	assert(reader.read(m)  &&  m == Length_m(3000));
+	TimeDbl_s t;
+	assert(reader.read(t)  &&  t.value == -0.25);
+	assert(reader.read(m)  &&  m == Length_m(3704));
+	AreaDbl_m2 area;
+	assert(reader.read(area)  &&  area.value == -500000);
+	LengthDbl_m dbl;
+	assert(reader.read(dbl)  &&  dbl.value == 1.5);
+	assert(reader.at_end());
+	assert(!reader.read(m));
+}
+
+
+void columns() {
+	std::vector<LengthDbl_m> doubles;
+	for(int i = 0; i < 10000; i++) {
+		doubles.push_back(LengthDbl_m(i * 0.5));
+	}
+	const Time_h hours[] = { Time_h(1), Time_h(-2), Time_h(3) };
+
+	std::vector<unsigned char> message;
+	si::wire::write(message, Length_km(1));         // Misaligns the next column
+	si::wire::write(message, si::quantity_span<const LengthDbl_m>(doubles));
+	si::wire::write(message, si::quantity_span<const Time_h>(hours));
+	si::wire::write(message, si::quantity_span<const Time_h>());
+
+	const std::vector<unsigned char> received = sendAndReceive(message);
+	assert(received == message);
+
+	si::wire::reader reader(received);
+	assert(reader.skip());
+
+	// Same type: a view of the message
+	si::quantity_span<const LengthDbl_m> view;
+	std::vector<LengthDbl_m> storage;
+	assert(reader.read(view, storage));
+	assert(view.size() == doubles.size());
+	assert((const unsigned char*)view.data() > received.data());
+	assert((const unsigned char*)view.data() < received.data() + received.size());
+	assert(storage.empty());
+	for(std::size_t i = 0; i < doubles.size(); i++) {
+		assert(view[i] == doubles[i]);
+	}
+
+	// Other ratio: converted
+	const std::size_t position = reader.position();
+	si::quantity_span<const LengthDbl_m> wrong;
+	assert(!reader.read(wrong, storage));
+	assert(reader.position() == position);
+	si::quantity_span<const Time_s> seconds;
+	std::vector<Time_s> secondsStorage;
+	assert(reader.read(seconds, secondsStorage));
+	assert(seconds.size() == 3  &&  seconds.data() == secondsStorage.data());
+	assert(seconds[0] == Time_s(3600)  &&  seconds[1] == Time_s(-7200)  &&  seconds[2] == Time_s(10800));
+
+	si::quantity_span<const Time_h> empty;
+	std::vector<Time_h> emptyStorage;
+	assert(reader.read(empty, emptyStorage)  &&  empty.size() == 0);
+	assert(reader.at_end());
+
+	// Truncated message
+	si::wire::reader truncated(received.data(), received.size() - 1);
+	assert(truncated.skip());
+	assert(truncated.skip());
+	assert(truncated.skip());
+	assert(!truncated.skip());
+	assert(!truncated.read(empty, emptyStorage));
+}
+
+
+// The values that overflow the requested type are rejected.
+void overflows() {
+	std::vector<unsigned char> message;
+	si::wire::write(message, Length_huge(1));
+	si::wire::write(message, Length_huge(2));
+	si::wire::write(message, LengthDbl_m(1e300));
+	si::wire::write(message, LengthDbl_m(std::nan("")));
+	const Length_huge values[] = { Length_huge(1), Length_huge(-2) };
+	si::wire::write(message, si::quantity_span<const Length_huge>(values));
+
+	si::wire::reader reader(message);
+	si::Length_mm<long long> mm;
+	si::Length_m<long long> m;
+	assert(!reader.read(mm));                       // The factor overflows
+	assert(reader.read(m)  &&  m.value == INTMAX_MAX);
+	assert(!reader.read(m));                        // The value overflows
+	assert(reader.skip());
+	assert(!reader.read(m));
+	assert(reader.skip());
+	assert(!reader.read(m));
+	assert(reader.skip());
+
+	const std::size_t position = reader.position();
+	si::quantity_span<const si::Length_m<long long>> view;
+	std::vector<si::Length_m<long long>> storage;
+	assert(!reader.read(view, storage));
+	assert(reader.position() == position);
+	si::quantity_span<const LengthDbl_m> doubles;
+	std::vector<LengthDbl_m> doublesStorage;
+	assert(reader.read(doubles, doublesStorage)  &&  doubles[1].value == -2.0 * INTMAX_MAX);
+	assert(reader.at_end());
+
+	// 64-bit values read into narrower types
+	const si::Length_m<long long> wide[] = { si::Length_m<long long>(5000000000), si::Length_m<long long>(-7) };
+	const si::Length_km<long long> kilometers[] = { si::Length_km<long long>(3000000) };
+	std::vector<unsigned char> narrowing;
+	si::wire::write(narrowing, si::quantity_span<const si::Length_m<long long>>(wide));
+	si::wire::write(narrowing, si::quantity_span<const si::Length_km<long long>>(kilometers));
+	si::wire::write(narrowing, si::Length_m<long long>(-5000000000));
+	si::wire::write(narrowing, si::Length_m<long long>(-7));
+	si::wire::write(narrowing, LengthDbl_m(1e300));
+	si::wire::write(narrowing, LengthDbl_m(HUGE_VAL));
+
+	si::wire::reader narrow(narrowing);
+	si::quantity_span<const Length_m> ints;
+	std::vector<Length_m> intsStorage;
+	assert(!narrow.read(ints, intsStorage));        // 5000000000 m
+	assert(narrow.skip());
+	assert(!narrow.read(ints, intsStorage));        // 3e9 m
+	assert(narrow.skip());
+	Length_m length;
+	assert(!narrow.read(length));
+	assert(narrow.skip());
+	si::Length_m<unsigned> unsignedLength;
+	assert(!narrow.read(unsignedLength));
+	assert(narrow.read(length)  &&  length == Length_m(-7));
+	si::Length_m<float> single;
+	assert(!narrow.read(single));                   // Beyond the largest float
+	assert(narrow.skip());
+	assert(narrow.read(single)  &&  single.value == HUGE_VALF);
+	assert(narrow.at_end());
+}
+
+
+void test() {
+	tags();
+	records();
+	columns();
+	overflows();
+}
+
+
+} /* namespace wire */
+
+
+#endif /* WIRE_HPP_ */